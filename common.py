@@ -144,6 +144,7 @@ def get_sources(env, is_editor_build):
         "util/godot/direct_multimesh_instance.cpp",
         "util/godot/direct_static_body.cpp",
         "util/godot/file_utils.cpp",
+        "util/godot/server_object_pools.cpp",
         "util/godot/shader_material_pool.cpp",
 
         "util/io/*.cpp",
@@ -151,6 +152,7 @@ def get_sources(env, is_editor_build):
         # Thirdparty
 
         "thirdparty/lz4/*.c",
+        "thirdparty/meshoptimizer/*.cpp",
         # "thirdparty/sqlite/*.c",
     ]
 
@@ -191,6 +193,7 @@ def get_sources(env, is_editor_build):
             "tests/voxel/test_curve_range.cpp",
             "tests/voxel/test_edition_funcs.cpp",
             "tests/voxel/test_octree.cpp",
+            "tests/voxel/test_priority_dependency.cpp",
             "tests/voxel/test_raycast.cpp",
             "tests/voxel/test_region_file.cpp",
             "tests/voxel/test_storage_funcs.cpp",
@@ -199,7 +202,10 @@ def get_sources(env, is_editor_build):
             "tests/voxel/test_voxel_data_map.cpp",
             "tests/voxel/test_voxel_graph.cpp",
             "tests/voxel/test_voxel_instancer.cpp",
+            "tests/voxel/test_voxel_lod_terrain.cpp",
+            "tests/voxel/test_voxel_mesher_blocky.cpp",
             "tests/voxel/test_voxel_mesher_cubes.cpp",
+            "tests/voxel/test_voxel_terrain.cpp",
         ]
 
     if smoosh_meshing_enabled:
@@ -210,8 +216,6 @@ def get_sources(env, is_editor_build):
             
             "engine/detail_rendering/detail_rendering.cpp",
             "engine/detail_rendering/render_detail_texture_task.cpp",
-
-            "thirdparty/meshoptimizer/*.cpp"
         ]
 
         if gpu_enabled:
@@ -30,6 +30,7 @@ VoxelStringNames::VoxelStringNames() {
 
 	block_loaded = StringName("block_loaded");
 	block_unloaded = StringName("block_unloaded");
+	data_loading_progress = StringName("data_loading_progress");
 
 	mesh_block_entered = StringName("mesh_block_entered");
 	mesh_block_exited = StringName("mesh_block_exited");
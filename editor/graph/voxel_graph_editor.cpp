@@ -1212,7 +1212,7 @@ void VoxelGraphEditor::profile() {
 		if (i == node_ratios.size()) {
 			node_ratios.push_back(NodeRatio{ info.node_id, float(info.microseconds) });
 		} else {
-			node_ratios[i].ratio += info.microseconds;
+			node_ratios[i].ratio += float(info.microseconds);
 		}
 		max_individual_time = math::max(max_individual_time, float(info.microseconds));
 	}
@@ -182,15 +182,57 @@ inline Vector3f encode_normal_xyz(const Vector3f n) {
 	return Vector3f(0.5f) + 0.5f * n;
 }
 
+#ifdef VOXEL_ENABLE_MODIFIERS
+
+// Modifiers work on separate coordinate buffers
+void apply_modifiers(
+		const VoxelModifierStack &modifiers,
+		Span<const Vector3f> positions,
+		Span<float> sdf_buffer,
+		Vector3f min_pos,
+		Vector3f max_pos
+) {
+	static thread_local StdVector<float> tls_x_buffer;
+	static thread_local StdVector<float> tls_y_buffer;
+	static thread_local StdVector<float> tls_z_buffer;
+	tls_x_buffer.resize(positions.size());
+	tls_y_buffer.resize(positions.size());
+	tls_z_buffer.resize(positions.size());
+
+	for (unsigned int i = 0; i < positions.size(); ++i) {
+		const Vector3f pos = positions[i];
+		tls_x_buffer[i] = pos.x;
+		tls_y_buffer[i] = pos.y;
+		tls_z_buffer[i] = pos.z;
+	}
+
+	modifiers.apply(to_span(tls_x_buffer), to_span(tls_y_buffer), to_span(tls_z_buffer), sdf_buffer, min_pos, max_pos);
+}
+
+#endif
+
+inline void generate_sdf_series(
+		VoxelGenerator &generator,
+		Span<const Vector3f> positions,
+		Span<float> sdf_buffer,
+		Vector3f min_pos,
+		Vector3f max_pos
+) {
+	VoxelGenerator::SeriesOutput sdf_output;
+	sdf_output.type = VoxelGenerator::SeriesOutput::TYPE_SDF;
+	sdf_output.values = sdf_buffer;
+	generator.generate_series_batch(
+			positions, Span<const VoxelGenerator::SeriesOutput>(&sdf_output, 1), min_pos, max_pos
+	);
+}
+
 void query_sdf_with_edits(
 		VoxelGenerator &generator,
 #ifdef VOXEL_ENABLE_MODIFIERS
 		const VoxelModifierStack &modifiers,
 #endif
 		const VoxelDataGrid &grid,
-		Span<const float> query_x_buffer,
-		Span<const float> query_y_buffer,
-		Span<const float> query_z_buffer,
+		Span<const Vector3f> query_positions,
 		Span<float> query_sdf_buffer,
 		Vector3f query_min_pos,
 		Vector3f query_max_pos
@@ -199,26 +241,28 @@ void query_sdf_with_edits(
 
 	VoxelDataGrid::LockRead rlock(grid);
 
-	for (unsigned int query_index = 0; query_index < query_sdf_buffer.size(); ++query_index) {
-		const Vector3 posf(query_x_buffer[query_index], query_y_buffer[query_index], query_z_buffer[query_index]);
+	const VoxelBuffer::ChannelId channel = VoxelBuffer::CHANNEL_SDF;
 
-		// TODO Optimize: broaden the amount of samples done at once to benefit more from bulk processing
-		// Attempting to evaluate multiple values at once when possible: 8 samples for cube of linear interpolation
-		FixedArray<float, 8> sd_samples;
-		FixedArray<float, 8> x_gen;
-		FixedArray<float, 8> y_gen;
-		FixedArray<float, 8> z_gen;
-		FixedArray<uint8_t, 8> i_gen;
-		unsigned int gen_count = 0;
+	// 8 samples per query, for cubes of linear interpolation
+	static thread_local StdVector<float> tls_corner_samples;
+	tls_corner_samples.resize(query_positions.size() * 8);
 
-		const VoxelBuffer::ChannelId channel = VoxelBuffer::CHANNEL_SDF;
+	// Samples that were not edited. They are generated all at once afterward, to benefit from bulk processing.
+	static thread_local StdVector<Vector3f> tls_gen_positions;
+	static thread_local StdVector<uint32_t> tls_gen_corner_indices;
+	static thread_local StdVector<float> tls_gen_samples;
+	tls_gen_positions.clear();
+	tls_gen_corner_indices.clear();
+
+	// Gather samples from edited voxels
+	{
+		ZN_PROFILE_SCOPE_NAMED("Edited samples");
 
-		const Vector3i posi0 = math::floor_to_int(posf);
 		unsigned int i = 0;
 
-		// Gather 8 samples from edited voxels
-		{
-			ZN_PROFILE_SCOPE();
+		for (unsigned int query_index = 0; query_index < query_positions.size(); ++query_index) {
+			const Vector3i posi0 = math::floor_to_int(query_positions[query_index]);
+
 			for (int z = 0; z < 2; ++z) {
 				for (int y = 0; y < 2; ++y) {
 					for (int x = 0; x < 2; ++x) {
@@ -227,53 +271,44 @@ void query_sdf_with_edits(
 						//      (because we can't lock multiple blocks at once otherwise it causes deadlocks)
 						// TODO Optimize: the grid could be told to gather raw channels so we get direct access
 						//      (requires the former optimization)
-						if (!grid.try_get_voxel_f(posi, sd_samples[i], channel)) {
+						if (!grid.try_get_voxel_f(posi, tls_corner_samples[i], channel)) {
 							// Not edited, add to the list of voxels to generate
-							x_gen[gen_count] = posi.x;
-							y_gen[gen_count] = posi.y;
-							z_gen[gen_count] = posi.z;
-							i_gen[gen_count] = i;
-							++gen_count;
+							tls_gen_positions.push_back(to_vec3f(posi));
+							tls_gen_corner_indices.push_back(i);
 						}
 						++i;
 					}
 				}
 			}
 		}
+	}
 
-		// Complete samples with generator. Note, these samples are not scaled since we are working with floats instead
-		// of encoded buffer values.
-		if (gen_count > 0) {
-			ZN_PROFILE_SCOPE();
-			FixedArray<float, 8> gen_samples;
-
-			generator.generate_series(
-					to_span(x_gen, gen_count),
-					to_span(y_gen, gen_count),
-					to_span(z_gen, gen_count),
-					channel,
-					to_span(gen_samples, gen_count),
-					query_min_pos,
-					query_max_pos
-			);
+	// Complete samples with generator. Note, these samples are not scaled since we are working with floats instead
+	// of encoded buffer values.
+	if (tls_gen_positions.size() > 0) {
+		ZN_PROFILE_SCOPE_NAMED("Generated samples");
+
+		tls_gen_samples.resize(tls_gen_positions.size());
+
+		generate_sdf_series(
+				generator, to_span(tls_gen_positions), to_span(tls_gen_samples), query_min_pos, query_max_pos
+		);
 
 #ifdef VOXEL_ENABLE_MODIFIERS
-			modifiers.apply(
-					to_span(x_gen, gen_count),
-					to_span(y_gen, gen_count),
-					to_span(z_gen, gen_count),
-					to_span(gen_samples, gen_count),
-					query_min_pos,
-					query_max_pos
-			);
+		apply_modifiers(
+				modifiers, to_span(tls_gen_positions), to_span(tls_gen_samples), query_min_pos, query_max_pos
+		);
 #endif
 
-			for (unsigned int j = 0; j < gen_count; ++j) {
-				sd_samples[i_gen[j]] = gen_samples[j];
-			}
+		for (unsigned int j = 0; j < tls_gen_samples.size(); ++j) {
+			tls_corner_samples[tls_gen_corner_indices[j]] = tls_gen_samples[j];
 		}
+	}
+
+	// Interpolate
+	for (unsigned int query_index = 0; query_index < query_positions.size(); ++query_index) {
+		Span<const float> sd_samples = to_span_from_position_and_size(tls_corner_samples, query_index * 8, 8);
 
-		// Interpolate
 		const float sd_interp = math::interpolate_trilinear(
 				sd_samples[0],
 				sd_samples[1],
@@ -283,7 +318,7 @@ void query_sdf_with_edits(
 				sd_samples[3],
 				sd_samples[7],
 				sd_samples[6],
-				math::fract(posf)
+				math::fract(query_positions[query_index])
 		);
 
 		query_sdf_buffer[query_index] = sd_interp;
@@ -346,9 +381,7 @@ inline void query_sdf(
 #ifdef VOXEL_ENABLE_MODIFIERS
 		const VoxelModifierStack *modifiers,
 #endif
-		Span<const float> query_x_buffer,
-		Span<const float> query_y_buffer,
-		Span<const float> query_z_buffer,
+		Span<const Vector3f> query_positions,
 		Span<float> query_sdf_buffer,
 		Vector3f query_min_pos,
 		Vector3f query_max_pos
@@ -368,9 +401,7 @@ inline void query_sdf(
 				*modifiers,
 #endif
 				*edited_voxel_data,
-				query_x_buffer,
-				query_y_buffer,
-				query_z_buffer,
+				query_positions,
 				query_sdf_buffer,
 				query_min_pos,
 				query_max_pos
@@ -379,21 +410,11 @@ inline void query_sdf(
 		// Generator only.
 
 		// Note, these samples are not scaled since we are working with floats instead of encoded buffer values.
-		generator.generate_series(
-				query_x_buffer,
-				query_y_buffer,
-				query_z_buffer,
-				VoxelBuffer::CHANNEL_SDF,
-				query_sdf_buffer,
-				query_min_pos,
-				query_max_pos
-		);
+		generate_sdf_series(generator, query_positions, query_sdf_buffer, query_min_pos, query_max_pos);
 
 #ifdef VOXEL_ENABLE_MODIFIERS
 		if (modifiers != nullptr) {
-			modifiers->apply(
-					query_x_buffer, query_y_buffer, query_z_buffer, query_sdf_buffer, query_min_pos, query_max_pos
-			);
+			apply_modifiers(*modifiers, query_positions, query_sdf_buffer, query_min_pos, query_max_pos);
 		}
 #endif
 	}
@@ -505,17 +526,11 @@ void compute_detail_texture_data(
 		const unsigned int max_buffer_size = math::squared(tile_resolution) * 4;
 
 		static thread_local StdVector<float> tls_sdf_buffer;
-		static thread_local StdVector<float> tls_x_buffer;
-		static thread_local StdVector<float> tls_y_buffer;
-		static thread_local StdVector<float> tls_z_buffer;
+		static thread_local StdVector<Vector3f> tls_pos_buffer;
 		tls_sdf_buffer.clear();
-		tls_x_buffer.clear();
-		tls_y_buffer.clear();
-		tls_z_buffer.clear();
+		tls_pos_buffer.clear();
 		tls_sdf_buffer.reserve(max_buffer_size);
-		tls_x_buffer.reserve(max_buffer_size);
-		tls_y_buffer.reserve(max_buffer_size);
-		tls_z_buffer.reserve(max_buffer_size);
+		tls_pos_buffer.reserve(max_buffer_size);
 
 		// Optimize triangles
 		CellTriangles baked_triangles;
@@ -565,32 +580,15 @@ void compute_detail_texture_data(
 					tls_tile_sample_positions.push_back(Vector2i(xi, yi));
 					tls_tile_sample_triangle_index.push_back(hit_triangle_index);
 
-					tls_x_buffer.push_back(pos000.x);
-					tls_y_buffer.push_back(pos000.y);
-					tls_z_buffer.push_back(pos000.z);
-
-					Vector3f pos100 = pos000;
-					pos100.x += step;
-					tls_x_buffer.push_back(pos100.x);
-					tls_y_buffer.push_back(pos100.y);
-					tls_z_buffer.push_back(pos100.z);
-
-					Vector3f pos010 = pos000;
-					pos010.y += step;
-					tls_x_buffer.push_back(pos010.x);
-					tls_y_buffer.push_back(pos010.y);
-					tls_z_buffer.push_back(pos010.z);
-
-					Vector3f pos001 = pos000;
-					pos001.z += step;
-					tls_x_buffer.push_back(pos001.x);
-					tls_y_buffer.push_back(pos001.y);
-					tls_z_buffer.push_back(pos001.z);
+					tls_pos_buffer.push_back(pos000);
+					tls_pos_buffer.push_back(pos000 + Vector3f(step, 0.f, 0.f));
+					tls_pos_buffer.push_back(pos000 + Vector3f(0.f, step, 0.f));
+					tls_pos_buffer.push_back(pos000 + Vector3f(0.f, 0.f, step));
 				}
 			}
 		}
 
-		tls_sdf_buffer.resize(tls_x_buffer.size());
+		tls_sdf_buffer.resize(tls_pos_buffer.size());
 
 		{
 			const VoxelDataGrid *edits_grid = cell_has_edits ? &tls_voxel_data_grid : nullptr;
@@ -605,9 +603,7 @@ void compute_detail_texture_data(
 #ifdef VOXEL_ENABLE_MODIFIERS
 					modifiers,
 #endif
-					to_span(tls_x_buffer),
-					to_span(tls_y_buffer),
-					to_span(tls_z_buffer),
+					to_span(tls_pos_buffer),
 					to_span(tls_sdf_buffer),
 					cell_origin_world,
 					cell_origin_world + Vector3f(cell_size)
@@ -4,25 +4,78 @@
 
 namespace zylann::voxel {
 
+namespace {
+
+// Blocks within this distance from a viewer are not affected by view direction, because the viewer can turn around at
+// any time, and might also be standing on them
+constexpr float VIEW_CONE_MIN_DISTANCE = 32.f;
+constexpr float VIEW_CONE_MIN_DISTANCE_SQ = VIEW_CONE_MIN_DISTANCE * VIEW_CONE_MIN_DISTANCE;
+// Cosine of the half-angle of the cone in which blocks keep their priority. Approximates a wide camera frustum.
+constexpr float VIEW_CONE_COS_HALF_ANGLE = 0.5f;
+
+inline float get_distance_squared_to_segment(const Vector3f p, const Vector3f a, const Vector3f b) {
+	const Vector3f ab = b - a;
+	const float ab_length_sq = math::length_squared(ab);
+	if (ab_length_sq == 0.f) {
+		return math::distance_squared(p, a);
+	}
+	const float t = math::clamp(math::dot(p - a, ab) / ab_length_sq, 0.f, 1.f);
+	return math::distance_squared(p, a + ab * t);
+}
+
+// Returns a squared distance used to rank how soon a block should be processed for the given viewer
+inline float get_priority_distance_squared(
+		const PriorityDependency::ViewersData::Viewer &viewer,
+		const Vector3f block_position,
+		const float distance_sq
+) {
+	float priority_distance_sq = distance_sq;
+
+	if (viewer.predicted_position != viewer.position) {
+		priority_distance_sq =
+				get_distance_squared_to_segment(block_position, viewer.position, viewer.predicted_position);
+	}
+
+	if (viewer.view_direction != Vector3f() && distance_sq > VIEW_CONE_MIN_DISTANCE_SQ) {
+		const float cos_angle = math::dot(block_position - viewer.position, viewer.view_direction) /
+				Math::sqrt(distance_sq);
+		// Blocks get farther the more they are behind the viewer, up to 2.5 times directly behind
+		const float factor = 1.f + math::max(VIEW_CONE_COS_HALF_ANGLE - cos_angle, 0.f);
+		priority_distance_sq *= factor * factor;
+	}
+
+	return priority_distance_sq;
+}
+
+} // namespace
+
 TaskPriority PriorityDependency::evaluate(uint8_t lod_index, uint8_t band2_priority, float *out_closest_distance_sq) {
 	TaskPriority priority;
 	ZN_ASSERT_RETURN_V(shared != nullptr, priority);
 
-	const StdVector<Vector3f> &viewer_positions = shared->viewers;
+	const StdVector<ViewersData::Viewer> &viewers = shared->viewers;
 	const unsigned int viewer_count = shared->viewers_count;
 
 	const Vector3f block_position = world_position;
 
 	float closest_distance_sq = 99999.f;
-	if (viewer_positions.size() == 0) {
+	// Distance used for priority. Can differ from actual distance when viewers predict motion or have a view direction.
+	float closest_priority_distance_sq = 99999.f;
+	if (viewers.size() == 0) {
 		// Assume origin
 		closest_distance_sq = math::length_squared(block_position);
+		closest_priority_distance_sq = closest_distance_sq;
 	} else {
 		for (unsigned int i = 0; i < viewer_count; ++i) {
-			const float d = math::distance_squared(viewer_positions[i], block_position);
+			const ViewersData::Viewer &viewer = viewers[i];
+			const float d = math::distance_squared(viewer.position, block_position);
 			if (d < closest_distance_sq) {
 				closest_distance_sq = d;
 			}
+			const float pd = get_priority_distance_squared(viewer, block_position, d);
+			if (pd < closest_priority_distance_sq) {
+				closest_priority_distance_sq = pd;
+			}
 		}
 	}
 
@@ -33,7 +86,7 @@ TaskPriority PriorityDependency::evaluate(uint8_t lod_index, uint8_t band2_prior
 	// TODO Any way to optimize out the sqrt? Maybe with a fast integer version?
 	// I added it because the LOD modifier was not working with squared distances,
 	// which led blocks to subdivide too much compared to their neighbors, making cracks more likely to happen
-	const int distance = static_cast<int>(Math::sqrt(closest_distance_sq));
+	const int distance = static_cast<int>(Math::sqrt(closest_priority_distance_sq));
 
 	// TODO Prioritizing LOD makes generation slower... but not prioritizing makes cracks more likely to appear...
 	// This could be fixed by allowing the volume to preemptively request blocks of the next LOD?
@@ -18,7 +18,15 @@ struct PriorityDependency {
 		// a task will run much sooner or later than expected, but it will run in any case.
 		// This vector is never resized after the instance is created. It is just big enough to have room for all
 		// viewers.
-		StdVector<Vector3f> viewers;
+		struct Viewer {
+			Vector3f position;
+			// Where the viewer is expected to be after its motion prediction time. Same as `position` if prediction is
+			// off. Blocks along the way get the same priority as if the viewer was already closer to them.
+			Vector3f predicted_position;
+			// Normalized. Blocks outside of a cone around it get lower priority. Zero if not used.
+			Vector3f view_direction;
+		};
+		StdVector<Viewer> viewers;
 		// Use this count instead of `viewers.size()`. Can change, but will always be <= `viewers.size()`
 		std::atomic_uint32_t viewers_count;
 		float highest_view_distance = 999999;
@@ -71,6 +71,10 @@ VoxelEngine::VoxelEngine(Config config) {
 	ZN_PRINT_VERBOSE(format("Size of MeshBlockTask: {}", sizeof(MeshBlockTask)));
 
 	set_main_thread_time_budget_usec(config.main_thread_budget_usec);
+
+	_rendering_instance_pool.set_max_size(config.rendering_instance_pool_size);
+	_physics_body_pool.set_max_size(config.physics_body_pool_size);
+	_shader_material_pool_size = config.shader_material_pool_size;
 }
 
 VoxelEngine::~VoxelEngine() {
@@ -118,6 +122,23 @@ static bool auto_detect_threaded_graphics_resource_building_support() {
 	}
 }
 
+static bool auto_detect_threaded_physics_shape_building_support() {
+	const ProjectSettings *project = ProjectSettings::get_singleton();
+	ZN_ASSERT_RETURN_V(project != nullptr, false);
+
+	// Shapes of the physics servers shipped with Godot can be created from any thread. Servers coming from extensions
+	// might not support it, so we don't assume anything about them.
+	const String physics_engine = project->get("physics/3d/physics_engine");
+	return physics_engine == "DEFAULT" || physics_engine == "GodotPhysics3D" || physics_engine == "Jolt Physics";
+}
+
+void VoxelEngine::try_initialize_physics_features() {
+	_threaded_physics_shape_building_enabled = auto_detect_threaded_physics_shape_building_support();
+	ZN_PRINT_VERBOSE(
+			format("Auto-detected threaded physics shape building: {}", _threaded_physics_shape_building_enabled)
+	);
+}
+
 void VoxelEngine::try_initialize_gpu_features() {
 	_threaded_graphics_resource_building_enabled = auto_detect_threaded_graphics_resource_building_support();
 	ZN_PRINT_VERBOSE(format(
@@ -239,6 +260,21 @@ int VoxelEngine::get_viewer_network_peer_id(ViewerID viewer_id) const {
 	return viewer.network_peer_id;
 }
 
+void VoxelEngine::set_viewer_velocity(ViewerID viewer_id, Vector3 velocity) {
+	Viewer &viewer = _world.viewers.get(viewer_id);
+	viewer.velocity = velocity;
+}
+
+void VoxelEngine::set_viewer_motion_prediction_time(ViewerID viewer_id, float time) {
+	Viewer &viewer = _world.viewers.get(viewer_id);
+	viewer.motion_prediction_time = math::max(time, 0.f);
+}
+
+void VoxelEngine::set_viewer_view_direction(ViewerID viewer_id, Vector3 direction) {
+	Viewer &viewer = _world.viewers.get(viewer_id);
+	viewer.view_direction = direction;
+}
+
 bool VoxelEngine::viewer_exists(ViewerID viewer_id) const {
 	return _world.viewers.exists(viewer_id);
 }
@@ -270,6 +306,10 @@ bool VoxelEngine::is_threaded_graphics_resource_building_enabled() const {
 // 	_threaded_graphics_resource_building_enabled = enabled;
 // }
 
+bool VoxelEngine::is_threaded_physics_shape_building_enabled() const {
+	return _threaded_physics_shape_building_enabled;
+}
+
 void VoxelEngine::push_async_task(zylann::IThreadedTask *task) {
 	_general_thread_pool.enqueue(task, false);
 }
@@ -352,7 +392,11 @@ void VoxelEngine::sync_viewers_task_priority_data() {
 	size_t i = 0;
 	unsigned int max_distance = 0;
 	_world.viewers.for_each_value([&i, &max_distance, &dep](Viewer &viewer) {
-		dep.viewers[i] = to_vec3f(viewer.world_position);
+		PriorityDependency::ViewersData::Viewer &dep_viewer = dep.viewers[i];
+		dep_viewer.position = to_vec3f(viewer.world_position);
+		dep_viewer.predicted_position =
+				to_vec3f(viewer.world_position + viewer.velocity * viewer.motion_prediction_time);
+		dep_viewer.view_direction = math::normalized(to_vec3f(viewer.view_direction));
 		max_distance = math::max(max_distance, viewer.view_distances.max());
 		++i;
 	});
@@ -411,6 +455,10 @@ int VoxelEngine::get_thread_count() const {
 	return _general_thread_pool.get_thread_count();
 }
 
+unsigned int VoxelEngine::get_idle_thread_count() const {
+	return _general_thread_pool.get_waiting_thread_count();
+}
+
 void VoxelEngine::set_thread_count(uint32_t count) {
 	_general_thread_pool.set_thread_count(count);
 }
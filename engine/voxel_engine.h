@@ -5,9 +5,12 @@
 #include "../util/containers/slot_map.h"
 #include "../util/containers/std_vector.h"
 #include "../util/godot/classes/rendering_device.h"
+#include "../util/godot/classes/shape_3d.h"
+#include "../util/godot/server_object_pools.h"
 #include "../util/io/file_locker.h"
 #include "../util/memory/memory.h"
 #include "../util/string/std_string.h"
+#include "../util/tasks/parallel_for.h"
 #include "../util/tasks/progressive_task_runner.h"
 #include "../util/tasks/threaded_task_runner.h"
 #include "../util/tasks/time_spread_task_runner.h"
@@ -65,6 +68,12 @@ public:
 		bool has_mesh_resource;
 		// Tells if the meshing task was required to build a rendering mesh if possible.
 		bool visual_was_required;
+		// Only used if `has_collision_shape` is true (usually when resources are allowed to be built in threads and
+		// collision was requested). Can be null if there is no collision surface.
+		Ref<Shape3D> collision_shape;
+		// Tells if the collision shape was built as part of the task. If not, you need to build it on the main thread
+		// if it is needed.
+		bool has_collision_shape;
 #ifdef VOXEL_ENABLE_SMOOTH_MESHING
 		// Can be null. Attached to meshing output so it is tracked more easily, because it is baked asynchronously
 		// starting from the mesh task, and it might complete earlier or later than the mesh.
@@ -144,9 +153,18 @@ public:
 		bool require_visuals = true;
 		bool requires_data_block_notifications = false;
 		int network_peer_id = -1;
+		// Only used for task priority
+		Vector3 velocity;
+		// How far ahead in time along `velocity` blocks get prioritized. 0 means no prediction.
+		float motion_prediction_time = 0.f;
+		// If not zero, blocks outside of a cone around this direction get lower priority
+		Vector3 view_direction;
 	};
 
 	static constexpr unsigned int DEFAULT_MAIN_THREAD_BUDGET_USEC = 8000;
+	static constexpr unsigned int DEFAULT_RENDERING_INSTANCE_POOL_SIZE = 1024;
+	static constexpr unsigned int DEFAULT_PHYSICS_BODY_POOL_SIZE = 512;
+	static constexpr unsigned int DEFAULT_SHADER_MATERIAL_POOL_SIZE = 1024;
 
 	struct Config {
 		int thread_count_minimum = 1;
@@ -155,6 +173,10 @@ public:
 		// Portion of available CPU threads to attempt using
 		float thread_count_ratio_over_max = 0.5;
 		unsigned int main_thread_budget_usec = DEFAULT_MAIN_THREAD_BUDGET_USEC;
+		// How many unused server objects and materials can be kept to be reused by terrain blocks
+		unsigned int rendering_instance_pool_size = DEFAULT_RENDERING_INSTANCE_POOL_SIZE;
+		unsigned int physics_body_pool_size = DEFAULT_PHYSICS_BODY_POOL_SIZE;
+		unsigned int shader_material_pool_size = DEFAULT_SHADER_MATERIAL_POOL_SIZE;
 	};
 
 	static VoxelEngine &get_singleton();
@@ -166,6 +188,9 @@ public:
 	// class registrations, contrary to modules).
 	// See https://github.com/godotengine/godot-cpp/issues/1180
 	void try_initialize_gpu_features();
+	// Same as above, for physics. Unlike graphics, it does not depend on the renderer, so headless servers also
+	// benefit from it.
+	void try_initialize_physics_features();
 
 	VolumeID add_volume(VolumeCallbacks callbacks);
 	VolumeCallbacks get_volume_callbacks(VolumeID volume_id) const;
@@ -190,6 +215,9 @@ public:
 	bool is_viewer_requiring_data_block_notifications(ViewerID viewer_id) const;
 	void set_viewer_network_peer_id(ViewerID viewer_id, int peer_id);
 	int get_viewer_network_peer_id(ViewerID viewer_id) const;
+	void set_viewer_velocity(ViewerID viewer_id, Vector3 velocity);
+	void set_viewer_motion_prediction_time(ViewerID viewer_id, float time);
+	void set_viewer_view_direction(ViewerID viewer_id, Vector3 direction);
 	bool viewer_exists(ViewerID viewer_id) const;
 	void sync_viewers_task_priority_data();
 	bool get_viewer_count() const;
@@ -209,6 +237,8 @@ public:
 	// This should be fast and safe to access from multiple threads.
 	bool is_threaded_graphics_resource_building_enabled() const;
 	// void set_threaded_graphics_resource_building_enabled(bool enabled);
+	// This should be fast and safe to access from multiple threads.
+	bool is_threaded_physics_shape_building_enabled() const;
 
 	void push_main_thread_progressive_task(IProgressiveTask *task);
 
@@ -221,6 +251,16 @@ public:
 	// Thread-safe.
 	void push_async_io_tasks(Span<IThreadedTask *> tasks);
 
+	// Calls `f(i)` for every `i` in `[0, count)`, using threads of the general pool that are idle if any, and returns
+	// when all calls are done. Can be called from a task of that pool. Thread-safe.
+	template <typename F>
+	void parallel_for(uint32_t count, F f) {
+		zylann::parallel_for(_general_thread_pool, count, f);
+	}
+
+	// Number of threads of the general pool having nothing to do. Only a hint, it can change at any time.
+	unsigned int get_idle_thread_count() const;
+
 #ifdef VOXEL_ENABLE_GPU
 	void push_gpu_task(IGPUTask *task);
 
@@ -247,6 +287,22 @@ public:
 		return _file_locker;
 	}
 
+	// Pools shared by terrains to recycle the objects of their blocks, instead of freeing and creating them as blocks
+	// enter and leave. Must only be used on the main thread.
+
+	inline zylann::godot::RenderingInstancePool &get_rendering_instance_pool() {
+		return _rendering_instance_pool;
+	}
+
+	inline zylann::godot::PhysicsBodyPool &get_physics_body_pool() {
+		return _physics_body_pool;
+	}
+
+	// Shader materials depend on the terrain, so terrains have their own pools, with this size.
+	inline unsigned int get_shader_material_pool_size() const {
+		return _shader_material_pool_size;
+	}
+
 	static inline int get_octree_lod_block_region_extent(float lod_distance, float block_size) {
 		// This is a bounding radius of blocks around a viewer within which we may load them.
 		// `lod_distance` is the distance under which a block should subdivide into a smaller one.
@@ -350,10 +406,17 @@ private:
 
 	FileLocker _file_locker;
 
+	zylann::godot::RenderingInstancePool _rendering_instance_pool;
+	zylann::godot::PhysicsBodyPool _physics_body_pool;
+	unsigned int _shader_material_pool_size = DEFAULT_SHADER_MATERIAL_POOL_SIZE;
+
 	// Caches whether building Mesh and Texture resources is allowed from inside threads.
 	// Depends on Godot's efficiency at doing so, and which renderer is used.
 	// For example, the OpenGL renderer does not support this well, but the Vulkan one should.
 	bool _threaded_graphics_resource_building_enabled = false;
+	// Caches whether building collision shapes is allowed from inside threads. Depends on the physics server, but
+	// the ones shipped with Godot support it.
+	bool _threaded_physics_shape_building_enabled = true;
 
 #ifdef VOXEL_ENABLE_GPU
 	GPUTaskRunner _gpu_task_runner;
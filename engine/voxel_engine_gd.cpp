@@ -6,6 +6,7 @@
 #include "../util/godot/classes/rendering_server.h"
 #include "../util/godot/core/packed_arrays.h"
 #include "../util/macros.h"
+#include "../util/memory/temp_arena.h"
 #include "../util/profiling.h"
 #include "../util/tasks/godot/threaded_task_gd.h"
 #include "voxel_engine.h"
@@ -55,6 +56,31 @@ VoxelEngine::Config VoxelEngine::get_config_from_godot() {
 			Variant::INT, "voxel/threads/main/time_budget_ms", PROPERTY_HINT_RANGE, "0,1000", 8, true
 	);
 
+	add_custom_project_setting(
+			Variant::INT,
+			"voxel/pools/rendering_instances",
+			PROPERTY_HINT_RANGE,
+			"0,65536",
+			zylann::voxel::VoxelEngine::DEFAULT_RENDERING_INSTANCE_POOL_SIZE,
+			true
+	);
+	add_custom_project_setting(
+			Variant::INT,
+			"voxel/pools/physics_bodies",
+			PROPERTY_HINT_RANGE,
+			"0,65536",
+			zylann::voxel::VoxelEngine::DEFAULT_PHYSICS_BODY_POOL_SIZE,
+			true
+	);
+	add_custom_project_setting(
+			Variant::INT,
+			"voxel/pools/shader_materials",
+			PROPERTY_HINT_RANGE,
+			"0,65536",
+			zylann::voxel::VoxelEngine::DEFAULT_SHADER_MATERIAL_POOL_SIZE,
+			true
+	);
+
 	add_custom_project_setting(Variant::BOOL, "voxel/ownership_checks", PROPERTY_HINT_NONE, "", true, true);
 
 	config.inner.main_thread_budget_usec = 1000 * int(ps.get("voxel/threads/main/time_budget_ms"));
@@ -68,6 +94,10 @@ VoxelEngine::Config VoxelEngine::get_config_from_godot() {
 	config.inner.thread_count_ratio_over_max =
 			math::clamp(float(ps.get("voxel/threads/count/ratio_over_max")), 0.f, 1.f);
 
+	config.inner.rendering_instance_pool_size = math::max(0, int(ps.get("voxel/pools/rendering_instances")));
+	config.inner.physics_body_pool_size = math::max(0, int(ps.get("voxel/pools/physics_bodies")));
+	config.inner.shader_material_pool_size = math::max(0, int(ps.get("voxel/pools/shader_materials")));
+
 	config.ownership_checks = ps.get("voxel/ownership_checks");
 
 	return config;
@@ -153,6 +183,8 @@ Dictionary to_dict(const zylann::voxel::VoxelEngine::Stats &stats) {
 	mem["voxel_total"] = ZN_SIZE_T_TO_VARIANT(VoxelMemoryPool::get_singleton().debug_get_total_memory());
 	mem["voxel_used"] = ZN_SIZE_T_TO_VARIANT(VoxelMemoryPool::get_singleton().debug_get_used_memory());
 	mem["block_count"] = VoxelMemoryPool::get_singleton().debug_get_used_blocks();
+	mem["temp_arena_total"] = ZN_SIZE_T_TO_VARIANT(TempArena::get_global_capacity());
+	mem["temp_arena_high_water_mark"] = ZN_SIZE_T_TO_VARIANT(TempArena::get_global_high_water_mark());
 #ifdef DEBUG_ENABLED
 	const uint64_t std_allocated = static_cast<int64_t>(StdDefaultAllocatorCounters::g_allocated);
 	const uint64_t std_deallocated = static_cast<int64_t>(StdDefaultAllocatorCounters::g_deallocated);
@@ -231,6 +263,11 @@ bool VoxelEngine::_b_get_threaded_graphics_resource_building_enabled() const {
 	return ve.is_threaded_graphics_resource_building_enabled();
 }
 
+bool VoxelEngine::_b_get_threaded_physics_shape_building_enabled() const {
+	const zylann::voxel::VoxelEngine &ve = zylann::voxel::VoxelEngine::get_singleton();
+	return ve.is_threaded_physics_shape_building_enabled();
+}
+
 // This is normally automatic. This method is mainly to allow overriding it just in case.
 // void VoxelEngine::_b_set_threaded_graphics_resource_building_enabled(bool enabled) {
 // 	zylann::voxel::VoxelEngine &ve = zylann::voxel::VoxelEngine::get_singleton();
@@ -253,6 +290,10 @@ void VoxelEngine::_bind_methods() {
 			D_METHOD("get_threaded_graphics_resource_building_enabled"),
 			&VoxelEngine::_b_get_threaded_graphics_resource_building_enabled
 	);
+	ClassDB::bind_method(
+			D_METHOD("get_threaded_physics_shape_building_enabled"),
+			&VoxelEngine::_b_get_threaded_physics_shape_building_enabled
+	);
 
 #ifdef VOXEL_TESTS
 	ClassDB::bind_method(D_METHOD("run_tests", "options"), &VoxelEngine::run_tests);
@@ -56,6 +56,7 @@ private:
 
 	bool _b_get_threaded_graphics_resource_building_enabled() const;
 	// void _b_set_threaded_graphics_resource_building_enabled(bool enabled);
+	bool _b_get_threaded_physics_shape_building_enabled() const;
 
 	static void _bind_methods();
 
@@ -43,6 +43,7 @@ void VoxelEngineUpdater::ensure_existence(SceneTree *st) {
 	root->add_child(u);
 
 	VoxelEngine::get_singleton().try_initialize_gpu_features();
+	VoxelEngine::get_singleton().try_initialize_physics_features();
 }
 
 void VoxelEngineUpdater::_notification(int p_what) {
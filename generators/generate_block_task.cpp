@@ -6,6 +6,7 @@
 #include "../util/dstack.h"
 #include "../util/io/log.h"
 #include "../util/math/conv.h"
+#include "../util/memory/temp_arena.h"
 #include "../util/profiling.h"
 #include "../util/string/format.h"
 #include "../util/tasks/async_dependency_tracker.h"
@@ -43,6 +44,9 @@ void GenerateBlockTask::run(zylann::ThreadedTaskContext &ctx) {
 	ZN_DSTACK();
 	ZN_PROFILE_SCOPE();
 
+	// Scratch memory used by the generator is released when the task ends
+	TempArenaScope temp_arena_scope(TempArena::get_for_current_thread());
+
 	CRASH_COND(_stream_dependency == nullptr);
 	Ref<VoxelGenerator> generator = _stream_dependency->generator;
 	ERR_FAIL_COND(generator.is_null());
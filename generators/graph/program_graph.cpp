@@ -360,7 +360,8 @@ void ProgramGraph::debug_print_dot_file(String p_file_path) const {
 bool ProgramGraph::branch_equals(
 		const uint32_t node_id,
 		const ProgramGraph &other_graph,
-		const uint32_t other_node_id
+		const uint32_t other_node_id,
+		const bool objects_by_instance
 ) const {
 	const Node &src_node = get_node(node_id);
 	const Node &dst_node = other_graph.get_node(other_node_id);
@@ -390,6 +391,9 @@ bool ProgramGraph::branch_equals(
 		}
 
 		if (src_value.get_type() == Variant::OBJECT) {
+			if (objects_by_instance) {
+				return false;
+			}
 			const Object *obj0 = src_value;
 			const Object *obj1 = dst_value;
 			if (obj0 == nullptr || obj1 == nullptr) {
@@ -433,7 +437,7 @@ bool ProgramGraph::branch_equals(
 			return false;
 		}
 
-		if (!branch_equals(src_loc.node_id, other_graph, dst_loc.node_id)) {
+		if (!branch_equals(src_loc.node_id, other_graph, dst_loc.node_id, objects_by_instance)) {
 			return false;
 		}
 	}
@@ -146,7 +146,14 @@ public:
 
 	void debug_print_dot_file(String p_file_path) const;
 
-	bool branch_equals(const uint32_t node_id, const ProgramGraph &other_graph, const uint32_t other_node_id) const;
+	// Compares the branch ending with the given node with another one. If `objects_by_instance` is true, object
+	// parameters are only equal if they are the same instance. Otherwise, their properties are compared.
+	bool branch_equals(
+			const uint32_t node_id,
+			const ProgramGraph &other_graph,
+			const uint32_t other_node_id,
+			const bool objects_by_instance = false
+	) const;
 
 private:
 	StdUnorderedMap<uint32_t, Node *> _nodes;
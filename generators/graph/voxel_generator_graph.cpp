@@ -3,6 +3,7 @@
 #include "../../storage/mixel4.h"
 #include "../../storage/voxel_buffer.h"
 #include "../../util/containers/container_funcs.h"
+#include "../../util/containers/std_unordered_map.h"
 #include "../../util/godot/classes/engine.h"
 #include "../../util/godot/classes/image.h"
 #include "../../util/godot/classes/object.h"
@@ -137,6 +138,89 @@ bool VoxelGeneratorGraph::is_using_xz_caching() const {
 	return _use_xz_caching;
 }
 
+void VoxelGeneratorGraph::set_use_xz_column_cache(bool enabled) {
+	_use_xz_column_cache = enabled;
+	if (!enabled) {
+		_xz_column_cache.clear();
+	}
+}
+
+bool VoxelGeneratorGraph::is_using_xz_column_cache() const {
+	return _use_xz_column_cache;
+}
+
+void VoxelGeneratorGraph::set_xz_column_cache_capacity(int capacity) {
+	ERR_FAIL_COND(capacity < 0);
+	_xz_column_cache.set_capacity(capacity);
+}
+
+int VoxelGeneratorGraph::get_xz_column_cache_capacity() const {
+	return _xz_column_cache.get_capacity();
+}
+
+void VoxelGeneratorGraph::set_node_profiling_enabled(bool enabled) {
+	_node_profiling_enabled = enabled;
+}
+
+bool VoxelGeneratorGraph::is_node_profiling_enabled() const {
+	return _node_profiling_enabled;
+}
+
+void VoxelGeneratorGraph::get_node_profiling_info(StdVector<NodeProfilingInfo> &out_info) const {
+	MutexLock mlock(_node_profiler_mutex);
+	const NodeProfiler &profiler = _node_profiler;
+	out_info.clear();
+	for (unsigned int i = 0; i < profiler.times.size(); ++i) {
+		const uint32_t node_id = profiler.node_ids[i];
+		if (node_id == ProgramGraph::NULL_ID) {
+			continue;
+		}
+		out_info.push_back(NodeProfilingInfo{ node_id, profiler.times[i] / 1000 });
+	}
+}
+
+void VoxelGeneratorGraph::clear_node_profiling_info() {
+	MutexLock mlock(_node_profiler_mutex);
+	NodeProfiler &profiler = _node_profiler;
+	profiler.program_id = 0;
+	profiler.times.clear();
+	profiler.node_ids.clear();
+}
+
+bool VoxelGeneratorGraph::sample_node_profiling(Cache &cache) const {
+	if (!_node_profiling_enabled) {
+		return false;
+	}
+	++cache.node_profiling_counter;
+	return (cache.node_profiling_counter % NODE_PROFILING_SAMPLE_INTERVAL) == 0;
+}
+
+void VoxelGeneratorGraph::add_node_profiling_sample(const Runtime &runtime_wrapper, const pg::Runtime::State &state) {
+	ZN_PROFILE_SCOPE();
+	const pg::Runtime &runtime = runtime_wrapper.runtime;
+	// Times are accumulated per operation of the default execution map, even if the query used an optimized one.
+	// Skipped operations simply have no time.
+	const pg::Runtime::ExecutionMap &execution_map = runtime.get_default_execution_map();
+
+	MutexLock mlock(_node_profiler_mutex);
+	NodeProfiler &profiler = _node_profiler;
+
+	if (profiler.program_id != runtime.get_program_id()) {
+		// The graph was recompiled, previous times no longer apply
+		profiler.program_id = runtime.get_program_id();
+		profiler.times.clear();
+		profiler.times.resize(execution_map.operations.size(), 0);
+		profiler.node_ids.resize(execution_map.operations.size());
+		for (unsigned int i = 0; i < execution_map.operations.size(); ++i) {
+			profiler.node_ids[i] = runtime.get_operation_node_id(execution_map.operations[i].address);
+		}
+	}
+
+	for (unsigned int i = 0; i < execution_map.operations.size(); ++i) {
+		profiler.times[i] += state.get_execution_time(execution_map.operations[i].address);
+	}
+}
+
 void VoxelGeneratorGraph::set_texture_mode(const TextureMode mode) {
 	ZN_ASSERT_RETURN(mode >= 0 && mode < TEXTURE_MODE_COUNT);
 	_texture_mode = mode;
@@ -717,7 +801,8 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 	// Slice is on the Y axis
 	const unsigned int slice_buffer_size = section_size.x * section_size.z;
 	pg::Runtime &runtime = runtime_ptr->runtime;
-	runtime.prepare_state(cache.state, slice_buffer_size, false);
+	const bool profile_nodes = sample_node_profiling(cache);
+	pg::Runtime::State &state = cache.get_state(runtime, slice_buffer_size, profile_nodes);
 
 	cache.x_cache.resize(slice_buffer_size);
 	cache.y_cache.resize(slice_buffer_size);
@@ -734,6 +819,10 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 	const int sdf_output_buffer_index = runtime_ptr->sdf_output_buffer_index;
 	const int type_output_buffer_index = runtime_ptr->type_output_buffer_index;
 
+	const Span<const uint16_t> outer_group_output_addresses = runtime.get_outer_group_output_addresses();
+	const bool use_xz_column_cache =
+			_use_xz_caching && _use_xz_column_cache && outer_group_output_addresses.size() > 0;
+
 	bool all_sdf_is_air = (sdf_output_buffer_index != -1) && (type_output_buffer_index == -1);
 	bool all_sdf_is_matter = all_sdf_is_air;
 
@@ -778,7 +867,7 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 							math::Interval(gmin.z, gmax.z),
 							sdf_input_range
 					);
-					runtime.analyze_range(cache.state, range_inputs.get());
+					runtime.analyze_range(state, range_inputs.get());
 				}
 
 				SmallVector<unsigned int, pg::Runtime::MAX_OUTPUTS> required_outputs;
@@ -786,7 +875,7 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 				bool sdf_is_air = true;
 				bool sdf_is_uniform = true;
 				if (sdf_output_buffer_index != -1) {
-					const math::Interval sdf_range = cache.state.get_range(sdf_output_buffer_index);
+					const math::Interval sdf_range = state.get_range(sdf_output_buffer_index);
 					bool sdf_is_matter = false;
 
 					if (sdf_range.min > clip_threshold && sdf_range.max > clip_threshold) {
@@ -816,7 +905,7 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 
 				bool type_is_uniform = false;
 				if (type_output_buffer_index != -1) {
-					const math::Interval type_range = cache.state.get_range(type_output_buffer_index);
+					const math::Interval type_range = state.get_range(type_output_buffer_index);
 					if (type_range.is_single_value()) {
 						out_buffer.fill_area(int(type_range.min), rmin, rmax, type_channel);
 						type_is_uniform = true;
@@ -843,7 +932,7 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 				bool single_texture_is_uniform = false;
 				if (runtime_ptr->single_texture_output_index != -1 && !sdf_is_air) {
 					const math::Interval index_range =
-							cache.state.get_range(runtime_ptr->single_texture_output_buffer_index);
+							state.get_range(runtime_ptr->single_texture_output_buffer_index);
 
 					if (index_range.is_single_value()) {
 						single_texture_is_uniform = true;
@@ -864,7 +953,7 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 
 				if (_use_optimized_execution_map) {
 					runtime.generate_optimized_execution_map(
-							cache.state, cache.optimized_execution_map, to_span(required_outputs), false
+							state, cache.optimized_execution_map, to_span(required_outputs), false
 					);
 				}
 
@@ -879,6 +968,37 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 					}
 				}
 
+				// Results of the outer group only depend on X and Z, so they can be shared by all sections of the same
+				// column, even across blocks.
+				bool outer_group_ready = false;
+				if (use_xz_column_cache) {
+					ZN_PROFILE_SCOPE_NAMED("XZ column cache");
+
+					cache.xz_column_cache_buffers.clear();
+					for (const uint16_t address : outer_group_output_addresses) {
+						cache.xz_column_cache_buffers.push_back(state.get_buffer(address).data);
+					}
+					const Span<float *const> buffers = to_span(cache.xz_column_cache_buffers);
+
+					const pg::XZCache::Key key{ Vector2i(gmin.x, gmin.z),
+												Vector2i(section_size.x, section_size.z),
+												static_cast<uint8_t>(input.lod),
+												runtime.get_program_id() };
+
+					if (!_xz_column_cache.try_load(key, buffers, slice_buffer_size)) {
+						// Not using the optimized execution map, because it depends on the Y range of the section,
+						// while cached results will be used by other sections
+						y_cache.fill(gmin.y);
+						QueryInputs<Span<const float>> query_inputs(
+								*runtime_ptr, x_cache, y_cache, z_cache, input_sdf_slice_cache
+						);
+						runtime.generate_outer_group(state, query_inputs.get());
+						_xz_column_cache.store(key, buffers, slice_buffer_size);
+					}
+
+					outer_group_ready = true;
+				}
+
 				for (int ry = rmin.y, gy = gmin.y; ry < rmax.y; ++ry, gy += stride) {
 					ZN_PROFILE_SCOPE_NAMED("Full slice");
 
@@ -903,9 +1023,9 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 								*runtime_ptr, x_cache, y_cache, z_cache, input_sdf_slice_cache
 						);
 						runtime.generate_set(
-								cache.state,
+								state,
 								query_inputs.get(),
-								_use_xz_caching && ry != rmin.y,
+								outer_group_ready || (_use_xz_caching && ry != rmin.y),
 								_use_optimized_execution_map ? &cache.optimized_execution_map : nullptr
 						);
 					}
@@ -918,14 +1038,14 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 						// The same logic goes for other outputs: if they aren't in the query, we must not fill
 						// them.
 						&& !sdf_is_uniform) {
-						const pg::Runtime::Buffer &sdf_buffer = cache.state.get_buffer(sdf_output_buffer_index);
+						const pg::Runtime::Buffer &sdf_buffer = state.get_buffer(sdf_output_buffer_index);
 						fill_zx_sdf_slice(
 								sdf_buffer, out_buffer, sdf_channel, sdf_channel_depth, sdf_scale, rmin, rmax, ry
 						);
 					}
 
 					if (type_output_buffer_index != -1 && !type_is_uniform) {
-						const pg::Runtime::Buffer &type_buffer = cache.state.get_buffer(type_output_buffer_index);
+						const pg::Runtime::Buffer &type_buffer = state.get_buffer(type_output_buffer_index);
 						fill_zx_integer_slice(
 								type_buffer, out_buffer, type_channel, type_channel_depth, rmin, rmax, ry
 						);
@@ -934,7 +1054,7 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 					if (runtime_ptr->single_texture_output_index != -1 && !single_texture_is_uniform) {
 						gather_texturing_data_from_single_texture_output(
 								runtime_ptr->single_texture_output_buffer_index,
-								cache.state,
+								state,
 								rmin,
 								rmax,
 								ry,
@@ -946,7 +1066,7 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 					if (runtime_ptr->weight_outputs_count > 0) {
 						gather_texturing_data_from_weight_outputs(
 								to_span_const(runtime_ptr->weight_outputs, runtime_ptr->weight_outputs_count),
-								cache.state,
+								state,
 								rmin,
 								rmax,
 								ry,
@@ -979,6 +1099,10 @@ VoxelGenerator::Result VoxelGeneratorGraph::generate_block(VoxelGenerator::Voxel
 		result.max_lod_hint = true;
 	}
 
+	if (profile_nodes) {
+		add_node_profiling_sample(*runtime_ptr, state);
+	}
+
 	return result;
 }
 
@@ -1014,7 +1138,7 @@ bool VoxelGeneratorGraph::generate_broad_block(VoxelGenerator::VoxelQueryData in
 
 	// Slice is on the Y axis
 	pg::Runtime &runtime = runtime_ptr->runtime;
-	runtime.prepare_state(cache.state, 1, false);
+	pg::Runtime::State &state = cache.get_state(runtime, 1, false);
 
 	const float air_sdf = _debug_clipped_blocks ? constants::SDF_FAR_INSIDE : constants::SDF_FAR_OUTSIDE;
 	const float matter_sdf = _debug_clipped_blocks ? constants::SDF_FAR_OUTSIDE : constants::SDF_FAR_INSIDE;
@@ -1033,12 +1157,12 @@ bool VoxelGeneratorGraph::generate_broad_block(VoxelGenerator::VoxelQueryData in
 				math::Interval(gmin.z, gmax.z),
 				math::Interval()
 		);
-		runtime.analyze_range(cache.state, range_inputs.get());
+		runtime.analyze_range(state, range_inputs.get());
 	}
 
 	bool sdf_is_air = true;
 	if (sdf_output_buffer_index != -1) {
-		const math::Interval sdf_range = cache.state.get_range(sdf_output_buffer_index);
+		const math::Interval sdf_range = state.get_range(sdf_output_buffer_index);
 
 		if (sdf_range.min > clip_threshold && sdf_range.max > clip_threshold) {
 			out_buffer.fill_f(air_sdf, sdf_channel);
@@ -1059,7 +1183,7 @@ bool VoxelGeneratorGraph::generate_broad_block(VoxelGenerator::VoxelQueryData in
 	}
 
 	if (type_output_buffer_index != -1) {
-		const math::Interval type_range = cache.state.get_range(type_output_buffer_index);
+		const math::Interval type_range = state.get_range(type_output_buffer_index);
 		if (type_range.is_single_value()) {
 			out_buffer.fill(int(type_range.min), type_channel);
 		} else {
@@ -1079,7 +1203,7 @@ bool VoxelGeneratorGraph::generate_broad_block(VoxelGenerator::VoxelQueryData in
 	// those outputs later if any other output isn't uniform. Instead, the graph runtime can figure out
 	// that stuff is constant.
 	if (runtime_ptr->single_texture_output_index != -1 && !sdf_is_air) {
-		const math::Interval index_range = cache.state.get_range(runtime_ptr->single_texture_output_buffer_index);
+		const math::Interval index_range = state.get_range(runtime_ptr->single_texture_output_buffer_index);
 		if (index_range.is_single_value()) {
 			fill_texturing_data_from_single_texture_index(out_buffer, int(index_range.min), _texture_mode);
 		} else {
@@ -1118,10 +1242,43 @@ pg::CompilationResult VoxelGeneratorGraph::compile(bool debug) {
 
 	const int64_t time_before = Time::get_singleton()->get_ticks_usec();
 
-	std::shared_ptr<Runtime> r = make_shared_instance<Runtime>();
-
 	// We usually expect X, Y, Z and SDF inputs. Custom inputs are not supported.
 	_main_function->auto_pick_inputs_and_outputs();
+
+	// Debug compilation produces extra data, so it is not shared
+	const uint64_t graph_hash = debug ? 0 : _main_function->get_output_graph_hash();
+
+	if (!debug) {
+		bool is_first_compilation;
+		{
+			RWLockRead rlock(_runtime_lock);
+			is_first_compilation = _runtime == nullptr;
+		}
+		// Only on first compilation, which usually happens on load. Later ones are usually caused by edits, and
+		// sub-resources changes might not be detected by the hash, so they always recompile.
+		if (is_first_compilation) {
+			std::shared_ptr<Runtime> shared_runtime =
+					get_shared_runtime_cache().find(graph_hash, **_main_function);
+
+			if (shared_runtime != nullptr) {
+				{
+					RWLockWrite wlock(_runtime_lock);
+					_runtime = shared_runtime;
+					_xz_column_cache.clear();
+				}
+
+				ZN_PRINT_VERBOSE("Voxel graph compilation skipped, using the runtime of an identical graph");
+
+#ifdef VOXEL_ENABLE_GPU
+				invalidate_shaders();
+#endif
+				return shared_runtime->compilation_result;
+			}
+		}
+	}
+
+	std::shared_ptr<Runtime> r = make_shared_instance<Runtime>();
+
 	Span<const pg::VoxelGraphFunction::Port> input_defs = _main_function->get_input_definitions();
 	for (unsigned int input_index = 0; input_index < input_defs.size(); ++input_index) {
 		const pg::VoxelGraphFunction::Port &port = input_defs[input_index];
@@ -1304,10 +1461,20 @@ pg::CompilationResult VoxelGeneratorGraph::compile(bool debug) {
 		r->spare_texture_indices = spare_indices;
 	}
 
+	r->compilation_result = result;
+
+	if (!debug) {
+		r->source_graph.copy_from(source_graph, false);
+		get_shared_runtime_cache().add(graph_hash, r);
+	}
+
 	// Store valid result
 	RWLockWrite wlock(_runtime_lock);
 	_runtime = r;
 
+	// Cached results belong to the previous program
+	_xz_column_cache.clear();
+
 	const int64_t time_spent = Time::get_singleton()->get_ticks_usec() - time_before;
 	ZN_PRINT_VERBOSE(format("Voxel graph compiled in {} us", time_spent));
 
@@ -1320,6 +1487,58 @@ pg::CompilationResult VoxelGeneratorGraph::compile(bool debug) {
 	return result;
 }
 
+struct VoxelGeneratorGraph::SharedRuntimeCache {
+	// Generators own runtimes, the cache doesn't keep them alive.
+	// There can be several runtimes per hash, because graphs with equal contents are only shared if they use the same
+	// resource instances.
+	StdUnorderedMap<uint64_t, StdVector<std::weak_ptr<Runtime>>> runtimes;
+	Mutex mutex;
+
+	std::shared_ptr<Runtime> find(uint64_t graph_hash, const pg::VoxelGraphFunction &graph) {
+		MutexLock mlock(mutex);
+		auto it = runtimes.find(graph_hash);
+		if (it == runtimes.end()) {
+			return nullptr;
+		}
+		for (const std::weak_ptr<Runtime> &weak_runtime : it->second) {
+			std::shared_ptr<Runtime> runtime = weak_runtime.lock();
+			if (runtime == nullptr) {
+				continue;
+			}
+			// Hashes of different graphs can collide.
+			// Compiled operations point directly to resources used by the graph (noises, curves, images...), so they
+			// must be the same instances. Otherwise, the runtime would ignore changes made to our own resources, and
+			// would get those made to resources of the other graph.
+			if (graph.equals(runtime->source_graph, true)) {
+				return runtime;
+			}
+		}
+		return nullptr;
+	}
+
+	void add(uint64_t graph_hash, std::shared_ptr<Runtime> runtime) {
+		MutexLock mlock(mutex);
+		// Forget runtimes no longer used by any generator
+		for (auto it = runtimes.begin(); it != runtimes.end();) {
+			StdVector<std::weak_ptr<Runtime>> &list = it->second;
+			unordered_remove_if(list, [](const std::weak_ptr<Runtime> &weak_runtime) { //
+				return weak_runtime.expired();
+			});
+			if (list.size() == 0) {
+				it = runtimes.erase(it);
+			} else {
+				++it;
+			}
+		}
+		runtimes[graph_hash].push_back(runtime);
+	}
+};
+
+VoxelGeneratorGraph::SharedRuntimeCache &VoxelGeneratorGraph::get_shared_runtime_cache() {
+	static SharedRuntimeCache s_cache;
+	return s_cache;
+}
+
 // This is an external API which involves locking so better not use this internally
 bool VoxelGeneratorGraph::is_good() const {
 	RWLockRead rlock(_runtime_lock);
@@ -1343,8 +1562,8 @@ void VoxelGeneratorGraph::generate_set(Span<const float> in_x, Span<const float>
 
 	QueryInputs<Span<const float>> inputs(*_runtime, in_x, in_y, in_z, in_sdf);
 
-	runtime.prepare_state(cache.state, in_x.size(), false);
-	runtime.generate_set(cache.state, inputs.get(), false, nullptr);
+	pg::Runtime::State &state = cache.get_state(runtime, in_x.size(), false);
+	runtime.generate_set(state, inputs.get(), false, nullptr);
 	// Note, when generating SDF, we don't scale it because the return values are uncompressed floats. Scale only
 	// matters if we are storing it inside 16-bit or 8-bit VoxelBuffer.
 }
@@ -1362,8 +1581,8 @@ void VoxelGeneratorGraph::generate_series(
 
 	QueryInputs inputs(*_runtime, in_x, in_y, in_z, in_sdf);
 
-	runtime.prepare_state(cache.state, in_x.size(), false);
-	runtime.generate_set(cache.state, inputs.get(), false, nullptr);
+	pg::Runtime::State &state = cache.get_state(runtime, in_x.size(), false);
+	runtime.generate_set(state, inputs.get(), false, nullptr);
 	// Note, when generating SDF, we don't scale it because the return values are uncompressed floats. Scale only
 	// matters if we are storing it inside 16-bit or 8-bit VoxelBuffer.
 }
@@ -1377,60 +1596,203 @@ void VoxelGeneratorGraph::generate_series(
 		Vector3f min_pos,
 		Vector3f max_pos
 ) {
-	std::shared_ptr<Runtime> runtime_ptr;
-	{
-		RWLockRead rlock(_runtime_lock);
-		runtime_ptr = _runtime;
-	}
-	if (runtime_ptr == nullptr) {
-		return;
-	}
-
-	int buffer_index;
-	float defval = 0.f;
+	SeriesOutput output;
 	switch (channel) {
 		case VoxelBuffer::CHANNEL_SDF:
-			buffer_index = runtime_ptr->sdf_output_buffer_index;
-			defval = constants::SDF_FAR_OUTSIDE;
+			output.type = SeriesOutput::TYPE_SDF;
 			break;
 		case VoxelBuffer::CHANNEL_TYPE:
-			buffer_index = runtime_ptr->type_output_buffer_index;
+			output.type = SeriesOutput::TYPE_TYPE;
 			break;
 		default:
 			ZN_PRINT_ERROR("Unexpected channel");
 			return;
 	}
+	output.values = out_values;
 
-	if (buffer_index == -1) {
-		// The graph does not define such output
-		out_values.fill(defval);
-		return;
+	generate_series_internal(positions_x, positions_y, positions_z, Span<const SeriesOutput>(&output, 1));
+}
+
+void VoxelGeneratorGraph::generate_series_batch(
+		Span<const Vector3f> positions,
+		Span<const SeriesOutput> outputs,
+		Vector3f min_pos,
+		Vector3f max_pos
+) {
+	ZN_PROFILE_SCOPE();
+
+	// The graph runs on separate coordinate buffers
+	Cache &cache = get_tls_cache();
+	cache.x_cache.resize(positions.size());
+	cache.y_cache.resize(positions.size());
+	cache.z_cache.resize(positions.size());
+
+	for (unsigned int i = 0; i < positions.size(); ++i) {
+		const Vector3f pos = positions[i];
+		cache.x_cache[i] = pos.x;
+		cache.y_cache[i] = pos.y;
+		cache.z_cache[i] = pos.z;
 	}
 
+	generate_series_internal(to_span(cache.x_cache), to_span(cache.y_cache), to_span(cache.z_cache), outputs);
+}
+
+void VoxelGeneratorGraph::generate_series_internal(
+		Span<const float> positions_x,
+		Span<const float> positions_y,
+		Span<const float> positions_z,
+		Span<const SeriesOutput> outputs
+) {
+	ZN_PROFILE_SCOPE();
+	ZN_ASSERT_RETURN(positions_y.size() == positions_x.size());
+	ZN_ASSERT_RETURN(positions_z.size() == positions_x.size());
+
+	std::shared_ptr<Runtime> runtime_ptr;
 	{
-		// The implementation cannot guarantee constness at compile time, but it should not modifiy the data either way
-		float *ptr_x = const_cast<float *>(positions_x.data());
-		float *ptr_y = const_cast<float *>(positions_y.data());
-		float *ptr_z = const_cast<float *>(positions_z.data());
-		generate_set(
-				Span<float>(ptr_x, positions_x.size()),
-				Span<float>(ptr_y, positions_y.size()),
-				Span<float>(ptr_z, positions_z.size())
+		RWLockRead rlock(_runtime_lock);
+		runtime_ptr = _runtime;
+	}
+
+	// Finds where results of the requested output are. Returns false if the graph doesn't define such output.
+	auto find_output = [&runtime_ptr](
+							   const SeriesOutput &output, unsigned int &out_output_index, int &out_buffer_index
+					   ) {
+		if (runtime_ptr == nullptr) {
+			return false;
+		}
+		const Runtime &rw = *runtime_ptr;
+		switch (output.type) {
+			case SeriesOutput::TYPE_SDF:
+				out_output_index = rw.sdf_output_index;
+				out_buffer_index = rw.sdf_output_buffer_index;
+				break;
+			case SeriesOutput::TYPE_TYPE:
+				out_output_index = rw.type_output_index;
+				out_buffer_index = rw.type_output_buffer_index;
+				break;
+			case SeriesOutput::TYPE_SINGLE_TEXTURE:
+				out_output_index = rw.single_texture_output_index;
+				out_buffer_index = rw.single_texture_output_buffer_index;
+				break;
+			case SeriesOutput::TYPE_WEIGHT:
+				out_buffer_index = -1;
+				for (unsigned int i = 0; i < rw.weight_outputs_count; ++i) {
+					if (rw.weight_outputs[i].layer_index == output.layer_index) {
+						out_output_index = rw.weight_output_indices[i];
+						out_buffer_index = rw.weight_outputs[i].output_buffer_index;
+						break;
+					}
+				}
+				break;
+			default:
+				ZN_PRINT_ERROR("Unexpected output type");
+				return false;
+		}
+		return out_buffer_index != -1;
+	};
+
+	SmallVector<unsigned int, pg::Runtime::MAX_OUTPUTS> required_outputs;
+
+	for (const SeriesOutput &output : outputs) {
+		ZN_ASSERT_RETURN(output.values.size() == positions_x.size());
+
+		unsigned int output_index = 0;
+		int buffer_index = -1;
+		if (find_output(output, output_index, buffer_index)) {
+			if (!contains(to_span(required_outputs), output_index)) {
+				required_outputs.push_back(output_index);
+			}
+		} else {
+			// The graph does not define such output
+			Span<float> values = output.values;
+			values.fill(output.type == SeriesOutput::TYPE_SDF ? constants::SDF_FAR_OUTSIDE : 0.f);
+		}
+	}
+
+	if (required_outputs.size() == 0 || positions_x.size() == 0) {
+		return;
+	}
+
+	Cache &cache = get_tls_cache();
+	pg::Runtime &runtime = runtime_ptr->runtime;
+
+	Span<float> in_sdf;
+	if (runtime_ptr->sdf_input_index != -1) {
+		// Support graphs having an SDF input, give it default values
+		cache.input_sdf_full_cache.resize(positions_x.size());
+		in_sdf = to_span(cache.input_sdf_full_cache);
+		in_sdf.fill(0.f);
+	}
+
+	const bool profile_nodes = sample_node_profiling(cache);
+	pg::Runtime::State &state = cache.get_state(runtime, positions_x.size(), profile_nodes);
+
+	// Like the block path, range analysis runs at most once per subdivision volume. Below that, small queries would
+	// spend more time analyzing than they could save by skipping nodes.
+	const unsigned int min_series_size_for_execution_map =
+			static_cast<unsigned int>(math::max(_subdivision_size * _subdivision_size * _subdivision_size, 1));
+
+	const pg::Runtime::ExecutionMap *execution_map = nullptr;
+	if (_use_optimized_execution_map && positions_x.size() >= min_series_size_for_execution_map) {
+		// Bounds given by callers are only hints, so they are calculated here to make sure range analysis covers
+		// every position. This allows to skip nodes that don't contribute to the requested outputs.
+		math::Interval x_range = math::Interval::from_single_value(positions_x[0]);
+		math::Interval y_range = math::Interval::from_single_value(positions_y[0]);
+		math::Interval z_range = math::Interval::from_single_value(positions_z[0]);
+		for (unsigned int i = 1; i < positions_x.size(); ++i) {
+			x_range.add_point(positions_x[i]);
+			y_range.add_point(positions_y[i]);
+			z_range.add_point(positions_z[i]);
+		}
+
+		QueryInputs<math::Interval> range_inputs(
+				*runtime_ptr, x_range, y_range, z_range, math::Interval::from_single_value(0.f)
+		);
+		runtime.analyze_range(state, range_inputs.get());
+		runtime.generate_optimized_execution_map(
+				state, cache.optimized_execution_map, to_span(required_outputs), false
 		);
+		execution_map = &cache.optimized_execution_map;
+	}
+
+	QueryInputs<Span<const float>> inputs(*runtime_ptr, positions_x, positions_y, positions_z, in_sdf);
+	runtime.generate_set(state, inputs.get(), false, execution_map);
+	// Note, when generating SDF, we don't scale it because the return values are uncompressed floats. Scale only
+	// matters if we are storing it inside 16-bit or 8-bit VoxelBuffer.
+
+	for (const SeriesOutput &output : outputs) {
+		unsigned int output_index = 0;
+		int buffer_index = -1;
+		if (find_output(output, output_index, buffer_index)) {
+			const pg::Runtime::Buffer &buffer = state.get_buffer(buffer_index);
+			Span<float> values = output.values;
+			memcpy(values.data(), buffer.data, sizeof(float) * values.size());
+		}
 	}
 
-	const pg::Runtime::Buffer &buffer = get_tls_cache().state.get_buffer(buffer_index);
-	memcpy(out_values.data(), buffer.data, sizeof(float) * out_values.size());
+	if (profile_nodes) {
+		add_node_profiling_sample(*runtime_ptr, state);
+	}
 }
 
 const pg::Runtime::State &VoxelGeneratorGraph::get_last_state_from_current_thread() {
-	return get_tls_cache().state;
+	const Cache &cache = get_tls_cache();
+	if (cache.last_state == nullptr) {
+		// No query was made on this thread yet
+		static const pg::Runtime::State s_empty_state;
+		return s_empty_state;
+	}
+	return *cache.last_state;
 }
 
 Span<const uint32_t> VoxelGeneratorGraph::get_last_execution_map_debug_from_current_thread() {
 	return to_span_const(get_tls_cache().optimized_execution_map.debug_nodes);
 }
 
+uint32_t VoxelGeneratorGraph::get_state_allocation_count_from_current_thread() {
+	return get_tls_cache().state_pool.get_allocation_count();
+}
+
 bool VoxelGeneratorGraph::try_get_output_port_address(ProgramGraph::PortLocation port, uint32_t &out_address) const {
 	RWLockRead rlock(_runtime_lock);
 	ERR_FAIL_COND_V(_runtime == nullptr, false);
@@ -1578,9 +1940,10 @@ void VoxelGeneratorGraph::bake_sphere_bumpmap(Ref<Image> im, float ref_radius, f
 		}
 	};
 
-	Cache &cache = get_tls_cache();
+	// Baking is a one-off operation with its own buffer sizes, so it doesn't use pooled states
+	pg::Runtime::State state;
 
-	ProcessChunk pc(cache.state, *runtime_ptr, ref_radius, sdf_min, sdf_max, **im);
+	ProcessChunk pc(state, *runtime_ptr, ref_radius, sdf_min, sdf_max, **im);
 	for_chunks_2d(im->get_width(), im->get_height(), 32, pc);
 }
 
@@ -1739,7 +2102,8 @@ void VoxelGeneratorGraph::bake_sphere_normalmap(Ref<Image> im, float ref_radius,
 		}
 	};
 
-	Cache &cache = get_tls_cache();
+	// Baking is a one-off operation with its own buffer sizes, so it doesn't use pooled states
+	pg::Runtime::State state;
 
 	// The default for strength is 1.f
 	const float e = 0.001f;
@@ -1751,7 +2115,7 @@ void VoxelGeneratorGraph::bake_sphere_normalmap(Ref<Image> im, float ref_radius,
 		}
 	}
 
-	ProcessChunk pc(cache.state, **im, *runtime_ptr, strength, ref_radius);
+	ProcessChunk pc(state, **im, *runtime_ptr, strength, ref_radius);
 	for_chunks_2d(im->get_width(), im->get_height(), 32, pc);
 }
 
@@ -1810,9 +2174,9 @@ VoxelSingleValue VoxelGeneratorGraph::generate_single(Vector3i position, unsigne
 
 			Cache &cache = get_tls_cache();
 			const pg::Runtime &runtime = runtime_info.runtime;
-			runtime.prepare_state(cache.state, 1, false);
-			runtime.generate_single(cache.state, inputs.get(), nullptr);
-			const pg::Runtime::Buffer &buffer = cache.state.get_buffer(buffer_index);
+			pg::Runtime::State &state = cache.get_state(runtime, 1, false);
+			runtime.generate_single(state, inputs.get(), nullptr);
+			const pg::Runtime::Buffer &buffer = state.get_buffer(buffer_index);
 			ERR_FAIL_COND_V(buffer.size == 0, 0.f);
 			ERR_FAIL_COND_V(buffer.data == nullptr, 0.f);
 			return buffer.data[0];
@@ -1908,10 +2272,10 @@ math::Interval VoxelGeneratorGraph::debug_analyze_range(
 	);
 
 	// Note, buffer size is irrelevant here, because range analysis doesn't use buffers
-	runtime.prepare_state(cache.state, 1, false);
-	runtime.analyze_range(cache.state, query_inputs.get());
+	pg::Runtime::State &state = cache.get_state(runtime, 1, false);
+	runtime.analyze_range(state, query_inputs.get());
 	if (optimize_execution_map) {
-		runtime.generate_optimized_execution_map(cache.state, cache.optimized_execution_map, true);
+		runtime.generate_optimized_execution_map(state, cache.optimized_execution_map, true);
 	}
 
 #if 0
@@ -1961,10 +2325,10 @@ math::Interval VoxelGeneratorGraph::debug_analyze_range(
 
 			QueryInputs inputs(*runtime_ptr, sx, sy, sz, ssdf);
 
-			runtime.prepare_state(cache.state, sx.size(), false);
-			runtime.generate_set(cache.state, inputs.get(), false, nullptr);
+			pg::Runtime::State &validation_state = cache.get_state(runtime, sx.size(), false);
+			runtime.generate_set(validation_state, inputs.get(), false, nullptr);
 
-			const pg::Runtime::State &state = get_last_state_from_current_thread();
+			const pg::Runtime::State &state = validation_state;
 
 			_main_function->get_graph().for_each_node_const([this, &state](const ProgramGraph::Node &node) {
 				for (uint32_t output_index = 0; output_index < node.outputs.size(); ++output_index) {
@@ -2014,7 +2378,7 @@ math::Interval VoxelGeneratorGraph::debug_analyze_range(
 
 	// TODO Change return value to allow checking other outputs
 	if (runtime_ptr->sdf_output_buffer_index != -1) {
-		return cache.state.get_range(runtime_ptr->sdf_output_buffer_index);
+		return state.get_range(runtime_ptr->sdf_output_buffer_index);
 	}
 	return math::Interval();
 }
@@ -2055,7 +2419,7 @@ float VoxelGeneratorGraph::debug_measure_microseconds_per_voxel(
 	Cache &cache = get_tls_cache();
 
 	if (singular) {
-		runtime.prepare_state(cache.state, 1, false);
+		pg::Runtime::State &state = cache.get_state(runtime, 1, false);
 
 		for (uint32_t i = 0; i < cube_count; ++i) {
 			profiling_clock.restart();
@@ -2064,7 +2428,7 @@ float VoxelGeneratorGraph::debug_measure_microseconds_per_voxel(
 				for (uint32_t y = 0; y < cube_size; ++y) {
 					for (uint32_t x = 0; x < cube_size; ++x) {
 						QueryInputs<float> inputs(*runtime_ptr, x, y, z, 0.f);
-						runtime.generate_single(cache.state, inputs.get(), nullptr);
+						runtime.generate_single(state, inputs.get(), nullptr);
 					}
 				}
 			}
@@ -2090,13 +2454,13 @@ float VoxelGeneratorGraph::debug_measure_microseconds_per_voxel(
 		QueryInputs inputs(*runtime_ptr, sx, sy, sz, ssdf);
 
 		const bool per_node_profiling = node_profiling_info != nullptr;
-		runtime.prepare_state(cache.state, sx.size(), per_node_profiling);
+		pg::Runtime::State &state = cache.get_state(runtime, sx.size(), per_node_profiling);
 
 		for (uint32_t i = 0; i < cube_count; ++i) {
 			profiling_clock.restart();
 
 			for (uint32_t y = 0; y < cube_size; ++y) {
-				runtime.generate_set(cache.state, inputs.get(), false, nullptr);
+				runtime.generate_set(state, inputs.get(), false, nullptr);
 			}
 
 			total_elapsed_us += profiling_clock.restart();
@@ -2108,7 +2472,7 @@ float VoxelGeneratorGraph::debug_measure_microseconds_per_voxel(
 			for (unsigned int i = 0; i < node_profiling_info->size(); ++i) {
 				NodeProfilingInfo &info = (*node_profiling_info)[i];
 				info.node_id = execution_map.debug_nodes[i];
-				info.microseconds = cache.state.get_execution_time(i);
+				info.microseconds = state.get_execution_time(execution_map.operations[i].address) / 1000;
 			}
 		}
 	}
@@ -2244,6 +2608,18 @@ float VoxelGeneratorGraph::_b_debug_measure_microseconds_per_voxel(bool singular
 	return debug_measure_microseconds_per_voxel(singular, nullptr);
 }
 
+Dictionary VoxelGeneratorGraph::_b_get_node_profiling_data() const {
+	StdVector<NodeProfilingInfo> infos;
+	get_node_profiling_info(infos);
+	Dictionary d;
+	for (const NodeProfilingInfo &info : infos) {
+		// Nodes compiled into multiple operations get the sum of their times
+		const int64_t previous_us = d.get(info.node_id, 0);
+		d[info.node_id] = previous_us + static_cast<int64_t>(info.microseconds);
+	}
+	return d;
+}
+
 void VoxelGeneratorGraph::_on_subresource_changed() {
 	emit_changed();
 }
@@ -2286,6 +2662,18 @@ void VoxelGeneratorGraph::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_use_xz_caching", "enabled"), &Self::set_use_xz_caching);
 	ClassDB::bind_method(D_METHOD("is_using_xz_caching"), &Self::is_using_xz_caching);
 
+	ClassDB::bind_method(D_METHOD("set_use_xz_column_cache", "enabled"), &Self::set_use_xz_column_cache);
+	ClassDB::bind_method(D_METHOD("is_using_xz_column_cache"), &Self::is_using_xz_column_cache);
+
+	ClassDB::bind_method(D_METHOD("set_xz_column_cache_capacity", "capacity"), &Self::set_xz_column_cache_capacity);
+	ClassDB::bind_method(D_METHOD("get_xz_column_cache_capacity"), &Self::get_xz_column_cache_capacity);
+
+	ClassDB::bind_method(D_METHOD("set_node_profiling_enabled", "enabled"), &Self::set_node_profiling_enabled);
+	ClassDB::bind_method(D_METHOD("is_node_profiling_enabled"), &Self::is_node_profiling_enabled);
+
+	ClassDB::bind_method(D_METHOD("get_node_profiling_data"), &Self::_b_get_node_profiling_data);
+	ClassDB::bind_method(D_METHOD("clear_node_profiling_data"), &Self::clear_node_profiling_info);
+
 	ClassDB::bind_method(D_METHOD("set_texture_mode", "mode"), &Self::set_texture_mode);
 	ClassDB::bind_method(D_METHOD("get_texture_mode"), &Self::get_texture_mode);
 
@@ -2346,9 +2734,22 @@ void VoxelGeneratorGraph::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_subdivision"), "set_use_subdivision", "is_using_subdivision");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "subdivision_size"), "set_subdivision_size", "get_subdivision_size");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_xz_caching"), "set_use_xz_caching", "is_using_xz_caching");
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "use_xz_column_cache"), "set_use_xz_column_cache", "is_using_xz_column_cache"
+	);
+	ADD_PROPERTY(
+			PropertyInfo(Variant::INT, "xz_column_cache_capacity", PROPERTY_HINT_RANGE, "0,65536,1"),
+			"set_xz_column_cache_capacity",
+			"get_xz_column_cache_capacity"
+	);
 	ADD_PROPERTY(
 			PropertyInfo(Variant::BOOL, "debug_block_clipping"), "set_debug_clipped_blocks", "is_debug_clipped_blocks"
 	);
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "node_profiling_enabled"),
+			"set_node_profiling_enabled",
+			"is_node_profiling_enabled"
+	);
 
 	ADD_SIGNAL(MethodInfo(SIGNAL_NODE_NAME_CHANGED, PropertyInfo(Variant::INT, "node_id")));
 
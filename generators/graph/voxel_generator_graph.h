@@ -15,6 +15,7 @@
 #include "program_graph.h"
 #include "voxel_graph_function.h"
 #include "voxel_graph_runtime.h"
+#include "xz_cache.h"
 
 #include <memory>
 
@@ -67,6 +68,12 @@ public:
 	void set_use_xz_caching(bool enabled);
 	bool is_using_xz_caching() const;
 
+	void set_use_xz_column_cache(bool enabled);
+	bool is_using_xz_column_cache() const;
+
+	void set_xz_column_cache_capacity(int capacity);
+	int get_xz_column_cache_capacity() const;
+
 	void set_texture_mode(const TextureMode mode);
 	TextureMode get_texture_mode() const;
 
@@ -95,6 +102,13 @@ public:
 			Vector3f max_pos
 	) override;
 
+	void generate_series_batch(
+			Span<const Vector3f> positions,
+			Span<const SeriesOutput> outputs,
+			Vector3f min_pos,
+			Vector3f max_pos
+	) override;
+
 	// Ref<Resource> duplicate(bool p_subresources) const ZN_OVERRIDE_UNLESS_GODOT_EXTENSION;
 
 	// Utility
@@ -119,6 +133,10 @@ public:
 	static const pg::Runtime::State &get_last_state_from_current_thread();
 	static Span<const uint32_t> get_last_execution_map_debug_from_current_thread();
 
+	// How many times graph states of the current thread had to allocate memory. Used to check that generation reaches
+	// a steady state where it no longer allocates.
+	static uint32_t get_state_allocation_count_from_current_thread();
+
 	bool try_get_output_port_address(ProgramGraph::PortLocation port, uint32_t &out_address) const;
 	int get_sdf_output_port_address() const;
 
@@ -139,11 +157,21 @@ public:
 
 	struct NodeProfilingInfo {
 		uint32_t node_id;
-		uint32_t microseconds;
+		uint64_t microseconds;
 	};
 
 	float debug_measure_microseconds_per_voxel(bool singular, StdVector<NodeProfilingInfo> *node_profiling_info);
 
+	// When enabled, a fraction of generation queries running on any thread measure how long each node takes, so the
+	// most expensive nodes can be found with real workloads.
+	void set_node_profiling_enabled(bool enabled);
+	bool is_node_profiling_enabled() const;
+
+	// Gets time accumulated in each node by queries measured since node profiling was enabled or cleared.
+	// A node can appear more than once if it compiled into multiple operations.
+	void get_node_profiling_info(StdVector<NodeProfilingInfo> &out_info) const;
+	void clear_node_profiling_info();
+
 	void debug_load_waves_preset();
 
 	// Editor
@@ -158,6 +186,7 @@ private:
 	Vector2 _b_debug_analyze_range(Vector3 min_pos, Vector3 max_pos) const;
 	Dictionary _b_compile();
 	float _b_debug_measure_microseconds_per_voxel(bool singular);
+	Dictionary _b_get_node_profiling_data() const;
 #ifdef TOOLS_ENABLED
 	// This exists because some custom editors will edit an internal object instead of the resource itself
 	// (here the "main function" object). And because Godot determines wether or not a resource should be saved based on
@@ -168,6 +197,13 @@ private:
 	Dictionary get_graph_as_variant_data() const;
 	void load_graph_from_variant_data(Dictionary data);
 
+	void generate_series_internal(
+			Span<const float> positions_x,
+			Span<const float> positions_y,
+			Span<const float> positions_z,
+			Span<const SeriesOutput> outputs
+	);
+
 	struct WeightOutput {
 		unsigned int layer_index;
 		unsigned int output_buffer_index;
@@ -206,6 +242,12 @@ private:
 	// This prevents recalculating values that would otherwise be the same on each slice.
 	// It helps a lot when part of the graph is generating a heightmap for example.
 	bool _use_xz_caching = true;
+	// When enabled, results of nodes using only the X and Z coordinates are also shared between blocks of the same
+	// column (same XZ area and LOD), so they are only calculated once when generating blocks stacked vertically.
+	// Requires `_use_xz_caching`.
+	bool _use_xz_column_cache = false;
+	// When enabled, some queries measure execution time of each node. See `NODE_PROFILING_SAMPLE_INTERVAL`.
+	bool _node_profiling_enabled = false;
 	// If true, inverts clipped blocks so they create visual artifacts making the clipped area visible.
 	bool _debug_clipped_blocks = false;
 	TextureMode _texture_mode = TEXTURE_MODE_MIXEL4;
@@ -239,8 +281,18 @@ private:
 		// List of indices to feed queries. The order doesn't matter, can be different from `weight_outputs`.
 		FixedArray<unsigned int, 16> weight_output_indices;
 		unsigned int weight_outputs_count = 0;
+
+		pg::CompilationResult compilation_result;
+		// Copy of the graph this was compiled from, to check matches when sharing runtimes between generators
+		ProgramGraph source_graph;
 	};
 
+	// Runtimes are shared between live generators having identical graphs, so loading the same graph many times in
+	// one process (for example one terrain per world on a server) only compiles it once. Nothing is persisted: compiled
+	// programs are not saved into the resource, so the first load of a graph in a process still compiles it.
+	struct SharedRuntimeCache;
+	static SharedRuntimeCache &get_shared_runtime_cache();
+
 	// Helper to setup inputs for runtime queries
 	template <typename T>
 	struct QueryInputs {
@@ -271,6 +323,25 @@ private:
 	std::shared_ptr<Runtime> _runtime = nullptr;
 	RWLock _runtime_lock;
 
+	// Shared by all threads generating with this graph. Entries are specific to the compiled program.
+	pg::XZCache _xz_column_cache;
+
+	// Only one query out of this amount is measured on each thread, to keep the overhead of node profiling low
+	static const uint32_t NODE_PROFILING_SAMPLE_INTERVAL = 8;
+
+	// Execution times gathered from all threads when node profiling is enabled
+	struct NodeProfiler {
+		// Program the times were measured with. Times are reset if it changes.
+		uint64_t program_id = 0;
+		// Indexed like operations of the default execution map, in nanoseconds
+		StdVector<uint64_t> times;
+		// Node of the user-facing graph each operation comes from
+		StdVector<uint32_t> node_ids;
+	};
+
+	NodeProfiler _node_profiler;
+	mutable Mutex _node_profiler_mutex;
+
 	struct Cache {
 		StdVector<float> x_cache;
 		StdVector<float> y_cache;
@@ -278,11 +349,27 @@ private:
 		StdVector<float> input_sdf_slice_cache;
 		StdVector<float> input_sdf_full_cache;
 		// TODO Use the runtime and state from `VoxelGraphFunction`
-		pg::Runtime::State state;
+		// States are pooled so alternating between generators or query sizes on the same thread doesn't re-allocate.
+		pg::StatePool state_pool;
+		// State used by the last query. Kept for debugging and for getting results out of `generate_set`.
+		pg::Runtime::State *last_state = nullptr;
 		pg::Runtime::ExecutionMap optimized_execution_map;
+		// Buffers to save or restore when using the XZ column cache
+		StdVector<float *> xz_column_cache_buffers;
+		// Counts queries to choose which ones are measured by node profiling
+		uint32_t node_profiling_counter = 0;
+
+		inline pg::Runtime::State &get_state(const pg::Runtime &runtime, unsigned int buffer_size, bool profiling) {
+			last_state = &state_pool.get_state(runtime, buffer_size, profiling);
+			return *last_state;
+		}
 	};
 
 	static Cache &get_tls_cache();
+
+	// Tells if the next query on the current thread should measure node execution times
+	bool sample_node_profiling(Cache &cache) const;
+	void add_node_profiling_sample(const Runtime &runtime_wrapper, const pg::Runtime::State &state);
 };
 
 } // namespace zylann::voxel
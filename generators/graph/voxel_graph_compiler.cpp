@@ -10,6 +10,7 @@
 #include "node_type_db.h"
 #include "voxel_graph_function.h"
 
+#include <atomic>
 #include <limits>
 
 namespace zylann::voxel::pg {
@@ -1651,6 +1652,10 @@ CompilationResult Runtime::compile_preprocessed_graph(
 		node_id_to_dependency_graph.insert(std::make_pair(node_id, dg_node_index));
 	}
 
+	// The first node of the inner group is not necessarily an operation (it can be an input or a constant), so we
+	// can't rely on finding it exactly when adding operations to the default execution map
+	bool default_inner_group_start_assigned = false;
+
 	// Run through each node in order, and turn them into program instructions
 	for (size_t order_index = 0; order_index < order.size(); ++order_index) {
 		const uint32_t node_id = order[order_index];
@@ -1729,8 +1734,9 @@ CompilationResult Runtime::compile_preprocessed_graph(
 
 		ZN_ASSERT(node.type_id <= std::numeric_limits<uint16_t>::max());
 
-		if (order_index == inner_group_start_index) {
+		if (!default_inner_group_start_assigned && order_index >= inner_group_start_index) {
 			program.default_execution_map.inner_group_start_index = program.default_execution_map.operations.size();
+			default_inner_group_start_assigned = true;
 		}
 		program.default_execution_map.operations.push_back(
 				ExecutionMap::OperationInfo{ uint16_t(operations.size()), 0 }
@@ -1872,6 +1878,14 @@ CompilationResult Runtime::compile_preprocessed_graph(
 #endif
 	}
 
+	if (!default_inner_group_start_assigned) {
+		// Every operation is in the outer group
+		program.default_execution_map.inner_group_start_index = program.default_execution_map.operations.size();
+	}
+	if (inner_group_start_index == order.size()) {
+		program.inner_group_start_op_index = operations.size();
+	}
+
 	program.buffer_count = mem.next_address;
 
 	// Pin buffers from the outer group that are read by operations of the inner group.
@@ -1909,6 +1923,32 @@ CompilationResult Runtime::compile_preprocessed_graph(
 				ZN_ASSERT(address_it != program.output_port_addresses.end());
 				BufferSpec &src_buffer_spec = buffer_specs[address_it->second];
 				src_buffer_spec.is_pinned = true;
+
+				if (!contains(to_span_const(program.outer_group_output_addresses), address_it->second)) {
+					program.outer_group_output_addresses.push_back(address_it->second);
+				}
+			}
+		}
+
+		// Output nodes can also be part of the outer group (for example if a branch only depends on X and Z). Their
+		// results are needed too if the outer group gets skipped. Their buffers are never re-used, so they don't
+		// need pinning.
+		for (unsigned int order_index = 0; order_index < inner_group_start_index; ++order_index) {
+			const uint32_t node_id = order[order_index];
+			const ProgramGraph::Node &node = graph.get_node(node_id);
+			const NodeType &type = type_db.get_type(node.type_id);
+			if (type.category != pg::CATEGORY_OUTPUT) {
+				continue;
+			}
+			for (uint32_t output_index = 0; output_index < node.outputs.size(); ++output_index) {
+				const ProgramGraph::PortLocation port{ node_id, output_index };
+				auto address_it = program.output_port_addresses.find(port);
+				if (address_it == program.output_port_addresses.end()) {
+					continue;
+				}
+				if (!contains(to_span_const(program.outer_group_output_addresses), address_it->second)) {
+					program.outer_group_output_addresses.push_back(address_it->second);
+				}
 			}
 		}
 	}
@@ -2044,6 +2084,13 @@ CompilationResult Runtime::compile_preprocessed_graph(
 		program.buffer_data_count = data_helper.datas.size();
 	}
 
+	// Only keep outer group outputs that actually hold data. Bindings are provided by the user, and constants are
+	// filled when preparing states.
+	unordered_remove_if(program.outer_group_output_addresses, [&program](uint16_t address) {
+		const BufferSpec &bs = program.buffer_specs[address];
+		return bs.is_binding || bs.is_constant || !bs.has_data;
+	});
+
 	ZN_PRINT_VERBOSE(
 			format("Compiled voxel graph. Program size: {}b, ports: {}, buffers: {}",
 				   program.operations.size() * sizeof(uint16_t),
@@ -2051,6 +2098,10 @@ CompilationResult Runtime::compile_preprocessed_graph(
 				   program.buffer_data_count)
 	);
 
+	// Starts at 1 so 0 can mean "no program"
+	static std::atomic_uint64_t g_next_program_id(1);
+	program.id = g_next_program_id++;
+
 	CompilationResult result;
 	result.success = true;
 	return result;
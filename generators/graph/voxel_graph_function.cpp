@@ -789,18 +789,6 @@ unsigned int VoxelGraphFunction::get_nodes_count() const {
 	return _graph.get_nodes_count();
 }
 
-#ifdef TOOLS_ENABLED
-
-void VoxelGraphFunction::get_configuration_warnings(PackedStringArray &out_warnings) const {
-	if (_last_compiling_result.success == false) {
-		if (_last_compiling_result.message.is_empty()) {
-			out_warnings.append("The graph isn't compiled.");
-		} else {
-			out_warnings.append(String("Compiling failed: {0}").format(_last_compiling_result.message));
-		}
-	}
-}
-
 uint64_t VoxelGraphFunction::get_output_graph_hash() const {
 	const NodeTypeDB &type_db = NodeTypeDB::get_singleton();
 	StdVector<uint32_t> terminal_nodes;
@@ -853,6 +841,18 @@ uint64_t VoxelGraphFunction::get_output_graph_hash() const {
 	return hash;
 }
 
+#ifdef TOOLS_ENABLED
+
+void VoxelGraphFunction::get_configuration_warnings(PackedStringArray &out_warnings) const {
+	if (_last_compiling_result.success == false) {
+		if (_last_compiling_result.message.is_empty()) {
+			out_warnings.append("The graph isn't compiled.");
+		} else {
+			out_warnings.append(String("Compiling failed: {0}").format(_last_compiling_result.message));
+		}
+	}
+}
+
 #endif
 
 void VoxelGraphFunction::find_dependencies(uint32_t node_id, StdVector<uint32_t> &out_dependencies) const {
@@ -1558,7 +1558,11 @@ CompilationResult VoxelGraphFunction::expand_and_reduce() {
 	return result;
 }
 
-bool VoxelGraphFunction::equals(const VoxelGraphFunction &other) {
+bool VoxelGraphFunction::equals(const VoxelGraphFunction &other) const {
+	return equals(other._graph);
+}
+
+bool VoxelGraphFunction::equals(const ProgramGraph &other_graph, const bool objects_by_instance) const {
 	StdVector<Port> src_output_defs;
 	StdVector<uint32_t> src_output_ids;
 
@@ -1566,7 +1570,7 @@ bool VoxelGraphFunction::equals(const VoxelGraphFunction &other) {
 	StdVector<uint32_t> dst_output_ids;
 
 	auto_pick_outputs(_graph, src_output_defs, src_output_ids);
-	auto_pick_outputs(other._graph, dst_output_defs, dst_output_ids);
+	auto_pick_outputs(other_graph, dst_output_defs, dst_output_ids);
 
 	ZN_ASSERT_RETURN_V(src_output_defs.size() == src_output_ids.size(), false);
 	ZN_ASSERT_RETURN_V(dst_output_defs.size() == dst_output_ids.size(), false);
@@ -1596,7 +1600,7 @@ bool VoxelGraphFunction::equals(const VoxelGraphFunction &other) {
 		const uint32_t src_node_id = src_output_ids[i];
 		const uint32_t dst_node_id = dst_output_ids[i];
 
-		if (!_graph.branch_equals(src_node_id, other._graph, dst_node_id)) {
+		if (!_graph.branch_equals(src_node_id, other_graph, dst_node_id, objects_by_instance)) {
 			return false;
 		}
 	}
@@ -214,16 +214,17 @@ public:
 
 	unsigned int get_nodes_count() const;
 
-	// Editor
-
-#ifdef TOOLS_ENABLED
-	void get_configuration_warnings(PackedStringArray &out_warnings) const;
-
 	// Gets a hash that attempts to only change if the output of the graph is different.
 	// This is computed from the editable graph data, not the compiled result.
 	// Note: this is not guaranteed to work when comparing two graphs. This was designed initially to detect changes.
+	// Use `equals` to confirm two graphs are the same.
 	uint64_t get_output_graph_hash() const;
 
+	// Editor
+
+#ifdef TOOLS_ENABLED
+	void get_configuration_warnings(PackedStringArray &out_warnings) const;
+
 	bool can_load_default_graph() const {
 		return _can_load_default_graph;
 	}
@@ -326,8 +327,10 @@ public:
 	CompilationResult expand_and_reduce();
 
 	// Tests if two graphs are the same, considering their output branches. Object parameters are first compared by
-	// reference, and then compared by their properties. Nodes that the outputs don't depend on will be ignored.
-	bool equals(const VoxelGraphFunction &other);
+	// reference, and then compared by their properties, unless `objects_by_instance` is true. Nodes that the outputs
+	// don't depend on will be ignored.
+	bool equals(const VoxelGraphFunction &other) const;
+	bool equals(const ProgramGraph &other_graph, const bool objects_by_instance = false) const;
 
 	void debug_analyze_range(Span<const math::Interval> input_ranges, const bool optimize_execution_map);
 
@@ -274,37 +274,55 @@ void Runtime::generate_single(State &state, Span<const float> inputs, const Exec
 }
 
 void Runtime::prepare_state(State &state, unsigned int buffer_size, bool with_profiling) const {
+	if (_program.id != 0 && state.prepared_program_id == _program.id && state.buffer_size == buffer_size) {
+		// Already prepared for the same program and size. Buffer datas and constants are still valid, only the
+		// transient parts of the state need to be reset.
+		for (const BufferSpec &buffer_spec : _program.buffer_specs) {
+			Buffer &buffer = state.buffers[buffer_spec.address];
+			if (buffer.is_binding) {
+#if DEBUG_ENABLED
+				// Forgot to unbind?
+				ZN_ASSERT(buffer.data == nullptr);
+#endif
+				buffer.size = buffer_size;
+			}
+		}
+		prepare_state_profiling(state, with_profiling);
+		return;
+	}
+
 	// Allocate memory
 
-	const unsigned int old_buffer_data_count = state.buffer_datas.size();
+	const size_t required_arena_size = size_t(_program.buffer_data_count) * buffer_size;
+	if (state.arena_capacity < required_arena_size) {
+		// Contents don't need to be preserved, they are re-initialized below or written by the program.
+		if (state.arena != nullptr) {
+			ZN_FREE(state.arena);
+		}
+		state.arena = reinterpret_cast<float *>(ZN_ALLOC(required_arena_size * sizeof(float)));
+		state.arena_capacity = required_arena_size;
+		++state.allocation_count;
+	}
+
+	if (state.buffer_datas.capacity() < _program.buffer_data_count ||
+		state.buffers.capacity() < _program.buffer_count) {
+		++state.allocation_count;
+	}
+
 	if (state.buffer_datas.size() < _program.buffer_data_count) {
-		// Create more buffer datas.
 		state.buffer_datas.resize(_program.buffer_data_count);
-		for (unsigned int i = old_buffer_data_count; i < state.buffer_datas.size(); ++i) {
-			BufferData &bd = state.buffer_datas[i];
-			ZN_ASSERT(bd.data == nullptr);
-			// These are new items, we always allocate.
-			bd.data = reinterpret_cast<float *>(ZN_ALLOC(buffer_size * sizeof(float)));
-			bd.capacity = buffer_size;
-		}
 	}
 
-	if (state.buffer_size < buffer_size) {
-		// Make existing buffer datas larger.
-		for (unsigned int i = 0; i < old_buffer_data_count; ++i) {
-			BufferData &bd = state.buffer_datas[i];
-			ZN_ASSERT(bd.data != nullptr);
-			if (bd.capacity < buffer_size) {
-				// These are existing items, we always realloc.
-				bd.data = reinterpret_cast<float *>(ZN_REALLOC(bd.data, buffer_size * sizeof(float)));
-				bd.capacity = buffer_size;
-			}
-		}
-		// TODO Not sure if worth keeping capacity at state level. Buffer datas can have varying capacities depending on
-		// which multiple graphs were prepared before.
-		state.buffer_capacity = buffer_size;
+	for (unsigned int i = 0; i < _program.buffer_data_count; ++i) {
+		BufferData &bd = state.buffer_datas[i];
+		bd.data = state.arena + size_t(i) * buffer_size;
+		bd.capacity = buffer_size;
 	}
 
+	// TODO Not sure if worth keeping capacity at state level. Buffer datas can have varying capacities depending on
+	// which multiple graphs were prepared before.
+	state.buffer_capacity = buffer_size;
+
 	// Initialize buffers
 
 #if DEBUG_ENABLED
@@ -383,11 +401,85 @@ void Runtime::prepare_state(State &state, unsigned int buffer_size, bool with_pr
 		}
 	}*/
 
-	state.debug_profiler_times.clear();
+	prepare_state_profiling(state, with_profiling);
+
+	state.prepared_program_id = _program.id;
+}
+
+void Runtime::prepare_state_profiling(State &state, bool with_profiling) const {
+	state.profiling = with_profiling;
 	if (with_profiling) {
-		// Give maximum size
-		state.debug_profiler_times.resize(_program.dependency_graph.nodes.size());
+		// Memory is kept when profiling is turned off, so sampling only some queries doesn't re-allocate
+		state.profiler_times.resize(_program.operations.size());
+		for (uint64_t &t : state.profiler_times) {
+			t = 0;
+		}
+	}
+}
+
+uint32_t Runtime::get_operation_node_id(uint16_t op_address) const {
+	// Nodes that don't produce operations (like constants) can share the address of the next operation, so the last
+	// node with that address is the one that produced it
+	for (auto it = _program.dependency_graph.nodes.rbegin(); it != _program.dependency_graph.nodes.rend(); ++it) {
+		const DependencyGraph::Node &node = *it;
+		if (node.is_input || node.op_address != op_address) {
+			continue;
+		}
+		auto remap_it = _program.expanded_node_id_to_user_node_id.find(node.debug_node_id);
+		if (remap_it != _program.expanded_node_id_to_user_node_id.end()) {
+			return remap_it->second;
+		}
+		return node.debug_node_id;
+	}
+	return ProgramGraph::NULL_ID;
+}
+
+Runtime::State &StatePool::get_state(const Runtime &runtime, unsigned int buffer_size, bool with_profiling) {
+	++_use_counter;
+
+	const uint64_t program_id = runtime.get_program_id();
+
+	// Prefer a state that was already prepared with the same program and size, otherwise recycle the least recently
+	// used one. Recycled states keep their memory, so they only allocate if they have to grow.
+	unsigned int selected_index = 0;
+	bool found = false;
+	for (unsigned int i = 0; i < _entries.size(); ++i) {
+		const Entry &entry = _entries[i];
+		if (entry.state.get_prepared_program_id() == program_id && entry.state.get_buffer_size() == buffer_size) {
+			selected_index = i;
+			found = true;
+			break;
+		}
+	}
+	if (!found) {
+		for (unsigned int i = 1; i < _entries.size(); ++i) {
+			if (_entries[i].last_use < _entries[selected_index].last_use) {
+				selected_index = i;
+			}
+		}
+	}
+
+	Entry &entry = _entries[selected_index];
+	entry.last_use = _use_counter;
+	runtime.prepare_state(entry.state, buffer_size, with_profiling);
+	return entry.state;
+}
+
+uint32_t StatePool::get_allocation_count() const {
+	uint32_t count = 0;
+	for (unsigned int i = 0; i < _entries.size(); ++i) {
+		count += _entries[i].state.get_allocation_count();
 	}
+	return count;
+}
+
+void StatePool::clear() {
+	for (unsigned int i = 0; i < _entries.size(); ++i) {
+		Entry &entry = _entries[i];
+		entry.state.clear();
+		entry.last_use = 0;
+	}
+	_use_counter = 0;
 }
 
 void Runtime::generate_set(
@@ -395,6 +487,45 @@ void Runtime::generate_set(
 		Span<const Span<const float>> p_inputs,
 		bool skip_outer_group,
 		const ExecutionMap *p_execution_map
+) const {
+	ZN_PROFILE_SCOPE();
+
+	const ExecutionMap &execution_map = p_execution_map != nullptr ? *p_execution_map : _program.default_execution_map;
+	Span<const ExecutionMap::OperationInfo> operation_infos = to_span(execution_map.operations);
+	unsigned int first_constant_fill_index = 0;
+
+	if (skip_outer_group && operation_infos.size() > 0) {
+		const unsigned int offset = execution_map.inner_group_start_index;
+		// Constant fills of skipped operations must be skipped too, otherwise the remaining operations would consume
+		// fills that were meant for the outer group
+		for (unsigned int i = 0; i < offset; ++i) {
+			first_constant_fill_index += operation_infos[i].constant_fill_count;
+		}
+		operation_infos = operation_infos.sub(offset);
+	}
+
+	generate_set_internal(
+			state, p_inputs, operation_infos, execution_map, first_constant_fill_index, p_execution_map != nullptr
+	);
+}
+
+void Runtime::generate_outer_group(State &state, Span<const Span<const float>> p_inputs) const {
+	ZN_PROFILE_SCOPE();
+
+	const ExecutionMap &execution_map = _program.default_execution_map;
+	const Span<const ExecutionMap::OperationInfo> operation_infos =
+			to_span(execution_map.operations).sub(0, execution_map.inner_group_start_index);
+
+	generate_set_internal(state, p_inputs, operation_infos, execution_map, 0, false);
+}
+
+void Runtime::generate_set_internal(
+		State &state,
+		Span<const Span<const float>> p_inputs,
+		Span<const ExecutionMap::OperationInfo> operation_infos,
+		const ExecutionMap &execution_map,
+		unsigned int first_constant_fill_index,
+		bool using_execution_map
 ) const {
 	// I don't like putting private helper functions in headers.
 	struct L {
@@ -414,8 +545,6 @@ void Runtime::generate_set(
 		}
 	};
 
-	ZN_PROFILE_SCOPE();
-
 	ZN_ASSERT_RETURN(p_inputs.size() == _program.inputs.size());
 
 #ifdef DEBUG_ENABLED
@@ -455,25 +584,11 @@ void Runtime::generate_set(
 
 	const Span<const uint16_t> operations(_program.operations.data(), 0, _program.operations.size());
 
-	const ExecutionMap &execution_map = p_execution_map != nullptr ? *p_execution_map : _program.default_execution_map;
-	Span<const ExecutionMap::OperationInfo> operation_infos = to_span(execution_map.operations);
 	const Span<const ExecutionMap::ConstantFill> constant_fills = to_span(execution_map.constant_fills);
 
-	if (skip_outer_group && operation_infos.size() > 0) {
-		const unsigned int offset = execution_map.inner_group_start_index;
-		operation_infos = operation_infos.sub(offset);
-	}
-
-#ifdef TOOLS_ENABLED
-	ProfilingClock profiling_clock;
-	const bool profile = state.debug_profiler_times.size() > 0;
-#endif
-
-	unsigned int constant_fill_index = 0;
-
-	for (unsigned int execution_map_index = 0; execution_map_index < operation_infos.size(); ++execution_map_index) {
-		const ExecutionMap::OperationInfo op_info = operation_infos[execution_map_index];
+	unsigned int constant_fill_index = first_constant_fill_index;
 
+	auto run_operation = [&](const ExecutionMap::OperationInfo op_info) {
 		for (unsigned int i = 0; i < op_info.constant_fill_count; ++i) {
 			const ExecutionMap::ConstantFill &cf = constant_fills[constant_fill_index];
 			ZN_ASSERT(cf.data != nullptr);
@@ -499,17 +614,27 @@ void Runtime::generate_set(
 		Span<const uint8_t> op_params = read_params(operations, pc);
 
 		// TODO Buffers will stay bound if this error occurs!
-		ZN_ASSERT_RETURN(node_type.process_buffer_func != nullptr);
-		ProcessBufferContext ctx(op_inputs, op_outputs, op_params, buffers, p_execution_map != nullptr);
+		ZN_ASSERT_RETURN_V(node_type.process_buffer_func != nullptr, false);
+		ProcessBufferContext ctx(op_inputs, op_outputs, op_params, buffers, using_execution_map);
 		node_type.process_buffer_func(ctx);
+		return true;
+	};
 
-#ifdef TOOLS_ENABLED
-		if (profile) {
-			const uint32_t elapsed_microseconds = profiling_clock.get_elapsed_microseconds();
-			state.add_execution_time(execution_map_index, elapsed_microseconds);
-			profiling_clock.restart();
+	// The clock is only created when profiling, so regular runs don't pay for reading the time
+	if (state.profiling) {
+		ProfilingClockNs profiling_clock;
+		for (const ExecutionMap::OperationInfo op_info : operation_infos) {
+			if (!run_operation(op_info)) {
+				return;
+			}
+			state.add_execution_time(op_info.address, profiling_clock.restart());
+		}
+	} else {
+		for (const ExecutionMap::OperationInfo op_info : operation_infos) {
+			if (!run_operation(op_info)) {
+				return;
+			}
 		}
-#endif
 	}
 
 	// Unbind buffers
@@ -9,6 +9,7 @@
 #include "../../util/math/interval.h"
 #include "../../util/math/vector3f.h"
 #include "../../util/math/vector3i.h"
+#include "../../util/memory/memory.h"
 #include "program_graph.h"
 
 namespace zylann::voxel::pg {
@@ -146,31 +147,50 @@ public:
 			return buffer_size;
 		}
 
+		// Identifies the program this state was last prepared with. 0 means it was never prepared.
+		inline uint64_t get_prepared_program_id() const {
+			return prepared_program_id;
+		}
+
+		// How many times this state had to allocate or grow its memory. Once a state has been used with the largest
+		// program and buffer size it will see, this should no longer change.
+		inline uint32_t get_allocation_count() const {
+			return allocation_count;
+		}
+
 		void clear() {
 			buffer_size = 0;
-			// buffer_capacity = 0;
-			for (BufferData &bd : buffer_datas) {
-				ZN_ASSERT(bd.data != nullptr);
-				memfree(bd.data);
+			buffer_capacity = 0;
+			prepared_program_id = 0;
+			if (arena != nullptr) {
+				ZN_FREE(arena);
+				arena = nullptr;
 			}
+			arena_capacity = 0;
 			buffer_datas.clear();
 			buffers.clear();
 			ranges.clear();
-			debug_profiler_times.clear();
+			profiler_times.clear();
+			profiling = false;
 		}
 
-		inline void add_execution_time(uint32_t execution_map_index, uint32_t time) {
+		inline bool is_profiling() const {
+			return profiling;
+		}
+
+		inline void add_execution_time(uint16_t op_address, uint64_t nanoseconds) {
 #if DEBUG_ENABLED
-			CRASH_COND(execution_map_index >= debug_profiler_times.size());
+			CRASH_COND(op_address >= profiler_times.size());
 #endif
-			debug_profiler_times[execution_map_index] += time;
+			profiler_times[op_address] += nanoseconds;
 		}
 
-		inline uint32_t get_execution_time(uint32_t execution_map_index) const {
+		// Gets time spent running the operation at the given address since the state was prepared, in nanoseconds
+		inline uint64_t get_execution_time(uint16_t op_address) const {
 #if DEBUG_ENABLED
-			CRASH_COND(execution_map_index >= debug_profiler_times.size());
+			CRASH_COND(op_address >= profiler_times.size());
 #endif
-			return debug_profiler_times[execution_map_index];
+			return profiler_times[op_address];
 		}
 
 	private:
@@ -178,12 +198,22 @@ public:
 
 		StdVector<math::Interval> ranges;
 		StdVector<Buffer> buffers;
+		// Buffer datas all point into `arena`
 		StdVector<BufferData> buffer_datas;
-		// [execution_map_index] => microseconds
-		StdVector<uint32_t> debug_profiler_times;
+		// [operation address] => nanoseconds.
+		// Indexed by address so times are found the same way regardless of the execution map that was used.
+		StdVector<uint64_t> profiler_times;
+		bool profiling = false;
+
+		// Single allocation holding the data of all buffer datas, so preparing a state only grows one block of memory
+		// instead of one per buffer. Owned.
+		float *arena = nullptr;
+		size_t arena_capacity = 0;
 
 		unsigned int buffer_size = 0;
 		unsigned int buffer_capacity = 0;
+		uint64_t prepared_program_id = 0;
+		uint32_t allocation_count = 0;
 	};
 
 	struct InputInfo {
@@ -209,7 +239,9 @@ public:
 
 	// Call this before you use a state with generation functions.
 	// You need to call it once, until you want to use a different graph, buffer size or buffer count.
-	// If none of these change, you can keep re-using it.
+	// If none of these change, you can keep re-using it. Calling it again in that case is cheap and does not allocate.
+	// When `with_profiling` is true, execution times of each operation will be measured when generating sets, starting
+	// from zero.
 	void prepare_state(State &state, unsigned int buffer_size, bool with_profiling) const;
 
 	// Convenience for set generation with only one value
@@ -223,6 +255,21 @@ public:
 			const ExecutionMap *p_execution_map
 	) const;
 
+	// Runs only operations of the outer group (those only depending on inputs tagged as "outer group"), without
+	// execution map optimization. After this, buffers returned by `get_outer_group_output_addresses` contain the
+	// results needed to run the inner group with `skip_outer_group`.
+	void generate_outer_group(State &state, Span<const Span<const float>> p_inputs) const;
+
+	// Gets the ID of the node from the user-facing graph that produced the operation at the given address.
+	// Returns `ProgramGraph::NULL_ID` if not found.
+	uint32_t get_operation_node_id(uint16_t op_address) const;
+
+	// Buffers written by the outer group and read by the inner group. Their data is enough to run the inner group
+	// without running the outer group, so it can be saved and restored to re-use results across multiple queries.
+	inline Span<const uint16_t> get_outer_group_output_addresses() const {
+		return to_span(_program.outer_group_output_addresses);
+	}
+
 #ifdef DEBUG_ENABLED
 	void debug_print_operations();
 #endif
@@ -266,6 +313,12 @@ public:
 
 	uint64_t get_program_hash() const;
 
+	// Unique for every successful compilation, so states prepared with a previous program can be told apart even if
+	// the runtime got re-created at the same address. 0 if there is no valid program.
+	inline uint64_t get_program_id() const {
+		return _program.id;
+	}
+
 	static inline Span<const uint8_t> read_params(Span<const uint16_t> operations, unsigned int &pc) {
 		const uint16_t params_size_in_words = operations[pc];
 		++pc;
@@ -423,6 +476,17 @@ private:
 
 	bool is_operation_constant(const State &state, uint16_t op_address) const;
 
+	void prepare_state_profiling(State &state, bool with_profiling) const;
+
+	void generate_set_internal(
+			State &state,
+			Span<const Span<const float>> p_inputs,
+			Span<const ExecutionMap::OperationInfo> operation_infos,
+			const ExecutionMap &execution_map,
+			unsigned int first_constant_fill_index,
+			bool using_execution_map
+	) const;
+
 	struct BufferSpec {
 		// Index the buffer should be stored at
 		uint16_t address = 0;
@@ -512,6 +576,10 @@ private:
 		// cases.
 		uint32_t inner_group_start_op_index;
 
+		// Addresses of buffers written by the outer group and read by the inner group. Only contains buffers that own
+		// data (not bindings or constants).
+		StdVector<uint16_t> outer_group_output_addresses;
+
 		StdVector<InputInfo> inputs;
 
 		FixedArray<OutputInfo, MAX_OUTPUTS> outputs;
@@ -537,10 +605,15 @@ private:
 		// Result of the last compilation attempt. The program should not be run if it failed.
 		CompilationResult compilation_result;
 
+		// See `get_program_id`
+		uint64_t id = 0;
+
 		void clear() {
+			id = 0;
 			operations.clear();
 			buffer_specs.clear();
 			inner_group_start_op_index = 0;
+			outer_group_output_addresses.clear();
 			default_execution_map.clear();
 			output_port_addresses.clear();
 			user_port_to_expanded_port.clear();
@@ -562,6 +635,30 @@ private:
 	Program _program;
 };
 
+// Keeps a few prepared states around, so alternating between programs or buffer sizes on the same thread (for example
+// range analysis followed by block generation, or several generators sharing worker threads) does not re-prepare or
+// re-allocate them every time. Not thread-safe, meant to be used as thread-local storage.
+class StatePool {
+public:
+	// Gets a state prepared for the given runtime and buffer size, preferably one that was already prepared for it.
+	Runtime::State &get_state(const Runtime &runtime, unsigned int buffer_size, bool with_profiling);
+
+	uint32_t get_allocation_count() const;
+
+	void clear();
+
+private:
+	static const unsigned int CAPACITY = 4;
+
+	struct Entry {
+		Runtime::State state;
+		uint32_t last_use = 0;
+	};
+
+	FixedArray<Entry, CAPACITY> _entries;
+	uint32_t _use_counter = 0;
+};
+
 } // namespace zylann::voxel::pg
 
 #endif // VOXEL_GRAPH_RUNTIME_H
@@ -0,0 +1,94 @@
+#include "xz_cache.h"
+#include "../../util/profiling.h"
+
+#include <cstring>
+
+namespace zylann::voxel::pg {
+
+bool XZCache::try_load(const Key &key, Span<float *const> dst_buffers, unsigned int buffer_size) {
+	ZN_PROFILE_SCOPE();
+	MutexLock mlock(_mutex);
+
+	auto it = _entries.find(key);
+	if (it == _entries.end()) {
+		return false;
+	}
+
+	Entry &entry = it->second;
+	ZN_ASSERT_RETURN_V(entry.data.size() == dst_buffers.size() * buffer_size, false);
+
+	const float *src = entry.data.data();
+	for (float *dst : dst_buffers) {
+		memcpy(dst, src, buffer_size * sizeof(float));
+		src += buffer_size;
+	}
+
+	++_use_counter;
+	entry.last_use = _use_counter;
+	return true;
+}
+
+void XZCache::store(const Key &key, Span<const float *const> src_buffers, unsigned int buffer_size) {
+	ZN_PROFILE_SCOPE();
+	MutexLock mlock(_mutex);
+
+	if (_capacity == 0) {
+		return;
+	}
+
+	auto existing_it = _entries.find(key);
+	if (existing_it != _entries.end()) {
+		// Another thread generated the same column at the same time
+		return;
+	}
+
+	if (_entries.size() >= _capacity) {
+		// Evict the least recently used entry.
+		// Linear search, but this only happens when a column is generated for the first time, which is already
+		// much more expensive.
+		auto oldest_it = _entries.begin();
+		for (auto it = _entries.begin(); it != _entries.end(); ++it) {
+			if (it->second.last_use < oldest_it->second.last_use) {
+				oldest_it = it;
+			}
+		}
+		_spare_data = std::move(oldest_it->second.data);
+		_entries.erase(oldest_it);
+	}
+
+	Entry &entry = _entries[key];
+	entry.data = std::move(_spare_data);
+	_spare_data.clear();
+	entry.data.resize(src_buffers.size() * buffer_size);
+
+	float *dst = entry.data.data();
+	for (const float *src : src_buffers) {
+		memcpy(dst, src, buffer_size * sizeof(float));
+		dst += buffer_size;
+	}
+
+	++_use_counter;
+	entry.last_use = _use_counter;
+}
+
+void XZCache::set_capacity(unsigned int max_entries) {
+	MutexLock mlock(_mutex);
+	_capacity = max_entries;
+	if (_entries.size() > _capacity) {
+		// Not bothering with LRU order here, it rarely changes
+		_entries.clear();
+	}
+}
+
+unsigned int XZCache::get_capacity() const {
+	MutexLock mlock(_mutex);
+	return _capacity;
+}
+
+void XZCache::clear() {
+	MutexLock mlock(_mutex);
+	_entries.clear();
+	_use_counter = 0;
+}
+
+} // namespace zylann::voxel::pg
@@ -0,0 +1,73 @@
+#ifndef VOXEL_GRAPH_XZ_CACHE_H
+#define VOXEL_GRAPH_XZ_CACHE_H
+
+#include "../../util/containers/span.h"
+#include "../../util/containers/std_unordered_map.h"
+#include "../../util/containers/std_vector.h"
+#include "../../util/math/vector2i.h"
+#include "../../util/thread/mutex.h"
+
+namespace zylann::voxel::pg {
+
+// Stores results of the part of a graph that only depends on X and Z coordinates (the "outer group", typically a
+// heightmap), so they can be re-used when generating other blocks of the same column at different heights.
+// Entries are evicted in least-recently-used order when the cache is full.
+// Thread-safe.
+class XZCache {
+public:
+	struct Key {
+		// Origin of the area in voxels, not scaled by LOD
+		Vector2i origin;
+		// Size of the area in voxels, not scaled by LOD
+		Vector2i size;
+		uint8_t lod_index;
+		// Results depend on the compiled program
+		uint64_t program_id;
+
+		inline bool operator==(const Key &other) const {
+			return origin == other.origin && size == other.size && lod_index == other.lod_index &&
+					program_id == other.program_id;
+		}
+	};
+
+	// Copies cached values into `dst_buffers` if the key is found. `dst_buffers` must be in the same order and have
+	// the same sizes as when the values were stored.
+	bool try_load(const Key &key, Span<float *const> dst_buffers, unsigned int buffer_size);
+
+	// Stores a copy of the given buffers.
+	void store(const Key &key, Span<const float *const> src_buffers, unsigned int buffer_size);
+
+	void set_capacity(unsigned int max_entries);
+	unsigned int get_capacity() const;
+
+	void clear();
+
+private:
+	struct KeyHasher {
+		inline size_t operator()(const Key &k) const {
+			uint32_t h = hash_murmur3_one_32(k.origin.x);
+			h = hash_murmur3_one_32(k.origin.y, h);
+			h = hash_murmur3_one_32(k.size.x, h);
+			h = hash_murmur3_one_32(k.size.y, h);
+			h = hash_murmur3_one_32(k.lod_index, h);
+			h = hash_murmur3_one_32(static_cast<uint32_t>(k.program_id), h);
+			return hash_fmix32(h);
+		}
+	};
+
+	struct Entry {
+		StdVector<float> data;
+		uint32_t last_use = 0;
+	};
+
+	StdUnorderedMap<Key, Entry, KeyHasher> _entries;
+	// Data of evicted entries, re-used to avoid allocating when the cache is full
+	StdVector<float> _spare_data;
+	unsigned int _capacity = 256;
+	uint32_t _use_counter = 0;
+	Mutex _mutex;
+};
+
+} // namespace zylann::voxel::pg
+
+#endif // VOXEL_GRAPH_XZ_CACHE_H
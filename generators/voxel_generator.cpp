@@ -3,6 +3,7 @@
 #include "../shaders/shaders.h"
 #include "../storage/voxel_buffer_gd.h"
 #include "../util/godot/core/array.h" // for `varray` in GDExtension builds
+#include "../util/memory/temp_arena.h"
 #include "../util/profiling.h"
 #include "generate_block_task.h"
 
@@ -60,6 +61,63 @@ void VoxelGenerator::generate_series(
 	ZN_PRINT_ERROR("Not implemented");
 }
 
+void VoxelGenerator::generate_series_batch(
+		Span<const Vector3f> positions,
+		Span<const SeriesOutput> outputs,
+		Vector3f min_pos,
+		Vector3f max_pos
+) {
+	ZN_PROFILE_SCOPE();
+
+	TempArenaScope temp_arena_scope(TempArena::get_for_current_thread());
+	TempArena &arena = temp_arena_scope.get_arena();
+	Span<float> x_buffer = arena.allocate_span<float>(positions.size());
+	Span<float> y_buffer = arena.allocate_span<float>(positions.size());
+	Span<float> z_buffer = arena.allocate_span<float>(positions.size());
+
+	for (unsigned int i = 0; i < positions.size(); ++i) {
+		const Vector3f pos = positions[i];
+		x_buffer[i] = pos.x;
+		y_buffer[i] = pos.y;
+		z_buffer[i] = pos.z;
+	}
+
+	for (const SeriesOutput &output : outputs) {
+		ZN_ASSERT_CONTINUE(output.values.size() == positions.size());
+
+		switch (output.type) {
+			case SeriesOutput::TYPE_SDF:
+				generate_series(
+						x_buffer,
+						y_buffer,
+						z_buffer,
+						VoxelBuffer::CHANNEL_SDF,
+						output.values,
+						min_pos,
+						max_pos
+				);
+				break;
+
+			case SeriesOutput::TYPE_TYPE:
+				generate_series(
+						x_buffer,
+						y_buffer,
+						z_buffer,
+						VoxelBuffer::CHANNEL_TYPE,
+						output.values,
+						min_pos,
+						max_pos
+				);
+				break;
+
+			default: {
+				Span<float> values = output.values;
+				values.fill(0.f);
+			} break;
+		}
+	}
+}
+
 void VoxelGenerator::_b_generate_block(Ref<godot::VoxelBuffer> out_buffer, Vector3 origin_in_voxels, int lod) {
 	ERR_FAIL_COND(lod < 0);
 	ERR_FAIL_COND(lod >= int(constants::MAX_LOD));
@@ -115,6 +115,32 @@ public:
 			Vector3f max_pos
 	);
 
+	// Output requested from `generate_series_batch`
+	struct SeriesOutput {
+		enum Type : uint8_t {
+			TYPE_SDF,
+			TYPE_TYPE,
+			TYPE_SINGLE_TEXTURE,
+			// Texture weight of the layer specified with `layer_index`
+			TYPE_WEIGHT
+		};
+		Type type = TYPE_SDF;
+		uint8_t layer_index = 0;
+		// Must have the same size as queried positions. Outputs the generator doesn't have are filled with a default
+		// value (SDF is air, others are zero).
+		Span<float> values;
+	};
+
+	// Generates multiple outputs at arbitrary positions in a single pass. `min_pos` and `max_pos` are hints of the
+	// bounds containing the positions, they don't have to be exact.
+	// The default implementation runs `generate_series` once per output.
+	virtual void generate_series_batch(
+			Span<const Vector3f> positions,
+			Span<const SeriesOutput> outputs,
+			Vector3f min_pos,
+			Vector3f max_pos
+	);
+
 	// Declares the channels this generator will use
 	virtual int get_used_channels_mask() const;
 
@@ -85,6 +85,9 @@ struct BakedModel {
 		// Bits are indexed with the Cube::Side enum.
 		uint8_t empty_sides_mask = 0;
 		uint8_t full_sides_mask = 0;
+		// Sides made of a single quad covering the whole side, with UVs mapped linearly. Greedy meshing can merge
+		// them with identical neighbors.
+		uint8_t greedy_sides_mask = 0;
 
 		// Tells what is the "shape" of each side in order to cull them quickly when in contact with neighbors.
 		// Side patterns are still determined based on a combination of all surfaces.
@@ -169,6 +172,9 @@ struct BakedLibrary {
 	// Where index is X + Y * pattern count
 	DynamicBitset side_pattern_culling;
 	unsigned int side_pattern_count = 0;
+	// Models that are opaque cubes without inside geometry, indexed by model ID. Sides between two such models are
+	// always culled, which allows the mesher to cull them with bitwise operations.
+	DynamicBitset opaque_cube_models;
 	// Lots of data can get moved but it's only on load.
 	StdVector<BakedModel> models;
 	StdVector<BakedFluid> fluids;
@@ -186,6 +192,10 @@ struct BakedLibrary {
 		return i < models.size();
 	}
 
+	inline bool is_opaque_cube(uint32_t i) const {
+		return i < opaque_cube_models.size() && opaque_cube_models.get(i);
+	}
+
 	inline bool get_side_pattern_occlusion(unsigned int pattern_a, unsigned int pattern_b) const {
 #ifdef DEBUG_ENABLED
 		CRASH_COND(pattern_a >= side_pattern_count);
@@ -0,0 +1,119 @@
+#include "blocky_side_connectivity.h"
+#include "../../util/containers/std_vector.h"
+#include "../../util/io/log.h"
+#include "../../util/profiling.h"
+#include "../side_connectivity.h"
+#include "voxel_mesher_blocky.h"
+
+namespace zylann::voxel::blocky {
+
+namespace {
+
+template <typename TModelID>
+uint16_t flood_fill_side_connectivity(
+		const Span<const TModelID> id_buffer,
+		const Vector3i block_size,
+		const BakedLibrary &baked_data
+) {
+	// Data must be padded, hence the off-by-one
+	const Vector3i min = Vector3iUtil::create(VoxelMesherBlocky::PADDING);
+	const Vector3i size = block_size - Vector3iUtil::create(2 * VoxelMesherBlocky::PADDING);
+
+	ZN_ASSERT_RETURN_V(Vector3iUtil::get_volume_u64(block_size) == id_buffer.size(), side_connectivity::ALL_CONNECTED);
+
+	static thread_local StdVector<uint8_t> tls_visited;
+	static thread_local StdVector<Vector3i> tls_stack;
+
+	StdVector<uint8_t> &visited = tls_visited;
+	StdVector<Vector3i> &stack = tls_stack;
+
+	visited.clear();
+	visited.resize(Vector3iUtil::get_volume_u64(size), 0);
+
+	uint16_t connectivity = side_connectivity::NONE_CONNECTED;
+
+	Vector3i start_pos;
+	for (start_pos.z = 0; start_pos.z < size.z; ++start_pos.z) {
+		for (start_pos.x = 0; start_pos.x < size.x; ++start_pos.x) {
+			for (start_pos.y = 0; start_pos.y < size.y; ++start_pos.y) {
+				const unsigned int start_loc = Vector3iUtil::get_zxy_index(start_pos, size);
+				if (visited[start_loc] != 0) {
+					continue;
+				}
+				visited[start_loc] = 1;
+
+				const TModelID start_id = id_buffer[Vector3iUtil::get_zxy_index(start_pos + min, block_size)];
+				if (baked_data.is_opaque_cube(start_id)) {
+					continue;
+				}
+
+				// Flood-fill the region of empty space, and gather which sides of the block it touches
+				uint8_t sides_mask = 0;
+				stack.clear();
+				stack.push_back(start_pos);
+
+				while (stack.size() > 0) {
+					const Vector3i pos = stack.back();
+					stack.pop_back();
+
+					for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
+						const Vector3i npos = pos + Cube::g_side_normals[side];
+
+						if (npos.x < 0 || npos.y < 0 || npos.z < 0 || npos.x >= size.x || npos.y >= size.y ||
+							npos.z >= size.z) {
+							sides_mask |= (1 << side);
+							continue;
+						}
+
+						const unsigned int nloc = Vector3iUtil::get_zxy_index(npos, size);
+						if (visited[nloc] != 0) {
+							continue;
+						}
+						visited[nloc] = 1;
+
+						const TModelID nid = id_buffer[Vector3iUtil::get_zxy_index(npos + min, block_size)];
+						if (!baked_data.is_opaque_cube(nid)) {
+							stack.push_back(npos);
+						}
+					}
+				}
+
+				connectivity |= side_connectivity::get_connectivity_from_sides_mask(sides_mask);
+
+				if (connectivity == side_connectivity::ALL_CONNECTED) {
+					// Nothing more to find
+					return connectivity;
+				}
+			}
+		}
+	}
+
+	return connectivity;
+}
+
+} // namespace
+
+uint16_t compute_side_connectivity(
+		const Span<const uint8_t> id_buffer_raw,
+		const VoxelBuffer::Depth depth,
+		const Vector3i block_size,
+		const BakedLibrary &baked_data
+) {
+	ZN_PROFILE_SCOPE();
+
+	switch (depth) {
+		case VoxelBuffer::DEPTH_8_BIT:
+			return flood_fill_side_connectivity(id_buffer_raw, block_size, baked_data);
+
+		case VoxelBuffer::DEPTH_16_BIT:
+			return flood_fill_side_connectivity(
+					id_buffer_raw.reinterpret_cast_to<const uint16_t>(), block_size, baked_data
+			);
+
+		default:
+			ZN_PRINT_ERROR("Unsupported voxel depth");
+			return side_connectivity::ALL_CONNECTED;
+	}
+}
+
+} // namespace zylann::voxel::blocky
@@ -0,0 +1,22 @@
+#ifndef VOXEL_BLOCKY_SIDE_CONNECTIVITY_H
+#define VOXEL_BLOCKY_SIDE_CONNECTIVITY_H
+
+#include "../../storage/voxel_buffer.h"
+#include "../../util/containers/span.h"
+#include "../../util/math/vector3i.h"
+#include "blocky_baked_library.h"
+
+namespace zylann::voxel::blocky {
+
+// Finds which sides of the block are connected through voxels that are not opaque cubes.
+// See `side_connectivity.h`.
+uint16_t compute_side_connectivity(
+		const Span<const uint8_t> id_buffer_raw,
+		const VoxelBuffer::Depth depth,
+		const Vector3i block_size,
+		const BakedLibrary &baked_data
+);
+
+} // namespace zylann::voxel::blocky
+
+#endif // VOXEL_BLOCKY_SIDE_CONNECTIVITY_H
@@ -2,6 +2,7 @@
 #include "../../util/containers/container_funcs.h"
 #include "../../util/containers/small_vector.h"
 #include "../../util/math/box2f.h"
+#include "../../util/math/funcs.h"
 #include "../../util/math/triangle.h"
 #include "../../util/math/vector4f.h"
 #include "../../util/profiling.h"
@@ -676,6 +677,55 @@ void rasterize_side_all_surfaces(
 	}
 }
 
+bool is_side_greedy_mergeable(const BakedModel &model_data, const unsigned int side_index) {
+	const BakedModel::Model &model = model_data.model;
+
+	if (model_data.fluid_index != NULL_FLUID_INDEX || model_data.cutout_sides_enabled || model.surface_count != 1 ||
+		(model.full_sides_mask & (1 << side_index)) == 0) {
+		return false;
+	}
+
+	const BakedModel::SideSurface &side_surface = model.sides_surfaces[side_index][0];
+	if (side_surface.positions.size() != 4 || side_surface.uvs.size() != 4 || side_surface.indices.size() != 6) {
+		return false;
+	}
+
+	const Vector3i normal = Cube::g_side_normals[side_index];
+	const unsigned int za = normal.x != 0 ? Vector3i::AXIS_X : (normal.y != 0 ? Vector3i::AXIS_Y : Vector3i::AXIS_Z);
+	const unsigned int xa = (za + 1) % Vector3iUtil::AXIS_COUNT;
+	const unsigned int ya = (za + 2) % Vector3iUtil::AXIS_COUNT;
+	const float plane = normal[za] > 0 ? 1.f : 0.f;
+
+	// Each vertex must be on a different corner of the side.
+	// Indexed by in-plane coordinates of the corner, X + 2 * Y.
+	FixedArray<int, 4> corner_vertices;
+	fill(corner_vertices, -1);
+
+	for (unsigned int i = 0; i < side_surface.positions.size(); ++i) {
+		const Vector3f pos = side_surface.positions[i];
+		if (!Math::is_equal_approx(pos[za], plane)) {
+			return false;
+		}
+		const bool ax = Math::is_equal_approx(pos[xa], 1.f);
+		const bool ay = Math::is_equal_approx(pos[ya], 1.f);
+		if ((!ax && !Math::is_zero_approx(pos[xa])) || (!ay && !Math::is_zero_approx(pos[ya]))) {
+			return false;
+		}
+		int &corner_vertex = corner_vertices[ax + 2 * ay];
+		if (corner_vertex != -1) {
+			return false;
+		}
+		corner_vertex = i;
+	}
+
+	// UVs must form a parallelogram, so stretching the quad can extend them linearly
+	const Vector2f uv00 = side_surface.uvs[corner_vertices[0]];
+	const Vector2f uv10 = side_surface.uvs[corner_vertices[1]];
+	const Vector2f uv01 = side_surface.uvs[corner_vertices[2]];
+	const Vector2f uv11 = side_surface.uvs[corner_vertices[3]];
+	return math::is_equal_approx(uv11, uv10 + uv01 - uv00);
+}
+
 void generate_side_culling_matrix(BakedLibrary &baked_data) {
 	ZN_PROFILE_SCOPE();
 	// When two blocky voxels are next to each other, they share a side.
@@ -731,6 +781,10 @@ void generate_side_culling_matrix(BakedLibrary &baked_data) {
 				}
 			}
 
+			if (is_side_greedy_mergeable(model_data, side)) {
+				model_data.model.greedy_sides_mask |= (1 << side);
+			}
+
 			// Find if the same pattern already exists
 			uint32_t pattern_index = VoxelBlockyLibraryBase::NULL_INDEX;
 			for (unsigned int i = 0; i < patterns.size(); ++i) {
@@ -767,6 +821,39 @@ void generate_side_culling_matrix(BakedLibrary &baked_data) {
 		} // side
 	} // type
 
+	// Find models fully culling each other on every side
+	baked_data.opaque_cube_models.resize_no_init(baked_data.models.size());
+	baked_data.opaque_cube_models.fill(false);
+	if (full_side_pattern_index != VoxelBlockyLibraryBase::NULL_INDEX) {
+		for (unsigned int model_id = 0; model_id < baked_data.models.size(); ++model_id) {
+			const BakedModel &model_data = baked_data.models[model_id];
+			// Transparency indices must be the same for all of them, otherwise some sides would remain visible
+			if (model_data.empty || model_data.fluid_index != NULL_FLUID_INDEX || !model_data.culls_neighbors ||
+				model_data.transparency_index != 0) {
+				continue;
+			}
+			bool all_sides_full = true;
+			for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
+				if (model_data.model.side_pattern_indices[side] != full_side_pattern_index) {
+					all_sides_full = false;
+					break;
+				}
+			}
+			// The mesher skips opaque cubes surrounded by other opaque cubes, which would also drop geometry that is
+			// not on a side
+			bool has_inside_geometry = false;
+			for (unsigned int surface_index = 0; surface_index < model_data.model.surface_count; ++surface_index) {
+				if (model_data.model.surfaces[surface_index].positions.size() > 0) {
+					has_inside_geometry = true;
+					break;
+				}
+			}
+			if (all_sides_full && !has_inside_geometry) {
+				baked_data.opaque_cube_models.set(model_id);
+			}
+		}
+	}
+
 	// Find which pattern occludes which
 
 	baked_data.side_pattern_count = patterns.size();
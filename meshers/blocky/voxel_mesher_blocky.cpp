@@ -1,12 +1,16 @@
 #include "voxel_mesher_blocky.h"
 #include "../../constants/cube_tables.h"
+#include "../../engine/voxel_engine.h"
 #include "../../storage/voxel_buffer.h"
 #include "../../util/containers/span.h"
+#include "../../util/godot/classes/rendering_server.h"
 #include "../../util/godot/core/array.h"
 #include "../../util/godot/core/packed_arrays.h"
 #include "../../util/macros.h"
 #include "../../util/math/conv.h"
 #include "../../util/math/funcs.h"
+#include "../../util/memory/memory.h"
+#include "../../util/memory/temp_arena.h"
 // TODO GDX: String has no `operator+=`
 #include "../../util/containers/container_funcs.h"
 #include "../../util/godot/core/string.h"
@@ -14,6 +18,7 @@
 #include "blocky_fluids_meshing_impl.h"
 #include "blocky_lod_skirts.h"
 #include "blocky_shadow_occluders.h"
+#include "blocky_side_connectivity.h"
 
 using namespace zylann::godot;
 
@@ -34,6 +39,501 @@ StdVector<int> &get_tls_index_offsets() {
 	return tls_index_offsets;
 }
 
+// Calculates how many occluders touch each corner of a side, for baked ambient occlusion
+template <typename Type_T>
+inline void get_side_corners_occlusion(
+		const BakedLibrary &library,
+		const Span<const Type_T> type_buffer,
+		const unsigned int voxel_index,
+		const unsigned int side,
+		const FixedArray<int, Cube::EDGE_COUNT> &edge_neighbor_lut,
+		const FixedArray<int, Cube::CORNER_COUNT> &corner_neighbor_lut,
+		int8_t out_shaded_corner[Cube::CORNER_COUNT]
+) {
+	// Combinatory solution for
+	// https://0fps.net/2013/07/03/ambient-occlusion-for-minecraft-like-worlds/ (inverted)
+	//	function vertexAO(side1, side2, corner) {
+	//	  if(side1 && side2) {
+	//		return 0
+	//	  }
+	//	  return 3 - (side1 + side2 + corner)
+	//	}
+
+	for (unsigned int j = 0; j < 4; ++j) {
+		const unsigned int edge = Cube::g_side_edges[side][j];
+		const int edge_neighbor_id = type_buffer[voxel_index + edge_neighbor_lut[edge]];
+		if (contributes_to_ao(library, edge_neighbor_id)) {
+			++out_shaded_corner[Cube::g_edge_corners[edge][0]];
+			++out_shaded_corner[Cube::g_edge_corners[edge][1]];
+		}
+	}
+	for (unsigned int j = 0; j < 4; ++j) {
+		const unsigned int corner = Cube::g_side_corners[side][j];
+		if (out_shaded_corner[corner] == 2) {
+			out_shaded_corner[corner] = 3;
+		} else {
+			const int corner_neigbor_id = type_buffer[voxel_index + corner_neighbor_lut[corner]];
+			if (contributes_to_ao(library, corner_neigbor_id)) {
+				++out_shaded_corner[corner];
+			}
+		}
+	}
+}
+
+// Gets how much a vertex of a side is darkened by baked ambient occlusion
+inline float get_side_vertex_shade(
+		const unsigned int side,
+		const int8_t shaded_corner[Cube::CORNER_COUNT],
+		const Vector3f vertex_pos,
+		const float baked_occlusion_darkness
+) {
+	// General purpose occlusion colouring.
+	// TODO Optimize for cubes
+	// TODO Fix occlusion inconsistency caused by triangles orientation? Not sure if
+	// worth it
+	float shade = 0;
+	for (unsigned int j = 0; j < 4; ++j) {
+		unsigned int corner = Cube::g_side_corners[side][j];
+		if (shaded_corner[corner] != 0) {
+			float s = baked_occlusion_darkness * static_cast<float>(shaded_corner[corner]);
+			// float k = 1.f - Cube::g_corner_position[corner].distance_to(v);
+			float k = 1.f - math::distance_squared(Cube::g_corner_position[corner], vertex_pos);
+			if (k < 0.0) {
+				k = 0.0;
+			}
+			s *= k;
+			if (s > shade) {
+				shade = s;
+			}
+		}
+	}
+	return shade;
+}
+
+// Tile rects are only produced by greedy meshing. Vertices added by other parts of the mesher get an empty rect, so
+// shaders wrapping UVs within atlas tiles leave them unchanged.
+inline void fill_missing_tile_rects(VoxelMesherBlocky::Arrays &arrays) {
+	const size_t expected_size = 4 * arrays.uvs.size();
+	if (arrays.tile_rects.size() < expected_size) {
+		arrays.tile_rects.resize(expected_size, 0.f);
+	}
+}
+
+// Welds, simplifies (if `target_ratio` is lower than 1) and reorders vertices of the given arrays.
+void optimize_arrays(
+		VoxelMesherBlocky::Arrays &arrays,
+		const float target_ratio,
+		const float error_threshold,
+		const Vector3f border_size
+) {
+	if (arrays.indices.size() == 0) {
+		return;
+	}
+
+	if (arrays.tile_rects.size() > 0) {
+		fill_missing_tile_rects(arrays);
+	}
+
+	FixedArray<mesh_optimization::VertexStream, 5> streams;
+	unsigned int stream_count = 0;
+	streams[stream_count++] = { arrays.normals.data(), sizeof(Vector3f) };
+	streams[stream_count++] = { arrays.uvs.data(), sizeof(Vector2f) };
+	streams[stream_count++] = { arrays.colors.data(), sizeof(Color) };
+	if (arrays.tile_rects.size() > 0) {
+		streams[stream_count++] = { arrays.tile_rects.data(), 4 * sizeof(float) };
+	}
+	if (arrays.tangents.size() > 0) {
+		streams[stream_count++] = { arrays.tangents.data(), 4 * sizeof(float) };
+	}
+
+	const mesh_optimization::Result result = mesh_optimization::optimize(
+			to_span(arrays.indices),
+			to_span(arrays.positions),
+			to_span_const(streams, stream_count),
+			target_ratio,
+			error_threshold,
+			border_size
+	);
+
+	arrays.positions.resize(result.vertex_count);
+	arrays.normals.resize(result.vertex_count);
+	arrays.uvs.resize(result.vertex_count);
+	arrays.colors.resize(result.vertex_count);
+	if (arrays.tile_rects.size() > 0) {
+		arrays.tile_rects.resize(4 * result.vertex_count);
+	}
+	if (arrays.tangents.size() > 0) {
+		arrays.tangents.resize(4 * result.vertex_count);
+	}
+	arrays.indices.resize(result.index_count);
+}
+
+// Appends a side of a model, stretched to cover `size_x * size_y` voxels along the two axes of the side.
+// The side must be mergeable (see `BakedModel::Model::greedy_sides_mask`).
+void append_greedy_side(
+		VoxelMesherBlocky::Arrays &arrays,
+		int &index_offset,
+		VoxelMesher::Output::CollisionSurface *collision_surface,
+		int &collision_surface_index_offset,
+		const BakedModel::Surface &surface,
+		const BakedModel::SideSurface &side_surface,
+		const unsigned int side,
+		const unsigned int xa,
+		const unsigned int ya,
+		const Vector3f pos,
+		const unsigned int size_x,
+		const unsigned int size_y,
+		const int8_t shaded_corner[Cube::CORNER_COUNT],
+		const bool bake_occlusion,
+		const float baked_occlusion_darkness,
+		const Color modulate_color,
+		const bool visual
+) {
+	const unsigned int vertex_count = 4;
+	ZN_ASSERT(side_surface.positions.size() == vertex_count);
+
+	const Vector2f extension(size_x - 1, size_y - 1);
+
+	if (collision_surface != nullptr && surface.collision_enabled) {
+		for (unsigned int i = 0; i < vertex_count; ++i) {
+			const Vector3f side_pos = side_surface.positions[i];
+			Vector3f vertex_pos = side_pos + pos;
+			vertex_pos[xa] += side_pos[xa] * extension.x;
+			vertex_pos[ya] += side_pos[ya] * extension.y;
+			collision_surface->positions.push_back(vertex_pos);
+		}
+		for (const int index : side_surface.indices) {
+			collision_surface->indices.push_back(collision_surface_index_offset + index);
+		}
+		collision_surface_index_offset += vertex_count;
+	}
+
+	if (!visual) {
+		return;
+	}
+
+	// UVs are extended linearly, so textures repeat if the material samples them with wrapping. The rectangle of the
+	// tile is stored in a custom attribute, so shaders can instead wrap UVs within a tile of an atlas.
+	Vector2f uv_min = side_surface.uvs[0];
+	Vector2f uv_max = side_surface.uvs[0];
+	Vector2f uv_x;
+	Vector2f uv_y;
+	{
+		Vector2f uv00;
+		for (unsigned int i = 0; i < vertex_count; ++i) {
+			const Vector3f p = side_surface.positions[i];
+			const Vector2f uv = side_surface.uvs[i];
+			if (p[xa] < 0.5f && p[ya] < 0.5f) {
+				uv00 = uv;
+			} else if (p[ya] < 0.5f) {
+				uv_x = uv;
+			} else if (p[xa] < 0.5f) {
+				uv_y = uv;
+			}
+			uv_min = math::min(uv_min, uv);
+			uv_max = math::max(uv_max, uv);
+		}
+		uv_x = uv_x - uv00;
+		uv_y = uv_y - uv00;
+	}
+
+	fill_missing_tile_rects(arrays);
+	const Vector2f uv_size = uv_max - uv_min;
+
+	for (unsigned int i = 0; i < vertex_count; ++i) {
+		const Vector3f side_pos = side_surface.positions[i];
+		const float ex = side_pos[xa] * extension.x;
+		const float ey = side_pos[ya] * extension.y;
+
+		Vector3f vertex_pos = side_pos + pos;
+		vertex_pos[xa] += ex;
+		vertex_pos[ya] += ey;
+		arrays.positions.push_back(vertex_pos);
+
+		arrays.uvs.push_back(side_surface.uvs[i] + uv_x * ex + uv_y * ey);
+		arrays.tile_rects.push_back(uv_min.x);
+		arrays.tile_rects.push_back(uv_min.y);
+		arrays.tile_rects.push_back(uv_size.x);
+		arrays.tile_rects.push_back(uv_size.y);
+		arrays.normals.push_back(to_vec3f(Cube::g_side_normals[side]));
+
+		if (bake_occlusion) {
+			const float gs = 1.f - get_side_vertex_shade(side, shaded_corner, side_pos, baked_occlusion_darkness);
+			arrays.colors.push_back(Color(gs, gs, gs) * modulate_color);
+		} else {
+			arrays.colors.push_back(modulate_color);
+		}
+	}
+
+	if (side_surface.tangents.size() > 0) {
+		arrays.tangents.insert(arrays.tangents.end(), side_surface.tangents.begin(), side_surface.tangents.end());
+	}
+
+	for (const int index : side_surface.indices) {
+		arrays.indices.push_back(index_offset + index);
+	}
+	index_offset += vertex_count;
+}
+
+struct GreedyFace {
+	// Model of the voxel the face belongs to, or `AIR_ID` if there is no face to merge
+	uint32_t model_id;
+	// Ambient occlusion of the face. Only faces with the same occlusion on all corners can be merged.
+	int8_t shade;
+	Color color;
+
+	inline bool operator==(const GreedyFace &other) const {
+		return model_id == other.model_id && shade == other.shade && color == other.color;
+	}
+
+	inline bool operator!=(const GreedyFace &other) const {
+		return !(*this == other);
+	}
+};
+
+StdVector<uint64_t> &get_tls_opaque_cube_rows() {
+	static thread_local StdVector<uint64_t> tls_opaque_cube_rows;
+	return tls_opaque_cube_rows;
+}
+
+// Builds one bitmask per row of voxels along the Y axis, where each bit tells if the voxel is an opaque cube.
+// Rows are indexed by `x + z * block_size.x`.
+template <typename Type_T>
+void build_opaque_cube_rows(
+		StdVector<uint64_t> &out_rows,
+		const Span<const Type_T> type_buffer,
+		const Vector3i block_size,
+		const BakedLibrary &library
+) {
+	ZN_ASSERT(block_size.y <= 64);
+	out_rows.resize(block_size.x * block_size.z);
+
+	unsigned int voxel_index = 0;
+	unsigned int row_index = 0;
+	// Same order as voxels in the buffer: ZXY
+	for (int z = 0; z < block_size.z; ++z) {
+		for (int x = 0; x < block_size.x; ++x) {
+			uint64_t row = 0;
+			for (int y = 0; y < block_size.y; ++y) {
+				if (library.is_opaque_cube(type_buffer[voxel_index])) {
+					row |= (uint64_t(1) << y);
+				}
+				++voxel_index;
+			}
+			out_rows[row_index] = row;
+			++row_index;
+		}
+	}
+}
+
+StdVector<GreedyFace> &get_tls_greedy_mask() {
+	static thread_local StdVector<GreedyFace> tls_greedy_mask;
+	return tls_greedy_mask;
+}
+
+// Generates sides that are skipped by the main loop of `generate_mesh` when greedy meshing is enabled.
+// Identical faces lying next to each other on the same plane are merged into larger quads.
+// See https://0fps.net/2012/06/30/meshing-in-a-minecraft-game/
+template <typename Type_T>
+void generate_greedy_sides(
+		StdVector<VoxelMesherBlocky::Arrays> &out_arrays_per_material,
+		StdVector<int> &index_offsets,
+		VoxelMesher::Output::CollisionSurface *collision_surface,
+		int &collision_surface_index_offset,
+		const Span<const Type_T> type_buffer,
+		const Vector3i block_size,
+		const BakedLibrary &library,
+		const bool bake_occlusion,
+		const float baked_occlusion_darkness,
+		const TintSampler tint_sampler,
+		const FixedArray<int, Cube::SIDE_COUNT> &side_neighbor_lut,
+		const FixedArray<int, Cube::EDGE_COUNT> &edge_neighbor_lut,
+		const FixedArray<int, Cube::CORNER_COUNT> &corner_neighbor_lut,
+		const bool visual
+) {
+	ZN_PROFILE_SCOPE();
+
+	const int row_size = block_size.y;
+	const int deck_size = block_size.x * row_size;
+
+	const Vector3i min = Vector3iUtil::create(VoxelMesherBlocky::PADDING);
+	const Vector3i max = block_size - Vector3iUtil::create(VoxelMesherBlocky::PADDING);
+
+	StdVector<GreedyFace> &mask = get_tls_greedy_mask();
+
+	for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
+		const Vector3i normal = Cube::g_side_normals[side];
+		const unsigned int za =
+				normal.x != 0 ? Vector3i::AXIS_X : (normal.y != 0 ? Vector3i::AXIS_Y : Vector3i::AXIS_Z);
+		const unsigned int xa = (za + 1) % Vector3iUtil::AXIS_COUNT;
+		const unsigned int ya = (za + 2) % Vector3iUtil::AXIS_COUNT;
+
+		const unsigned int mask_size_x = max[xa] - min[xa];
+		const unsigned int mask_size_y = max[ya] - min[ya];
+		mask.resize(mask_size_x * mask_size_y);
+
+		for (int d = min[za]; d < max[za]; ++d) {
+			// Gather faces of the slice
+			for (unsigned int my = 0; my < mask_size_y; ++my) {
+				for (unsigned int mx = 0; mx < mask_size_x; ++mx) {
+					GreedyFace &face = mask[mx + my * mask_size_x];
+					face.model_id = AIR_ID;
+
+					Vector3i vpos;
+					vpos[xa] = mx + min[xa];
+					vpos[ya] = my + min[ya];
+					vpos[za] = d;
+
+					const unsigned int voxel_index = vpos.y + vpos.x * row_size + vpos.z * deck_size;
+					const unsigned int voxel_id = type_buffer[voxel_index];
+
+					if (voxel_id == AIR_ID || !library.has_model(voxel_id)) {
+						continue;
+					}
+
+					const BakedModel &voxel = library.models[voxel_id];
+					if ((voxel.model.greedy_sides_mask & (1 << side)) == 0) {
+						continue;
+					}
+
+					const uint32_t neighbor_voxel_id = type_buffer[voxel_index + side_neighbor_lut[side]];
+					if (!is_face_visible(library, voxel, neighbor_voxel_id, side)) {
+						continue;
+					}
+
+					int8_t shaded_corner[Cube::CORNER_COUNT] = { 0 };
+					if (bake_occlusion) {
+						get_side_corners_occlusion(
+								library,
+								type_buffer,
+								voxel_index,
+								side,
+								edge_neighbor_lut,
+								corner_neighbor_lut,
+								shaded_corner
+						);
+					}
+
+					const Color modulate_color = voxel.color * tint_sampler.evaluate(vpos);
+
+					const int8_t shade = shaded_corner[Cube::g_side_corners[side][0]];
+					bool uniform_shade = true;
+					for (unsigned int j = 1; j < 4; ++j) {
+						if (shaded_corner[Cube::g_side_corners[side][j]] != shade) {
+							uniform_shade = false;
+							break;
+						}
+					}
+
+					if (!uniform_shade) {
+						// Merging would stretch the occlusion gradient across multiple voxels, so this face is added
+						// on its own
+						const BakedModel::Surface &surface = voxel.model.surfaces[0];
+						ZN_ASSERT(surface.material_id < index_offsets.size());
+						append_greedy_side(
+								out_arrays_per_material[surface.material_id],
+								index_offsets[surface.material_id],
+								collision_surface,
+								collision_surface_index_offset,
+								surface,
+								voxel.model.sides_surfaces[side][0],
+								side,
+								xa,
+								ya,
+								// Subtracting 1 because the data is padded
+								to_vec3f(vpos - Vector3i(1, 1, 1)),
+								1,
+								1,
+								shaded_corner,
+								bake_occlusion,
+								baked_occlusion_darkness,
+								modulate_color,
+								visual
+						);
+						continue;
+					}
+
+					face.model_id = voxel_id;
+					face.shade = shade;
+					face.color = modulate_color;
+				}
+			}
+
+			// Merge faces into quads
+			for (unsigned int my = 0; my < mask_size_y; ++my) {
+				for (unsigned int mx = 0; mx < mask_size_x; ++mx) {
+					const GreedyFace face = mask[mx + my * mask_size_x];
+					if (face.model_id == AIR_ID) {
+						continue;
+					}
+
+					// Extend along X
+					unsigned int rx = mx + 1;
+					while (rx < mask_size_x && mask[rx + my * mask_size_x] == face) {
+						++rx;
+					}
+
+					// Extend along Y as long as the whole row matches
+					unsigned int ry = my + 1;
+					for (; ry < mask_size_y; ++ry) {
+						bool row_matches = true;
+						for (unsigned int x = mx; x < rx; ++x) {
+							if (mask[x + ry * mask_size_x] != face) {
+								row_matches = false;
+								break;
+							}
+						}
+						if (!row_matches) {
+							break;
+						}
+					}
+
+					for (unsigned int y = my; y < ry; ++y) {
+						for (unsigned int x = mx; x < rx; ++x) {
+							mask[x + y * mask_size_x].model_id = AIR_ID;
+						}
+					}
+
+					const BakedModel &voxel = library.models[face.model_id];
+					const BakedModel::Surface &surface = voxel.model.surfaces[0];
+
+					int8_t shaded_corner[Cube::CORNER_COUNT] = { 0 };
+					for (unsigned int j = 0; j < 4; ++j) {
+						shaded_corner[Cube::g_side_corners[side][j]] = face.shade;
+					}
+
+					// Subtracting 1 because the data is padded
+					Vector3f pos;
+					pos[xa] = mx + min[xa] - 1;
+					pos[ya] = my + min[ya] - 1;
+					pos[za] = d - 1;
+
+					ZN_ASSERT(surface.material_id < index_offsets.size());
+					append_greedy_side(
+							out_arrays_per_material[surface.material_id],
+							index_offsets[surface.material_id],
+							collision_surface,
+							collision_surface_index_offset,
+							surface,
+							voxel.model.sides_surfaces[side][0],
+							side,
+							xa,
+							ya,
+							pos,
+							rx - mx,
+							ry - my,
+							shaded_corner,
+							bake_occlusion,
+							baked_occlusion_darkness,
+							face.color,
+							visual
+					);
+				}
+			}
+		}
+	}
+}
+
 template <typename Type_T>
 void generate_mesh(
 		StdVector<VoxelMesherBlocky::Arrays> &out_arrays_per_material,
@@ -43,7 +543,13 @@ void generate_mesh(
 		const BakedLibrary &library,
 		const bool bake_occlusion,
 		const float baked_occlusion_darkness,
-		const TintSampler tint_sampler
+		const TintSampler tint_sampler,
+		const bool greedy_meshing,
+		// If false, only the collision surface is generated
+		const bool visual,
+		// Range of voxels to mesh along the Y axis, in padded coordinates. Greedy meshing ignores it.
+		const unsigned int min_y,
+		const unsigned int max_y
 ) {
 	// TODO Optimization: not sure if this mandates a template function. There is so much more happening in this
 	// function other than reading voxels, although reading is on the hottest path. It needs to be profiled. If
@@ -54,6 +560,10 @@ void generate_mesh(
 			block_size.y < static_cast<int>(2 * VoxelMesherBlocky::PADDING) ||
 			block_size.z < static_cast<int>(2 * VoxelMesherBlocky::PADDING)
 	);
+	ERR_FAIL_COND(
+			min_y < static_cast<unsigned int>(VoxelMesherBlocky::PADDING) ||
+			max_y > static_cast<unsigned int>(block_size.y - VoxelMesherBlocky::PADDING)
+	);
 
 	// Build lookup tables so to speed up voxel access.
 	// These are values to add to an address in order to get given neighbor.
@@ -124,15 +634,52 @@ void generate_mesh(
 	corner_neighbor_lut[Cube::CORNER_TOP_FRONT_LEFT] = side_neighbor_lut[Cube::SIDE_TOP] +
 			side_neighbor_lut[Cube::SIDE_FRONT] + side_neighbor_lut[Cube::SIDE_LEFT];
 
+	// Binary culling: when a whole row of voxels fits in 64 bits, sides between two opaque cubes are culled with
+	// bitwise operations instead of comparing models one side at a time. Mostly-solid chunks then skip most voxels.
+	// Other voxels still go through the regular checks.
+	const bool use_opaque_cube_rows = block_size.y <= 64 && library.opaque_cube_models.size() > 0;
+	StdVector<uint64_t> &opaque_cube_rows = get_tls_opaque_cube_rows();
+	if (use_opaque_cube_rows) {
+		build_opaque_cube_rows(opaque_cube_rows, type_buffer, block_size, library);
+	}
+
 	// uint64_t time_prep = Time::get_singleton()->get_ticks_usec() - time_before;
 	// time_before = Time::get_singleton()->get_ticks_usec();
 
 	for (unsigned int z = min.z; z < (unsigned int)max.z; ++z) {
 		for (unsigned int x = min.x; x < (unsigned int)max.x; ++x) {
-			for (unsigned int y = min.y; y < (unsigned int)max.y; ++y) {
+			// Bits of opaque cubes in the current row, and in rows of neighbors on each side
+			uint64_t opaque_cubes = 0;
+			FixedArray<uint64_t, Cube::SIDE_COUNT> neighbor_opaque_cubes;
+			fill(neighbor_opaque_cubes, uint64_t(0));
+			// Opaque cubes only surrounded by opaque cubes
+			uint64_t hidden_cubes = 0;
+
+			if (use_opaque_cube_rows) {
+				const unsigned int row_index = x + z * block_size.x;
+				opaque_cubes = opaque_cube_rows[row_index];
+				neighbor_opaque_cubes[Cube::SIDE_LEFT] = opaque_cube_rows[row_index + 1];
+				neighbor_opaque_cubes[Cube::SIDE_RIGHT] = opaque_cube_rows[row_index - 1];
+				neighbor_opaque_cubes[Cube::SIDE_BACK] = opaque_cube_rows[row_index - block_size.x];
+				neighbor_opaque_cubes[Cube::SIDE_FRONT] = opaque_cube_rows[row_index + block_size.x];
+				neighbor_opaque_cubes[Cube::SIDE_BOTTOM] = opaque_cubes << 1;
+				neighbor_opaque_cubes[Cube::SIDE_TOP] = opaque_cubes >> 1;
+
+				hidden_cubes = opaque_cubes;
+				for (const uint64_t neighbors : neighbor_opaque_cubes) {
+					hidden_cubes &= neighbors;
+				}
+			}
+
+			for (unsigned int y = min_y; y < max_y; ++y) {
 				// min and max are chosen such that you can visit 1 neighbor away from the current voxel without size
 				// check
 
+				if (((hidden_cubes >> y) & 1) != 0) {
+					// All sides are culled
+					continue;
+				}
+
 				const unsigned int voxel_index = y + x * row_size + z * deck_size;
 				const unsigned int voxel_id = type_buffer[voxel_index];
 
@@ -144,6 +691,8 @@ void generate_mesh(
 				const BakedModel &voxel = library.models[voxel_id];
 				const BakedModel::Model &model = voxel.model;
 
+				const bool is_opaque_cube = ((opaque_cubes >> y) & 1) != 0;
+
 				// Calculate visibility of sides
 				uint32_t visible_sides_mask = 0;
 				for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
@@ -152,6 +701,11 @@ void generate_mesh(
 						continue;
 					}
 
+					if (is_opaque_cube && ((neighbor_opaque_cubes[side] >> y) & 1) != 0) {
+						// Covered by another opaque cube
+						continue;
+					}
+
 					const uint32_t neighbor_voxel_id = type_buffer[voxel_index + side_neighbor_lut[side]];
 
 					// Invalid voxels are treated like air
@@ -199,12 +753,18 @@ void generate_mesh(
 
 				const Color modulate_color = voxel.color * tint_sampler.evaluate(Vector3i(x, y, z));
 
+				// These sides are generated later, in a way that merges them with their neighbors
+				const uint8_t greedy_sides_mask = greedy_meshing ? model.greedy_sides_mask : 0;
+
 				// Sides
 				for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
 					if ((visible_sides_mask & (1 << side)) == 0) {
 						// This side is culled
 						continue;
 					}
+					if ((greedy_sides_mask & (1 << side)) != 0) {
+						continue;
+					}
 
 					// By default we render the whole side if we consider it visible
 					const FixedArray<BakedModel::SideSurface, MAX_SURFACES> *side_surfaces =
@@ -242,34 +802,15 @@ void generate_mesh(
 					int8_t shaded_corner[8] = { 0 };
 
 					if (bake_occlusion) {
-						// Combinatory solution for
-						// https://0fps.net/2013/07/03/ambient-occlusion-for-minecraft-like-worlds/ (inverted)
-						//	function vertexAO(side1, side2, corner) {
-						//	  if(side1 && side2) {
-						//		return 0
-						//	  }
-						//	  return 3 - (side1 + side2 + corner)
-						//	}
-
-						for (unsigned int j = 0; j < 4; ++j) {
-							const unsigned int edge = Cube::g_side_edges[side][j];
-							const int edge_neighbor_id = type_buffer[voxel_index + edge_neighbor_lut[edge]];
-							if (contributes_to_ao(library, edge_neighbor_id)) {
-								++shaded_corner[Cube::g_edge_corners[edge][0]];
-								++shaded_corner[Cube::g_edge_corners[edge][1]];
-							}
-						}
-						for (unsigned int j = 0; j < 4; ++j) {
-							const unsigned int corner = Cube::g_side_corners[side][j];
-							if (shaded_corner[corner] == 2) {
-								shaded_corner[corner] = 3;
-							} else {
-								const int corner_neigbor_id = type_buffer[voxel_index + corner_neighbor_lut[corner]];
-								if (contributes_to_ao(library, corner_neigbor_id)) {
-									++shaded_corner[corner];
-								}
-							}
-						}
+						get_side_corners_occlusion(
+								library,
+								type_buffer,
+								voxel_index,
+								side,
+								edge_neighbor_lut,
+								corner_neighbor_lut,
+								shaded_corner
+						);
 					}
 
 					// Subtracting 1 because the data is padded
@@ -289,6 +830,38 @@ void generate_mesh(
 						const StdVector<Vector3f> &side_positions = side_surface.positions;
 						const unsigned int vertex_count = side_surface.positions.size();
 
+						const StdVector<int> &side_indices = side_surface.indices;
+						const unsigned int index_count = side_indices.size();
+
+						if (collision_surface != nullptr && surface.collision_enabled) {
+							StdVector<Vector3f> &dst_positions = collision_surface->positions;
+							StdVector<int> &dst_indices = collision_surface->indices;
+
+							{
+								const unsigned int append_index = dst_positions.size();
+								dst_positions.resize(dst_positions.size() + vertex_count);
+								Vector3f *w = dst_positions.data() + append_index;
+								for (unsigned int i = 0; i < vertex_count; ++i) {
+									w[i] = side_positions[i] + pos;
+								}
+							}
+
+							{
+								int i = dst_indices.size();
+								dst_indices.resize(dst_indices.size() + index_count);
+								int *w = dst_indices.data();
+								for (unsigned int j = 0; j < index_count; ++j) {
+									w[i++] = collision_surface_index_offset + side_indices[j];
+								}
+							}
+
+							collision_surface_index_offset += vertex_count;
+						}
+
+						if (!visual) {
+							continue;
+						}
+
 						const StdVector<Vector2f> &side_uvs = side_surface.uvs;
 						const StdVector<float> &side_tangents = side_surface.tangents;
 
@@ -333,30 +906,9 @@ void generate_mesh(
 
 							if (bake_occlusion) {
 								for (unsigned int i = 0; i < vertex_count; ++i) {
-									const Vector3f vertex_pos = side_positions[i];
-
-									// General purpose occlusion colouring.
-									// TODO Optimize for cubes
-									// TODO Fix occlusion inconsistency caused by triangles orientation? Not sure if
-									// worth it
-									float shade = 0;
-									for (unsigned int j = 0; j < 4; ++j) {
-										unsigned int corner = Cube::g_side_corners[side][j];
-										if (shaded_corner[corner] != 0) {
-											float s = baked_occlusion_darkness *
-													static_cast<float>(shaded_corner[corner]);
-											// float k = 1.f - Cube::g_corner_position[corner].distance_to(v);
-											float k = 1.f -
-													math::distance_squared(Cube::g_corner_position[corner], vertex_pos);
-											if (k < 0.0) {
-												k = 0.0;
-											}
-											s *= k;
-											if (s > shade) {
-												shade = s;
-											}
-										}
-									}
+									const float shade = get_side_vertex_shade(
+											side, shaded_corner, side_positions[i], baked_occlusion_darkness
+									);
 									const float gs = 1.0 - shade;
 									w[i] = Color(gs, gs, gs) * modulate_color;
 								}
@@ -368,9 +920,6 @@ void generate_mesh(
 							}
 						}
 
-						const StdVector<int> &side_indices = side_surface.indices;
-						const unsigned int index_count = side_indices.size();
-
 						{
 							int i = arrays.indices.size();
 							arrays.indices.resize(arrays.indices.size() + index_count);
@@ -380,31 +929,6 @@ void generate_mesh(
 							}
 						}
 
-						if (collision_surface != nullptr && surface.collision_enabled) {
-							StdVector<Vector3f> &dst_positions = collision_surface->positions;
-							StdVector<int> &dst_indices = collision_surface->indices;
-
-							{
-								const unsigned int append_index = dst_positions.size();
-								dst_positions.resize(dst_positions.size() + vertex_count);
-								Vector3f *w = dst_positions.data() + append_index;
-								for (unsigned int i = 0; i < vertex_count; ++i) {
-									w[i] = side_positions[i] + pos;
-								}
-							}
-
-							{
-								int i = dst_indices.size();
-								dst_indices.resize(dst_indices.size() + index_count);
-								int *w = dst_indices.data();
-								for (unsigned int j = 0; j < index_count; ++j) {
-									w[i++] = collision_surface_index_offset + side_indices[j];
-								}
-							}
-
-							collision_surface_index_offset += vertex_count;
-						}
-
 						index_offset += vertex_count;
 					}
 				}
@@ -431,6 +955,27 @@ void generate_mesh(
 
 					const Vector3f pos(x - 1, y - 1, z - 1);
 
+					const StdVector<int> &indices = surface.indices;
+					const unsigned int index_count = indices.size();
+
+					if (collision_surface != nullptr && surface.collision_enabled) {
+						StdVector<Vector3f> &dst_positions = collision_surface->positions;
+						StdVector<int> &dst_indices = collision_surface->indices;
+
+						for (unsigned int i = 0; i < vertex_count; ++i) {
+							dst_positions.push_back(positions[i] + pos);
+						}
+						for (unsigned int i = 0; i < index_count; ++i) {
+							dst_indices.push_back(collision_surface_index_offset + indices[i]);
+						}
+
+						collision_surface_index_offset += vertex_count;
+					}
+
+					if (!visual) {
+						continue;
+					}
+
 					if (tangents.size() > 0) {
 						const int append_index = arrays.tangents.size();
 						arrays.tangents.resize(arrays.tangents.size() + vertex_count * 4);
@@ -447,32 +992,197 @@ void generate_mesh(
 						arrays.colors.push_back(modulate_color);
 					}
 
-					const StdVector<int> &indices = surface.indices;
-					const unsigned int index_count = indices.size();
-
 					for (unsigned int i = 0; i < index_count; ++i) {
 						arrays.indices.push_back(index_offset + indices[i]);
 					}
 
-					if (collision_surface != nullptr && surface.collision_enabled) {
-						StdVector<Vector3f> &dst_positions = collision_surface->positions;
-						StdVector<int> &dst_indices = collision_surface->indices;
-
-						for (unsigned int i = 0; i < vertex_count; ++i) {
-							dst_positions.push_back(positions[i] + pos);
-						}
-						for (unsigned int i = 0; i < index_count; ++i) {
-							dst_indices.push_back(collision_surface_index_offset + indices[i]);
-						}
-
-						collision_surface_index_offset += vertex_count;
-					}
-
 					index_offset += vertex_count;
 				}
 			}
 		}
 	}
+
+	if (greedy_meshing) {
+		generate_greedy_sides(
+				out_arrays_per_material,
+				index_offsets,
+				collision_surface,
+				collision_surface_index_offset,
+				type_buffer,
+				block_size,
+				library,
+				bake_occlusion,
+				baked_occlusion_darkness,
+				tint_sampler,
+				side_neighbor_lut,
+				edge_neighbor_lut,
+				corner_neighbor_lut,
+				visual
+		);
+	}
+}
+
+void append_arrays(VoxelMesherBlocky::Arrays &dst, const VoxelMesherBlocky::Arrays &src) {
+	const int index_offset = dst.positions.size();
+	// Tile rects are only produced by greedy meshing, which is not used in incremental builds
+	append_array(dst.positions, src.positions);
+	append_array(dst.normals, src.normals);
+	append_array(dst.uvs, src.uvs);
+	append_array(dst.colors, src.colors);
+	append_array(dst.tangents, src.tangents);
+	for (const int i : src.indices) {
+		dst.indices.push_back(index_offset + i);
+	}
+}
+
+void append_collision_surface(
+		VoxelMesher::Output::CollisionSurface &dst,
+		const VoxelMesher::Output::CollisionSurface &src
+) {
+	const int index_offset = dst.positions.size();
+	append_array(dst.positions, src.positions);
+	for (const int i : src.indices) {
+		dst.indices.push_back(index_offset + i);
+	}
+}
+
+// Used to mesh sections of a block in parallel when there is no usable incremental cache. Rebuilt entirely every time.
+IncrementalCache &get_tls_parallel_sections() {
+	thread_local IncrementalCache tls_cache;
+	return tls_cache;
+}
+
+// Builds the mesh one slice along the Y axis at a time, only rebuilding slices intersecting the dirty area. Other
+// slices are taken from the previous build. Results are then concatenated into the output arrays.
+// If `parallel` is true, slices to rebuild are split among idle threads, if any.
+template <typename Type_T>
+void generate_mesh_incremental(
+		IncrementalCache &cache,
+		const VoxelMesher::IncrementalCache::DirtyArea &dirty_area,
+		StdVector<VoxelMesherBlocky::Arrays> &out_arrays_per_material,
+		VoxelMesher::Output::CollisionSurface *collision_surface,
+		const Span<const Type_T> type_buffer,
+		const Vector3i block_size,
+		const BakedLibrary &library,
+		const unsigned int material_count,
+		const bool bake_occlusion,
+		const float baked_occlusion_darkness,
+		const TintSampler tint_sampler,
+		const bool parallel
+) {
+	ZN_PROFILE_SCOPE();
+
+	MutexLock lock(cache.mutex);
+
+	if (dirty_area.generation != 0 && dirty_area.generation < cache.generation) {
+		// A task which took its dirty area after this one already updated the cache with more recent voxels. Reusing
+		// its sections or overwriting them would mix old and new voxels, so rebuild everything outside of the cache.
+		IncrementalCache &stale_cache = get_tls_parallel_sections();
+		ZN_ASSERT(&stale_cache != &cache);
+		generate_mesh_incremental(
+				stale_cache,
+				VoxelMesher::IncrementalCache::DirtyArea(),
+				out_arrays_per_material,
+				collision_surface,
+				type_buffer,
+				block_size,
+				library,
+				material_count,
+				bake_occlusion,
+				baked_occlusion_darkness,
+				tint_sampler,
+				parallel
+		);
+		return;
+	}
+
+	const unsigned int inner_size_y = block_size.y - 2 * VoxelMesherBlocky::PADDING;
+	const unsigned int section_count = math::ceildiv(inner_size_y, IncrementalCache::SECTION_HEIGHT);
+	const bool has_collision = collision_surface != nullptr;
+
+	const bool rebuild_all = dirty_area.full || !cache.valid || cache.block_size != block_size ||
+			cache.material_count != material_count || cache.has_collision != has_collision ||
+			cache.sections.size() != section_count;
+
+	if (rebuild_all) {
+		cache.sections.resize(section_count);
+		cache.block_size = block_size;
+		cache.material_count = material_count;
+		cache.has_collision = has_collision;
+	}
+
+	TempArenaScope temp_arena_scope(TempArena::get_for_current_thread());
+	Span<unsigned int> dirty_sections = temp_arena_scope.get_arena().allocate_span<unsigned int>(section_count);
+	unsigned int dirty_section_count = 0;
+
+	for (unsigned int section_index = 0; section_index < section_count; ++section_index) {
+		// Relative to the origin of the block
+		const unsigned int section_min_y = section_index * IncrementalCache::SECTION_HEIGHT;
+		const unsigned int section_max_y = math::min(section_min_y + IncrementalCache::SECTION_HEIGHT, inner_size_y);
+
+		const bool dirty = rebuild_all ||
+				(!dirty_area.box.is_empty() && dirty_area.box.position.y < static_cast<int>(section_max_y) &&
+				 dirty_area.box.position.y + dirty_area.box.size.y > static_cast<int>(section_min_y));
+
+		if (dirty) {
+			dirty_sections[dirty_section_count] = section_index;
+			++dirty_section_count;
+		}
+	}
+
+	auto build_section = [&](const uint32_t i) {
+		const unsigned int section_index = dirty_sections[i];
+		IncrementalCache::Section &section = cache.sections[section_index];
+
+		const unsigned int section_min_y = section_index * IncrementalCache::SECTION_HEIGHT;
+		const unsigned int section_max_y = math::min(section_min_y + IncrementalCache::SECTION_HEIGHT, inner_size_y);
+
+		section.arrays_per_material.resize(material_count);
+		for (VoxelMesherBlocky::Arrays &arrays : section.arrays_per_material) {
+			arrays.clear();
+		}
+		section.collision_surface.positions.clear();
+		section.collision_surface.indices.clear();
+
+		generate_mesh(
+				section.arrays_per_material,
+				has_collision ? &section.collision_surface : nullptr,
+				type_buffer,
+				block_size,
+				library,
+				bake_occlusion,
+				baked_occlusion_darkness,
+				tint_sampler,
+				false,
+				true,
+				section_min_y + VoxelMesherBlocky::PADDING,
+				section_max_y + VoxelMesherBlocky::PADDING
+		);
+	};
+
+	if (parallel) {
+		VoxelEngine::get_singleton().parallel_for(dirty_section_count, build_section);
+	} else {
+		for (unsigned int i = 0; i < dirty_section_count; ++i) {
+			build_section(i);
+		}
+	}
+
+	// Faces of cubes are never shared between voxels, so unlike smooth meshes, there are no vertices to weld where
+	// sections meet
+	for (const IncrementalCache::Section &section : cache.sections) {
+		for (unsigned int material_index = 0; material_index < material_count; ++material_index) {
+			append_arrays(out_arrays_per_material[material_index], section.arrays_per_material[material_index]);
+		}
+		if (has_collision) {
+			append_collision_surface(*collision_surface, section.collision_surface);
+		}
+	}
+
+	if (dirty_area.generation != 0) {
+		cache.generation = dirty_area.generation;
+	}
+	cache.valid = true;
 }
 
 bool is_empty(const StdVector<VoxelMesherBlocky::Arrays> &arrays_per_material) {
@@ -559,6 +1269,74 @@ void VoxelMesherBlocky::set_tint_mode(const VoxelMesherBlocky::TintMode new_mode
 	_parameters.tint_mode = new_mode;
 }
 
+void VoxelMesherBlocky::set_greedy_meshing_enabled(bool enable) {
+	RWLockWrite wlock(_parameters_lock);
+	_parameters.greedy_meshing = enable;
+}
+
+bool VoxelMesherBlocky::is_greedy_meshing_enabled() const {
+	RWLockRead rlock(_parameters_lock);
+	return _parameters.greedy_meshing;
+}
+
+void VoxelMesherBlocky::set_mesh_optimization_enabled(bool enabled) {
+	RWLockWrite wlock(_parameters_lock);
+	_parameters.mesh_optimization.enabled = enabled;
+}
+
+bool VoxelMesherBlocky::is_mesh_optimization_enabled() const {
+	RWLockRead rlock(_parameters_lock);
+	return _parameters.mesh_optimization.enabled;
+}
+
+void VoxelMesherBlocky::set_mesh_optimization_error_threshold(float threshold) {
+	RWLockWrite wlock(_parameters_lock);
+	_parameters.mesh_optimization.error_threshold = math::clamp(threshold, 0.f, 1.f);
+}
+
+float VoxelMesherBlocky::get_mesh_optimization_error_threshold() const {
+	RWLockRead rlock(_parameters_lock);
+	return _parameters.mesh_optimization.error_threshold;
+}
+
+void VoxelMesherBlocky::set_mesh_optimization_target_ratio(float ratio) {
+	RWLockWrite wlock(_parameters_lock);
+	_parameters.mesh_optimization.target_ratio = math::clamp(ratio, 0.f, 1.f);
+}
+
+float VoxelMesherBlocky::get_mesh_optimization_target_ratio() const {
+	RWLockRead rlock(_parameters_lock);
+	return _parameters.mesh_optimization.target_ratio;
+}
+
+void VoxelMesherBlocky::set_incremental_meshing_enabled(bool enabled) {
+	RWLockWrite wlock(_parameters_lock);
+	_parameters.incremental_meshing = enabled;
+}
+
+bool VoxelMesherBlocky::is_incremental_meshing_enabled() const {
+	RWLockRead rlock(_parameters_lock);
+	return _parameters.incremental_meshing;
+}
+
+void VoxelMesherBlocky::set_parallel_meshing_enabled(bool enabled) {
+	RWLockWrite wlock(_parameters_lock);
+	_parameters.parallel_meshing = enabled;
+}
+
+bool VoxelMesherBlocky::is_parallel_meshing_enabled() const {
+	RWLockRead rlock(_parameters_lock);
+	return _parameters.parallel_meshing;
+}
+
+std::shared_ptr<VoxelMesher::IncrementalCache> VoxelMesherBlocky::create_incremental_cache() const {
+	RWLockRead rlock(_parameters_lock);
+	if (!_parameters.incremental_meshing) {
+		return nullptr;
+	}
+	return make_shared_instance<blocky::IncrementalCache>();
+}
+
 void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::Input &input) {
 	const VoxelBuffer::ChannelId channel = VoxelBuffer::CHANNEL_TYPE;
 	Parameters params;
@@ -567,13 +1345,51 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 		params = _parameters;
 	}
 
+	if (!input.visual_hint) {
+		// Only the collision surface will be generated, and occlusion only affects vertex colors
+		params.bake_occlusion = false;
+	}
+
+	blocky::IncrementalCache *incremental_cache = nullptr;
+	if (input.incremental_cache != nullptr) {
+		incremental_cache = static_cast<blocky::IncrementalCache *>(input.incremental_cache);
+		// Greedy meshing merges sides across slices, LODs are not edited, and collision-only builds don't produce the
+		// render arrays sections are made of
+		if (!params.incremental_meshing || params.greedy_meshing || input.lod_index > 0 || !input.visual_hint) {
+			// This build won't update the cache, so the next incremental build has to start over
+			incremental_cache->invalidate();
+			incremental_cache = nullptr;
+		}
+	}
+
 	if (params.library.is_null()) {
 		// This may be a configuration warning, the mesh will be left empty.
 		// If it was an error it would spam unnecessarily in the editor as users set things up.
+		if (incremental_cache != nullptr) {
+			incremental_cache->invalidate();
+		}
 		return;
 	}
 	// ERR_FAIL_COND(params.library.is_null());
 
+	const VoxelBuffer &voxels = input.voxels;
+	const Vector3i block_size = voxels.get_size();
+
+	// Sections are independent, so they can be built by several threads. Greedy meshing merges sides across them.
+	bool parallel = false;
+	if (params.parallel_meshing && !params.greedy_meshing && input.visual_hint) {
+		const int inner_size_y = block_size.y - 2 * PADDING;
+		parallel = inner_size_y >= static_cast<int>(2 * blocky::IncrementalCache::SECTION_HEIGHT) &&
+				VoxelEngine::get_singleton().get_idle_thread_count() > 0;
+	}
+
+	VoxelMesher::IncrementalCache::DirtyArea dirty_area = input.incremental_dirty_area;
+	if (parallel && incremental_cache == nullptr) {
+		incremental_cache = &blocky::get_tls_parallel_sections();
+		// Fully dirty
+		dirty_area = VoxelMesher::IncrementalCache::DirtyArea();
+	}
+
 	Cache &cache = get_tls_cache();
 
 	StdVector<Arrays> &arrays_per_material = cache.arrays_per_material;
@@ -588,14 +1404,13 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 	}
 
 	// The technique is Culled faces.
-	// Could be improved with greedy meshing: https://0fps.net/2012/06/30/meshing-in-a-minecraft-game/
-	// However I don't feel it's worth it yet:
+	// Optionally, greedy meshing can be used on sides of cube-like models:
+	// https://0fps.net/2012/06/30/meshing-in-a-minecraft-game/
+	// It is not the default because:
 	// - Not so much gain for organic worlds with lots of texture variations
 	// - Works well with cubes but not with any shape
 	// - Slower
-	// => Could be implemented in a separate class?
-
-	const VoxelBuffer &voxels = input.voxels;
+	// - Textures from atlases need a shader to repeat on merged faces
 
 	// Iterate 3D padded data to extract voxel faces.
 	// This is the most intensive job in this class, so all required data should be as fit as possible.
@@ -610,6 +1425,16 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 		// TODO Handle edge case of uniform block with non-cubic voxels!
 		// If the type of voxel still produces geometry in this situation (which is an absurd use case but not an
 		// error), decompress into a backing array to still allow the use of the same algorithm.
+		if (incremental_cache != nullptr) {
+			incremental_cache->invalidate();
+		}
+		if (input.side_connectivity_hint) {
+			const uint32_t model_id = voxels.get_voxel(Vector3i(), channel);
+			RWLockRead lock(params.library->get_baked_data_rw_lock());
+			if (params.library->get_baked_data().is_opaque_cube(model_id)) {
+				output.side_connectivity = side_connectivity::NONE_CONNECTED;
+			}
+		}
 		return;
 
 	} else if (voxels.get_channel_compression(channel) != VoxelBuffer::COMPRESSION_NONE) {
@@ -625,7 +1450,6 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 		return;
 	}
 
-	const Vector3i block_size = voxels.get_size();
 	const VoxelBuffer::Depth channel_depth = voxels.get_channel_depth(channel);
 
 	VoxelMesher::Output::CollisionSurface *collision_surface = nullptr;
@@ -648,19 +1472,43 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 		const blocky::TintSampler tint_sampler =
 				blocky::TintSampler::create(voxels, static_cast<blocky::TintSampler::Mode>(params.tint_mode));
 
+		const unsigned int min_y = PADDING;
+		const unsigned int max_y = block_size.y - PADDING;
+
 		switch (channel_depth) {
 			case VoxelBuffer::DEPTH_8_BIT:
-				blocky::generate_mesh(
-						arrays_per_material,
-						collision_surface,
-						raw_channel,
-						block_size,
-						library_baked_data,
-						params.bake_occlusion,
-						baked_occlusion_darkness,
-						tint_sampler
-				);
-				if (input.lod_index > 0) {
+				if (incremental_cache != nullptr) {
+					blocky::generate_mesh_incremental(
+							*incremental_cache,
+							dirty_area,
+							arrays_per_material,
+							collision_surface,
+							raw_channel,
+							block_size,
+							library_baked_data,
+							material_count,
+							params.bake_occlusion,
+							baked_occlusion_darkness,
+							tint_sampler,
+							parallel
+					);
+				} else {
+					blocky::generate_mesh(
+							arrays_per_material,
+							collision_surface,
+							raw_channel,
+							block_size,
+							library_baked_data,
+							params.bake_occlusion,
+							baked_occlusion_darkness,
+							tint_sampler,
+							params.greedy_meshing,
+							input.visual_hint,
+							min_y,
+							max_y
+					);
+				}
+				if (input.lod_index > 0 && input.visual_hint) {
 					blocky::append_skirts(
 							raw_channel, block_size, arrays_per_material, library_baked_data, tint_sampler
 					);
@@ -669,23 +1517,47 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 
 			case VoxelBuffer::DEPTH_16_BIT: {
 				Span<const uint16_t> model_ids = raw_channel.reinterpret_cast_to<const uint16_t>();
-				blocky::generate_mesh(
-						arrays_per_material,
-						collision_surface,
-						model_ids,
-						block_size,
-						library_baked_data,
-						params.bake_occlusion,
-						baked_occlusion_darkness,
-						tint_sampler
-				);
-				if (input.lod_index > 0) {
+				if (incremental_cache != nullptr) {
+					blocky::generate_mesh_incremental(
+							*incremental_cache,
+							dirty_area,
+							arrays_per_material,
+							collision_surface,
+							model_ids,
+							block_size,
+							library_baked_data,
+							material_count,
+							params.bake_occlusion,
+							baked_occlusion_darkness,
+							tint_sampler,
+							parallel
+					);
+				} else {
+					blocky::generate_mesh(
+							arrays_per_material,
+							collision_surface,
+							model_ids,
+							block_size,
+							library_baked_data,
+							params.bake_occlusion,
+							baked_occlusion_darkness,
+							tint_sampler,
+							params.greedy_meshing,
+							input.visual_hint,
+							min_y,
+							max_y
+					);
+				}
+				if (input.lod_index > 0 && input.visual_hint) {
 					blocky::append_skirts(model_ids, block_size, arrays_per_material, library_baked_data, tint_sampler);
 				}
 			} break;
 
 			default:
 				ERR_PRINT("Unsupported voxel depth");
+				if (incremental_cache != nullptr) {
+					incremental_cache->invalidate();
+				}
 				return;
 		}
 	}
@@ -705,11 +1577,31 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 		}
 	}
 
+	if (params.mesh_optimization.enabled && input.visual_hint) {
+		ZN_PROFILE_SCOPE_NAMED("Mesh optimization");
+		// Simplification is only done on LODs, the first one is kept intact
+		const float target_ratio = input.lod_index > 0 ? params.mesh_optimization.target_ratio : 1.f;
+		// Vertices on the borders of the block are kept in place to avoid cracks with neighbors
+		const Vector3i block_size_without_padding =
+				input.voxels.get_size() - Vector3iUtil::create(get_minimum_padding() + get_maximum_padding());
+		const Vector3f border_size = to_vec3f(block_size_without_padding) * static_cast<float>(1 << input.lod_index);
+		for (unsigned int material_index = 0; material_index < material_count; ++material_index) {
+			blocky::optimize_arrays(
+					arrays_per_material[material_index],
+					target_ratio,
+					params.mesh_optimization.error_threshold,
+					border_size
+			);
+		}
+	}
+
 	// TODO Optimization: we could return a single byte array and use Mesh::add_surface down the line?
 	// That API does not seem to exist yet though.
 
+	bool has_tile_rects = false;
+
 	for (unsigned int material_index = 0; material_index < material_count; ++material_index) {
-		const Arrays &arrays = arrays_per_material[material_index];
+		Arrays &arrays = arrays_per_material[material_index];
 
 		if (arrays.positions.size() != 0) {
 			Array mesh_arrays;
@@ -739,6 +1631,14 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 					copy_to(tangents, to_span_const(arrays.tangents));
 					mesh_arrays[Mesh::ARRAY_TANGENT] = tangents;
 				}
+
+				if (arrays.tile_rects.size() > 0) {
+					blocky::fill_missing_tile_rects(arrays);
+					PackedFloat32Array tile_rects;
+					copy_to(tile_rects, to_span_const(arrays.tile_rects));
+					mesh_arrays[Mesh::ARRAY_CUSTOM0] = tile_rects;
+					has_tile_rects = true;
+				}
 			}
 
 			output.surfaces.push_back(Output::Surface());
@@ -752,6 +1652,13 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 		// }
 	}
 
+	if (input.side_connectivity_hint) {
+		RWLockRead lock(params.library->get_baked_data_rw_lock());
+		output.side_connectivity = blocky::compute_side_connectivity(
+				raw_channel, channel_depth, block_size, params.library->get_baked_data()
+		);
+	}
+
 	if (params.shadow_occluders_mask != 0 && !blocky::is_empty(arrays_per_material)) {
 		// TODO Candidate for temp allocator (maybe even stack allocator in this case?)
 		blocky::OccluderArrays occluder_arrays;
@@ -799,6 +1706,11 @@ void VoxelMesherBlocky::build(VoxelMesher::Output &output, const VoxelMesher::In
 	}
 
 	output.primitive_type = Mesh::PRIMITIVE_TRIANGLES;
+	// Only declare the custom format when a surface actually carries tile rects
+	if (has_tile_rects) {
+		output.mesh_flags |= (RenderingServer::ARRAY_CUSTOM_RGBA_FLOAT << Mesh::ARRAY_FORMAT_CUSTOM0_SHIFT);
+	}
+	apply_vertex_compression(output, input);
 }
 
 // Ref<Resource> VoxelMesherBlocky::duplicate(bool p_subresources) const {
@@ -895,6 +1807,44 @@ void VoxelMesherBlocky::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_tint_mode", "mode"), &VoxelMesherBlocky::set_tint_mode);
 	ClassDB::bind_method(D_METHOD("get_tint_mode"), &VoxelMesherBlocky::get_tint_mode);
 
+	ClassDB::bind_method(
+			D_METHOD("set_greedy_meshing_enabled", "enable"), &VoxelMesherBlocky::set_greedy_meshing_enabled
+	);
+	ClassDB::bind_method(D_METHOD("is_greedy_meshing_enabled"), &VoxelMesherBlocky::is_greedy_meshing_enabled);
+
+	ClassDB::bind_method(
+			D_METHOD("set_mesh_optimization_enabled", "enabled"), &VoxelMesherBlocky::set_mesh_optimization_enabled
+	);
+	ClassDB::bind_method(D_METHOD("is_mesh_optimization_enabled"), &VoxelMesherBlocky::is_mesh_optimization_enabled);
+
+	ClassDB::bind_method(
+			D_METHOD("set_mesh_optimization_error_threshold", "threshold"),
+			&VoxelMesherBlocky::set_mesh_optimization_error_threshold
+	);
+	ClassDB::bind_method(
+			D_METHOD("get_mesh_optimization_error_threshold"), &VoxelMesherBlocky::get_mesh_optimization_error_threshold
+	);
+
+	ClassDB::bind_method(
+			D_METHOD("set_mesh_optimization_target_ratio", "ratio"),
+			&VoxelMesherBlocky::set_mesh_optimization_target_ratio
+	);
+	ClassDB::bind_method(
+			D_METHOD("get_mesh_optimization_target_ratio"), &VoxelMesherBlocky::get_mesh_optimization_target_ratio
+	);
+
+	ClassDB::bind_method(
+			D_METHOD("set_incremental_meshing_enabled", "enabled"), &VoxelMesherBlocky::set_incremental_meshing_enabled
+	);
+	ClassDB::bind_method(
+			D_METHOD("is_incremental_meshing_enabled"), &VoxelMesherBlocky::is_incremental_meshing_enabled
+	);
+
+	ClassDB::bind_method(
+			D_METHOD("set_parallel_meshing_enabled", "enabled"), &VoxelMesherBlocky::set_parallel_meshing_enabled
+	);
+	ClassDB::bind_method(D_METHOD("is_parallel_meshing_enabled"), &VoxelMesherBlocky::is_parallel_meshing_enabled);
+
 	ADD_PROPERTY(
 			PropertyInfo(
 					Variant::OBJECT,
@@ -922,6 +1872,42 @@ void VoxelMesherBlocky::_bind_methods() {
 			"get_tint_mode"
 	);
 
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "greedy_meshing_enabled"),
+			"set_greedy_meshing_enabled",
+			"is_greedy_meshing_enabled"
+	);
+
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "incremental_meshing_enabled"),
+			"set_incremental_meshing_enabled",
+			"is_incremental_meshing_enabled"
+	);
+
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "parallel_meshing_enabled"),
+			"set_parallel_meshing_enabled",
+			"is_parallel_meshing_enabled"
+	);
+
+	ADD_GROUP("Mesh optimization", "mesh_optimization_");
+
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "mesh_optimization_enabled"),
+			"set_mesh_optimization_enabled",
+			"is_mesh_optimization_enabled"
+	);
+	ADD_PROPERTY(
+			PropertyInfo(Variant::FLOAT, "mesh_optimization_error_threshold", PROPERTY_HINT_RANGE, "0,1,0.001"),
+			"set_mesh_optimization_error_threshold",
+			"get_mesh_optimization_error_threshold"
+	);
+	ADD_PROPERTY(
+			PropertyInfo(Variant::FLOAT, "mesh_optimization_target_ratio", PROPERTY_HINT_RANGE, "0,1,0.01"),
+			"set_mesh_optimization_target_ratio",
+			"get_mesh_optimization_target_ratio"
+	);
+
 	ADD_GROUP("Shadow Occluders", "shadow_occluder_");
 
 #define ADD_SHADOW_OCCLUDER_PROPERTY(m_name, m_flag)                                                                   \
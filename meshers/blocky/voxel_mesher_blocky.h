@@ -4,6 +4,7 @@
 #include "../../util/godot/classes/mesh.h"
 #include "../../util/math/color.h"
 #include "../../util/thread/rw_lock.h"
+#include "../mesh_optimization.h"
 #include "../voxel_mesher.h"
 #include "blocky_tint_sampler.h"
 #include "voxel_blocky_library_base.h"
@@ -55,6 +56,26 @@ public:
 	TintMode get_tint_mode() const;
 	void set_tint_mode(const TintMode new_mode);
 
+	void set_greedy_meshing_enabled(bool enable);
+	bool is_greedy_meshing_enabled() const;
+
+	void set_mesh_optimization_enabled(bool enabled);
+	bool is_mesh_optimization_enabled() const;
+
+	void set_mesh_optimization_error_threshold(float threshold);
+	float get_mesh_optimization_error_threshold() const;
+
+	void set_mesh_optimization_target_ratio(float ratio);
+	float get_mesh_optimization_target_ratio() const;
+
+	void set_incremental_meshing_enabled(bool enabled);
+	bool is_incremental_meshing_enabled() const;
+
+	void set_parallel_meshing_enabled(bool enabled);
+	bool is_parallel_meshing_enabled() const;
+
+	std::shared_ptr<IncrementalCache> create_incremental_cache() const override;
+
 	void build(VoxelMesher::Output &output, const VoxelMesher::Input &input) override;
 
 	// TODO GDX: Resource::duplicate() cannot be overriden (while it can in modules).
@@ -82,6 +103,9 @@ public:
 		StdVector<Vector3f> positions;
 		StdVector<Vector3f> normals;
 		StdVector<Vector2f> uvs;
+		// Only used with greedy meshing. 4 floats per vertex: origin (xy) and size (zw) of the texture atlas tile
+		// covered by the vertex's UVs. A size of zero means UVs are not meant to be wrapped.
+		StdVector<float> tile_rects;
 		StdVector<Color> colors;
 		StdVector<int> indices;
 		StdVector<float> tangents;
@@ -90,6 +114,7 @@ public:
 			positions.clear();
 			normals.clear();
 			uvs.clear();
+			tile_rects.clear();
 			colors.clear();
 			indices.clear();
 			tangents.clear();
@@ -114,6 +139,10 @@ private:
 		uint8_t shadow_occluders_mask = 0;
 		Ref<VoxelBlockyLibraryBase> library;
 		TintMode tint_mode = TINT_NONE;
+		bool greedy_meshing = false;
+		mesh_optimization::Params mesh_optimization;
+		bool incremental_meshing = false;
+		bool parallel_meshing = false;
 	};
 
 	struct Cache {
@@ -130,6 +159,35 @@ private:
 
 namespace blocky {
 
+// Geometry of the previous build of a block, split in slices along the Y axis, so that changes only rebuild slices they
+// intersect.
+class IncrementalCache : public VoxelMesher::IncrementalCache {
+public:
+	static const unsigned int SECTION_HEIGHT = 8;
+
+	struct Section {
+		StdVector<VoxelMesherBlocky::Arrays> arrays_per_material;
+		VoxelMesher::Output::CollisionSurface collision_surface;
+	};
+
+	// Forces the next build to rebuild all sections
+	void invalidate() {
+		MutexLock lock(mutex);
+		valid = false;
+	}
+
+	// Locked while a build uses the cache, because several tasks may mesh the same block at the same time
+	Mutex mutex;
+	StdVector<Section> sections;
+	Vector3i block_size;
+	unsigned int material_count = 0;
+	// Generation of the most recent dirty area sections were built with. Builds with an older one must not write
+	// their sections, since they were made from older voxels.
+	uint32_t generation = 0;
+	bool has_collision = false;
+	bool valid = false;
+};
+
 inline bool is_face_visible_regardless_of_shape(const BakedModel &vt, const BakedModel &other_vt) {
 	// TODO Maybe we could get rid of `empty` here and instead set `culls_neighbors` to false during baking
 	return other_vt.empty || (other_vt.transparency_index > vt.transparency_index) || !other_vt.culls_neighbors;
@@ -9,6 +9,7 @@
 #include "../../util/godot/core/packed_arrays.h"
 #include "../../util/godot/core/string.h"
 #include "../../util/math/conv.h"
+#include "../../util/math/funcs.h"
 #include "../../util/profiling.h"
 #include "../../util/string/format.h"
 
@@ -733,6 +734,47 @@ Ref<Image> make_greedy_atlas(
 	return image;
 }
 
+// Welds, simplifies (if `target_ratio` is lower than 1) and reorders vertices of the given arrays.
+void optimize_arrays(
+		VoxelMesherCubes::Arrays &arrays,
+		const float target_ratio,
+		const float error_threshold,
+		const Vector3f border_size
+) {
+	if (arrays.indices.size() == 0) {
+		return;
+	}
+
+	FixedArray<mesh_optimization::VertexStream, 3> streams;
+	unsigned int stream_count = 0;
+	streams[stream_count++] = { arrays.normals.data(), sizeof(Vector3f) };
+	if (arrays.colors.size() > 0) {
+		streams[stream_count++] = { arrays.colors.data(), sizeof(Color) };
+	}
+	if (arrays.uvs.size() > 0) {
+		streams[stream_count++] = { arrays.uvs.data(), sizeof(Vector2f) };
+	}
+
+	const mesh_optimization::Result result = mesh_optimization::optimize(
+			to_span(arrays.indices),
+			to_span(arrays.positions),
+			to_span_const(streams, stream_count),
+			target_ratio,
+			error_threshold,
+			border_size
+	);
+
+	arrays.positions.resize(result.vertex_count);
+	arrays.normals.resize(result.vertex_count);
+	if (arrays.colors.size() > 0) {
+		arrays.colors.resize(result.vertex_count);
+	}
+	if (arrays.uvs.size() > 0) {
+		arrays.uvs.resize(result.vertex_count);
+	}
+	arrays.indices.resize(result.index_count);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 VoxelMesherCubes::VoxelMesherCubes() {
@@ -998,6 +1040,26 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 		}
 	}
 
+	if (params.mesh_optimization.enabled) {
+		ZN_PROFILE_SCOPE_NAMED("Mesh optimization");
+		// Simplification is only done on LODs, the first one is kept intact.
+		// It is also skipped when colors are stored in an atlas, because each quad then has its own UV rectangle.
+		const float target_ratio =
+				input.lod_index > 0 && !params.store_colors_in_texture ? params.mesh_optimization.target_ratio : 1.f;
+		// Vertices on the borders of the block are kept in place to avoid cracks with neighbors
+		const Vector3i block_size_without_padding =
+				input.voxels.get_size() - Vector3iUtil::create(get_minimum_padding() + get_maximum_padding());
+		const Vector3f border_size = to_vec3f(block_size_without_padding) * static_cast<float>(1 << input.lod_index);
+		for (unsigned int material_index = 0; material_index < MATERIAL_COUNT; ++material_index) {
+			optimize_arrays(
+					cache.arrays_per_material[material_index],
+					target_ratio,
+					params.mesh_optimization.error_threshold,
+					border_size
+			);
+		}
+	}
+
 	// TODO We could return a single byte array and use Mesh::add_surface down the line?
 
 	for (unsigned int material_index = 0; material_index < MATERIAL_COUNT; ++material_index) {
@@ -1047,12 +1109,11 @@ void VoxelMesherCubes::build(VoxelMesher::Output &output, const VoxelMesher::Inp
 
 	output.primitive_type = Mesh::PRIMITIVE_TRIANGLES;
 	output.atlas_image = atlas_image;
-
-	// if (params.store_colors_in_texture) {
-	// 	// Don't compress UVs, they need to be precise. Not doing this causes noticeable offsets.
-	// 	output.compression_flags = Mesh::ARRAY_COMPRESS_FLAGS_BASE & ~Mesh::ARRAY_FORMAT_TEX_UV;
-	// }
-	// output.compression_flags = Mesh::ARRAY_COMPRESS_COLOR;
+	if (atlas_image.is_null()) {
+		// Don't compress when colors are stored in an atlas. UVs need to be precise, and Godot's attribute
+		// compression would quantize them to 16 bits, causing noticeable offsets.
+		apply_vertex_compression(output, input);
+	}
 }
 
 void VoxelMesherCubes::set_greedy_meshing_enabled(bool enable) {
@@ -1065,6 +1126,36 @@ bool VoxelMesherCubes::is_greedy_meshing_enabled() const {
 	return _parameters.greedy_meshing;
 }
 
+void VoxelMesherCubes::set_mesh_optimization_enabled(bool enabled) {
+	RWLockWrite wlock(_parameters_lock);
+	_parameters.mesh_optimization.enabled = enabled;
+}
+
+bool VoxelMesherCubes::is_mesh_optimization_enabled() const {
+	RWLockRead rlock(_parameters_lock);
+	return _parameters.mesh_optimization.enabled;
+}
+
+void VoxelMesherCubes::set_mesh_optimization_error_threshold(float threshold) {
+	RWLockWrite wlock(_parameters_lock);
+	_parameters.mesh_optimization.error_threshold = math::clamp(threshold, 0.f, 1.f);
+}
+
+float VoxelMesherCubes::get_mesh_optimization_error_threshold() const {
+	RWLockRead rlock(_parameters_lock);
+	return _parameters.mesh_optimization.error_threshold;
+}
+
+void VoxelMesherCubes::set_mesh_optimization_target_ratio(float ratio) {
+	RWLockWrite wlock(_parameters_lock);
+	_parameters.mesh_optimization.target_ratio = math::clamp(ratio, 0.f, 1.f);
+}
+
+float VoxelMesherCubes::get_mesh_optimization_target_ratio() const {
+	RWLockRead rlock(_parameters_lock);
+	return _parameters.mesh_optimization.target_ratio;
+}
+
 void VoxelMesherCubes::set_palette(Ref<VoxelColorPalette> palette) {
 	RWLockWrite wlock(_parameters_lock);
 	_parameters.palette = palette;
@@ -1235,6 +1326,21 @@ void VoxelMesherCubes::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_greedy_meshing_enabled", "enable"), &Self::set_greedy_meshing_enabled);
 	ClassDB::bind_method(D_METHOD("is_greedy_meshing_enabled"), &Self::is_greedy_meshing_enabled);
 
+	ClassDB::bind_method(D_METHOD("set_mesh_optimization_enabled", "enabled"), &Self::set_mesh_optimization_enabled);
+	ClassDB::bind_method(D_METHOD("is_mesh_optimization_enabled"), &Self::is_mesh_optimization_enabled);
+
+	ClassDB::bind_method(
+			D_METHOD("set_mesh_optimization_error_threshold", "threshold"), &Self::set_mesh_optimization_error_threshold
+	);
+	ClassDB::bind_method(
+			D_METHOD("get_mesh_optimization_error_threshold"), &Self::get_mesh_optimization_error_threshold
+	);
+
+	ClassDB::bind_method(
+			D_METHOD("set_mesh_optimization_target_ratio", "ratio"), &Self::set_mesh_optimization_target_ratio
+	);
+	ClassDB::bind_method(D_METHOD("get_mesh_optimization_target_ratio"), &Self::get_mesh_optimization_target_ratio);
+
 	ClassDB::bind_method(D_METHOD("set_palette", "palette"), &Self::set_palette);
 	ClassDB::bind_method(D_METHOD("get_palette"), &Self::get_palette);
 
@@ -1294,6 +1400,24 @@ void VoxelMesherCubes::_bind_methods() {
 			"_get_transparent_material"
 	);
 
+	ADD_GROUP("Mesh optimization", "mesh_optimization_");
+
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "mesh_optimization_enabled"),
+			"set_mesh_optimization_enabled",
+			"is_mesh_optimization_enabled"
+	);
+	ADD_PROPERTY(
+			PropertyInfo(Variant::FLOAT, "mesh_optimization_error_threshold", PROPERTY_HINT_RANGE, "0,1,0.001"),
+			"set_mesh_optimization_error_threshold",
+			"get_mesh_optimization_error_threshold"
+	);
+	ADD_PROPERTY(
+			PropertyInfo(Variant::FLOAT, "mesh_optimization_target_ratio", PROPERTY_HINT_RANGE, "0,1,0.01"),
+			"set_mesh_optimization_target_ratio",
+			"get_mesh_optimization_target_ratio"
+	);
+
 	BIND_ENUM_CONSTANT(MATERIAL_OPAQUE);
 	BIND_ENUM_CONSTANT(MATERIAL_TRANSPARENT);
 	BIND_ENUM_CONSTANT(MATERIAL_COUNT);
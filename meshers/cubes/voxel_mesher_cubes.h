@@ -4,6 +4,7 @@
 #include "../../util/math/vector2f.h"
 #include "../../util/math/vector3f.h"
 #include "../../util/thread/rw_lock.h"
+#include "../mesh_optimization.h"
 #include "../voxel_mesher.h"
 #include "voxel_color_palette.h"
 
@@ -45,6 +46,15 @@ public:
 	void set_greedy_meshing_enabled(bool enable);
 	bool is_greedy_meshing_enabled() const;
 
+	void set_mesh_optimization_enabled(bool enabled);
+	bool is_mesh_optimization_enabled() const;
+
+	void set_mesh_optimization_error_threshold(float threshold);
+	float get_mesh_optimization_error_threshold() const;
+
+	void set_mesh_optimization_target_ratio(float ratio);
+	float get_mesh_optimization_target_ratio() const;
+
 	void set_color_mode(ColorMode mode);
 	ColorMode get_color_mode() const;
 
@@ -125,6 +135,7 @@ private:
 		Ref<VoxelColorPalette> palette;
 		bool greedy_meshing = true;
 		bool store_colors_in_texture = false;
+		mesh_optimization::Params mesh_optimization;
 	};
 
 	struct Cache {
@@ -5,6 +5,7 @@
 #include "../util/godot/classes/mesh.h"
 #include "../util/io/log.h"
 #include "../util/math/conv.h"
+#include "../util/memory/temp_arena.h"
 #include "../util/profiling.h"
 // #include "../util/string/format.h" // Debug
 #include "../engine/voxel_engine.h"
@@ -57,6 +58,29 @@ CubicAreaInfo get_cubic_area_info_from_size(unsigned int size) {
 	return { edge_size, mesh_block_size_factor, anchor_buffer_index };
 }
 
+// Returns true if all blocks of the cube surrounding the area we want to create a mesh from are present and have the
+// same uniform value in the given channel. This is checked without reading individual voxels. In that case, the
+// padded area can be represented without copying anything.
+bool try_get_uniform_channel_value(
+		Span<const std::shared_ptr<VoxelBuffer>> blocks,
+		const unsigned int channel_index,
+		uint64_t &out_value
+) {
+	for (unsigned int i = 0; i < blocks.size(); ++i) {
+		const VoxelBuffer *block = blocks[i].get();
+		if (block == nullptr || !block->is_uniform(channel_index)) {
+			return false;
+		}
+		const uint64_t value = block->get_voxel(Vector3i(), channel_index);
+		if (i == 0) {
+			out_value = value;
+		} else if (value != out_value) {
+			return false;
+		}
+	}
+	return blocks.size() > 0;
+}
+
 // Takes a list of blocks and interprets it as a cube of blocks centered around the area we want to create a mesh from.
 // Voxels from central blocks are copied, and part of side blocks are also copied so we get a temporary buffer
 // which includes enough neighbors for the mesher to avoid doing bound checks.
@@ -135,6 +159,18 @@ void copy_block_and_neighbors(
 				)
 		);
 
+		// Channels having the same value everywhere don't need to be copied. That's frequent with blocks fully
+		// above or below ground, in which case the destination doesn't even allocate memory.
+		SmallVector<uint8_t, VoxelBuffer::MAX_CHANNELS> channels_to_copy;
+		for (const uint8_t channel_index : channels) {
+			uint64_t uniform_value;
+			if (try_get_uniform_channel_value(blocks.to_const(), channel_index, uniform_value)) {
+				dst.fill(uniform_value, channel_index);
+			} else {
+				channels_to_copy.push_back(channel_index);
+			}
+		}
+
 		// Using ZXY as convention to reconstruct positions with thread locking consistency
 		unsigned int block_index = 0;
 		for (int z = -1; z < area_info.edge_size - 1; ++z) {
@@ -151,7 +187,7 @@ void copy_block_and_neighbors(
 					const Vector3i src_min = min_pos - offset;
 					const Vector3i src_max = max_pos - offset;
 
-					for (const uint8_t channel_index : channels) {
+					for (const uint8_t channel_index : channels_to_copy) {
 						dst.copy_channel_from(*src, src_min, src_max, Vector3i(), channel_index);
 					}
 
@@ -322,6 +358,9 @@ void MeshBlockTask::run(zylann::ThreadedTaskContext &ctx) {
 	ZN_DSTACK();
 	ZN_PROFILE_SCOPE();
 	ZN_ASSERT(meshing_dependency != nullptr);
+
+	// Scratch memory used by meshers is released when the task ends
+	TempArenaScope temp_arena_scope(TempArena::get_for_current_thread());
 #ifdef DEBUG_ENABLED
 	ZN_ASSERT_RETURN_MSG(
 			meshing_dependency->mesher.is_valid(),
@@ -346,6 +385,11 @@ void MeshBlockTask::run(zylann::ThreadedTaskContext &ctx) {
 		ZN_ASSERT(data != nullptr);
 		const VoxelFormat format = data->get_format();
 		format.configure_buffer(_voxels);
+
+		if (incremental_cache != nullptr) {
+			// Taken before voxels are gathered, so changes made after that are left to the next task
+			_incremental_dirty_area = incremental_cache->take_dirty_area();
+		}
 	}
 
 #ifdef VOXEL_ENABLE_GPU
@@ -512,8 +556,12 @@ void MeshBlockTask::build_mesh() {
 		lod_index,
 		collision_hint,
 		lod_hint,
-		// TODO Gathering detail texture information is not always necessary
-		true // detail_texture_hint
+		// Detail textures are only rendered for visual meshes
+		require_visual, // detail_texture_hint
+		incremental_cache.get(),
+		_incremental_dirty_area,
+		side_connectivity_hint,
+		require_visual || keep_render_attributes // visual_hint
 	};
 	mesher->build(_surfaces_output, input);
 
@@ -597,6 +645,19 @@ void MeshBlockTask::build_mesh() {
 		_has_mesh_resource = false;
 	}
 
+	// This is checked separately from graphics, because servers running headless or with the Compatibility renderer
+	// can't build meshes in threads, yet they still benefit from building collision shapes in threads.
+	if (collision_hint && VoxelEngine::get_singleton().is_threaded_physics_shape_building_enabled()) {
+		// Creating a concave shape also builds its BVH, which is where most of the time goes. That used to be the
+		// main cost of mesh updates on the main thread, especially on servers which only need collisions.
+		ZN_PROFILE_SCOPE_NAMED("Collision shape");
+		_collision_shape = make_collision_shape_from_mesher_output(_surfaces_output, **mesher);
+		_has_collision_shape = true;
+
+	} else {
+		_has_collision_shape = false;
+	}
+
 	_has_run = true;
 }
 
@@ -638,6 +699,8 @@ void MeshBlockTask::apply_result() {
 			o.shadow_occluder_mesh = _shadow_occluder_mesh;
 			o.mesh_material_indices = std::move(_mesh_material_indices);
 			o.has_mesh_resource = _has_mesh_resource;
+			o.collision_shape = _collision_shape;
+			o.has_collision_shape = _has_collision_shape;
 			o.visual_was_required = require_visual;
 #ifdef VOXEL_ENABLE_SMOOTH_MESHING
 			o.detail_textures = _detail_textures;
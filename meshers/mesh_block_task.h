@@ -60,8 +60,14 @@ public:
 	uint8_t blocks_count = 0;
 	// If true, a rendering mesh resource will be created if possible.
 	bool require_visual = true;
-	// If true, a collision mesh is required if possible
+	// If true, surfaces keep all their rendering attributes even when no visual is required, because something else
+	// uses them (for example VoxelInstancer needs normals). Otherwise, meshers may only output what colliders need.
+	bool keep_render_attributes = false;
+	// If true, a collision mesh is required if possible. The collision shape will also be built if the engine allows
+	// building physics shapes in threads.
 	bool collision_hint = false;
+	// If true, the mesher will be asked which sides of the block are connected, for occlusion culling.
+	bool side_connectivity_hint = false;
 	// If true, the mesh will be used in a context with LOD, which might require a few extra things in the way it is
 	// built
 	bool lod_hint = false;
@@ -74,6 +80,8 @@ public:
 	PriorityDependency priority_dependency;
 	std::shared_ptr<MeshingDependency> meshing_dependency;
 	std::shared_ptr<VoxelData> data;
+	// Optional, see `VoxelMesher::IncrementalCache`
+	std::shared_ptr<VoxelMesher::IncrementalCache> incremental_cache;
 #ifdef VOXEL_ENABLE_SMOOTH_MESHING
 	DetailRenderingSettings detail_texture_settings;
 #endif
@@ -90,13 +98,16 @@ private:
 	bool _has_run = false;
 	bool _too_far = false;
 	bool _has_mesh_resource = false;
+	bool _has_collision_shape = false;
 #ifdef VOXEL_ENABLE_GPU
 	uint8_t _stage = 0;
 #endif
 	VoxelBuffer _voxels;
 	VoxelMesher::Output _surfaces_output;
+	VoxelMesher::IncrementalCache::DirtyArea _incremental_dirty_area;
 	Ref<Mesh> _mesh;
 	Ref<Mesh> _shadow_occluder_mesh;
+	Ref<Shape3D> _collision_shape;
 	StdVector<uint16_t> _mesh_material_indices; // Indexed by mesh surface
 #ifdef VOXEL_ENABLE_SMOOTH_MESHING
 	std::shared_ptr<DetailTextureOutput> _detail_textures;
@@ -0,0 +1,243 @@
+#include "mesh_optimization.h"
+#include "../thirdparty/meshoptimizer/meshoptimizer.h"
+#include "../util/containers/small_vector.h"
+#include "../util/errors.h"
+#include "../util/memory/temp_arena.h"
+#include "../util/profiling.h"
+
+namespace zylann::voxel::mesh_optimization {
+
+namespace {
+
+// Returned by MeshOptimizer remap functions for vertices that are not referenced by any triangle
+static constexpr unsigned int NO_VERTEX = ~0u;
+
+// Applies a remap table to indices and all vertex arrays
+void remap_mesh(
+		Span<unsigned int> indices,
+		Span<Vector3f> positions,
+		Span<const VertexStream> streams,
+		Span<const unsigned int> remap
+) {
+	// TODO See build script about the `zylannmeshopt::` namespace
+	zylannmeshopt::meshopt_remapIndexBuffer(indices.data(), indices.data(), indices.size(), remap.data());
+	zylannmeshopt::meshopt_remapVertexBuffer(
+			positions.data(), positions.data(), positions.size(), sizeof(Vector3f), remap.data()
+	);
+	for (const VertexStream &stream : streams) {
+		zylannmeshopt::meshopt_remapVertexBuffer(
+				stream.data, stream.data, positions.size(), stream.item_size, remap.data()
+		);
+	}
+}
+
+inline bool is_on_border(const Vector3f p, const Vector3f border_size) {
+	// Positions of voxel meshes are multiples of voxel sizes on borders, so a small tolerance is enough
+	const float tolerance = 0.0001f;
+	return Math::abs(p.x) < tolerance || Math::abs(p.y) < tolerance || Math::abs(p.z) < tolerance ||
+			Math::abs(p.x - border_size.x) < tolerance || Math::abs(p.y - border_size.y) < tolerance ||
+			Math::abs(p.z - border_size.z) < tolerance;
+}
+
+// Simplifies triangles in place and returns the new index count. Vertices must have been welded before.
+unsigned int simplify(
+		Span<unsigned int> indices,
+		Span<const Vector3f> positions,
+		const float target_ratio,
+		const float error_threshold,
+		const Vector3f border_size
+) {
+	ZN_PROFILE_SCOPE_NAMED("meshopt_simplify");
+
+	TempArenaScope temp_arena_scope(TempArena::get_for_current_thread());
+	TempArena &arena = temp_arena_scope.get_arena();
+
+	const unsigned int vertex_count = positions.size();
+	const unsigned int index_count = indices.size();
+
+	// The simplifier only looks at positions. Vertices are welded by position only, so faces having different
+	// attributes are connected. Otherwise, any vertex where more than two of them meet would be locked, and flat
+	// areas made of quads with different UVs could not be simplified at all.
+	Span<unsigned int> position_remap = arena.allocate_span<unsigned int>(vertex_count);
+	const unsigned int position_count = zylannmeshopt::meshopt_generateVertexRemap(
+			position_remap.data(), indices.data(), index_count, positions.data(), vertex_count, sizeof(Vector3f)
+	);
+
+	// Room is left for duplicates of border positions
+	Span<Vector3f> simplify_positions = arena.allocate_span<Vector3f>(2 * position_count);
+	zylannmeshopt::meshopt_remapVertexBuffer(
+			simplify_positions.data(), positions.data(), vertex_count, sizeof(Vector3f), position_remap.data()
+	);
+	Span<unsigned int> simplify_indices = arena.allocate_span<unsigned int>(index_count);
+	zylannmeshopt::meshopt_remapIndexBuffer(
+			simplify_indices.data(), indices.data(), index_count, position_remap.data()
+	);
+
+	// The version of MeshOptimizer we use has no option to lock vertices. However, it never moves a vertex sharing
+	// its position with another vertex that has no open edge. Adding an unused duplicate of a position locks it,
+	// which keeps the outer faces of the block intact, so seams with neighbor blocks don't open.
+	unsigned int simplify_vertex_count = position_count;
+	for (unsigned int i = 0; i < position_count; ++i) {
+		if (is_on_border(simplify_positions[i], border_size)) {
+			simplify_positions[simplify_vertex_count] = simplify_positions[i];
+			++simplify_vertex_count;
+		}
+	}
+
+	Span<unsigned int> simplified_indices = arena.allocate_span<unsigned int>(index_count);
+	const unsigned int target_index_count = target_ratio * index_count;
+	float lod_error = 0.f;
+
+	const unsigned int simplified_index_count = zylannmeshopt::meshopt_simplify(
+			simplified_indices.data(),
+			simplify_indices.data(),
+			index_count,
+			&simplify_positions[0].x,
+			simplify_vertex_count,
+			sizeof(Vector3f),
+			target_index_count,
+			error_threshold,
+			&lod_error
+	);
+
+	// Remaining triangles refer to positions. Each corner then picks, among vertices having that position, the one
+	// whose original faces are best aligned with the new triangle, so attributes such as normals and UVs of flat
+	// faces are preserved.
+
+	// Orientation of original faces around each vertex
+	Span<Vector3f> vertex_face_normals = arena.allocate_span<Vector3f>(vertex_count);
+	vertex_face_normals.fill(Vector3f());
+	for (unsigned int i = 0; i < index_count; i += 3) {
+		const unsigned int i0 = indices[i];
+		const unsigned int i1 = indices[i + 1];
+		const unsigned int i2 = indices[i + 2];
+		const Vector3f n = math::cross(positions[i1] - positions[i0], positions[i2] - positions[i0]);
+		vertex_face_normals[i0] += n;
+		vertex_face_normals[i1] += n;
+		vertex_face_normals[i2] += n;
+	}
+	for (Vector3f &n : vertex_face_normals) {
+		n = math::normalized(n);
+	}
+
+	// Linked lists of vertices sharing the same position
+	Span<unsigned int> first_wedges = arena.allocate_span<unsigned int>(position_count);
+	first_wedges.fill(NO_VERTEX);
+	Span<unsigned int> next_wedges = arena.allocate_span<unsigned int>(vertex_count);
+	for (unsigned int vi = 0; vi < vertex_count; ++vi) {
+		const unsigned int pi = position_remap[vi];
+		if (pi == NO_VERTEX) {
+			next_wedges[vi] = NO_VERTEX;
+			continue;
+		}
+		next_wedges[vi] = first_wedges[pi];
+		first_wedges[pi] = vi;
+	}
+
+	for (unsigned int i = 0; i < simplified_index_count; i += 3) {
+		const Vector3f p0 = simplify_positions[simplified_indices[i]];
+		const Vector3f p1 = simplify_positions[simplified_indices[i + 1]];
+		const Vector3f p2 = simplify_positions[simplified_indices[i + 2]];
+		const Vector3f face_normal = math::normalized(math::cross(p1 - p0, p2 - p0));
+
+		for (unsigned int c = 0; c < 3; ++c) {
+			const unsigned int pi = simplified_indices[i + c];
+			unsigned int best_vi = first_wedges[pi];
+			float best_alignment = -2.f;
+			for (unsigned int vi = best_vi; vi != NO_VERTEX; vi = next_wedges[vi]) {
+				const float alignment = math::dot(vertex_face_normals[vi], face_normal);
+				if (alignment > best_alignment) {
+					best_alignment = alignment;
+					best_vi = vi;
+				}
+			}
+			indices[i + c] = best_vi;
+		}
+	}
+
+	return simplified_index_count;
+}
+
+} // namespace
+
+Result optimize(
+		Span<int32_t> p_indices,
+		Span<Vector3f> positions,
+		Span<const VertexStream> streams,
+		const float target_ratio,
+		const float error_threshold,
+		const Vector3f border_size
+) {
+	ZN_PROFILE_SCOPE();
+
+	ZN_ASSERT(target_ratio >= 0.f && target_ratio <= 1.f);
+	ZN_ASSERT(p_indices.size() % 3 == 0);
+
+	if (p_indices.size() == 0) {
+		return { 0, 0 };
+	}
+
+	Span<unsigned int> indices = p_indices.reinterpret_cast_to<unsigned int>();
+
+	TempArenaScope temp_arena_scope(TempArena::get_for_current_thread());
+	TempArena &arena = temp_arena_scope.get_arena();
+
+	Span<unsigned int> remap = arena.allocate_span<unsigned int>(positions.size());
+	unsigned int vertex_count = positions.size();
+
+	// Weld
+	{
+		ZN_PROFILE_SCOPE_NAMED("Weld");
+
+		SmallVector<zylannmeshopt::meshopt_Stream, 8> meshopt_streams;
+		meshopt_streams.push_back({ positions.data(), sizeof(Vector3f), sizeof(Vector3f) });
+		for (const VertexStream &stream : streams) {
+			meshopt_streams.push_back({ stream.data, stream.item_size, stream.item_size });
+		}
+
+		vertex_count = zylannmeshopt::meshopt_generateVertexRemapMulti(
+				remap.data(),
+				indices.data(),
+				indices.size(),
+				positions.size(),
+				meshopt_streams.data(),
+				meshopt_streams.size()
+		);
+
+		remap_mesh(indices, positions, streams, remap);
+	}
+
+	unsigned int index_count = indices.size();
+
+	// Simplify
+	if (target_ratio < 1.f) {
+		index_count = simplify(indices, positions.sub(0, vertex_count), target_ratio, error_threshold, border_size);
+	}
+
+	indices = indices.sub(0, index_count);
+
+	// Reorder
+	{
+		ZN_PROFILE_SCOPE_NAMED("Reorder");
+
+		zylannmeshopt::meshopt_optimizeVertexCache(indices.data(), indices.data(), index_count, vertex_count);
+		// Threshold recommended by the library, allowing to degrade vertex cache efficiency by 5%
+		zylannmeshopt::meshopt_optimizeOverdraw(
+				indices.data(), indices.data(), index_count, &positions[0].x, vertex_count, sizeof(Vector3f), 1.05f
+		);
+
+		// Only the first vertices are still relevant after welding
+		const unsigned int welded_vertex_count = vertex_count;
+
+		// Also removes vertices not used anymore after simplification
+		vertex_count = zylannmeshopt::meshopt_optimizeVertexFetchRemap(
+				remap.data(), indices.data(), index_count, welded_vertex_count
+		);
+
+		remap_mesh(indices, positions.sub(0, welded_vertex_count), streams, remap);
+	}
+
+	return { vertex_count, index_count };
+}
+
+} // namespace zylann::voxel::mesh_optimization
@@ -0,0 +1,48 @@
+#ifndef VOXEL_MESH_OPTIMIZATION_H
+#define VOXEL_MESH_OPTIMIZATION_H
+
+#include "../util/containers/span.h"
+#include "../util/math/vector3f.h"
+#include <cstdint>
+
+namespace zylann::voxel::mesh_optimization {
+
+struct Params {
+	bool enabled = false;
+	float error_threshold = 0.005;
+	// Only used for LODs above 0
+	float target_ratio = 0.25;
+};
+
+// Vertex attribute array to remap along with positions. `data` must contain as many items as there are positions.
+struct VertexStream {
+	void *data;
+	size_t item_size;
+};
+
+struct Result {
+	unsigned int vertex_count;
+	unsigned int index_count;
+};
+
+// Optimizes an indexed triangle mesh in place:
+// - Vertices having identical attributes are welded first, so faces built separately become connected.
+// - If `target_ratio` is lower than 1, triangles are simplified. Simplification works on vertices welded by position
+//   only, and each remaining corner then uses the attributes of the original vertex whose faces are best aligned with
+//   the new triangle. Vertices lying on the faces of the box going from the origin to `border_size` are locked, so
+//   chunk edges are preserved.
+// - Triangles are reordered to improve vertex cache efficiency and reduce overdraw, then vertices are reordered to
+//   follow triangles.
+// Vertex and index counts can only decrease. Arrays should be resized afterward to the returned counts.
+Result optimize(
+		Span<int32_t> indices,
+		Span<Vector3f> positions,
+		Span<const VertexStream> streams,
+		const float target_ratio,
+		const float error_threshold,
+		const Vector3f border_size
+);
+
+} // namespace zylann::voxel::mesh_optimization
+
+#endif // VOXEL_MESH_OPTIMIZATION_H
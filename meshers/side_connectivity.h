@@ -0,0 +1,50 @@
+#ifndef VOXEL_SIDE_CONNECTIVITY_H
+#define VOXEL_SIDE_CONNECTIVITY_H
+
+#include "../constants/cube_tables.h"
+#include "../util/errors.h"
+#include <cstdint>
+
+// Tells which pairs of sides of a block can see each other through non-opaque voxels. There are 15 pairs, so the
+// information fits in 15 bits. Used to cull blocks that are hidden behind opaque ones, such as caves.
+namespace zylann::voxel::side_connectivity {
+
+static constexpr unsigned int PAIR_COUNT = 15;
+static constexpr uint16_t ALL_CONNECTED = (1 << PAIR_COUNT) - 1;
+static constexpr uint16_t NONE_CONNECTED = 0;
+
+inline unsigned int get_pair_index(unsigned int side_a, unsigned int side_b) {
+	ZN_ASSERT(side_a != side_b);
+	ZN_ASSERT(side_a < Cube::SIDE_COUNT && side_b < Cube::SIDE_COUNT);
+	if (side_a > side_b) {
+		const unsigned int temp = side_a;
+		side_a = side_b;
+		side_b = temp;
+	}
+	// Pairs are packed in order (0,1), (0,2)...(0,5), (1,2)...(4,5)
+	return (side_a * (11 - side_a)) / 2 + (side_b - side_a - 1);
+}
+
+inline bool are_connected(const uint16_t connectivity, const unsigned int side_a, const unsigned int side_b) {
+	return (connectivity & (1 << get_pair_index(side_a, side_b))) != 0;
+}
+
+// Converts a mask of sides touched by the same region of empty space into the pairs it connects.
+inline uint16_t get_connectivity_from_sides_mask(const uint8_t sides_mask) {
+	uint16_t connectivity = 0;
+	for (unsigned int side_a = 0; side_a < Cube::SIDE_COUNT; ++side_a) {
+		if ((sides_mask & (1 << side_a)) == 0) {
+			continue;
+		}
+		for (unsigned int side_b = side_a + 1; side_b < Cube::SIDE_COUNT; ++side_b) {
+			if ((sides_mask & (1 << side_b)) != 0) {
+				connectivity |= (1 << get_pair_index(side_a, side_b));
+			}
+		}
+	}
+	return connectivity;
+}
+
+} // namespace zylann::voxel::side_connectivity
+
+#endif // VOXEL_SIDE_CONNECTIVITY_H
@@ -4,6 +4,7 @@
 #include "../../util/godot/core/sort_array.h"
 #include "../../util/math/conv.h"
 #include "../../util/math/funcs.h"
+#include "../../util/memory/temp_arena.h"
 #include "../../util/profiling.h"
 #include "transvoxel_materials_mixel4.h"
 #include "transvoxel_materials_null.h"
@@ -181,6 +182,127 @@ inline float get_isolevel<float>() {
 	return 0.f;
 }
 
+// Packs the sign of voxels into bitmasks, one row of bits per column of voxels along the Y axis.
+// Rows are stored in the same order as voxels (ZX), each taking `words_per_row` words.
+// Only columns within `[min_pos, max_pos]` on the X and Z axes are computed.
+template <typename TSdf>
+void compute_sign_rows(
+		Span<const TSdf> sdf_data,
+		const Vector3i block_size,
+		const Vector3i min_pos,
+		const Vector3i max_pos,
+		const TSdf isolevel,
+		const unsigned int words_per_row,
+		Span<uint64_t> rows
+) {
+	ZN_PROFILE_SCOPE();
+
+	ZN_ASSERT(rows.size() == static_cast<size_t>(block_size.x * block_size.z * words_per_row));
+
+	for (int z = min_pos.z; z <= max_pos.z; ++z) {
+		for (int x = min_pos.x; x <= max_pos.x; ++x) {
+			const unsigned int row_index = x + z * block_size.x;
+			const unsigned int data_index = Vector3iUtil::get_zxy_index(Vector3i(x, 0, z), block_size);
+			const TSdf *column = &sdf_data[data_index];
+			uint64_t *row = &rows[row_index * words_per_row];
+
+			for (unsigned int word_index = 0; word_index < words_per_row; ++word_index) {
+				const int begin_y = word_index * 64;
+				const int end_y = math::min(begin_y + 64, block_size.y);
+				uint64_t bits = 0;
+				// Branchless so compilers can vectorize it.
+				// The chosen comparison here is very important. This relates to case selections where 4 samples are
+				// equal to the isolevel and 4 others are above or below:
+				// In one of these two cases, there has to be a surface to extract, otherwise no surface will be
+				// allowed to appear if it happens to line up with integer coordinates.
+				// If we used `<` instead of `>`, it would appear to work, but would break those edge cases.
+				// `>` is chosen because it must match the comparison we do with case selection (in Transvoxel it is
+				// inverted).
+				for (int y = begin_y; y < end_y; ++y) {
+					bits |= static_cast<uint64_t>(column[y] > isolevel) << (y - begin_y);
+				}
+				row[word_index] = bits;
+			}
+		}
+	}
+}
+
+// Iterates cells of a column along the Y axis in which the sign of voxels changes, using rows of packed signs.
+class SignChangeCellIterator {
+public:
+	// `row000` is the row of signs at the origin of the column of cells. Others are found from it.
+	SignChangeCellIterator(
+			const uint64_t *row000,
+			const unsigned int words_per_row,
+			const unsigned int row_stride_z,
+			const int min_y,
+			const int max_y
+	) :
+			_row000(row000),
+			_words_per_row(words_per_row),
+			_row_stride_z(row_stride_z),
+			_min_y(min_y),
+			_max_y(max_y) {
+		_word_index = 0;
+		_cells = get_cells(0);
+	}
+
+	// Gets the Y coordinate of the next cell. Returns false if there are no more cells.
+	inline bool next(int &out_y) {
+		while (_cells == 0) {
+			++_word_index;
+			if (_word_index >= _words_per_row) {
+				return false;
+			}
+			_cells = get_cells(_word_index);
+		}
+		out_y = _word_index * 64 + math::count_trailing_zeros_64(_cells);
+		// Clear lowest bit
+		_cells &= _cells - 1;
+		return true;
+	}
+
+private:
+	uint64_t get_cells(const unsigned int word_index) const {
+		uint64_t any = 0;
+		uint64_t all = ~uint64_t(0);
+		accumulate_row_pairs(_row000, word_index, any, all);
+		accumulate_row_pairs(_row000 + _words_per_row, word_index, any, all);
+		accumulate_row_pairs(_row000 + _row_stride_z, word_index, any, all);
+		accumulate_row_pairs(_row000 + _row_stride_z + _words_per_row, word_index, any, all);
+		return any & ~all & get_range_mask(word_index);
+	}
+
+	// Gets bits of a row where each bit `i` tells if voxels `i` and `i + 1` are both set (`all`), or if at least one
+	// of them is set (`any`).
+	inline void accumulate_row_pairs(const uint64_t *row, const unsigned int word_index, uint64_t &any, uint64_t &all)
+			const {
+		const uint64_t lo = row[word_index];
+		const uint64_t next = word_index + 1 < _words_per_row ? row[word_index + 1] : 0;
+		const uint64_t hi = (lo >> 1) | (next << 63);
+		any |= lo | hi;
+		all &= lo & hi;
+	}
+
+	// Gets a mask of bits within `[min_y, max_y)`, relative to the start of the given word.
+	inline uint64_t get_range_mask(const unsigned int word_index) const {
+		const int word_begin = word_index * 64;
+		const int lo = math::clamp(_min_y - word_begin, 0, 64);
+		const int hi = math::clamp(_max_y - word_begin, 0, 64);
+		const uint64_t below_hi = hi == 64 ? ~uint64_t(0) : (uint64_t(1) << hi) - 1;
+		const uint64_t below_lo = lo == 64 ? ~uint64_t(0) : (uint64_t(1) << lo) - 1;
+		return below_hi & ~below_lo;
+	}
+
+	const uint64_t *_row000;
+	const unsigned int _words_per_row;
+	const unsigned int _row_stride_z;
+	const int _min_y;
+	const int _max_y;
+	unsigned int _word_index;
+	uint64_t _cells;
+};
+
 // This function is template so we avoid branches and checks when sampling voxels
 template <typename TSdf, typename TMaterialProcessor>
 void build_regular_mesh(
@@ -191,7 +313,9 @@ void build_regular_mesh(
 		Cache &cache,
 		MeshArrays &output,
 		StdVector<CellInfo> *cell_info,
-		const float edge_clamp_margin
+		const float edge_clamp_margin,
+		const int cells_min_y,
+		const int cells_max_y
 ) {
 	ZN_PROFILE_SCOPE();
 
@@ -222,38 +346,32 @@ void build_regular_mesh(
 	// Get direct representation of the isolevel (not always zero since we are not using signed integers yet)
 	const TSdf isolevel = get_isolevel<TSdf>();
 
-	// Iterate all cells with padding (expected to be neighbors)
+	// Most cells don't cross the isolevel, so we must figure this out as fast as possible. Signs of voxels are packed
+	// into bitmasks first, then combined to find cells where they differ. Only those cells are polygonized.
+	const unsigned int words_per_row = (block_size_with_padding.y + 63) / 64;
+	TempArenaScope temp_arena_scope(TempArena::get_for_current_thread());
+	Span<uint64_t> sign_rows = temp_arena_scope.get_arena().allocate_span<uint64_t>(
+			block_size_with_padding.x * block_size_with_padding.z * words_per_row
+	);
+	compute_sign_rows(sdf_data, block_size_with_padding, min_pos, max_pos, isolevel, words_per_row, sign_rows);
+
+	// Iterate all cells with padding (expected to be neighbors).
+	// The order is ZXY to match how voxels are laid out in memory. Vertex reuse only depends on cells having lower
+	// coordinates, so it remains valid.
 	Vector3i pos;
 	for (pos.z = min_pos.z; pos.z < max_pos.z; ++pos.z) {
-		for (pos.y = min_pos.y; pos.y < max_pos.y; ++pos.y) {
-			// TODO Optimization: change iteration to be ZXY? (Data is laid out with Y as deepest coordinate)
-			unsigned int data_index =
-					Vector3iUtil::get_zxy_index(Vector3i(min_pos.x, pos.y, pos.z), block_size_with_padding);
-
-			for (pos.x = min_pos.x; pos.x < max_pos.x; ++pos.x, data_index += block_size_with_padding.y) {
-				{
-					// The chosen comparison here is very important. This relates to case selections where 4 samples
-					// are equal to the isolevel and 4 others are above or below:
-					// In one of these two cases, there has to be a surface to extract, otherwise no surface will be
-					// allowed to appear if it happens to line up with integer coordinates.
-					// If we used `<` instead of `>`, it would appear to work, but would break those edge cases.
-					// `>` is chosen because it must match the comparison we do with case selection (in Transvoxel
-					// it is inverted).
-					const bool s = sdf_data[data_index] > isolevel;
-
-					if ( //
-							(sdf_data[data_index + n010] > isolevel) == s &&
-							(sdf_data[data_index + n100] > isolevel) == s &&
-							(sdf_data[data_index + n110] > isolevel) == s &&
-							(sdf_data[data_index + n001] > isolevel) == s &&
-							(sdf_data[data_index + n011] > isolevel) == s &&
-							(sdf_data[data_index + n101] > isolevel) == s &&
-							(sdf_data[data_index + n111] > isolevel) == s) {
-						// Not crossing the isolevel, this cell won't produce any geometry.
-						// We must figure this out as fast as possible, because it will happen a lot.
-						continue;
-					}
-				}
+		for (pos.x = min_pos.x; pos.x < max_pos.x; ++pos.x) {
+			const unsigned int row_index = pos.x + pos.z * block_size_with_padding.x;
+			SignChangeCellIterator cell_it(
+					&sign_rows[row_index * words_per_row],
+					words_per_row,
+					block_size_with_padding.x * words_per_row,
+					cells_min_y,
+					cells_max_y
+			);
+
+			while (cell_it.next(pos.y)) {
+				const unsigned int data_index = Vector3iUtil::get_zxy_index(pos, block_size_with_padding);
 
 				//    6-------7
 				//   /|      /|
@@ -325,9 +443,10 @@ void build_regular_mesh(
 				// the preceding cells needed for vertex reuse may not exist.
 				// In these cases, we allow new vertex creation on additional edges of a cell.
 				// While iterating through the cells in a block, a 3-bit mask is maintained whose bits indicate
-				// whether corresponding bits in a direction code are valid
+				// whether corresponding bits in a direction code are valid.
+				// When only a range of Y is polygonized, cells below it are not available either.
 				const uint8_t direction_validity_mask = (pos.x > min_pos.x ? 1 : 0) |
-						((pos.y > min_pos.y ? 1 : 0) << 1) | ((pos.z > min_pos.z ? 1 : 0) << 2);
+						((pos.y > cells_min_y ? 1 : 0) << 1) | ((pos.z > min_pos.z ? 1 : 0) << 2);
 
 				const uint8_t regular_cell_class_index = tables::get_regular_cell_class(case_code);
 				const tables::RegularCellData &regular_cell_data =
@@ -595,8 +714,8 @@ void build_regular_mesh(
 					cell_info->push_back(CellInfo{ pos - min_pos, static_cast<uint8_t>(effective_triangle_count) });
 				}
 
-			} // x
-		} // y
+			} // y
+		} // x
 	} // z
 }
 
@@ -1089,21 +1208,22 @@ void build_transition_mesh(
 	} // for y
 }
 
+// If the channel is uniform, the returned data is allocated from the arena.
 template <typename T>
-Span<const T> get_or_decompress_channel(const VoxelBuffer &voxels, StdVector<T> &backing_buffer, unsigned int channel) {
+Span<const T> get_or_decompress_channel(const VoxelBuffer &voxels, TempArena &arena, unsigned int channel) {
 	//
 	ZN_ASSERT_RETURN_V(
 			voxels.get_channel_depth(channel) == VoxelBuffer::get_depth_from_size(sizeof(T)), Span<const T>()
 	);
 
 	if (voxels.get_channel_compression(channel) == VoxelBuffer::COMPRESSION_UNIFORM) {
-		backing_buffer.resize(Vector3iUtil::get_volume_u64(voxels.get_size()));
+		Span<T> backing_buffer = arena.allocate_span<T>(Vector3iUtil::get_volume_u64(voxels.get_size()));
 		const T v = voxels.get_voxel(Vector3i(), channel);
 		// TODO Could use a fast fill using 8-byte blocks or intrinsics?
 		for (unsigned int i = 0; i < backing_buffer.size(); ++i) {
 			backing_buffer[i] = v;
 		}
-		return to_span_const(backing_buffer);
+		return backing_buffer;
 
 	} else {
 		Span<const uint8_t> data_bytes;
@@ -1112,6 +1232,37 @@ Span<const T> get_or_decompress_channel(const VoxelBuffer &voxels, StdVector<T>
 	}
 }
 
+PreparedTexturingData prepare_texturing_data(
+		const VoxelBuffer &voxels,
+		const TexturingMode texturing_mode,
+		TempArena &arena
+) {
+	ZN_PROFILE_SCOPE();
+
+	PreparedTexturingData data;
+	if (texturing_mode != TEXTURES_MIXEL4_S4) {
+		return data;
+	}
+
+	// From this point we know SDF is not uniform so it has an allocated buffer,
+	// but it might have uniform indices or weights so we need to ensure there is a backing buffer.
+	DefaultTextureIndicesData default_texture_indices;
+	const materials::mixel4::TextureIndicesData indices_data =
+			materials::mixel4::get_texture_indices_data(voxels, VoxelBuffer::CHANNEL_INDICES, default_texture_indices);
+	data.weights = get_or_decompress_channel<uint16_t>(voxels, arena, VoxelBuffer::CHANNEL_WEIGHTS);
+
+	// Presorting allows most cells to skip texture selection
+	if (indices_data.buffer.size() != 0 && indices_data.buffer.size() == data.weights.size()) {
+		Span<uint16_t> sorted_indices = arena.allocate_span<uint16_t>(indices_data.buffer.size());
+		Span<uint16_t> sorted_weights = arena.allocate_span<uint16_t>(indices_data.buffer.size());
+		materials::mixel4::presort_texture_data(indices_data.buffer, data.weights, sorted_indices, sorted_weights);
+		data.sorted_indices = sorted_indices;
+		data.sorted_weights = sorted_weights;
+	}
+
+	return data;
+}
+
 // Presence of zeroes in samples occurs more often when precision is scarce
 // (8-bit, scaled SDF, or slow gradients).
 // This causes two symptoms:
@@ -1152,18 +1303,6 @@ Span<const Sdf_T> apply_zero_sdf_fix(Span<const Sdf_T> p_sdf_data) {
 	return to_span_const(sdf_data);
 }*/
 
-// TODO Candidate for temp allocator
-StdVector<uint16_t> &get_tls_weights_backing_buffer_u16() {
-	thread_local StdVector<uint16_t> tls_weights_backing_buffer_u16;
-	return tls_weights_backing_buffer_u16;
-}
-
-// TODO Candidate for temp allocator
-StdVector<uint8_t> &get_tls_u8_conversion_buffer() {
-	static thread_local StdVector<uint8_t> tls_conversion_backing_buffer;
-	return tls_conversion_backing_buffer;
-}
-
 template <typename TMaterialProcessor>
 inline void build_regular_mesh_dispatch_sd(
 		const VoxelBuffer &voxels,
@@ -1173,7 +1312,9 @@ inline void build_regular_mesh_dispatch_sd(
 		Cache &cache,
 		MeshArrays &output,
 		StdVector<CellInfo> *cell_infos,
-		const float edge_clamp_margin
+		const float edge_clamp_margin,
+		const int cells_min_y,
+		const int cells_max_y
 ) {
 	Span<const uint8_t> sdf_data_raw;
 	ZN_ASSERT(voxels.get_channel_as_bytes_read_only(sdf_channel, sdf_data_raw) == true);
@@ -1191,7 +1332,9 @@ inline void build_regular_mesh_dispatch_sd(
 					cache,
 					output,
 					cell_infos,
-					edge_clamp_margin
+					edge_clamp_margin,
+					cells_min_y,
+					cells_max_y
 			);
 		} break;
 
@@ -1205,7 +1348,9 @@ inline void build_regular_mesh_dispatch_sd(
 					cache,
 					output,
 					cell_infos,
-					edge_clamp_margin
+					edge_clamp_margin,
+					cells_min_y,
+					cells_max_y
 			);
 		} break;
 
@@ -1222,7 +1367,9 @@ inline void build_regular_mesh_dispatch_sd(
 					cache,
 					output,
 					cell_infos,
-					edge_clamp_margin
+					edge_clamp_margin,
+					cells_min_y,
+					cells_max_y
 			);
 		} break;
 
@@ -1250,11 +1397,17 @@ DefaultTextureIndicesData build_regular_mesh(
 		MeshArrays &output,
 		StdVector<CellInfo> *cell_infos,
 		const float edge_clamp_margin,
-		const bool textures_ignore_air_voxels
+		const bool textures_ignore_air_voxels,
+		const int cells_min_y,
+		const int cells_max_y,
+		const PreparedTexturingData *prepared_texturing_data
 ) {
 	ZN_PROFILE_SCOPE();
 	// From this point, we expect the buffer to contain allocated data in the relevant channels.
 
+	// Scratch buffers are released when meshing ends
+	TempArenaScope temp_arena_scope(TempArena::get_for_current_thread());
+
 	const unsigned int voxels_count = Vector3iUtil::get_volume_u64(voxels.get_size());
 
 	output.clear();
@@ -1272,7 +1425,9 @@ DefaultTextureIndicesData build_regular_mesh(
 					cache,
 					output,
 					cell_infos,
-					edge_clamp_margin
+					edge_clamp_margin,
+					cells_min_y,
+					cells_max_y
 			);
 			break;
 
@@ -1282,17 +1437,19 @@ DefaultTextureIndicesData build_regular_mesh(
 			{
 				ZN_PROFILE_SCOPE_NAMED("Prepare material info");
 
-				// From this point we know SDF is not uniform so it has an allocated buffer,
-				// but it might have uniform indices or weights so we need to ensure there is a backing buffer.
+				PreparedTexturingData local_texturing_data;
+				if (prepared_texturing_data == nullptr) {
+					local_texturing_data =
+							prepare_texturing_data(voxels, texturing_mode, temp_arena_scope.get_arena());
+					prepared_texturing_data = &local_texturing_data;
+				}
+
 				voxel_material_indices = materials::mixel4::get_texture_indices_data(
 						voxels, VoxelBuffer::CHANNEL_INDICES, default_texture_indices
 				);
-				voxel_material_weights.u16_data = get_or_decompress_channel(
-						voxels,
-						// TODO Candidate for Temp allocator
-						get_tls_weights_backing_buffer_u16(),
-						VoxelBuffer::CHANNEL_WEIGHTS
-				);
+				voxel_material_indices.sorted_buffer = prepared_texturing_data->sorted_indices;
+				voxel_material_indices.sorted_weights = prepared_texturing_data->sorted_weights;
+				voxel_material_weights.u16_data = prepared_texturing_data->weights;
 				ZN_ASSERT_RETURN_V(voxel_material_weights.u16_data.size() == voxels_count, default_texture_indices);
 			}
 			build_regular_mesh_dispatch_sd(
@@ -1308,14 +1465,16 @@ DefaultTextureIndicesData build_regular_mesh(
 					cache,
 					output,
 					cell_infos,
-					edge_clamp_margin
+					edge_clamp_margin,
+					cells_min_y,
+					cells_max_y
 			);
 		} break;
 
 		case TEXTURES_SINGLE_S4: {
 			const materials::single::VoxelMaterialIndices voxel_material_indices =
 					materials::single::get_material_indices_from_vb(
-							voxels, VoxelBuffer::CHANNEL_INDICES, get_tls_u8_conversion_buffer()
+							voxels, VoxelBuffer::CHANNEL_INDICES, temp_arena_scope.get_arena()
 					);
 			if (voxel_material_indices.is_uniform) {
 				default_texture_indices.indices[0] = voxel_material_indices.uniform_value;
@@ -1329,7 +1488,9 @@ DefaultTextureIndicesData build_regular_mesh(
 					cache,
 					output,
 					cell_infos,
-					edge_clamp_margin
+					edge_clamp_margin,
+					cells_min_y,
+					cells_max_y
 			);
 		} break;
 
@@ -1337,7 +1498,7 @@ DefaultTextureIndicesData build_regular_mesh(
 		case TEXTURES_SINGLE_S2: {
 			const materials::single::VoxelMaterialIndices voxel_material_indices =
 					materials::single::get_material_indices_from_vb(
-							voxels, VoxelBuffer::CHANNEL_INDICES, get_tls_u8_conversion_buffer()
+							voxels, VoxelBuffer::CHANNEL_INDICES, temp_arena_scope.get_arena()
 					);
 			if (voxel_material_indices.is_uniform) {
 				default_texture_indices.indices[0] = voxel_material_indices.uniform_value;
@@ -1351,7 +1512,9 @@ DefaultTextureIndicesData build_regular_mesh(
 					cache,
 					output,
 					cell_infos,
-					edge_clamp_margin
+					edge_clamp_margin,
+					cells_min_y,
+					cells_max_y
 			);
 		} break;
 #endif
@@ -1442,11 +1605,15 @@ void build_transition_mesh(
 		MeshArrays &output,
 		DefaultTextureIndicesData default_texture_indices_data,
 		const float edge_clamp_margin,
-		const bool textures_ignore_air_voxels
+		const bool textures_ignore_air_voxels,
+		const PreparedTexturingData *prepared_texturing_data
 ) {
 	ZN_PROFILE_SCOPE();
 	// From this point, we expect the buffer to contain allocated data in the relevant channels.
 
+	// Scratch buffers are released when meshing ends
+	TempArenaScope temp_arena_scope(TempArena::get_for_current_thread());
+
 	const unsigned int voxels_count = Vector3iUtil::get_volume_u64(voxels.get_size());
 
 	switch (texturing_mode) {
@@ -1478,14 +1645,21 @@ void build_transition_mesh(
 						voxels, VoxelBuffer::CHANNEL_INDICES, default_texture_indices_data
 				);
 			}
-			weights_data.u16_data = get_or_decompress_channel(
-					voxels,
-					// TODO Candidate for Temp allocator
-					get_tls_weights_backing_buffer_u16(),
-					VoxelBuffer::CHANNEL_WEIGHTS
-			);
+
+			PreparedTexturingData local_texturing_data;
+			if (prepared_texturing_data == nullptr) {
+				local_texturing_data = prepare_texturing_data(voxels, texturing_mode, temp_arena_scope.get_arena());
+				prepared_texturing_data = &local_texturing_data;
+			}
+
+			weights_data.u16_data = prepared_texturing_data->weights;
 			ZN_ASSERT_RETURN(weights_data.u16_data.size() == voxels_count);
 
+			if (indices_data.buffer.size() != 0) {
+				indices_data.sorted_buffer = prepared_texturing_data->sorted_indices;
+				indices_data.sorted_weights = prepared_texturing_data->sorted_weights;
+			}
+
 			build_transition_mesh_dispatch_sd(
 					voxels,
 					sdf_channel,
@@ -1507,7 +1681,7 @@ void build_transition_mesh(
 				voxel_material_indices.uniform_value = default_texture_indices_data.indices[0];
 			} else {
 				voxel_material_indices = materials::single::get_material_indices_from_vb(
-						voxels, VoxelBuffer::CHANNEL_INDICES, get_tls_u8_conversion_buffer()
+						voxels, VoxelBuffer::CHANNEL_INDICES, temp_arena_scope.get_arena()
 				);
 			}
 			build_transition_mesh_dispatch_sd(
@@ -1530,7 +1704,7 @@ void build_transition_mesh(
 				voxel_material_indices.uniform_value = default_texture_indices_data.indices[0];
 			} else {
 				voxel_material_indices = materials::single::get_material_indices_from_vb(
-						voxels, VoxelBuffer::CHANNEL_INDICES, get_tls_u8_conversion_buffer()
+						voxels, VoxelBuffer::CHANNEL_INDICES, temp_arena_scope.get_arena()
 				);
 			}
 			build_transition_mesh_dispatch_sd(
@@ -3,6 +3,7 @@
 
 #include "../../storage/voxel_buffer.h"
 #include "../../util/containers/fixed_array.h"
+#include "../../util/containers/span.h"
 #include "../../util/math/color.h"
 #include "../../util/math/vector2f.h"
 #include "../../util/math/vector3f.h"
@@ -10,6 +11,10 @@
 
 #include <vector>
 
+namespace zylann {
+class TempArena;
+}
+
 namespace zylann::voxel::transvoxel {
 
 // How many extra voxels are needed towards the negative axes
@@ -169,6 +174,28 @@ struct CellInfo {
 	uint32_t triangle_count;
 };
 
+// Texturing data of a block, prepared once so it can be shared read-only by all builds of parts of that block (slabs of
+// the regular mesh, transition meshes), instead of each of them preparing it again. Only used with
+// `TEXTURES_MIXEL4_S4`.
+struct PreparedTexturingData {
+	// Packed weights of every voxel
+	Span<const uint16_t> weights;
+	// Indices and weights of every voxel, with indices sorted. Empty if indices are uniform.
+	// See `materials::mixel4::presort_texture_data`.
+	Span<const uint16_t> sorted_indices;
+	Span<const uint16_t> sorted_weights;
+};
+
+// Memory that needs to be allocated is taken from `arena`, so results remain valid until it is rewound.
+PreparedTexturingData prepare_texturing_data(
+		const VoxelBuffer &voxels,
+		const TexturingMode texturing_mode,
+		TempArena &arena
+);
+
+// Only cells within `[cells_min_y, cells_max_y)` along the Y axis are polygonized, in padded coordinates. This allows
+// to build separate parts of the same block in parallel. Vertices on the plane separating two parts are then duplicated
+// in each of them.
 DefaultTextureIndicesData build_regular_mesh(
 		const VoxelBuffer &voxels,
 		const unsigned int sdf_channel,
@@ -178,7 +205,11 @@ DefaultTextureIndicesData build_regular_mesh(
 		MeshArrays &output,
 		StdVector<CellInfo> *cell_infos,
 		const float edge_clamp_margin,
-		const bool textures_ignore_air_voxels
+		const bool textures_ignore_air_voxels,
+		const int cells_min_y,
+		const int cells_max_y,
+		// Optional. If null, texturing data is prepared by the function.
+		const PreparedTexturingData *prepared_texturing_data
 );
 
 void build_transition_mesh(
@@ -191,7 +222,9 @@ void build_transition_mesh(
 		MeshArrays &output,
 		DefaultTextureIndicesData default_texture_indices_data,
 		const float edge_clamp_margin,
-		const bool textures_ignore_air_voxels
+		const bool textures_ignore_air_voxels,
+		// Optional. If null, texturing data is prepared by the function.
+		const PreparedTexturingData *prepared_texturing_data
 );
 
 } // namespace zylann::voxel::transvoxel
@@ -4,6 +4,8 @@
 #include "../../storage/mixel4.h"
 #include "../../util/containers/fixed_array.h"
 #include "../../util/containers/std_vector.h"
+#include "../../util/errors.h"
+#include "../../util/profiling.h"
 #include "transvoxel.h"
 #include "transvoxel_materials_common.h"
 
@@ -29,7 +31,7 @@ CellTextureDatas<NVoxels> select_textures_4_per_voxel(
 		const unsigned int case_code
 ) {
 	// TODO Optimization: this function takes almost half of the time when polygonizing non-empty cells.
-	// I wonder how it can be optimized further?
+	// Cells where all voxels use the same textures avoid it by using presorted data (see `presort_texture_data`).
 
 	struct IndexAndWeight {
 		unsigned int index;
@@ -114,11 +116,128 @@ CellTextureDatas<NVoxels> select_textures_4_per_voxel(
 struct TextureIndicesData {
 	// Texture indices for each voxel
 	Span<const uint16_t> buffer;
+	// Optional, same as `buffer` and weights but with indices sorted in ascending order, and weights moved
+	// accordingly. Voxels having duplicate indices are set to 0, which is not a valid sorted value. See
+	// `presort_texture_data`.
+	Span<const uint16_t> sorted_buffer;
+	Span<const uint16_t> sorted_weights;
 	// Used if the buffer is empty
 	FixedArray<uint8_t, 4> default_indices;
 	uint32_t packed_default_indices;
 };
 
+// Rewrites indices and weights of every voxel such that indices are in ascending order, which is the form cells expect
+// them to be. Done once per block, so cells whose voxels all use the same textures don't have to select and sort them.
+inline void presort_texture_data(
+		Span<const uint16_t> src_indices,
+		Span<const uint16_t> src_weights,
+		Span<uint16_t> dst_indices,
+		Span<uint16_t> dst_weights
+) {
+	ZN_PROFILE_SCOPE();
+	ZN_ASSERT_RETURN(src_indices.size() == src_weights.size());
+	ZN_ASSERT_RETURN(dst_indices.size() == src_indices.size());
+	ZN_ASSERT_RETURN(dst_weights.size() == src_indices.size());
+
+	// Neighbor voxels very often have the same indices, so we only sort when they change
+	uint16_t prev_src_indices = 0;
+	uint16_t prev_dst_indices = 0;
+	// Bit offsets from which every sorted weight has to be taken
+	FixedArray<uint8_t, 4> weight_shifts;
+	fill(weight_shifts, uint8_t(0));
+
+	for (unsigned int i = 0; i < src_indices.size(); ++i) {
+		const uint16_t encoded_indices = src_indices[i];
+
+		if (encoded_indices != prev_src_indices || i == 0) {
+			const FixedArray<uint8_t, 4> indices =
+					zylann::voxel::mixel4::decode_indices_from_packed_u16(encoded_indices);
+
+			FixedArray<uint8_t, 4> order;
+			for (unsigned int j = 0; j < order.size(); ++j) {
+				order[j] = j;
+			}
+			// Insertion sort, there are only 4 items
+			for (unsigned int j = 1; j < order.size(); ++j) {
+				const uint8_t o = order[j];
+				unsigned int k = j;
+				for (; k > 0 && indices[order[k - 1]] > indices[o]; --k) {
+					order[k] = order[k - 1];
+				}
+				order[k] = o;
+			}
+
+			const bool distinct = indices[order[0]] < indices[order[1]] && indices[order[1]] < indices[order[2]] &&
+					indices[order[2]] < indices[order[3]];
+
+			if (distinct) {
+				prev_dst_indices = zylann::voxel::mixel4::encode_indices_to_packed_u16(
+						indices[order[0]], indices[order[1]], indices[order[2]], indices[order[3]]
+				);
+			} else {
+				// The same texture is used twice, the generic path has to deal with it
+				prev_dst_indices = 0;
+			}
+			for (unsigned int j = 0; j < order.size(); ++j) {
+				weight_shifts[j] = order[j] * 4;
+			}
+			prev_src_indices = encoded_indices;
+		}
+
+		const uint16_t w = src_weights[i];
+		dst_indices[i] = prev_dst_indices;
+		dst_weights[i] = ((w >> weight_shifts[0]) & 0xf) | (((w >> weight_shifts[1]) & 0xf) << 4) |
+				(((w >> weight_shifts[2]) & 0xf) << 8) | (((w >> weight_shifts[3]) & 0xf) << 12);
+	}
+}
+
+// Fast path for cells where all voxels use the same textures, which is the most common case. Indices and weights are
+// then read directly from presorted data. Returns false if the cell must go through texture selection instead.
+template <unsigned int NVoxels>
+inline bool try_get_presorted_cell_texture_data(
+		CellTextureDatas<NVoxels> &cell_textures,
+		const TextureIndicesData &texture_indices_data,
+		const FixedArray<unsigned int, NVoxels> &voxel_indices,
+		const unsigned int case_code
+) {
+	const Span<const uint16_t> sorted_indices = texture_indices_data.sorted_buffer;
+	uint16_t cell_indices = 0;
+
+	for (unsigned int ci = 0; ci < voxel_indices.size(); ++ci) {
+		if ((case_code & (1 << ci)) != 0) {
+			continue;
+		}
+		const uint16_t voxel_indices_value = sorted_indices[voxel_indices[ci]];
+		if (voxel_indices_value == 0) {
+			return false;
+		}
+		if (cell_indices == 0) {
+			cell_indices = voxel_indices_value;
+		} else if (voxel_indices_value != cell_indices) {
+			return false;
+		}
+	}
+
+	if (cell_indices == 0) {
+		return false;
+	}
+
+	cell_textures.indices = zylann::voxel::mixel4::decode_indices_from_packed_u16(cell_indices);
+	cell_textures.packed_indices = pack_bytes(cell_textures.indices);
+
+	for (unsigned int ci = 0; ci < voxel_indices.size(); ++ci) {
+		if ((case_code & (1 << ci)) != 0) {
+			fill(cell_textures.weights[ci], uint8_t(0));
+		} else {
+			cell_textures.weights[ci] = zylann::voxel::mixel4::decode_weights_from_packed_u16(
+					texture_indices_data.sorted_weights[voxel_indices[ci]]
+			);
+		}
+	}
+
+	return true;
+}
+
 template <unsigned int NVoxels, typename WeightSampler_T>
 inline void get_cell_texture_data(
 		CellTextureDatas<NVoxels> &cell_textures,
@@ -145,6 +264,10 @@ inline void get_cell_texture_data(
 			}
 		}
 
+	} else if (texture_indices_data.sorted_buffer.size() != 0 &&
+			   try_get_presorted_cell_texture_data(cell_textures, texture_indices_data, voxel_indices, case_code)) {
+		// All voxels of the cell use the same 4 textures, no need to select them
+
 	} else {
 		// There can be more than 4 indices or they are not known, so we have to select them
 		cell_textures =
@@ -253,7 +376,7 @@ struct Processor {
 	}
 };
 
-TextureIndicesData get_texture_indices_data(
+inline TextureIndicesData get_texture_indices_data(
 		const VoxelBuffer &voxels,
 		const unsigned int indices_channel,
 		DefaultTextureIndicesData &out_default_texture_indices_data
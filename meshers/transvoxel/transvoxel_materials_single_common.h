@@ -1,6 +1,7 @@
 #ifndef VOXEL_TRANSVOXEL_MATERIALS_SINGLE_COMMON_H
 #define VOXEL_TRANSVOXEL_MATERIALS_SINGLE_COMMON_H
 
+#include "../../util/memory/temp_arena.h"
 #include "transvoxel_materials_common.h"
 
 namespace zylann::voxel::transvoxel::materials::single {
@@ -44,7 +45,7 @@ struct VoxelMaterialIndices {
 VoxelMaterialIndices get_material_indices_from_vb(
 		const VoxelBuffer &voxels,
 		const unsigned int channel,
-		StdVector<uint8_t> &conversion_buffer
+		TempArena &arena
 ) {
 	ZN_ASSERT_RETURN_V(voxels.get_channel_depth(channel) == VoxelBuffer::DEPTH_8_BIT, VoxelMaterialIndices());
 
@@ -78,12 +79,12 @@ VoxelMaterialIndices get_material_indices_from_vb(
 			Span<const uint16_t> data_u16;
 			ZN_ASSERT(voxels.get_channel_data_read_only(channel, data_u16) == true);
 
-			conversion_buffer.resize(data_u16.size());
+			Span<uint8_t> conversion_buffer = arena.allocate_span<uint8_t>(data_u16.size());
 			for (unsigned int i = 0; i < data_u16.size(); ++i) {
 				conversion_buffer[i] = data_u16[i];
 			}
 
-			data.indices = to_span(conversion_buffer);
+			data.indices = conversion_buffer;
 		} break;
 
 		case VoxelBuffer::DEPTH_32_BIT: {
@@ -1,16 +1,19 @@
 #include "voxel_mesher_transvoxel.h"
 #include "../../engine/voxel_engine.h"
 #include "../../generators/voxel_generator.h"
+#include "../../shaders/transvoxel_minimal_instance_shader.h"
 #include "../../shaders/transvoxel_minimal_shader.h"
 #include "../../storage/voxel_buffer_gd.h"
 #include "../../storage/voxel_data.h"
 #include "../../thirdparty/meshoptimizer/meshoptimizer.h"
+#include "../../util/containers/std_unordered_map.h"
 #include "../../util/godot/classes/array_mesh.h"
 #include "../../util/godot/classes/rendering_server.h"
 #include "../../util/godot/classes/shader.h"
 #include "../../util/godot/classes/shader_material.h"
 #include "../../util/godot/core/packed_arrays.h"
 #include "../../util/math/conv.h"
+#include "../../util/memory/temp_arena.h"
 #include "../../util/profiling.h"
 #include "transvoxel_tables.cpp"
 #ifdef TOOLS_ENABLED
@@ -23,6 +26,7 @@ namespace zylann::voxel {
 
 namespace {
 Ref<ShaderMaterial> g_minimal_shader_material;
+Ref<ShaderMaterial> g_minimal_instance_shader_material;
 } // namespace
 
 namespace transvoxel {
@@ -55,10 +59,17 @@ void VoxelMesherTransvoxel::load_static_resources() {
 	shader->set_code(g_transvoxel_minimal_shader);
 	g_minimal_shader_material.instantiate();
 	g_minimal_shader_material->set_shader(shader);
+
+	Ref<Shader> instance_shader;
+	instance_shader.instantiate();
+	instance_shader->set_code(g_transvoxel_minimal_instance_shader);
+	g_minimal_instance_shader_material.instantiate();
+	g_minimal_instance_shader_material->set_shader(instance_shader);
 }
 
 void VoxelMesherTransvoxel::free_static_resources() {
 	g_minimal_shader_material.unref();
+	g_minimal_instance_shader_material.unref();
 }
 
 VoxelMesherTransvoxel::VoxelMesherTransvoxel() {
@@ -133,6 +144,19 @@ void fill_surface_arrays(Array &arrays, const transvoxel::MeshArrays &src) {
 	arrays[Mesh::ARRAY_INDEX] = indices;
 }
 
+// Only fills what is needed to build a collision shape
+void fill_collision_surface_arrays(Array &arrays, const transvoxel::MeshArrays &src) {
+	PackedVector3Array vertices;
+	PackedInt32Array indices;
+
+	copy_to(vertices, to_span_const(src.vertices));
+	copy_to(indices, to_span_const(src.indices));
+
+	arrays.resize(Mesh::ARRAY_MAX);
+	arrays[Mesh::ARRAY_VERTEX] = vertices;
+	arrays[Mesh::ARRAY_INDEX] = indices;
+}
+
 template <typename T>
 void remap_vertex_array(
 		const StdVector<T> &src_data,
@@ -193,6 +217,25 @@ void simplify(
 		lod_indices.resize(lod_index_count);
 	}
 
+	// Reorder triangles
+	{
+		ZN_PROFILE_SCOPE_NAMED("meshopt_optimizeVertexCache");
+
+		zylannmeshopt::meshopt_optimizeVertexCache(
+				lod_indices.data(), lod_indices.data(), lod_indices.size(), src_mesh.vertices.size()
+		);
+		// Threshold recommended by the library, allowing to degrade vertex cache efficiency by 5%
+		zylannmeshopt::meshopt_optimizeOverdraw(
+				lod_indices.data(),
+				lod_indices.data(),
+				lod_indices.size(),
+				&src_mesh.vertices[0].x,
+				src_mesh.vertices.size(),
+				sizeof(Vector3f),
+				1.05f
+		);
+	}
+
 	// Produce output
 
 	Array surface;
@@ -222,6 +265,178 @@ void simplify(
 	);
 }
 
+// Slabs thinner than this are not worth the cost of merging them
+constexpr int MIN_PARALLEL_SLAB_HEIGHT = 8;
+
+// Part of a block built separately when meshing in parallel
+struct Slab {
+	transvoxel::Cache cache;
+	transvoxel::MeshArrays mesh_arrays;
+	StdVector<transvoxel::CellInfo> cell_infos;
+	transvoxel::DefaultTextureIndicesData default_texture_indices_data;
+};
+
+StdVector<Slab> &get_tls_slabs() {
+	thread_local StdVector<Slab> tls_slabs;
+	return tls_slabs;
+}
+
+// Gets how many slabs a block should be split into, depending on how many threads are available to mesh them, unless
+// `count_override` is not zero
+unsigned int get_parallel_slab_count(const int block_size_y, const unsigned int count_override) {
+	const unsigned int max_slab_count = math::max(block_size_y / MIN_PARALLEL_SLAB_HEIGHT, 1);
+	if (count_override != 0) {
+		return math::min(max_slab_count, count_override);
+	}
+	return math::min(max_slab_count, 1 + VoxelEngine::get_singleton().get_idle_thread_count());
+}
+
+// Identifies a position by the bits of its coordinates
+inline Vector3i get_exact_position_key(const Vector3f p) {
+	static_assert(sizeof(Vector3i) == sizeof(Vector3f));
+	Vector3i key;
+	memcpy(&key, &p, sizeof(Vector3f));
+	return key;
+}
+
+inline bool have_same_texturing_data(
+		const transvoxel::MeshArrays &a,
+		const unsigned int ai,
+		const transvoxel::MeshArrays &b,
+		const unsigned int bi
+) {
+	if (a.texturing_data_1f32.size() > 0 && a.texturing_data_1f32[ai] != b.texturing_data_1f32[bi]) {
+		return false;
+	}
+	if (a.texturing_data_2f32.size() > 0 && a.texturing_data_2f32[ai] != b.texturing_data_2f32[bi]) {
+		return false;
+	}
+	return true;
+}
+
+// Appends the mesh of a slab on top of the mesh of the slab below it. Vertices lying on the plane separating them were
+// created in both, so they are welded back together. They are computed from the same voxels in the same way, so their
+// positions match exactly.
+void append_slab(
+		transvoxel::MeshArrays &dst,
+		const transvoxel::MeshArrays &src,
+		// Where vertices of the slab below start in `dst`
+		const unsigned int prev_slab_vertex_begin,
+		const float seam_y,
+		// Vertices further from the seam than this can't be on it
+		const float seam_tolerance
+) {
+	ZN_PROFILE_SCOPE();
+
+	StdUnorderedMap<Vector3i, unsigned int> seam_vertices;
+	for (unsigned int vi = prev_slab_vertex_begin; vi < dst.vertices.size(); ++vi) {
+		const Vector3f pos = dst.vertices[vi];
+		if (math::abs(pos.y - seam_y) <= seam_tolerance) {
+			seam_vertices.insert({ get_exact_position_key(pos), vi });
+		}
+	}
+
+	TempArenaScope temp_arena_scope(TempArena::get_for_current_thread());
+	Span<int32_t> remap = temp_arena_scope.get_arena().allocate_span<int32_t>(src.vertices.size());
+
+	for (unsigned int src_vi = 0; src_vi < src.vertices.size(); ++src_vi) {
+		const Vector3f pos = src.vertices[src_vi];
+
+		if (math::abs(pos.y - seam_y) <= seam_tolerance) {
+			auto it = seam_vertices.find(get_exact_position_key(pos));
+			// Vertices with different textures are not shared within a slab either
+			if (it != seam_vertices.end() && have_same_texturing_data(dst, it->second, src, src_vi)) {
+				remap[src_vi] = it->second;
+				continue;
+			}
+		}
+
+		remap[src_vi] = dst.vertices.size();
+		dst.vertices.push_back(pos);
+		dst.normals.push_back(src.normals[src_vi]);
+		dst.lod_data.push_back(src.lod_data[src_vi]);
+		if (src.texturing_data_1f32.size() > 0) {
+			dst.texturing_data_1f32.push_back(src.texturing_data_1f32[src_vi]);
+		}
+		if (src.texturing_data_2f32.size() > 0) {
+			dst.texturing_data_2f32.push_back(src.texturing_data_2f32[src_vi]);
+		}
+	}
+
+	for (const int32_t src_index : src.indices) {
+		dst.indices.push_back(remap[src_index]);
+	}
+}
+
+// Builds the regular mesh of a block by splitting it in slabs along the Y axis, which are polygonized in parallel by
+// idle threads, and then merged.
+transvoxel::DefaultTextureIndicesData build_regular_mesh_in_slabs(
+		const VoxelBuffer &voxels,
+		const unsigned int sdf_channel,
+		const uint32_t lod_index,
+		const transvoxel::TexturingMode texturing_mode,
+		transvoxel::MeshArrays &output,
+		StdVector<transvoxel::CellInfo> *cell_infos,
+		const float edge_clamp_margin,
+		const bool textures_ignore_air_voxels,
+		const unsigned int slab_count,
+		const transvoxel::PreparedTexturingData &texturing_data
+) {
+	ZN_PROFILE_SCOPE();
+
+	StdVector<Slab> &slabs = get_tls_slabs();
+	if (slabs.size() < slab_count) {
+		slabs.resize(slab_count);
+	}
+
+	const int cells_min_y = transvoxel::MIN_PADDING;
+	const int cells_size_y = voxels.get_size().y - transvoxel::MIN_PADDING - transvoxel::MAX_PADDING;
+
+	// In padded coordinates
+	auto get_slab_min_y = [cells_min_y, cells_size_y, slab_count](const unsigned int slab_index) {
+		return cells_min_y + cells_size_y * static_cast<int>(slab_index) / static_cast<int>(slab_count);
+	};
+
+	VoxelEngine::get_singleton().parallel_for(slab_count, [&](const uint32_t slab_index) {
+		Slab &slab = slabs[slab_index];
+		slab.cell_infos.clear();
+		slab.default_texture_indices_data = transvoxel::build_regular_mesh(
+				voxels,
+				sdf_channel,
+				lod_index,
+				texturing_mode,
+				slab.cache,
+				slab.mesh_arrays,
+				cell_infos != nullptr ? &slab.cell_infos : nullptr,
+				edge_clamp_margin,
+				textures_ignore_air_voxels,
+				get_slab_min_y(slab_index),
+				get_slab_min_y(slab_index + 1),
+				// Shared by all slabs instead of being prepared by each of them
+				&texturing_data
+		);
+	});
+
+	const float lod_scale = 1 << lod_index;
+	unsigned int prev_slab_vertex_begin = 0;
+
+	for (unsigned int slab_index = 0; slab_index < slab_count; ++slab_index) {
+		const Slab &slab = slabs[slab_index];
+		const unsigned int slab_vertex_begin = output.vertices.size();
+		const float seam_y = (get_slab_min_y(slab_index) - cells_min_y) * lod_scale;
+
+		append_slab(output, slab.mesh_arrays, prev_slab_vertex_begin, seam_y, lod_scale);
+
+		if (cell_infos != nullptr) {
+			append_array(*cell_infos, slab.cell_infos);
+		}
+
+		prev_slab_vertex_begin = slab_vertex_begin;
+	}
+
+	return slabs[0].default_texture_indices_data;
+}
+
 } // namespace
 
 // TODO Maybe we could auto-detect? It could become ambiguous tho
@@ -307,20 +522,53 @@ void VoxelMesherTransvoxel::build(VoxelMesher::Output &output, const VoxelMesher
 		cell_infos = &transvoxel::get_tls_cell_infos();
 	}
 
-	const TexturingMode texture_mode = check_texturing_mode(_texture_mode, voxels);
+	// Texturing is only used for rendering
+	const TexturingMode texture_mode =
+			input.visual_hint ? check_texturing_mode(_texture_mode, voxels) : TEXTURES_NONE;
 
-	default_texture_indices_data = transvoxel::build_regular_mesh(
-			voxels,
-			sdf_channel,
-			input.lod_index,
-			static_cast<transvoxel::TexturingMode>(texture_mode),
-			tls_cache,
-			mesh_arrays,
-			cell_infos,
-			_edge_clamp_margin,
-			_textures_ignore_air_voxels
+	// Prepared once, and shared by the regular mesh (or its slabs) and transition meshes
+	TempArenaScope temp_arena_scope(TempArena::get_for_current_thread());
+	const transvoxel::PreparedTexturingData texturing_data = transvoxel::prepare_texturing_data(
+			voxels, static_cast<transvoxel::TexturingMode>(texture_mode), temp_arena_scope.get_arena()
 	);
 
+	const int cells_min_y = transvoxel::MIN_PADDING;
+	const int cells_max_y = voxels.get_size().y - transvoxel::MAX_PADDING;
+	const unsigned int slab_count = _parallel_meshing_enabled
+			? get_parallel_slab_count(cells_max_y - cells_min_y, _parallel_slab_count_override)
+			: 1;
+
+	if (slab_count > 1) {
+		default_texture_indices_data = build_regular_mesh_in_slabs(
+				voxels,
+				sdf_channel,
+				input.lod_index,
+				static_cast<transvoxel::TexturingMode>(texture_mode),
+				mesh_arrays,
+				cell_infos,
+				_edge_clamp_margin,
+				_textures_ignore_air_voxels,
+				slab_count,
+				texturing_data
+		);
+
+	} else {
+		default_texture_indices_data = transvoxel::build_regular_mesh(
+				voxels,
+				sdf_channel,
+				input.lod_index,
+				static_cast<transvoxel::TexturingMode>(texture_mode),
+				tls_cache,
+				mesh_arrays,
+				cell_infos,
+				_edge_clamp_margin,
+				_textures_ignore_air_voxels,
+				cells_min_y,
+				cells_max_y,
+				&texturing_data
+		);
+	}
+
 	if (mesh_arrays.vertices.size() == 0) {
 		// The mesh can be empty
 		return;
@@ -348,7 +596,7 @@ void VoxelMesherTransvoxel::build(VoxelMesher::Output &output, const VoxelMesher
 	output.collision_surface.submesh_vertex_end = combined_mesh_arrays->vertices.size();
 	output.collision_surface.submesh_index_end = combined_mesh_arrays->indices.size();
 
-	if (_transitions_enabled && input.lod_hint) {
+	if (_transitions_enabled && input.lod_hint && input.visual_hint) {
 		// We combine transition meshes with the regular mesh, because it results in less draw calls than if they were
 		// separate. This only requires a vertex shader trick to discard them when neighbors change.
 		ZN_ASSERT(combined_mesh_arrays != nullptr);
@@ -366,13 +614,19 @@ void VoxelMesherTransvoxel::build(VoxelMesher::Output &output, const VoxelMesher
 					*combined_mesh_arrays,
 					default_texture_indices_data,
 					_edge_clamp_margin,
-					_textures_ignore_air_voxels
+					_textures_ignore_air_voxels,
+					&texturing_data
 			);
 		}
 	}
 
 	Array gd_arrays;
-	fill_surface_arrays(gd_arrays, *combined_mesh_arrays);
+	if (input.visual_hint) {
+		fill_surface_arrays(gd_arrays, *combined_mesh_arrays);
+	} else {
+		// Normals are still computed because they are part of how vertices are placed, but they are not needed
+		fill_collision_surface_arrays(gd_arrays, *combined_mesh_arrays);
+	}
 	output.surfaces.push_back({ gd_arrays, 0 });
 
 	// const uint64_t time_spent = Time::get_singleton()->get_ticks_usec() - time_before;
@@ -380,6 +634,10 @@ void VoxelMesherTransvoxel::build(VoxelMesher::Output &output, const VoxelMesher
 
 	output.primitive_type = Mesh::PRIMITIVE_TRIANGLES;
 
+	if (!input.visual_hint) {
+		return;
+	}
+
 	// Transvoxel transitions data
 	output.mesh_flags = (RenderingServer::ARRAY_CUSTOM_RGBA_FLOAT << Mesh::ARRAY_FORMAT_CUSTOM0_SHIFT);
 
@@ -395,6 +653,8 @@ void VoxelMesherTransvoxel::build(VoxelMesher::Output &output, const VoxelMesher
 			ZN_PRINT_ERROR("Unhandled texture mode");
 			break;
 	}
+
+	apply_vertex_compression(output, input);
 }
 
 // Only exists for testing
@@ -425,7 +685,8 @@ Ref<ArrayMesh> VoxelMesherTransvoxel::build_transition_mesh(Ref<godot::VoxelBuff
 			s_mesh_arrays,
 			default_texture_indices_data,
 			_edge_clamp_margin,
-			_textures_ignore_air_voxels
+			_textures_ignore_air_voxels,
+			nullptr
 	);
 
 	Ref<ArrayMesh> mesh;
@@ -493,10 +754,26 @@ bool VoxelMesherTransvoxel::get_transitions_enabled() const {
 	return _transitions_enabled;
 }
 
+void VoxelMesherTransvoxel::set_parallel_meshing_enabled(bool enabled) {
+	_parallel_meshing_enabled = enabled;
+}
+
+bool VoxelMesherTransvoxel::is_parallel_meshing_enabled() const {
+	return _parallel_meshing_enabled;
+}
+
+void VoxelMesherTransvoxel::set_parallel_slab_count_override(unsigned int count) {
+	_parallel_slab_count_override = count;
+}
+
 Ref<ShaderMaterial> VoxelMesherTransvoxel::get_default_lod_material() const {
 	return g_minimal_shader_material;
 }
 
+Ref<ShaderMaterial> VoxelMesherTransvoxel::get_default_lod_instance_material() const {
+	return g_minimal_instance_shader_material;
+}
+
 void VoxelMesherTransvoxel::set_edge_clamp_margin(float margin) {
 	_edge_clamp_margin = math::clamp(margin, 0.f, 0.5f);
 }
@@ -537,6 +814,9 @@ void VoxelMesherTransvoxel::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_edge_clamp_margin"), &Self::get_edge_clamp_margin);
 	ClassDB::bind_method(D_METHOD("set_edge_clamp_margin", "margin"), &Self::set_edge_clamp_margin);
 
+	ClassDB::bind_method(D_METHOD("set_parallel_meshing_enabled", "enabled"), &Self::set_parallel_meshing_enabled);
+	ClassDB::bind_method(D_METHOD("is_parallel_meshing_enabled"), &Self::is_parallel_meshing_enabled);
+
 	ADD_GROUP("Materials", "");
 
 	ADD_PROPERTY(
@@ -577,6 +857,12 @@ void VoxelMesherTransvoxel::_bind_methods() {
 
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "edge_clamp_margin"), "set_edge_clamp_margin", "get_edge_clamp_margin");
 
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "parallel_meshing_enabled"),
+			"set_parallel_meshing_enabled",
+			"is_parallel_meshing_enabled"
+	);
+
 	BIND_ENUM_CONSTANT(TEXTURES_NONE);
 	BIND_ENUM_CONSTANT(TEXTURES_MIXEL4_S4);
 	BIND_ENUM_CONSTANT(TEXTURES_SINGLE_S4);
@@ -58,7 +58,11 @@ public:
 	void set_edge_clamp_margin(float margin);
 	float get_edge_clamp_margin() const;
 
+	void set_parallel_meshing_enabled(bool enabled);
+	bool is_parallel_meshing_enabled() const;
+
 	Ref<ShaderMaterial> get_default_lod_material() const override;
+	Ref<ShaderMaterial> get_default_lod_instance_material() const override;
 
 	// Internal
 
@@ -71,6 +75,10 @@ public:
 	// `build`, and only remains valid until the next invocation of build() in the calling thread.
 	static Span<const transvoxel::CellInfo> get_cell_info_from_current_thread();
 
+	// Forces the number of slabs blocks are split into when parallel meshing is enabled, instead of depending on how
+	// many threads are idle. 0 means automatic. Mostly useful for testing.
+	void set_parallel_slab_count_override(unsigned int count);
+
 	// Not sure if that's necessary, currently transitions are either combined or not generated
 	// enum TransitionMode {
 	// 	// No transition meshes will be generated
@@ -104,6 +112,10 @@ private:
 	bool _transitions_enabled = true;
 
 	bool _textures_ignore_air_voxels = false;
+
+	// If enabled, large blocks may be split in slabs along the Y axis, meshed in parallel by idle threads
+	bool _parallel_meshing_enabled = false;
+	unsigned int _parallel_slab_count_override = 0;
 };
 
 } // namespace zylann::voxel
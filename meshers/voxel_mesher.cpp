@@ -5,6 +5,7 @@
 #include "../util/godot/classes/array_mesh.h"
 #include "../util/godot/classes/mesh.h"
 #include "../util/godot/classes/shader_material.h"
+#include "../util/godot/core/version.h"
 #include "../util/profiling.h"
 #include "transvoxel/transvoxel_cell_iterator.h"
 
@@ -178,10 +179,153 @@ bool VoxelMesher::is_mesh_empty(const StdVector<Output::Surface> &surfaces) {
 	return true;
 }
 
+void VoxelMesher::IncrementalCache::add_dirty_box(const Box3i &box) {
+	MutexLock lock(_dirty_area_mutex);
+	if (_dirty_area.full) {
+		return;
+	}
+	if (_dirty_area.box.is_empty()) {
+		_dirty_area.box = box;
+	} else {
+		_dirty_area.box.merge_with(box);
+	}
+}
+
+void VoxelMesher::IncrementalCache::mark_fully_dirty() {
+	MutexLock lock(_dirty_area_mutex);
+	_dirty_area.full = true;
+}
+
+VoxelMesher::IncrementalCache::DirtyArea VoxelMesher::IncrementalCache::take_dirty_area() {
+	MutexLock lock(_dirty_area_mutex);
+	++_generation;
+	DirtyArea area = _dirty_area;
+	area.generation = _generation;
+	_dirty_area.box = Box3i();
+	_dirty_area.full = false;
+	return area;
+}
+
 Ref<ShaderMaterial> VoxelMesher::get_default_lod_material() const {
 	return Ref<ShaderMaterial>();
 }
 
+Ref<ShaderMaterial> VoxelMesher::get_default_lod_instance_material() const {
+	return Ref<ShaderMaterial>();
+}
+
+void VoxelMesher::set_vertex_compression_enabled(bool enabled) {
+	_vertex_compression_enabled = enabled;
+}
+
+bool VoxelMesher::is_vertex_compression_enabled() const {
+	return _vertex_compression_enabled;
+}
+
+namespace {
+
+// Appends `count` copies of the attributes of the first vertex. Works with attributes having several components per
+// vertex, like tangents or custom arrays of floats.
+template <typename PackedArray_T>
+void append_first_vertex_attributes(PackedArray_T &array, const unsigned int vertex_count, const unsigned int count) {
+	if (vertex_count == 0 || array.size() == 0) {
+		return;
+	}
+	const unsigned int components = array.size() / vertex_count;
+	for (unsigned int i = 0; i < count; ++i) {
+		for (unsigned int c = 0; c < components; ++c) {
+			const auto v = array[c];
+			array.push_back(v);
+		}
+	}
+}
+
+// Godot quantizes compressed positions within the bounds of the surface, which would be different for every block.
+// Adding the corners of the block as vertices not referenced by any triangle makes these bounds the same for all
+// blocks of the same size, so vertices on seams get quantized the same way on both sides.
+void add_compression_bounds_vertices(Array &arrays, const Vector3 bounds_size) {
+	PackedVector3Array positions = arrays[Mesh::ARRAY_VERTEX];
+	const unsigned int vertex_count = positions.size();
+	if (vertex_count == 0) {
+		return;
+	}
+	const unsigned int added_count = 2;
+	positions.push_back(Vector3());
+	positions.push_back(bounds_size);
+	arrays[Mesh::ARRAY_VERTEX] = positions;
+
+	for (int array_index = 0; array_index < Mesh::ARRAY_MAX; ++array_index) {
+		if (array_index == Mesh::ARRAY_VERTEX || array_index == Mesh::ARRAY_INDEX) {
+			continue;
+		}
+		Variant attributes = arrays[array_index];
+		switch (attributes.get_type()) {
+			case Variant::PACKED_VECTOR2_ARRAY: {
+				PackedVector2Array a = attributes;
+				append_first_vertex_attributes(a, vertex_count, added_count);
+				arrays[array_index] = a;
+			} break;
+			case Variant::PACKED_VECTOR3_ARRAY: {
+				PackedVector3Array a = attributes;
+				append_first_vertex_attributes(a, vertex_count, added_count);
+				arrays[array_index] = a;
+			} break;
+			case Variant::PACKED_FLOAT32_ARRAY: {
+				PackedFloat32Array a = attributes;
+				append_first_vertex_attributes(a, vertex_count, added_count);
+				arrays[array_index] = a;
+			} break;
+			case Variant::PACKED_COLOR_ARRAY: {
+				PackedColorArray a = attributes;
+				append_first_vertex_attributes(a, vertex_count, added_count);
+				arrays[array_index] = a;
+			} break;
+			case Variant::PACKED_BYTE_ARRAY: {
+				PackedByteArray a = attributes;
+				append_first_vertex_attributes(a, vertex_count, added_count);
+				arrays[array_index] = a;
+			} break;
+			case Variant::PACKED_INT32_ARRAY: {
+				PackedInt32Array a = attributes;
+				append_first_vertex_attributes(a, vertex_count, added_count);
+				arrays[array_index] = a;
+			} break;
+			default:
+				break;
+		}
+	}
+}
+
+} // namespace
+
+void VoxelMesher::apply_vertex_compression(Output &output, const Input &input) const {
+#if GODOT_VERSION_MAJOR == 4 && GODOT_VERSION_MINOR <= 1
+	// Attribute compression was introduced in Godot 4.2
+#else
+	if (!_vertex_compression_enabled) {
+		return;
+	}
+	ZN_PROFILE_SCOPE();
+
+	output.mesh_flags |= Mesh::ARRAY_FLAG_COMPRESS_ATTRIBUTES;
+
+	// Meshes are in local coordinates, starting at the first voxel after padding
+	const Vector3i block_size =
+			input.voxels.get_size() - Vector3iUtil::create(get_minimum_padding() + get_maximum_padding());
+	const real_t lod_scale = 1 << input.lod_index;
+	const Vector3 bounds_size = Vector3(block_size.x, block_size.y, block_size.z) * lod_scale;
+
+	for (Output::Surface &surface : output.surfaces) {
+		add_compression_bounds_vertices(surface.arrays, bounds_size);
+	}
+	for (StdVector<Output::Surface> &surfaces : output.transition_surfaces) {
+		for (Output::Surface &surface : surfaces) {
+			add_compression_bounds_vertices(surface.arrays, bounds_size);
+		}
+	}
+#endif
+}
+
 Ref<Mesh> VoxelMesher::_b_build_mesh(
 		Ref<godot::VoxelBuffer> voxels,
 		TypedArray<Material> materials,
@@ -202,6 +346,17 @@ void VoxelMesher::_bind_methods() {
 	);
 	ClassDB::bind_method(D_METHOD("get_minimum_padding"), &VoxelMesher::get_minimum_padding);
 	ClassDB::bind_method(D_METHOD("get_maximum_padding"), &VoxelMesher::get_maximum_padding);
+
+	ClassDB::bind_method(
+			D_METHOD("set_vertex_compression_enabled", "enabled"), &VoxelMesher::set_vertex_compression_enabled
+	);
+	ClassDB::bind_method(D_METHOD("is_vertex_compression_enabled"), &VoxelMesher::is_vertex_compression_enabled);
+
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "vertex_compression_enabled"),
+			"set_vertex_compression_enabled",
+			"is_vertex_compression_enabled"
+	);
 }
 
 } // namespace zylann::voxel
@@ -8,6 +8,11 @@
 #include "../util/godot/classes/image.h"
 #include "../util/godot/classes/mesh.h"
 #include "../util/macros.h"
+#include "../util/math/box3i.h"
+#include "../util/thread/mutex.h"
+#include "side_connectivity.h"
+#include <atomic>
+#include <memory>
 
 ZN_GODOT_FORWARD_DECLARE(class ShaderMaterial)
 
@@ -25,6 +30,35 @@ class VoxelData;
 class VoxelMesher : public Resource {
 	GDCLASS(VoxelMesher, Resource)
 public:
+	// Data a mesher can keep between builds of the same block, so that it only rebuilds parts affected by changes.
+	// Changed areas are accumulated by the terrain, and taken by the meshing task before it gathers voxels, so changes
+	// made after that are left to the next task.
+	class IncrementalCache {
+	public:
+		struct DirtyArea {
+			// In voxels, relative to the origin of the block (not including padding)
+			Box3i box;
+			// If true, the whole block must be rebuilt
+			bool full = true;
+			// Increases every time the area is taken, so meshers can tell which of two builds of the same block saw
+			// the most recent voxels, when they don't complete in the same order. 0 means unknown.
+			uint32_t generation = 0;
+		};
+
+		virtual ~IncrementalCache() {}
+
+		void add_dirty_box(const Box3i &box);
+		// Used when the area of the change is unknown, or when the mesher's parameters changed
+		void mark_fully_dirty();
+		// Returns the area changed since the last call, and resets it. Must be called right before gathering voxels.
+		DirtyArea take_dirty_area();
+
+	private:
+		Mutex _dirty_area_mutex;
+		DirtyArea _dirty_area;
+		uint32_t _generation = 0;
+	};
+
 	struct Input {
 		// Voxels to be used as the primary source of data.
 		const VoxelBuffer &voxels;
@@ -45,6 +79,16 @@ public:
 		// If true, the mesher can collect some extra information which can be useful to speed up detail texture
 		// baking. Depends on the mesher.
 		bool detail_texture_hint = false;
+		// If provided, the mesher may reuse parts of its previous build of the same block, only rebuilding
+		// `incremental_dirty_area`. The cache must have been created by the same mesher. Ignored by meshers that don't
+		// support it.
+		IncrementalCache *incremental_cache = nullptr;
+		IncrementalCache::DirtyArea incremental_dirty_area;
+		// If true, the mesher is asked to fill `Output::side_connectivity`, if it supports it.
+		bool side_connectivity_hint = false;
+		// If false, the mesh will not be rendered, only used to build a collision shape. Meshers may then skip
+		// attributes only used for rendering (normals, UVs, texturing...), and only output what colliders need.
+		bool visual_hint = true;
 	};
 
 	struct Output {
@@ -74,6 +118,10 @@ public:
 		// May be used to store extra information needed in shader to render the mesh properly
 		// (currently used only by the cubes mesher when baking colors)
 		Ref<Image> atlas_image;
+
+		// Which sides of the block can see each other through non-opaque voxels. Meshers that don't compute it leave
+		// all sides connected, so nothing gets culled because of them.
+		uint16_t side_connectivity = side_connectivity::ALL_CONNECTED;
 	};
 
 	static bool is_mesh_empty(const StdVector<Output::Surface> &surfaces);
@@ -124,13 +172,33 @@ public:
 		return false;
 	}
 
+	// Creates data to keep alongside a block to pass in `Input::incremental_cache`, if the mesher supports incremental
+	// builds in its current configuration. Returns null otherwise.
+	virtual std::shared_ptr<IncrementalCache> create_incremental_cache() const {
+		return nullptr;
+	}
+
 	// Gets a special default material to be used to render meshes produced with this mesher, when variable level of
 	// detail is used. If null, standard materials or default Godot shaders can be used. This is mostly to provide a
 	// default shader that looks ok. Users are still expected to tweak them if need be.
 	// Such material is not meant to be modified.
 	virtual Ref<ShaderMaterial> get_default_lod_material() const;
+	// Same as `get_default_lod_material`, for terrains setting per-block parameters as instance uniforms.
+	virtual Ref<ShaderMaterial> get_default_lod_instance_material() const;
+
+	// If enabled, meshes will be built with compressed vertex attributes: positions are quantized to 16 bits within
+	// the bounds of the block, and normals and tangents use octahedral encoding. This reduces memory and upload time,
+	// at the cost of precision. Shaders don't need changes, Godot decodes them before user code.
+	// Has no effect with Godot 4.1 and older.
+	void set_vertex_compression_enabled(bool enabled);
+	bool is_vertex_compression_enabled() const;
 
 protected:
+	// If vertex compression is enabled, adds the required flags to `Output::mesh_flags`. Also adds two vertices not
+	// used by any triangle to each surface, at the corners of the block, so positions are quantized within the bounds
+	// of the block rather than the bounds of the mesh.
+	void apply_vertex_compression(Output &output, const Input &input) const;
+
 	Ref<Mesh> _b_build_mesh(Ref<godot::VoxelBuffer> voxels, TypedArray<Material> materials, Dictionary additional_data);
 	static void _bind_methods();
 
@@ -140,6 +208,8 @@ private:
 	// Set in constructor and never changed after.
 	unsigned int _minimum_padding = 0;
 	unsigned int _maximum_padding = 0;
+
+	std::atomic_bool _vertex_compression_enabled = { false };
 };
 
 } // namespace zylann::voxel
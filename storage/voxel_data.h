@@ -194,6 +194,37 @@ public:
 		}
 	}
 
+	// Same as `try_set_block`, for many blocks of the same LOD at once. The map is locked only once, which is
+	// preferable when lots of blocks are received at the same time.
+	// `action_when_exists` also receives the position of the block: `f(position, existing_block, incoming_block)`.
+	template <typename F>
+	void try_set_blocks(
+			Span<const Vector3i> block_positions,
+			Span<const VoxelDataBlock> blocks,
+			unsigned int lod_index,
+			F action_when_exists
+	) {
+		ZN_ASSERT_RETURN(block_positions.size() == blocks.size());
+		Lod &lod = _lods[lod_index];
+		RWLockWrite wlock(lod.map_lock);
+		for (unsigned int i = 0; i < blocks.size(); ++i) {
+			const VoxelDataBlock &block = blocks[i];
+#ifdef DEBUG_ENABLED
+			ZN_ASSERT(block.get_lod_index() == lod_index);
+			if (block.has_voxels()) {
+				ZN_ASSERT(block.get_voxels_const().get_size() == Vector3iUtil::create(get_block_size()));
+			}
+#endif
+			const Vector3i block_position = block_positions[i];
+			VoxelDataBlock *existing_block = lod.map.get_block(block_position);
+			if (existing_block != nullptr) {
+				action_when_exists(block_position, *existing_block, block);
+			} else {
+				lod.map.set_block(block_position, block);
+			}
+		}
+	}
+
 	template <typename F>
 	void for_each_block_position(F op) const {
 		const unsigned int lod_count = get_lod_count();
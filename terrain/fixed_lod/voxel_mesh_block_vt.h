@@ -1,8 +1,12 @@
 #ifndef VOXEL_MESH_BLOCK_VT_H
 #define VOXEL_MESH_BLOCK_VT_H
 
+#include "../../engine/voxel_engine.h"
+#include "../../meshers/side_connectivity.h"
+#include "../../meshers/voxel_mesher.h"
 #include "../../util/godot/classes/material.h"
 #include "../voxel_mesh_block.h"
+#include <memory>
 
 namespace zylann::voxel {
 
@@ -31,6 +35,15 @@ public:
 	// collision, it may be a better idea to use `is_area_editable` and not use mesh blocks
 	bool is_loaded = false;
 
+	// Passed to meshing tasks so the mesher can only rebuild parts of the block affected by changes, if it supports it.
+	// Null otherwise.
+	std::shared_ptr<VoxelMesher::IncrementalCache> mesher_incremental_cache;
+
+	// Which sides of the block can see each other, used by occlusion culling.
+	uint16_t side_connectivity = side_connectivity::ALL_CONNECTED;
+	// False until meshing reported connectivity for the first time. Until then, `side_connectivity` is just a default.
+	bool side_connectivity_known = false;
+
 	VoxelMeshBlockVT(const Vector3i bpos, unsigned int size) : VoxelMeshBlock(bpos) {
 		_position_in_voxels = bpos * size;
 	}
@@ -41,7 +54,7 @@ public:
 
 			// To update world. I replaced visibility by presence in world because Godot 3 culling performance is
 			// horrible
-			_set_visible(_visible && _parent_visible);
+			_set_visible(is_instance_visible());
 
 			if (_static_body.is_valid()) {
 				_static_body.set_world(*p_world);
@@ -74,7 +87,7 @@ public:
 		} else {
 			if (!shadow_occluder.is_valid()) {
 				// Create instance if it doesn't exist
-				shadow_occluder.create();
+				shadow_occluder.create(VoxelEngine::get_singleton().get_rendering_instance_pool());
 				shadow_occluder.set_interpolated(false);
 				shadow_occluder.set_render_layers_mask(render_layers_mask);
 #ifdef TOOLS_ENABLED
@@ -82,12 +95,17 @@ public:
 #else
 				shadow_occluder.set_cast_shadows_setting(RenderingServer::SHADOW_CASTING_SETTING_SHADOWS_ONLY);
 #endif
-				set_mesh_instance_visible(shadow_occluder, _visible && _parent_visible);
+				set_mesh_instance_visible(shadow_occluder, is_instance_visible());
 			}
 			shadow_occluder.set_mesh(shadow_occluder_mesh);
 		}
 
+		const bool had_mesh_instance = _mesh_instance.is_valid();
 		VoxelMeshBlock::set_mesh(mesh, gi_mode, shadow_setting, render_layers_mask);
+		if (!had_mesh_instance && _occlusion_culled && _mesh_instance.is_valid()) {
+			// The base class doesn't know about occlusion culling
+			set_mesh_instance_visible(_mesh_instance, false);
+		}
 	}
 
 	void drop_mesh() {
@@ -109,7 +127,7 @@ public:
 			return;
 		}
 		_visible = visible;
-		_set_visible(_visible && _parent_visible);
+		_set_visible(is_instance_visible());
 	}
 
 	void set_parent_visible(bool parent_visible) {
@@ -117,7 +135,20 @@ public:
 			return;
 		}
 		_parent_visible = parent_visible;
-		_set_visible(_visible && _parent_visible);
+		_set_visible(is_instance_visible());
+	}
+
+	// Hides the block without changing its visibility state, when it can't be seen from the camera.
+	void set_occlusion_culled(bool culled) {
+		if (_occlusion_culled == culled) {
+			return;
+		}
+		_occlusion_culled = culled;
+		_set_visible(is_instance_visible());
+	}
+
+	bool is_occlusion_culled() const {
+		return _occlusion_culled;
 	}
 
 	void set_parent_transform(const Transform3D &parent_transform) {
@@ -136,12 +167,18 @@ public:
 	}
 
 protected:
+	inline bool is_instance_visible() const {
+		return _visible && _parent_visible && !_occlusion_culled;
+	}
+
 	void _set_visible(bool visible) {
 		if (shadow_occluder.is_valid()) {
 			set_mesh_instance_visible(shadow_occluder, visible);
 		}
 		VoxelMeshBlock::_set_visible(visible);
 	}
+
+	bool _occlusion_culled = false;
 };
 
 } // namespace zylann::voxel
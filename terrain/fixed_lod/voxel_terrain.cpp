@@ -4,6 +4,7 @@
 #include "../../edition/voxel_tool_terrain.h"
 #include "../../engine/buffered_task_scheduler.h"
 #include "../../engine/voxel_engine.h"
+#include "../../engine/voxel_engine_gd.h"
 #include "../../engine/voxel_engine_updater.h"
 #include "../../generators/generate_block_task.h"
 #include "../../meshers/blocky/voxel_mesher_blocky.h"
@@ -13,7 +14,9 @@
 #include "../../streams/load_block_data_task.h"
 #include "../../streams/save_block_data_task.h"
 #include "../../util/containers/container_funcs.h"
+#include "../../util/containers/std_unordered_set.h"
 #include "../../util/godot/classes/base_material_3d.h" // For property hint in release mode in GDExtension...
+#include "../../util/godot/classes/camera_3d.h"
 #include "../../util/godot/classes/concave_polygon_shape_3d.h"
 #include "../../util/godot/classes/engine.h"
 #include "../../util/godot/classes/multiplayer_api.h"
@@ -21,6 +24,7 @@
 #include "../../util/godot/classes/scene_tree.h"
 #include "../../util/godot/classes/script.h"
 #include "../../util/godot/classes/shader_material.h"
+#include "../../util/godot/classes/viewport.h"
 #include "../../util/godot/core/array.h"
 #include "../../util/godot/core/string.h"
 #include "../../util/macros.h"
@@ -32,6 +36,8 @@
 #include "../voxel_data_block_enter_info.h"
 #include "../voxel_save_completion_tracker.h"
 #include "voxel_terrain_multiplayer_synchronizer.h"
+#include <algorithm>
+#include <limits>
 
 #ifdef TOOLS_ENABLED
 #include "../../meshers/transvoxel/voxel_mesher_transvoxel.h"
@@ -88,7 +94,7 @@ VoxelTerrain::VoxelTerrain() {
 	};
 	callbacks.data_output_callback = [](void *cb_data, VoxelEngine::BlockDataOutput &ob) {
 		VoxelTerrain *self = reinterpret_cast<VoxelTerrain *>(cb_data);
-		self->apply_data_block_response(ob);
+		self->receive_data_block_response(ob);
 	};
 
 	_volume_id = VoxelEngine::get_singleton().add_volume(callbacks);
@@ -319,6 +325,11 @@ void VoxelTerrain::set_mesher(Ref<VoxelMesher> mesher) {
 
 	MeshingDependency::reset(_meshing_dependency, _mesher, get_generator());
 
+	// Caches are specific to the mesher that created them
+	_mesh_map.for_each_block([](VoxelMeshBlockVT &block) { //
+		block.mesher_incremental_cache.reset();
+	});
+
 	stop_updater();
 
 	if (_mesher.is_valid()) {
@@ -425,8 +436,38 @@ bool VoxelTerrain::is_automatic_loading_enabled() const {
 	return _automatic_loading_enabled;
 }
 
-void VoxelTerrain::try_schedule_mesh_update(VoxelMeshBlockVT &mesh_block) {
+void VoxelTerrain::set_occlusion_culling_enabled(bool enabled) {
+	if (enabled == is_occlusion_culling_enabled()) {
+		return;
+	}
+
+	if (enabled) {
+		_occlusion_culling_state = make_shared_instance<VoxelTerrainOcclusionCullingState>();
+		VoxelTerrainOcclusionCullingState &occlusion_culling = *_occlusion_culling_state;
+		// Blocks meshed before won't be culled until they are meshed again, because they have no connectivity
+		// information. Remeshing everything here would cause a big spike.
+		_mesh_map.for_each_block([&occlusion_culling](const VoxelMeshBlockVT &block) {
+			occlusion_culling.pending_changes.push_back({ block.position, block.side_connectivity, false });
+		});
+
+	} else {
+		// A task might still be running, it will finish on its own
+		_occlusion_culling_state.reset();
+		_mesh_map.for_each_block([](VoxelMeshBlockVT &block) { //
+			block.set_occlusion_culled(false);
+		});
+	}
+}
+
+bool VoxelTerrain::is_occlusion_culling_enabled() const {
+	return _occlusion_culling_state != nullptr;
+}
+
+void VoxelTerrain::try_schedule_mesh_update(VoxelMeshBlockVT &mesh_block, const bool whole_block_changed) {
 	ZN_PROFILE_SCOPE();
+	if (whole_block_changed && mesh_block.mesher_incremental_cache != nullptr) {
+		mesh_block.mesher_incremental_cache->mark_fully_dirty();
+	}
 	if (mesh_block.is_in_update_list) {
 		// Already in the list
 		return;
@@ -521,6 +562,13 @@ void VoxelTerrain::unview_mesh_block(Vector3i bpos, bool mesh_flag, bool collisi
 void VoxelTerrain::unload_mesh_block(Vector3i bpos) {
 	StdVector<Vector3i> &blocks_pending_update = _blocks_pending_update;
 
+	if (_occlusion_culling_state != nullptr) {
+		VoxelTerrainOcclusionCullingState &occlusion_culling = *_occlusion_culling_state;
+		occlusion_culling.removed_blocks_since_schedule.insert(bpos);
+		MutexLock mlock(occlusion_culling.pending_changes_mutex);
+		occlusion_culling.pending_changes.push_back({ bpos, side_connectivity::ALL_CONNECTED, true });
+	}
+
 	bool was_loaded = false;
 	_mesh_map.remove_block(bpos, [&blocks_pending_update, &was_loaded](const VoxelMeshBlockVT &block) {
 		if (block.is_in_update_list) {
@@ -720,6 +768,7 @@ void VoxelTerrain::stop_streamer() {
 	_loading_blocks.clear();
 	_blocks_pending_load.clear();
 	_quick_reloading_blocks.clear();
+	_received_data_blocks.clear();
 	_unloaded_saving_blocks.clear();
 }
 
@@ -744,6 +793,11 @@ void VoxelTerrain::clear_mesh_map() {
 	}
 
 	_mesh_map.clear();
+
+	if (_occlusion_culling_state != nullptr) {
+		// Start over. A task might still be running with the previous state, it will finish on its own.
+		_occlusion_culling_state = make_shared_instance<VoxelTerrainOcclusionCullingState>();
+	}
 }
 
 void VoxelTerrain::reset_map() {
@@ -758,6 +812,7 @@ void VoxelTerrain::reset_map() {
 
 	_loading_blocks.clear();
 	_blocks_pending_load.clear();
+	_received_data_blocks.clear();
 	_blocks_pending_update.clear();
 	_blocks_to_save.clear();
 
@@ -775,21 +830,47 @@ void VoxelTerrain::post_edit_voxel(Vector3i pos) {
 }
 
 void VoxelTerrain::try_schedule_mesh_update_from_data(const Box3i &box_in_voxels) {
+	try_schedule_mesh_update_from_data(Span<const Box3i>(&box_in_voxels, 1));
+}
+
+void VoxelTerrain::try_schedule_mesh_update_from_data(Span<const Box3i> boxes_in_voxels) {
 	ZN_PROFILE_SCOPE();
 	if (_mesher.is_null()) {
 		// No mesher, can't do updates
 		return;
 	}
-	// We pad by 1 because neighbor blocks might be affected visually (for example, baked ambient occlusion)
-	const Box3i mesh_box = box_in_voxels.padded(1).downscaled(get_mesh_block_size());
-	mesh_box.for_each_cell([this](Vector3i pos) {
-		VoxelMeshBlockVT *block = _mesh_map.get_block(pos);
-		// There isn't necessarily a mesh block, if the edit happens in a boundary,
-		// or if it is done next to a viewer that doesn't need meshes
-		if (block != nullptr) {
-			try_schedule_mesh_update(*block);
-		}
-	});
+
+	// Neighbor boxes often affect the same mesh blocks, so each of them is checked only once
+	static thread_local StdUnorderedSet<Vector3i> tls_mesh_blocks_to_check;
+	StdUnorderedSet<Vector3i> &mesh_blocks_to_check = tls_mesh_blocks_to_check;
+	mesh_blocks_to_check.clear();
+
+	const int mesh_block_size = get_mesh_block_size();
+
+	for (const Box3i &box_in_voxels : boxes_in_voxels) {
+		// We pad by 1 because neighbor blocks might be affected visually (for example, baked ambient occlusion)
+		const Box3i padded_box = box_in_voxels.padded(1);
+		const Box3i mesh_box = padded_box.downscaled(mesh_block_size);
+		mesh_box.for_each_cell([this, &padded_box, &mesh_blocks_to_check, mesh_block_size](Vector3i pos) {
+			VoxelMeshBlockVT *block = _mesh_map.get_block(pos);
+			// There isn't necessarily a mesh block, if the edit happens in a boundary,
+			// or if it is done next to a viewer that doesn't need meshes
+			if (block == nullptr) {
+				return;
+			}
+			if (block->mesher_incremental_cache != nullptr) {
+				const Vector3i origin = pos * mesh_block_size;
+				block->mesher_incremental_cache->add_dirty_box(Box3i(padded_box.position - origin, padded_box.size));
+			}
+			mesh_blocks_to_check.insert(pos);
+		});
+	}
+
+	for (const Vector3i mesh_block_pos : mesh_blocks_to_check) {
+		VoxelMeshBlockVT *block = _mesh_map.get_block(mesh_block_pos);
+		ZN_ASSERT_CONTINUE(block != nullptr);
+		try_schedule_mesh_update(*block, false);
+	}
 }
 
 void VoxelTerrain::post_edit_area(Box3i box_in_voxels, bool update_mesh) {
@@ -1201,14 +1282,16 @@ void VoxelTerrain::process() {
 				false, // had_instances
 				true // had_voxels
 			};
-			apply_data_block_response(ob);
+			_received_data_blocks.push_back(std::move(ob));
 		}
 		_quick_reloading_blocks.clear();
 	}
 
+	apply_data_block_responses();
 	process_viewers();
 	// process_received_data_blocks();
 	process_meshing();
+	process_occlusion_culling();
 
 #ifdef TOOLS_ENABLED
 	if (debug_is_draw_enabled() && is_visible_in_tree()) {
@@ -1632,7 +1715,7 @@ void VoxelTerrain::process_viewer_data_box_change(
 	}
 }
 
-void VoxelTerrain::apply_data_block_response(VoxelEngine::BlockDataOutput &ob) {
+void VoxelTerrain::receive_data_block_response(VoxelEngine::BlockDataOutput &ob) {
 	ZN_PROFILE_SCOPE();
 
 	// print_line(String("Receiving {0} blocks").format(varray(output.emerged_blocks.size())));
@@ -1662,95 +1745,148 @@ void VoxelTerrain::apply_data_block_response(VoxelEngine::BlockDataOutput &ob) {
 			ob.type != VoxelEngine::BlockDataOutput::TYPE_GENERATED
 	);
 
-	const Vector3i block_pos = ob.position;
-
-	if (ob.dropped) {
-		if (_loading_blocks.find(block_pos) == _loading_blocks.end()) {
-			// We are no longer expecting this block, ignore
-			return;
-		}
-		// That block was cancelled, but we are still expecting it.
-		// We'll have to request it again.
-		ZN_PRINT_VERBOSE(
-				format("Received a block loading drop while we were still expecting it: "
-					   "lod{} ({}, {}, {}), re-requesting it",
-					   int(ob.lod_index),
-					   ob.position.x,
-					   ob.position.y,
-					   ob.position.z)
-		);
+	// Applied on the next process call, along with other blocks received in the meantime
+	_received_data_blocks.push_back(std::move(ob));
+}
 
-		++_stats.dropped_block_loads;
+void VoxelTerrain::apply_data_block_responses() {
+	ZN_PROFILE_SCOPE();
 
-		_blocks_pending_load.push_back(ob.position);
+	if (_received_data_blocks.size() == 0) {
 		return;
 	}
 
-	LoadingBlock loading_block;
-	{
-		auto loading_block_it = _loading_blocks.find(block_pos);
+	static thread_local StdVector<Vector3i> tls_positions;
+	static thread_local StdVector<VoxelDataBlock> tls_blocks;
+	static thread_local StdVector<LoadingBlock> tls_loading_blocks;
+	StdVector<Vector3i> &positions = tls_positions;
+	StdVector<VoxelDataBlock> &blocks = tls_blocks;
+	StdVector<LoadingBlock> &loading_blocks = tls_loading_blocks;
+	positions.clear();
+	blocks.clear();
+	loading_blocks.clear();
+
+	const Vector3i expected_block_size = Vector3iUtil::create(_data->get_block_size());
+
+	for (VoxelEngine::BlockDataOutput &ob : _received_data_blocks) {
+		const Vector3i block_pos = ob.position;
+
+		if (ob.dropped) {
+			if (_loading_blocks.find(block_pos) == _loading_blocks.end()) {
+				// We are no longer expecting this block, ignore
+				continue;
+			}
+			// That block was cancelled, but we are still expecting it.
+			// We'll have to request it again.
+			ZN_PRINT_VERBOSE(
+					format("Received a block loading drop while we were still expecting it: "
+						   "lod{} ({}, {}, {}), re-requesting it",
+						   int(ob.lod_index),
+						   ob.position.x,
+						   ob.position.y,
+						   ob.position.z)
+			);
 
-		if (loading_block_it == _loading_blocks.end()) {
-			// That block was not requested or is no longer needed, drop it.
 			++_stats.dropped_block_loads;
-			return;
+
+			_blocks_pending_load.push_back(ob.position);
+			continue;
 		}
 
-		// Using move semantics because it can contain an allocated vector
-		loading_block = std::move(loading_block_it->second);
+		LoadingBlock loading_block;
+		{
+			auto loading_block_it = _loading_blocks.find(block_pos);
 
-		// Now we got the block. If we still have to drop it, the cause will be an error.
-		_loading_blocks.erase(loading_block_it);
-	}
+			if (loading_block_it == _loading_blocks.end()) {
+				// That block was not requested or is no longer needed, drop it.
+				++_stats.dropped_block_loads;
+				continue;
+			}
 
-	ZN_ASSERT_RETURN(ob.voxels != nullptr);
+			// Using move semantics because it can contain an allocated vector
+			loading_block = std::move(loading_block_it->second);
 
-	VoxelDataBlock block(ob.voxels, ob.lod_index);
-	block.set_edited(ob.type == VoxelEngine::BlockDataOutput::TYPE_LOADED);
-	// Viewers will be set only if the block doesn't already exist
-	block.viewers = loading_block.viewers;
+			// Now we got the block. If we still have to drop it, the cause will be an error.
+			_loading_blocks.erase(loading_block_it);
+		}
 
-	if (block.has_voxels() && block.get_voxels_const().get_size() != Vector3iUtil::create(_data->get_block_size())) {
-		// Voxel block size is incorrect, drop it
-		ZN_PRINT_ERROR(
-				format("Block is different from expected size. Expected {}, got {}",
-					   Vector3iUtil::create(_data->get_block_size()),
-					   block.get_voxels_const().get_size())
-		);
-		++_stats.dropped_block_loads;
+		ZN_ASSERT_CONTINUE(ob.voxels != nullptr);
+
+		VoxelDataBlock block(ob.voxels, ob.lod_index);
+		block.set_edited(ob.type == VoxelEngine::BlockDataOutput::TYPE_LOADED);
+		// Viewers will be set only if the block doesn't already exist
+		block.viewers = loading_block.viewers;
+
+		if (block.has_voxels() && block.get_voxels_const().get_size() != expected_block_size) {
+			// Voxel block size is incorrect, drop it
+			ZN_PRINT_ERROR(
+					format("Block is different from expected size. Expected {}, got {}",
+						   expected_block_size,
+						   block.get_voxels_const().get_size())
+			);
+			++_stats.dropped_block_loads;
+			continue;
+		}
+
+		positions.push_back(block_pos);
+		blocks.push_back(std::move(block));
+		loading_blocks.push_back(std::move(loading_block));
+	}
+
+	_received_data_blocks.clear();
+
+	if (blocks.size() == 0) {
 		return;
 	}
 
-	_data->try_set_block(
-			block_pos,
-			block,
-			[
-#ifdef DEBUG_ENABLED
-					block_pos
-#endif
-	](VoxelDataBlock &existing_block, const VoxelDataBlock &incoming_block) {
-#ifdef DEBUG_ENABLED
+	_data->try_set_blocks(
+			to_span_const(positions),
+			to_span_const(blocks),
+			0,
+			[](const Vector3i block_pos, VoxelDataBlock &existing_block, const VoxelDataBlock &incoming_block) {
 				ZN_PRINT_VERBOSE(format("Replacing existing data block {}", block_pos));
-#endif
 				existing_block.set_voxels(incoming_block.get_voxels_shared());
 				existing_block.set_edited(incoming_block.is_edited());
 			}
 	);
 
-	emit_data_block_loaded(block_pos);
+	for (unsigned int block_index = 0; block_index < positions.size(); ++block_index) {
+		const Vector3i block_pos = positions[block_index];
 
-	for (unsigned int i = 0; i < loading_block.viewers_to_notify.size(); ++i) {
-		const ViewerID viewer_id = loading_block.viewers_to_notify[i];
-		notify_data_block_enter(block, block_pos, viewer_id);
+		emit_data_block_loaded(block_pos);
+
+		const LoadingBlock &loading_block = loading_blocks[block_index];
+		for (unsigned int i = 0; i < loading_block.viewers_to_notify.size(); ++i) {
+			const ViewerID viewer_id = loading_block.viewers_to_notify[i];
+			notify_data_block_enter(blocks[block_index], block_pos, viewer_id);
+		}
 	}
 
-	// The block itself might not be suitable for meshing yet, but blocks surrounding it might be now
-	// TODO Optimize: initial loading can hang for a while here.
-	// Because lots of blocks are loaded at once, which leads to many block queries.
-	try_schedule_mesh_update_from_data(
-			Box3i(_data->block_to_voxel(block_pos), Vector3iUtil::create(get_data_block_size()))
+	// The blocks themselves might not be suitable for meshing yet, but blocks surrounding them might be now
+	{
+		static thread_local StdVector<Box3i> tls_boxes;
+		StdVector<Box3i> &boxes = tls_boxes;
+		boxes.clear();
+
+		const Vector3i data_block_size = Vector3iUtil::create(get_data_block_size());
+		for (const Vector3i block_pos : positions) {
+			boxes.push_back(Box3i(_data->block_to_voxel(block_pos), data_block_size));
+		}
+
+		try_schedule_mesh_update_from_data(to_span_const(boxes));
+	}
+
+	// Remaining blocks include those that will be requested again after being dropped
+	emit_signal(
+			VoxelStringNames::get_singleton().data_loading_progress,
+			static_cast<int64_t>(positions.size()),
+			static_cast<int64_t>(_loading_blocks.size())
 	);
 
+	// Release references to voxels. Blocks are now owned by the map.
+	blocks.clear();
+	loading_blocks.clear();
+
 	// We might have requested some blocks again (if we got a dropped one while we still need them)
 	// if (stream_enabled) {
 	// 	send_block_data_requests();
@@ -1835,6 +1971,40 @@ void VoxelTerrain::process_meshing() {
 	// const int used_channels_mask = get_used_channels_mask();
 	const int mesh_to_data_factor = get_mesh_block_size() / get_data_block_size();
 
+	if (_blocks_pending_update.size() > 1 && _paired_viewers.size() > 0) {
+		ZN_PROFILE_SCOPE_NAMED("Sort");
+		// Schedule blocks closest to viewers first. The thread pool sorts tasks by priority too, but only periodically,
+		// so this makes nearby blocks show up sooner when lots of them are scheduled at once (like when the game
+		// starts).
+		struct BlockDistance {
+			Vector3i position;
+			int distance;
+		};
+		static thread_local StdVector<BlockDistance> tls_block_distances;
+		StdVector<BlockDistance> &block_distances = tls_block_distances;
+		block_distances.clear();
+
+		const int mesh_block_size = get_mesh_block_size();
+		const Vector3i half_block_size = Vector3iUtil::create(mesh_block_size / 2);
+
+		for (const Vector3i mesh_block_pos : _blocks_pending_update) {
+			const Vector3i center = mesh_block_pos * mesh_block_size + half_block_size;
+			int distance = std::numeric_limits<int>::max();
+			for (const PairedViewer &viewer : _paired_viewers) {
+				distance = math::min(distance, math::chebyshev_distance(center, viewer.state.local_position_voxels));
+			}
+			block_distances.push_back(BlockDistance{ mesh_block_pos, distance });
+		}
+
+		std::sort(block_distances.begin(), block_distances.end(), [](const BlockDistance &a, const BlockDistance &b) {
+			return a.distance < b.distance;
+		});
+
+		for (size_t i = 0; i < block_distances.size(); ++i) {
+			_blocks_pending_update[i] = block_distances[i].position;
+		}
+	}
+
 	BufferedTaskScheduler &scheduler = BufferedTaskScheduler::get_for_current_thread();
 
 	for (size_t bi = 0; bi < _blocks_pending_update.size(); ++bi) {
@@ -1867,9 +2037,19 @@ void VoxelTerrain::process_meshing() {
 		task->lod_index = 0;
 		task->meshing_dependency = _meshing_dependency;
 		task->require_visual = mesh_block->mesh_viewers.get() > 0;
+#ifdef VOXEL_ENABLE_INSTANCER
+		// Instances are generated from surfaces of the mesh, even those only meshed for collision
+		task->keep_render_attributes = _instancer != nullptr;
+#endif
 		task->collision_hint = _generate_collisions && mesh_block->collision_viewers.get() > 0;
+		task->side_connectivity_hint = _occlusion_culling_state != nullptr;
 		task->data = _data;
 
+		if (mesh_block->mesher_incremental_cache == nullptr && _mesher.is_valid()) {
+			mesh_block->mesher_incremental_cache = _mesher->create_incremental_cache();
+		}
+		task->incremental_cache = mesh_block->mesher_incremental_cache;
+
 		// This iteration order is specifically chosen to match VoxelEngine and threaded access
 		_data->get_blocks_with_voxel_data(data_box, 0, to_span(task->blocks));
 		task->blocks_count = Vector3iUtil::get_volume_u64(data_box.size);
@@ -2018,9 +2198,23 @@ void VoxelTerrain::apply_mesh_update(const VoxelEngine::BlockMeshOutput &ob) {
 		block->set_material_override(_material_override);
 	}
 
+	// The first result is always reported, even if every side is connected. Otherwise the block would not be known
+	// by occlusion culling, so it would never get hidden.
+	if (!block->side_connectivity_known || block->side_connectivity != ob.surfaces.side_connectivity) {
+		block->side_connectivity = ob.surfaces.side_connectivity;
+		block->side_connectivity_known = true;
+		if (_occlusion_culling_state != nullptr) {
+			VoxelTerrainOcclusionCullingState &occlusion_culling = *_occlusion_culling_state;
+			MutexLock mlock(occlusion_culling.pending_changes_mutex);
+			occlusion_culling.pending_changes.push_back({ ob.position, block->side_connectivity, false });
+		}
+	}
+
 	const bool gen_collisions = _generate_collisions && block->collision_viewers.get() > 0;
 	if (gen_collisions) {
-		Ref<Shape3D> collision_shape = make_collision_shape_from_mesher_output(ob.surfaces, **_mesher);
+		Ref<Shape3D> collision_shape = ob.has_collision_shape
+				? ob.collision_shape
+				: make_collision_shape_from_mesher_output(ob.surfaces, **_mesher);
 
 		bool debug_collisions = false;
 		if (is_inside_tree()) {
@@ -2054,6 +2248,74 @@ void VoxelTerrain::apply_mesh_update(const VoxelEngine::BlockMeshOutput &ob) {
 	}
 }
 
+bool VoxelTerrain::get_camera_position(Vector3 &out_position) const {
+	if (!is_inside_tree()) {
+		return false;
+	}
+#ifdef TOOLS_ENABLED
+	if (Engine::get_singleton()->is_editor_hint()) {
+		// Falling back on the editor's camera
+		out_position = godot::VoxelEngine::get_singleton()->get_editor_camera_position();
+		return true;
+	}
+#endif
+	const Viewport *vp = get_viewport();
+	if (vp == nullptr) {
+		return false;
+	}
+	const Camera3D *camera = vp->get_camera_3d();
+	if (camera == nullptr) {
+		return false;
+	}
+	out_position = camera->get_global_transform().get_origin();
+	return true;
+}
+
+void VoxelTerrain::process_occlusion_culling() {
+	if (_occlusion_culling_state == nullptr) {
+		return;
+	}
+	VoxelTerrainOcclusionCullingState &occlusion_culling = *_occlusion_culling_state;
+	if (!occlusion_culling.task_is_complete) {
+		return;
+	}
+	ZN_PROFILE_SCOPE();
+
+	for (const Vector3i bpos : occlusion_culling.blocks_to_hide) {
+		// Blocks that were unloaded since the task started may have been loaded again, in which case results about
+		// them are outdated
+		if (occlusion_culling.removed_blocks_since_schedule.find(bpos) !=
+			occlusion_culling.removed_blocks_since_schedule.end()) {
+			continue;
+		}
+		VoxelMeshBlockVT *block = _mesh_map.get_block(bpos);
+		if (block != nullptr) {
+			block->set_occlusion_culled(true);
+		}
+	}
+	for (const Vector3i bpos : occlusion_culling.blocks_to_show) {
+		VoxelMeshBlockVT *block = _mesh_map.get_block(bpos);
+		if (block != nullptr) {
+			block->set_occlusion_culled(false);
+		}
+	}
+	occlusion_culling.blocks_to_hide.clear();
+	occlusion_culling.blocks_to_show.clear();
+	occlusion_culling.removed_blocks_since_schedule.clear();
+
+	Vector3 camera_position;
+	if (!get_camera_position(camera_position)) {
+		return;
+	}
+	const Vector3 local_camera_position = get_global_transform().affine_inverse().xform(camera_position);
+
+	occlusion_culling.camera_block_position = math::floor_to_int(local_camera_position) >> get_mesh_block_size_pow2();
+	occlusion_culling.max_distance_in_blocks = (_max_view_distance_voxels >> get_mesh_block_size_pow2()) + 1;
+	occlusion_culling.task_is_complete = false;
+
+	VoxelEngine::get_singleton().push_async_task(ZN_NEW(VoxelTerrainOcclusionCullingTask(_occlusion_culling_state)));
+}
+
 Ref<VoxelTool> VoxelTerrain::get_voxel_tool() {
 	Ref<VoxelTool> vt = memnew(VoxelToolTerrain(this));
 	const int used_channels_mask = get_used_channels_mask();
@@ -2418,6 +2680,9 @@ void VoxelTerrain::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_automatic_loading_enabled", "enable"), &Self::set_automatic_loading_enabled);
 	ClassDB::bind_method(D_METHOD("is_automatic_loading_enabled"), &Self::is_automatic_loading_enabled);
 
+	ClassDB::bind_method(D_METHOD("set_occlusion_culling_enabled", "enabled"), &Self::set_occlusion_culling_enabled);
+	ClassDB::bind_method(D_METHOD("is_occlusion_culling_enabled"), &Self::is_occlusion_culling_enabled);
+
 #ifdef VOXEL_ENABLE_GPU
 	ClassDB::bind_method(D_METHOD("set_generator_use_gpu", "enable"), &Self::set_generator_use_gpu);
 	ClassDB::bind_method(D_METHOD("get_generator_use_gpu"), &Self::get_generator_use_gpu);
@@ -2517,6 +2782,11 @@ void VoxelTerrain::_bind_methods() {
 			"is_stream_running_in_editor"
 	);
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "mesh_block_size"), "set_mesh_block_size", "get_mesh_block_size");
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "occlusion_culling_enabled"),
+			"set_occlusion_culling_enabled",
+			"is_occlusion_culling_enabled"
+	);
 #ifdef VOXEL_ENABLE_GPU
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "use_gpu_generation"), "set_generator_use_gpu", "get_generator_use_gpu");
 #endif
@@ -2554,6 +2824,11 @@ void VoxelTerrain::_bind_methods() {
 	// TODO Add back access to block, but with an API securing multithreaded access
 	ADD_SIGNAL(MethodInfo("block_loaded", PropertyInfo(Variant::VECTOR3I, "position")));
 	ADD_SIGNAL(MethodInfo("block_unloaded", PropertyInfo(Variant::VECTOR3I, "position")));
+	ADD_SIGNAL(MethodInfo(
+			"data_loading_progress",
+			PropertyInfo(Variant::INT, "loaded_block_count"),
+			PropertyInfo(Variant::INT, "remaining_block_count")
+	));
 
 	ADD_SIGNAL(MethodInfo("mesh_block_entered", PropertyInfo(Variant::VECTOR3I, "position")));
 	ADD_SIGNAL(MethodInfo("mesh_block_exited", PropertyInfo(Variant::VECTOR3I, "position")));
@@ -4,6 +4,7 @@
 #include "../../constants/voxel_constants.h"
 #include "../../engine/meshing_dependency.h"
 #include "../../storage/voxel_data.h"
+#include "../../util/containers/span.h"
 #include "../../util/containers/std_unordered_map.h"
 #include "../../util/containers/std_vector.h"
 #include "../../util/godot/core/gdvirtual.h"
@@ -13,6 +14,7 @@
 #include "../voxel_mesh_map.h"
 #include "../voxel_node.h"
 #include "voxel_mesh_block_vt.h"
+#include "voxel_terrain_occlusion_culling.h"
 #include "voxel_terrain_multiplayer_synchronizer.h"
 
 #ifdef TOOLS_ENABLED
@@ -95,6 +97,11 @@ public:
 	void set_automatic_loading_enabled(bool enable);
 	bool is_automatic_loading_enabled() const;
 
+	// Hides blocks that can't be seen from the camera because they are behind opaque voxels, like caves underground.
+	// Only works with meshers that provide side connectivity (currently `VoxelMesherBlocky`).
+	void set_occlusion_culling_enabled(bool enabled);
+	bool is_occlusion_culling_enabled() const;
+
 	void set_material_override(Ref<Material> material);
 	Ref<Material> get_material_override() const;
 
@@ -216,7 +223,10 @@ private:
 	// void process_received_data_blocks();
 	void process_meshing();
 	void apply_mesh_update(const VoxelEngine::BlockMeshOutput &ob);
-	void apply_data_block_response(VoxelEngine::BlockDataOutput &ob);
+	void process_occlusion_culling();
+	bool get_camera_position(Vector3 &out_position) const;
+	void receive_data_block_response(VoxelEngine::BlockDataOutput &ob);
+	void apply_data_block_responses();
 
 	void _on_stream_params_changed();
 	// void _set_block_size_po2(int p_block_size_po2);
@@ -235,8 +245,9 @@ private:
 	// void unload_data_block(Vector3i bpos);
 	void unload_mesh_block(Vector3i bpos);
 	// void make_data_block_dirty(Vector3i bpos);
-	void try_schedule_mesh_update(VoxelMeshBlockVT &block);
+	void try_schedule_mesh_update(VoxelMeshBlockVT &block, const bool whole_block_changed = true);
 	void try_schedule_mesh_update_from_data(const Box3i &box_in_voxels);
+	void try_schedule_mesh_update_from_data(Span<const Box3i> boxes_in_voxels);
 
 	void save_all_modified_blocks(bool with_copy, std::shared_ptr<AsyncDependencyTracker> tracker);
 	void get_viewer_pos_and_direction(Vector3 &out_pos, Vector3 &out_direction) const;
@@ -332,7 +343,7 @@ private:
 	// The order in that list does not matter.
 	StdVector<Vector3i> _blocks_pending_load;
 	// Block meshes that should be updated on the next process call.
-	// The order in that list does not matter.
+	// They get sorted by distance to viewers before being scheduled.
 	StdVector<Vector3i> _blocks_pending_update;
 	// Blocks that should be saved on the next process call.
 	// The order in that list does not matter.
@@ -347,6 +358,9 @@ private:
 		Vector3i position;
 	};
 	StdVector<QuickReloadingBlock> _quick_reloading_blocks;
+	// Loaded and generated data blocks received since the last process call. They are applied all at once, because
+	// large amounts of them can arrive in the same frame (when the game starts or when a viewer teleports).
+	StdVector<VoxelEngine::BlockDataOutput> _received_data_blocks;
 
 	Ref<VoxelMesher> _mesher;
 
@@ -369,6 +383,9 @@ private:
 
 	Ref<Material> _material_override;
 
+	// Null when occlusion culling is disabled. Shared with the task that computes it.
+	std::shared_ptr<VoxelTerrainOcclusionCullingState> _occlusion_culling_state;
+
 	zylann::godot::ObjectUniquePtr<VoxelDataBlockEnterInfo> _data_block_enter_info_obj;
 
 	// References to external nodes.
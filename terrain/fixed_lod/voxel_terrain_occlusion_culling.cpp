@@ -0,0 +1,147 @@
+#include "voxel_terrain_occlusion_culling.h"
+#include "../../constants/cube_tables.h"
+#include "../../meshers/side_connectivity.h"
+#include "../../util/math/funcs.h"
+#include "../../util/profiling.h"
+
+namespace zylann::voxel {
+
+namespace {
+
+void apply_changes(VoxelTerrainOcclusionCullingState &state) {
+	ZN_PROFILE_SCOPE();
+
+	state.changes.clear();
+	{
+		MutexLock mlock(state.pending_changes_mutex);
+		state.changes.swap(state.pending_changes);
+	}
+
+	for (const VoxelTerrainOcclusionCullingState::BlockChange &change : state.changes) {
+		if (change.removed) {
+			state.side_connectivity_map.erase(change.position);
+			// The main thread creates new blocks visible
+			state.culled_blocks.erase(change.position);
+		} else {
+			state.side_connectivity_map[change.position] = change.side_connectivity;
+		}
+	}
+}
+
+} // namespace
+
+void find_reachable_blocks(
+		const StdUnorderedMap<Vector3i, uint16_t> &side_connectivity_map,
+		const Vector3i camera_bpos,
+		const int max_distance,
+		StdUnorderedMap<Vector3i, uint8_t> &reached_blocks
+) {
+	ZN_PROFILE_SCOPE();
+
+	struct Item {
+		Vector3i position;
+		uint8_t entry_side;
+		// Directions taken so far. Going in the opposite direction of one of them cannot lead to something visible.
+		uint8_t directions_mask;
+	};
+
+	static thread_local StdVector<Item> tls_queue;
+	StdVector<Item> &queue = tls_queue;
+	queue.clear();
+
+	reached_blocks.clear();
+	// The camera can see every side of the block it is in
+	reached_blocks.insert({ camera_bpos, 0 });
+
+	for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
+		const Vector3i npos = camera_bpos + Cube::g_side_normals[side];
+		const uint8_t entry_side = Cube::g_opposite_side[side];
+		reached_blocks[npos] |= (1 << entry_side);
+		queue.push_back(Item{ npos, entry_side, static_cast<uint8_t>(1 << side) });
+	}
+
+	// Using the vector as a FIFO so blocks are visited in breadth-first order
+	for (size_t item_index = 0; item_index < queue.size(); ++item_index) {
+		const Item item = queue[item_index];
+
+		uint16_t connectivity = side_connectivity::ALL_CONNECTED;
+		auto it = side_connectivity_map.find(item.position);
+		if (it != side_connectivity_map.end()) {
+			connectivity = it->second;
+		}
+		// Blocks we don't know about are considered empty. They could be loading, or not meshed because they have no
+		// geometry.
+
+		for (unsigned int side = 0; side < Cube::SIDE_COUNT; ++side) {
+			if ((item.directions_mask & (1 << Cube::g_opposite_side[side])) != 0) {
+				continue;
+			}
+			if (side == item.entry_side || !side_connectivity::are_connected(connectivity, item.entry_side, side)) {
+				continue;
+			}
+
+			const Vector3i npos = item.position + Cube::g_side_normals[side];
+			const Vector3i diff = npos - camera_bpos;
+			if (math::max(math::abs(diff.x), math::max(math::abs(diff.y), math::abs(diff.z))) > max_distance) {
+				continue;
+			}
+
+			const uint8_t entry_side = Cube::g_opposite_side[side];
+			uint8_t &entry_sides = reached_blocks[npos];
+			if ((entry_sides & (1 << entry_side)) != 0) {
+				continue;
+			}
+			entry_sides |= (1 << entry_side);
+
+			queue.push_back(Item{ npos, entry_side, static_cast<uint8_t>(item.directions_mask | (1 << side)) });
+		}
+	}
+}
+
+void VoxelTerrainOcclusionCullingTask::run(ThreadedTaskContext &ctx) {
+	ZN_PROFILE_SCOPE();
+
+	struct SetCompleteOnScopeExit {
+		std::atomic_bool &_complete;
+		SetCompleteOnScopeExit(std::atomic_bool &b) : _complete(b) {}
+		~SetCompleteOnScopeExit() {
+			_complete = true;
+		}
+	};
+
+	ZN_ASSERT(_state != nullptr);
+	VoxelTerrainOcclusionCullingState &state = *_state;
+
+	SetCompleteOnScopeExit scoped_complete(state.task_is_complete);
+
+	apply_changes(state);
+
+	static thread_local StdUnorderedMap<Vector3i, uint8_t> tls_reached_blocks;
+	StdUnorderedMap<Vector3i, uint8_t> &reached_blocks = tls_reached_blocks;
+
+	find_reachable_blocks(
+			state.side_connectivity_map, state.camera_block_position, state.max_distance_in_blocks, reached_blocks
+	);
+
+	ZN_PROFILE_SCOPE_NAMED("Diff");
+
+	state.blocks_to_hide.clear();
+	state.blocks_to_show.clear();
+
+	// Only report changes, so the main thread doesn't have to go through every block
+	for (auto it = state.side_connectivity_map.begin(); it != state.side_connectivity_map.end(); ++it) {
+		const Vector3i bpos = it->first;
+		const bool reached = reached_blocks.find(bpos) != reached_blocks.end();
+		if (reached) {
+			if (state.culled_blocks.erase(bpos) != 0) {
+				state.blocks_to_show.push_back(bpos);
+			}
+		} else {
+			if (state.culled_blocks.insert(bpos).second) {
+				state.blocks_to_hide.push_back(bpos);
+			}
+		}
+	}
+}
+
+} // namespace zylann::voxel
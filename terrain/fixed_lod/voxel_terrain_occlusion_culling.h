@@ -0,0 +1,78 @@
+#ifndef VOXEL_TERRAIN_OCCLUSION_CULLING_H
+#define VOXEL_TERRAIN_OCCLUSION_CULLING_H
+
+#include "../../util/containers/std_unordered_map.h"
+#include "../../util/containers/std_unordered_set.h"
+#include "../../util/containers/std_vector.h"
+#include "../../util/math/vector3i.h"
+#include "../../util/tasks/threaded_task.h"
+#include "../../util/thread/mutex.h"
+#include <atomic>
+#include <memory>
+
+namespace zylann::voxel {
+
+// Shared between `VoxelTerrain` and its occlusion culling task. The task finds which mesh blocks can be reached from
+// the camera by going through sides that are connected by non-opaque voxels (see `side_connectivity.h`). Blocks that
+// can't be reached are hidden, which typically removes caves and underground from rendering.
+// Based on https://tomcc.github.io/2014/08/31/visibility-1.html
+struct VoxelTerrainOcclusionCullingState {
+	struct BlockChange {
+		Vector3i position;
+		uint16_t side_connectivity;
+		bool removed;
+	};
+
+	// Written by the main thread, consumed by the task.
+	StdVector<BlockChange> pending_changes;
+	BinaryMutex pending_changes_mutex;
+
+	// Inputs, only written by the main thread while no task is running.
+	Vector3i camera_block_position;
+	int max_distance_in_blocks = 0;
+
+	// Outputs, only read by the main thread once the task is complete.
+	StdVector<Vector3i> blocks_to_hide;
+	StdVector<Vector3i> blocks_to_show;
+
+	// Only accessed by the main thread.
+	// Blocks unloaded since the last task was scheduled. Results concerning them are outdated, and the task will
+	// forget about them next time it runs.
+	StdUnorderedSet<Vector3i> removed_blocks_since_schedule;
+
+	// Only accessed by the task.
+	StdUnorderedMap<Vector3i, uint16_t> side_connectivity_map;
+	StdUnorderedSet<Vector3i> culled_blocks;
+	StdVector<BlockChange> changes;
+
+	std::atomic_bool task_is_complete = { true };
+};
+
+// Finds blocks that can be seen from the block containing the camera, within `max_distance` blocks (Chebyshev
+// distance). `reached_blocks` is filled with the mask of sides each reached block was entered from. Blocks missing from
+// `side_connectivity_map` are considered empty.
+void find_reachable_blocks(
+		const StdUnorderedMap<Vector3i, uint16_t> &side_connectivity_map,
+		const Vector3i camera_bpos,
+		const int max_distance,
+		StdUnorderedMap<Vector3i, uint8_t> &reached_blocks
+);
+
+// Only one of these tasks can run at once per terrain.
+class VoxelTerrainOcclusionCullingTask : public IThreadedTask {
+public:
+	VoxelTerrainOcclusionCullingTask(std::shared_ptr<VoxelTerrainOcclusionCullingState> p_state) : _state(p_state) {}
+
+	const char *get_debug_name() const override {
+		return "VoxelTerrainOcclusionCulling";
+	}
+
+	void run(ThreadedTaskContext &ctx) override;
+
+private:
+	std::shared_ptr<VoxelTerrainOcclusionCullingState> _state;
+};
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_TERRAIN_OCCLUSION_CULLING_H
@@ -69,9 +69,7 @@ void snap_surface_points_from_generator_sdf(
 	ZN_ASSERT_RETURN_MSG(sample_count <= GEN_SDF_SAMPLE_COUNT_MAX, "Sample count is too high");
 
 	// TODO Candidates for temp allocator
-	StdVector<float> x_buffer;
-	StdVector<float> y_buffer;
-	StdVector<float> z_buffer;
+	StdVector<Vector3f> pos_buffer;
 	StdVector<float> sd_buffer;
 
 	const Vector3f positions_origin_f = to_vec3f(positions_origin);
@@ -83,9 +81,7 @@ void snap_surface_points_from_generator_sdf(
 
 		const unsigned int buffer_len = positions.size() * sample_count;
 
-		x_buffer.resize(buffer_len);
-		y_buffer.resize(buffer_len);
-		z_buffer.resize(buffer_len);
+		pos_buffer.resize(buffer_len);
 		sd_buffer.resize(buffer_len);
 
 		const float sample_count_inv_den = 1.f / static_cast<float>(sample_count - 1);
@@ -104,24 +100,23 @@ void snap_surface_points_from_generator_sdf(
 				// Goes from 0 to 1 included
 				const float t = static_cast<float>(j) * sample_count_inv_den;
 
-				const Vector3f pos = math::lerp(min_pos, max_pos, t);
-
-				x_buffer[k] = pos.x;
-				y_buffer[k] = pos.y;
-				z_buffer[k] = pos.z;
+				pos_buffer[k] = math::lerp(min_pos, max_pos, t);
 			}
 		}
 	}
 
-	generator.generate_series(
-			to_span(x_buffer),
-			to_span(y_buffer),
-			to_span(z_buffer),
-			VoxelBuffer::CHANNEL_SDF,
-			to_span(sd_buffer),
-			chunk_min_pos,
-			chunk_max_pos
-	);
+	{
+		VoxelGenerator::SeriesOutput sd_output;
+		sd_output.type = VoxelGenerator::SeriesOutput::TYPE_SDF;
+		sd_output.values = to_span(sd_buffer);
+
+		generator.generate_series_batch(
+				to_span(pos_buffer),
+				Span<const VoxelGenerator::SeriesOutput>(&sd_output, 1),
+				chunk_min_pos,
+				chunk_max_pos
+		);
+	}
 
 	// int debug_hits = 0;
 	// int debug_misses = 0;
@@ -0,0 +1,355 @@
+#include "mesh_block_batches_vlt.h"
+#include "../../constants/voxel_string_names.h"
+#include "../../engine/voxel_engine.h"
+#include "../../meshers/mesh_block_task.h"
+#include "../../util/containers/container_funcs.h"
+#include "../../util/godot/classes/mesh.h"
+#include "../../util/math/conv.h"
+#include "../../util/profiling.h"
+#include "../../util/profiling_clock.h"
+#include "../free_mesh_task.h"
+
+namespace zylann::voxel {
+
+namespace {
+
+bool is_block_batchable(const VoxelMeshBlockVLT &block) {
+	if (!block.visual_active || !block.is_visible() || block.fading_state != VoxelMeshBlockVLT::FADING_NONE) {
+		return false;
+	}
+	// Transition stitching is specific to each block. With no transition, vertices of transition cells are collapsed,
+	// and secondary positions are not used, so they don't need to be offset when merged.
+	if (block.get_transition_mask() != 0) {
+		return false;
+	}
+	if (block.batching_surfaces.size() == 0) {
+		return false;
+	}
+	Ref<ShaderMaterial> shader_material = block.get_shader_material();
+	if (shader_material.is_valid()) {
+		// Detail textures are specific to each block
+		const Variant cell_lookup =
+				shader_material->get_shader_parameter(VoxelStringNames::get_singleton().u_voxel_cell_lookup);
+		if (cell_lookup.get_type() != Variant::NIL) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void split_batch(
+		zylann::godot::DirectMeshInstance &mesh_instance,
+		Ref<ShaderMaterial> &shader_material,
+		bool shader_material_shared,
+		VoxelMeshMap<VoxelMeshBlockVLT> &mesh_map,
+		ShaderMaterialPoolVLT &shader_material_pool,
+		Vector3i group_position
+) {
+	const Vector3i origin_bpos = group_position * 2;
+	for (int z = 0; z < 2; ++z) {
+		for (int y = 0; y < 2; ++y) {
+			for (int x = 0; x < 2; ++x) {
+				VoxelMeshBlockVLT *block = mesh_map.get_block(origin_bpos + Vector3i(x, y, z));
+				if (block != nullptr) {
+					block->set_batched(false);
+				}
+			}
+		}
+	}
+
+	// Same as blocks: the instance does not own its material override, so remove it before the material can go away
+	mesh_instance.set_material_override(Ref<Material>());
+	FreeMeshTask::try_add_and_destroy(mesh_instance);
+
+	if (shader_material.is_valid()) {
+		if (!shader_material_shared) {
+			shader_material_pool.recycle(shader_material);
+		}
+		shader_material.unref();
+	}
+}
+
+} // namespace
+
+void MeshBlockBatchesVLT::invalidate(
+		VoxelMeshMap<VoxelMeshBlockVLT> &mesh_map,
+		ShaderMaterialPoolVLT &shader_material_pool,
+		unsigned int lod_index,
+		Vector3i block_position
+) {
+	Lod &lod = _lods[lod_index];
+	const Vector3i group_position = block_position >> 1;
+
+	auto it = lod.batches.find(group_position);
+	if (it != lod.batches.end()) {
+		Batch &batch = it->second;
+		split_batch(
+				batch.mesh_instance,
+				batch.shader_material,
+				batch.shader_material_shared,
+				mesh_map,
+				shader_material_pool,
+				group_position
+		);
+		lod.batches.erase(it);
+	}
+
+	lod.groups_to_merge.insert(group_position);
+}
+
+void MeshBlockBatchesVLT::invalidate_all(const VoxelMeshMap<VoxelMeshBlockVLT> &mesh_map, unsigned int lod_index) {
+	Lod &lod = _lods[lod_index];
+	mesh_map.for_each_block([&lod](const VoxelMeshBlockVLT &block) { //
+		lod.groups_to_merge.insert(block.position >> 1);
+	});
+}
+
+void MeshBlockBatchesVLT::clear(
+		Span<VoxelMeshMap<VoxelMeshBlockVLT>> mesh_maps,
+		ShaderMaterialPoolVLT &shader_material_pool
+) {
+	ZN_PROFILE_SCOPE();
+
+	for (unsigned int lod_index = 0; lod_index < _lods.size(); ++lod_index) {
+		Lod &lod = _lods[lod_index];
+
+		if (lod_index < mesh_maps.size()) {
+			VoxelMeshMap<VoxelMeshBlockVLT> &mesh_map = mesh_maps[lod_index];
+			for (auto it = lod.batches.begin(); it != lod.batches.end(); ++it) {
+				Batch &batch = it->second;
+				split_batch(
+						batch.mesh_instance,
+						batch.shader_material,
+						batch.shader_material_shared,
+						mesh_map,
+						shader_material_pool,
+						it->first
+				);
+			}
+		}
+
+		lod.batches.clear();
+		lod.groups_to_merge.clear();
+	}
+}
+
+void MeshBlockBatchesVLT::process(
+		Span<VoxelMeshMap<VoxelMeshBlockVLT>> mesh_maps,
+		ShaderMaterialPoolVLT &shader_material_pool,
+		const MergeParams &params,
+		unsigned int begin_lod_index,
+		uint32_t timeout_usec
+) {
+	ZN_PROFILE_SCOPE();
+
+	const ProfilingClock profiling_clock;
+
+	for (unsigned int lod_index = 0; lod_index < mesh_maps.size(); ++lod_index) {
+		Lod &lod = _lods[lod_index];
+
+		if (lod_index < begin_lod_index) {
+			// Could have been scheduled before batching settings changed
+			lod.groups_to_merge.clear();
+			continue;
+		}
+
+		VoxelMeshMap<VoxelMeshBlockVLT> &mesh_map = mesh_maps[lod_index];
+
+		for (auto it = lod.groups_to_merge.begin(); it != lod.groups_to_merge.end();) {
+			const Vector3i group_position = *it;
+			it = lod.groups_to_merge.erase(it);
+
+			if (lod.batches.find(group_position) == lod.batches.end()) {
+				try_merge(lod, mesh_map, shader_material_pool, params, lod_index, group_position);
+			}
+
+			// We always process at least one, then we check the timeout
+			if (profiling_clock.get_elapsed_microseconds() >= timeout_usec) {
+				return;
+			}
+		}
+	}
+}
+
+void MeshBlockBatchesVLT::try_merge(
+		Lod &lod,
+		VoxelMeshMap<VoxelMeshBlockVLT> &mesh_map,
+		ShaderMaterialPoolVLT &shader_material_pool,
+		const MergeParams &params,
+		unsigned int lod_index,
+		Vector3i group_position
+) {
+	ZN_PROFILE_SCOPE();
+
+	const Vector3i origin_bpos = group_position * 2;
+	const int block_size_in_voxels = params.mesh_block_size << lod_index;
+
+	FixedArray<VoxelMeshBlockVLT *, 8> blocks;
+	unsigned int block_count = 0;
+
+	for (int z = 0; z < 2; ++z) {
+		for (int y = 0; y < 2; ++y) {
+			for (int x = 0; x < 2; ++x) {
+				VoxelMeshBlockVLT *block = mesh_map.get_block(origin_bpos + Vector3i(x, y, z));
+				if (block == nullptr || !block->has_mesh()) {
+					// Nothing to draw there. If it gets a mesh later, the group will be invalidated.
+					continue;
+				}
+				if (!is_block_batchable(*block)) {
+					return;
+				}
+				if (block_count > 0 &&
+					(block->batching_mesh_flags != blocks[0]->batching_mesh_flags ||
+					 block->batching_primitive_type != blocks[0]->batching_primitive_type)) {
+					return;
+				}
+				blocks[block_count] = block;
+				++block_count;
+			}
+		}
+	}
+
+	if (block_count < 2) {
+		// Nothing to gain
+		return;
+	}
+
+	static thread_local StdVector<uint16_t> tls_material_indices;
+	StdVector<uint16_t> &material_indices = tls_material_indices;
+	material_indices.clear();
+
+	for (unsigned int i = 0; i < block_count; ++i) {
+		for (const VoxelMesher::Output::Surface &surface : blocks[i]->batching_surfaces) {
+			if (!contains(to_span_const(material_indices), surface.material_index)) {
+				material_indices.push_back(surface.material_index);
+			}
+		}
+	}
+
+	// Not thread-local because these hold references to Godot arrays
+	StdVector<Array> surfaces_to_merge;
+	StdVector<Vector3> offsets;
+	StdVector<VoxelMesher::Output::Surface> merged_surfaces;
+
+	for (const uint16_t material_index : material_indices) {
+		surfaces_to_merge.clear();
+		offsets.clear();
+
+		for (unsigned int i = 0; i < block_count; ++i) {
+			const VoxelMeshBlockVLT &block = *blocks[i];
+			const Vector3 offset = to_vec3((block.position - origin_bpos) * block_size_in_voxels);
+
+			for (const VoxelMesher::Output::Surface &surface : block.batching_surfaces) {
+				if (surface.material_index == material_index &&
+					zylann::godot::is_surface_triangulated(surface.arrays)) {
+					surfaces_to_merge.push_back(surface.arrays);
+					offsets.push_back(offset);
+				}
+			}
+		}
+
+		if (surfaces_to_merge.size() == 0) {
+			continue;
+		}
+
+		Array merged_arrays = zylann::godot::merge_surfaces(to_span_const(surfaces_to_merge), to_span_const(offsets));
+		if (merged_arrays.is_empty()) {
+			// Surfaces have different formats
+			return;
+		}
+		merged_surfaces.push_back(VoxelMesher::Output::Surface{ merged_arrays, material_index });
+	}
+
+	StdVector<uint16_t> mesh_material_indices;
+	Ref<ArrayMesh> mesh = build_mesh(
+			to_span_const(merged_surfaces),
+			blocks[0]->batching_primitive_type,
+			blocks[0]->batching_mesh_flags,
+			mesh_material_indices
+	);
+	if (mesh.is_null()) {
+		return;
+	}
+
+	if (params.mesher != nullptr) {
+		const unsigned int surface_count = mesh->get_surface_count();
+		for (unsigned int surface_index = 0; surface_index < surface_count; ++surface_index) {
+			const unsigned int material_index = mesh_material_indices[surface_index];
+			mesh->surface_set_material(surface_index, params.mesher->get_material_by_index(material_index));
+		}
+	}
+
+	Batch &batch = lod.batches[group_position];
+	batch.local_position = origin_bpos * block_size_in_voxels;
+
+	Ref<ShaderMaterial> block_material = blocks[0]->get_shader_material();
+	if (block_material.is_valid() && blocks[0]->is_shader_material_shared()) {
+		// The batch can use the same material as blocks, its instance parameters are set below
+		batch.shader_material = block_material;
+		batch.shader_material_shared = true;
+
+	} else if (block_material.is_valid()) {
+		// Blocks have identical parameters when they are batchable, except their position
+		batch.shader_material = shader_material_pool.allocate();
+		ZN_ASSERT(batch.shader_material.is_valid());
+		zylann::godot::copy_shader_params(
+				**block_material, **batch.shader_material, shader_material_pool.get_cached_shader_uniforms()
+		);
+		batch.shader_material->set_shader_parameter(
+				VoxelStringNames::get_singleton().u_block_local_transform,
+				Transform3D(Basis(), to_vec3(batch.local_position))
+		);
+	}
+
+	zylann::godot::DirectMeshInstance &mi = batch.mesh_instance;
+	mi.create(VoxelEngine::get_singleton().get_rendering_instance_pool());
+	mi.set_interpolated(false);
+	mi.set_gi_mode(params.gi_mode);
+	mi.set_cast_shadows_setting(params.shadow_casting);
+	mi.set_render_layers_mask(params.render_layers_mask);
+	mi.set_mesh(mesh);
+	if (batch.shader_material.is_valid()) {
+		mi.set_material_override(batch.shader_material);
+		if (batch.shader_material_shared) {
+			// Rendering instances are pooled, so they could have parameters from a previous use
+			const VoxelStringNames &sn = VoxelStringNames::get_singleton();
+			mi.set_shader_instance_parameter(sn.u_transition_mask, 0);
+			mi.set_shader_instance_parameter(sn.u_lod_fade, Vector2(0.0, 0.0));
+		}
+	} else if (params.material_override.is_valid()) {
+		mi.set_material_override(params.material_override);
+	}
+	mi.set_transform(params.volume_transform * Transform3D(Basis(), to_vec3(batch.local_position)));
+	mi.set_world(params.world);
+
+	for (unsigned int i = 0; i < block_count; ++i) {
+		blocks[i]->set_batched(true);
+	}
+}
+
+void MeshBlockBatchesVLT::set_world(World3D *world) {
+	for (Lod &lod : _lods) {
+		for (auto it = lod.batches.begin(); it != lod.batches.end(); ++it) {
+			it->second.mesh_instance.set_world(world);
+		}
+	}
+}
+
+void MeshBlockBatchesVLT::set_volume_transform(const Transform3D &volume_transform) {
+	for (Lod &lod : _lods) {
+		for (auto it = lod.batches.begin(); it != lod.batches.end(); ++it) {
+			Batch &batch = it->second;
+			batch.mesh_instance.set_transform(volume_transform * Transform3D(Basis(), to_vec3(batch.local_position)));
+		}
+	}
+}
+
+unsigned int MeshBlockBatchesVLT::get_batch_count() const {
+	unsigned int count = 0;
+	for (const Lod &lod : _lods) {
+		count += lod.batches.size();
+	}
+	return count;
+}
+
+} // namespace zylann::voxel
@@ -0,0 +1,96 @@
+#ifndef VOXEL_MESH_BLOCK_BATCHES_VLT_H
+#define VOXEL_MESH_BLOCK_BATCHES_VLT_H
+
+#include "../../constants/voxel_constants.h"
+#include "../../util/containers/fixed_array.h"
+#include "../../util/containers/span.h"
+#include "../../util/containers/std_unordered_map.h"
+#include "../../util/containers/std_unordered_set.h"
+#include "../../util/godot/direct_mesh_instance.h"
+#include "../voxel_mesh_map.h"
+#include "shader_material_pool_vlt.h"
+#include "voxel_mesh_block_vlt.h"
+
+namespace zylann::voxel {
+
+// Merges meshes of groups of 2x2x2 mesh blocks of the same LOD into a single rendering instance. Distant LODs have
+// blocks covering a large area with few triangles each, so the cost of rendering them is dominated by the number of
+// draw calls rather than by their geometry.
+// A group is merged once all its blocks having a mesh are in a stable state (active, not fading, no transition
+// stitching, no detail textures). It is split as soon as one of its blocks changes, and may be merged again later.
+class MeshBlockBatchesVLT {
+public:
+	struct MergeParams {
+		Transform3D volume_transform;
+		// Null if the volume is not in a world or is hidden
+		World3D *world = nullptr;
+		GeometryInstance3D::GIMode gi_mode;
+		RenderingServer::ShadowCastingSetting shadow_casting;
+		int render_layers_mask;
+		// Used when blocks don't have a ShaderMaterial
+		Ref<Material> material_override;
+		const VoxelMesher *mesher = nullptr;
+		unsigned int mesh_block_size;
+	};
+
+	// Splits the group containing the given block if it was merged, and schedules it to be merged again.
+	// Must be called before the block changes, so it doesn't remain hidden behind an outdated merged mesh.
+	void invalidate(
+			VoxelMeshMap<VoxelMeshBlockVLT> &mesh_map,
+			ShaderMaterialPoolVLT &shader_material_pool,
+			unsigned int lod_index,
+			Vector3i block_position
+	);
+
+	// Schedules merging of every group having blocks in the map.
+	void invalidate_all(const VoxelMeshMap<VoxelMeshBlockVLT> &mesh_map, unsigned int lod_index);
+
+	// Splits every merged group, and forgets about groups pending merging.
+	void clear(Span<VoxelMeshMap<VoxelMeshBlockVLT>> mesh_maps, ShaderMaterialPoolVLT &shader_material_pool);
+
+	// Merges groups pending merging, from LOD `begin_lod_index` onwards, until the time budget is exceeded.
+	void process(
+			Span<VoxelMeshMap<VoxelMeshBlockVLT>> mesh_maps,
+			ShaderMaterialPoolVLT &shader_material_pool,
+			const MergeParams &params,
+			unsigned int begin_lod_index,
+			uint32_t timeout_usec
+	);
+
+	void set_world(World3D *world);
+	void set_volume_transform(const Transform3D &volume_transform);
+
+	unsigned int get_batch_count() const;
+
+private:
+	struct Batch {
+		// Position of the merged mesh in voxels, local to the volume
+		Vector3i local_position;
+		// Declared before the instance, so it gets destroyed after it
+		Ref<ShaderMaterial> shader_material;
+		// If true, the material belongs to blocks and parameters are set on the instance
+		bool shader_material_shared = false;
+		zylann::godot::DirectMeshInstance mesh_instance;
+	};
+
+	struct Lod {
+		// Keys are positions of groups, which are block positions divided by 2
+		StdUnorderedMap<Vector3i, Batch> batches;
+		StdUnorderedSet<Vector3i> groups_to_merge;
+	};
+
+	void try_merge(
+			Lod &lod,
+			VoxelMeshMap<VoxelMeshBlockVLT> &mesh_map,
+			ShaderMaterialPoolVLT &shader_material_pool,
+			const MergeParams &params,
+			unsigned int lod_index,
+			Vector3i group_position
+	);
+
+	FixedArray<Lod, constants::MAX_LOD> _lods;
+};
+
+} // namespace zylann::voxel
+
+#endif // VOXEL_MESH_BLOCK_BATCHES_VLT_H
@@ -53,7 +53,9 @@ void remove_shader_material_from_block(VoxelMeshBlockVLT &block, ShaderMaterialP
 	// Recycle material
 	Ref<ShaderMaterial> sm = block.get_shader_material();
 	if (sm.is_valid()) {
-		shader_material_pool.recycle(sm);
+		if (!block.is_shader_material_shared()) {
+			shader_material_pool.recycle(sm);
+		}
 		block.set_shader_material(Ref<ShaderMaterial>());
 	}
 }
@@ -126,6 +128,8 @@ VoxelLodTerrain::VoxelLodTerrain() {
 
 	set_notify_transform(true);
 
+	_shader_material_pool.set_max_size(VoxelEngine::get_singleton().get_shader_material_pool_size());
+
 	// Doing this to setup the defaults
 	set_process_callback(_process_callback);
 
@@ -209,7 +213,7 @@ void VoxelLodTerrain::set_material(Ref<Material> p_material) {
 	// Create a fork of the default shader if a new empty ShaderMaterial is assigned
 	if (Engine::get_singleton()->is_editor_hint()) {
 		if (shader_material.is_valid() && shader_material->get_shader().is_null() && _mesher.is_valid()) {
-			Ref<ShaderMaterial> default_sm = _mesher->get_default_lod_material();
+			Ref<ShaderMaterial> default_sm = get_mesher_default_lod_material();
 			if (default_sm.is_valid()) {
 				Ref<Shader> default_shader = default_sm->get_shader();
 				ZN_ASSERT_RETURN(default_shader.is_valid());
@@ -243,6 +247,11 @@ void VoxelLodTerrain::set_material(Ref<Material> p_material) {
 					// No visuals loaded (collision only?)
 					return;
 				}
+				if (_instance_shader_parameters_enabled) {
+					// Per-block parameters are on instances, so they are kept
+					block.set_shared_shader_material(get_or_create_shared_shader_material(lod_index));
+					return;
+				}
 				Ref<ShaderMaterial> sm = _shader_material_pool.allocate();
 				Ref<ShaderMaterial> prev_material = block.get_shader_material();
 				if (prev_material.is_valid()) {
@@ -275,6 +284,8 @@ void VoxelLodTerrain::set_material(Ref<Material> p_material) {
 			});
 		}
 	}
+
+	reset_mesh_batches();
 }
 
 unsigned int VoxelLodTerrain::get_data_block_size() const {
@@ -361,6 +372,7 @@ void VoxelLodTerrain::_on_gi_mode_changed() {
 			block.set_gi_mode(gi_mode);
 		});
 	}
+	reset_mesh_batches();
 }
 
 void VoxelLodTerrain::_on_shadow_casting_changed() {
@@ -370,6 +382,7 @@ void VoxelLodTerrain::_on_shadow_casting_changed() {
 			block.set_shadow_casting(mode);
 		});
 	}
+	reset_mesh_batches();
 }
 
 void VoxelLodTerrain::_on_render_layers_mask_changed() {
@@ -379,14 +392,61 @@ void VoxelLodTerrain::_on_render_layers_mask_changed() {
 			block.set_render_layers_mask(mask);
 		});
 	}
+	reset_mesh_batches();
+}
+
+Ref<ShaderMaterial> VoxelLodTerrain::get_mesher_default_lod_material() const {
+	if (_mesher.is_null()) {
+		return Ref<ShaderMaterial>();
+	}
+	// The default shader must declare per-block parameters the same way they are going to be set
+	if (_instance_shader_parameters_enabled) {
+		return _mesher->get_default_lod_instance_material();
+	}
+	return _mesher->get_default_lod_material();
 }
 
 void VoxelLodTerrain::update_shader_material_pool_template() {
 	Ref<ShaderMaterial> shader_material = _material;
-	if (_material.is_null() && _mesher.is_valid()) {
-		shader_material = _mesher->get_default_lod_material();
+	if (_material.is_null()) {
+		shader_material = get_mesher_default_lod_material();
 	}
 	_shader_material_pool.set_template(shader_material);
+
+	// Blocks keep using previous shared materials until they get new ones
+	for (Ref<ShaderMaterial> &shared_material : _shared_shader_materials_per_lod) {
+		shared_material.unref();
+	}
+}
+
+Ref<ShaderMaterial> VoxelLodTerrain::get_or_create_shared_shader_material(unsigned int lod_index) {
+	Ref<ShaderMaterial> &shared_material = _shared_shader_materials_per_lod[lod_index];
+	if (shared_material.is_null()) {
+		shared_material = _shader_material_pool.allocate();
+		if (shared_material.is_valid() && _material_uses_lod_info) {
+			shared_material->set_shader_parameter(
+					VoxelStringNames::get_singleton().u_voxel_lod_info,
+					encode_lod_info_for_shader_uniform(lod_index, get_lod_count())
+			);
+		}
+	}
+	return shared_material;
+}
+
+void VoxelLodTerrain::set_instance_shader_parameters_enabled(bool enabled) {
+	if (enabled == _instance_shader_parameters_enabled) {
+		return;
+	}
+	_instance_shader_parameters_enabled = enabled;
+	// The default material depends on this mode
+	update_shader_material_pool_template();
+	// Blocks have to get their materials again
+	reset_mesh_maps();
+	update_configuration_warnings();
+}
+
+bool VoxelLodTerrain::is_instance_shader_parameters_enabled() const {
+	return _instance_shader_parameters_enabled;
 }
 
 void VoxelLodTerrain::set_mesher(Ref<VoxelMesher> p_mesher) {
@@ -399,6 +459,7 @@ void VoxelLodTerrain::set_mesher(Ref<VoxelMesher> p_mesher) {
 	_mesher = p_mesher;
 
 	update_shader_material_pool_template();
+	reset_mesh_batches();
 
 	MeshingDependency::reset(_meshing_dependency, _mesher, get_generator());
 
@@ -558,19 +619,13 @@ void VoxelLodTerrain::set_mesh_block_visual_active(
 
 			_fading_blocks_per_lod[lod_index].erase(block.position);
 
-			Ref<ShaderMaterial> mat = block.get_shader_material();
-			if (mat.is_valid()) {
-				mat->set_shader_parameter(VoxelStringNames::get_singleton().u_lod_fade, Vector2(0.0, 0.0));
-			}
+			block.set_lod_fade(Vector2(0.0, 0.0));
 
 		} else if (active && _lod_fade_duration > 0.f) {
 			// WHen LOD fade is enabled, it is possible that a block is disabled with a fade out, but later has to be
 			// enabled without a fade-in (because behind the camera for example). In this case we have to reset the
 			// parameter. Otherwise, it would be active but invisible due to still being faded out.
-			Ref<ShaderMaterial> mat = block.get_shader_material();
-			if (mat.is_valid()) {
-				mat->set_shader_parameter(VoxelStringNames::get_singleton().u_lod_fade, Vector2(0.0, 0.0));
-			}
+			block.set_lod_fade(Vector2(0.0, 0.0));
 		}
 
 		return;
@@ -901,6 +956,8 @@ void VoxelLodTerrain::reset_maps() {
 void VoxelLodTerrain::reset_mesh_maps() {
 	_update_data->wait_for_end_of_task();
 
+	_mesh_batches.clear(to_span(_mesh_maps_per_lod), _shader_material_pool);
+
 	const unsigned int lod_count = get_lod_count();
 	VoxelLodTerrainUpdateData::State &state = _update_data->state;
 
@@ -977,12 +1034,21 @@ bool VoxelLodTerrain::get_generate_collisions() const {
 void VoxelLodTerrain::set_collision_lod_count(int lod_count) {
 	ERR_FAIL_COND(lod_count < 0);
 	_collision_lod_count = static_cast<unsigned int>(math::min(lod_count, get_lod_count()));
+	_update_data->settings.collision_lod_count = _collision_lod_count;
 }
 
 int VoxelLodTerrain::get_collision_lod_count() const {
 	return _collision_lod_count;
 }
 
+void VoxelLodTerrain::set_collision_only_mode_enabled(bool enabled) {
+	_update_data->settings.collision_only_mode = enabled;
+}
+
+bool VoxelLodTerrain::is_collision_only_mode_enabled() const {
+	return _update_data->settings.collision_only_mode;
+}
+
 void VoxelLodTerrain::set_collision_layer(int layer) {
 	const unsigned int lod_count = get_lod_count();
 
@@ -1112,6 +1178,7 @@ void VoxelLodTerrain::_notification(int p_what) {
 					block.set_world(world);
 				});
 			}
+			_mesh_batches.set_world(is_visible() ? world : nullptr);
 #ifdef TOOLS_ENABLED
 			if (debug_is_draw_enabled()) {
 				_debug_renderer.set_world(is_visible_in_tree() ? world : nullptr);
@@ -1129,6 +1196,7 @@ void VoxelLodTerrain::_notification(int p_what) {
 					block.set_world(nullptr);
 				});
 			}
+			_mesh_batches.set_world(nullptr);
 #ifdef TOOLS_ENABLED
 			_debug_renderer.set_world(nullptr);
 #endif
@@ -1144,6 +1212,7 @@ void VoxelLodTerrain::_notification(int p_what) {
 					block.set_parent_visible(visible);
 				});
 			}
+			_mesh_batches.set_world(visible ? *get_world_3d() : nullptr);
 
 #ifdef TOOLS_ENABLED
 			if (debug_is_draw_enabled()) {
@@ -1176,6 +1245,8 @@ void VoxelLodTerrain::_notification(int p_what) {
 			for (FadingOutMesh &item : _fading_out_meshes) {
 				item.mesh_instance.set_transform(transform * Transform3D(Basis(), item.local_position));
 			}
+
+			_mesh_batches.set_volume_transform(transform);
 		} break;
 
 		default:
@@ -1187,7 +1258,8 @@ Vector3 VoxelLodTerrain::get_local_viewer_pos() const {
 	// Pick this by default
 	Vector3 pos = _update_data->state.lods[0].last_viewer_data_block_pos << get_data_block_size_pow2();
 
-	// TODO Support for multiple viewers, this is a placeholder implementation
+	// Only used by the legacy octree streaming system, which supports a single viewer. Clipbox streaming pairs every
+	// viewer within range of the volume instead.
 	VoxelEngine::get_singleton().for_each_viewer( //
 			[&pos](ViewerID id, const VoxelEngine::Viewer &viewer) { //
 				pos = viewer.world_position;
@@ -1307,6 +1379,9 @@ void VoxelLodTerrain::process(float delta) {
 
 	// Do it after we change mesh block states so materials are updated
 	process_fading_blocks(delta);
+
+	// Do it last, so only blocks that ended up in a stable state this frame get merged
+	process_mesh_batches();
 }
 
 void VoxelLodTerrain::apply_main_thread_update_tasks() {
@@ -1355,6 +1430,17 @@ void VoxelLodTerrain::apply_main_thread_update_tasks() {
 
 		const int mesh_block_size = get_mesh_block_size() << lod_index;
 
+		if (is_mesh_batching_used_at_lod(lod_index)) {
+			// Blocks about to change must be drawn on their own again
+			invalidate_mesh_block_batches(lod_index, to_span_const(lod.mesh_blocks_to_activate_visuals));
+			invalidate_mesh_block_batches(lod_index, to_span_const(lod.mesh_blocks_to_deactivate_visuals));
+			invalidate_mesh_block_batches(lod_index, to_span_const(lod.mesh_blocks_to_drop_visual));
+			invalidate_mesh_block_batches(lod_index, to_span_const(lod.mesh_blocks_to_unload));
+			for (const VoxelLodTerrainUpdateData::TransitionUpdate &tu : lod.mesh_blocks_to_update_transitions) {
+				invalidate_mesh_block_batch(lod_index, tu.block_position);
+			}
+		}
+
 		for (unsigned int i = 0; i < lod.mesh_blocks_to_activate_visuals.size(); ++i) {
 			const Vector3i bpos = lod.mesh_blocks_to_activate_visuals[i];
 			VoxelMeshBlockVLT *block = mesh_map.get_block(bpos);
@@ -1508,18 +1594,23 @@ void VoxelLodTerrain::apply_main_thread_update_tasks() {
 								item.progress = 1.f;
 							}
 
-							// TODO Do we actually have to instantiate a material? We could just re-use the one from the
-							// block, since it gets removed and no change occurs in that material (contrary to
-							// transition mask changes)
-							item.shader_material = _shader_material_pool.allocate();
-							ZN_ASSERT(item.shader_material.is_valid());
-							zylann::godot::copy_shader_params(
-									**shader_material,
-									**item.shader_material,
-									_shader_material_pool.get_cached_shader_uniforms()
-							);
+							if (mesh_block->is_shader_material_shared()) {
+								item.shader_material = shader_material;
+								item.shader_material_shared = true;
+							} else {
+								// TODO Do we actually have to instantiate a material? We could just re-use the one
+								// from the block, since it gets removed and no change occurs in that material
+								// (contrary to transition mask changes)
+								item.shader_material = _shader_material_pool.allocate();
+								ZN_ASSERT(item.shader_material.is_valid());
+								zylann::godot::copy_shader_params(
+										**shader_material,
+										**item.shader_material,
+										_shader_material_pool.get_cached_shader_uniforms()
+								);
+							}
 
-							item.mesh_instance.create();
+							item.mesh_instance.create(VoxelEngine::get_singleton().get_rendering_instance_pool());
 							item.mesh_instance.set_interpolated(false);
 							item.mesh_instance.set_mesh(mesh_block->get_mesh());
 							item.mesh_instance.set_gi_mode(get_gi_mode());
@@ -1527,6 +1618,9 @@ void VoxelLodTerrain::apply_main_thread_update_tasks() {
 									volume_transform * Transform3D(Basis(), item.local_position)
 							);
 							item.mesh_instance.set_material_override(item.shader_material);
+							if (item.shader_material_shared) {
+								mesh_block->copy_shader_instance_parameters(item.mesh_instance);
+							}
 							item.mesh_instance.set_world(*get_world_3d());
 							// TODO What if the terrain is hidden?
 							item.mesh_instance.set_visible(true);
@@ -1600,23 +1694,32 @@ void VoxelLodTerrain::apply_main_thread_update_tasks() {
 						// Wayyyy too slow, initially because of https://github.com/godotengine/godot/issues/34741
 						// but also generally slow because of how `duplicate` is implemented
 						// item.shader_material = shader_material->duplicate(false);
-						item.shader_material = _shader_material_pool.allocate();
-						ZN_ASSERT(item.shader_material.is_valid());
-						zylann::godot::copy_shader_params(
-								**shader_material,
-								**item.shader_material,
-								_shader_material_pool.get_cached_shader_uniforms()
-						);
+						if (block->is_shader_material_shared()) {
+							// Previous parameters are kept on the instance instead
+							item.shader_material = shader_material;
+							item.shader_material_shared = true;
+						} else {
+							item.shader_material = _shader_material_pool.allocate();
+							ZN_ASSERT(item.shader_material.is_valid());
+							zylann::godot::copy_shader_params(
+									**shader_material,
+									**item.shader_material,
+									_shader_material_pool.get_cached_shader_uniforms()
+							);
+						}
 
 						// item.shader_material->set_shader_param(
 						// 		VoxelStringNames::get_singleton().u_lod_fade, Vector2(item.progress, 0.f));
 
-						item.mesh_instance.create();
+						item.mesh_instance.create(VoxelEngine::get_singleton().get_rendering_instance_pool());
 						item.mesh_instance.set_interpolated(false);
 						item.mesh_instance.set_mesh(block->get_mesh());
 						item.mesh_instance.set_gi_mode(get_gi_mode());
 						item.mesh_instance.set_transform(volume_transform * Transform3D(Basis(), item.local_position));
 						item.mesh_instance.set_material_override(item.shader_material);
+						if (item.shader_material_shared) {
+							block->copy_shader_instance_parameters(item.mesh_instance);
+						}
 						item.mesh_instance.set_world(*get_world_3d());
 						item.mesh_instance.set_visible(true);
 
@@ -1817,13 +1920,16 @@ inline void set_block_collision_shape(
 	block.set_collision_mask(terrain.get_collision_mask());
 	block.last_collider_update_time = now;
 	block.deferred_collider_data.reset();
+	block.deferred_collision_shape.unref();
+	block.has_deferred_collision_shape = false;
 }
 
 void VoxelLodTerrain::apply_mesh_update(VoxelEngine::BlockMeshOutput &ob) {
 	// The following is done on the main thread because Godot doesn't really support everything done here.
 	// Building meshes can be done in the threaded task when using Vulkan, but not OpenGL.
 	// Setting up mesh instances might not be well threaded?
-	// Building collision shapes in threads efficiently is not supported.
+	// Collision shapes are built in the threaded task too when graphics resources can be, otherwise they are built
+	// here.
 	ZN_PROFILE_SCOPE();
 
 	// TODO This spams in the editor upon opening a project, when more than one scene was open with a terrain.
@@ -1913,6 +2019,8 @@ void VoxelLodTerrain::apply_mesh_update(VoxelEngine::BlockMeshOutput &ob) {
 	VoxelMeshMap<VoxelMeshBlockVLT> &mesh_map = _mesh_maps_per_lod[ob.lod];
 	VoxelMeshBlockVLT *block = mesh_map.get_block(ob.position);
 
+	invalidate_mesh_block_batch(ob.lod, ob.position);
+
 	VoxelMesher::Output &mesh_data = ob.surfaces;
 
 	Ref<ArrayMesh> mesh;
@@ -2024,7 +2132,11 @@ void VoxelLodTerrain::apply_mesh_update(VoxelEngine::BlockMeshOutput &ob) {
 			// set_mesh_block_active(*block, false);
 			block->set_parent_visible(is_visible());
 
-			if (_shader_material_pool.get_template().is_valid() && block->get_shader_material().is_null()) {
+			if (_instance_shader_parameters_enabled && _shader_material_pool.get_template().is_valid() &&
+				block->get_shader_material().is_null()) {
+				block->set_shared_shader_material(get_or_create_shared_shader_material(ob.lod));
+
+			} else if (_shader_material_pool.get_template().is_valid() && block->get_shader_material().is_null()) {
 				ZN_PROFILE_SCOPE_NAMED("Add ShaderMaterial");
 
 				// Pooling shader materials is necessary for now, to avoid stuttering in the editor.
@@ -2079,6 +2191,13 @@ void VoxelLodTerrain::apply_mesh_update(VoxelEngine::BlockMeshOutput &ob) {
 			// calling that before creating the mesh instance would not work.
 			block->set_material_override(_material);
 		}
+
+		if (is_mesh_batching_used_at_lod(ob.lod)) {
+			// Keep surfaces so the block can be merged with its neighbors later. Arrays are shared, not copied.
+			block->batching_surfaces = ob.surfaces.surfaces;
+			block->batching_primitive_type = ob.surfaces.primitive_type;
+			block->batching_mesh_flags = ob.surfaces.mesh_flags;
+		}
 	}
 
 	// TODO Remove this eventually, we no longer use separate transition mesh instances
@@ -2118,17 +2237,32 @@ void VoxelLodTerrain::apply_mesh_update(VoxelEngine::BlockMeshOutput &ob) {
 
 		if (_collision_update_delay == 0 ||
 			static_cast<int>(now - block->last_collider_update_time) > _collision_update_delay) {
-			ZN_ASSERT(_mesher.is_valid());
-			Ref<Shape3D> collision_shape = make_collision_shape_from_mesher_output(ob.surfaces, **_mesher);
+			Ref<Shape3D> collision_shape;
+			if (ob.has_collision_shape) {
+				collision_shape = ob.collision_shape;
+			} else {
+				ZN_ASSERT(_mesher.is_valid());
+				collision_shape = make_collision_shape_from_mesher_output(ob.surfaces, **_mesher);
+			}
 			set_block_collision_shape(*this, *block, collision_shape, now);
 			block->set_collision_enabled(collision_active);
 
 		} else {
-			if (block->deferred_collider_data == nullptr) {
+			if (block->deferred_collider_data == nullptr && !block->has_deferred_collision_shape) {
 				_deferred_collision_updates_per_lod[ob.lod].push_back(ob.position);
-				block->deferred_collider_data = make_unique_instance<VoxelMesher::Output>();
 			}
-			*block->deferred_collider_data = std::move(ob.surfaces);
+			if (ob.has_collision_shape) {
+				block->deferred_collider_data.reset();
+				block->deferred_collision_shape = ob.collision_shape;
+				block->has_deferred_collision_shape = true;
+			} else {
+				if (block->deferred_collider_data == nullptr) {
+					block->deferred_collider_data = make_unique_instance<VoxelMesher::Output>();
+				}
+				*block->deferred_collider_data = std::move(ob.surfaces);
+				block->deferred_collision_shape.unref();
+				block->has_deferred_collision_shape = false;
+			}
 		}
 	}
 
@@ -2245,7 +2379,8 @@ void VoxelLodTerrain::try_apply_parent_detail_texture_to_block(
 	ZN_PROFILE_SCOPE();
 
 	Ref<ShaderMaterial> material = block.get_shader_material();
-	if (!material.is_valid()) {
+	if (!material.is_valid() || block.is_shader_material_shared()) {
+		// Detail textures are specific to each block, they can't go in a shared material
 		return;
 	}
 	if (lod_index == static_cast<unsigned int>(get_lod_count())) {
@@ -2281,6 +2416,8 @@ void VoxelLodTerrain::apply_detail_texture_update_to_block(
 	ZN_PROFILE_SCOPE();
 	ZN_ASSERT(ob.valid);
 
+	invalidate_mesh_block_batch(lod_index, block.position);
+
 	DetailTextures normalmap_textures = ob.textures;
 
 	if (normalmap_textures.lookup.is_null()) {
@@ -2291,7 +2428,8 @@ void VoxelLodTerrain::apply_detail_texture_update_to_block(
 	}
 
 	Ref<ShaderMaterial> material = block.get_shader_material();
-	if (material.is_valid()) {
+	// Detail textures are specific to each block, they can't go in a shared material
+	if (material.is_valid() && !block.is_shader_material_shared()) {
 		const VoxelStringNames &sn = VoxelStringNames::get_singleton();
 
 		const bool had_texture = material->get_shader_parameter(sn.u_voxel_cell_lookup) != Variant();
@@ -2357,7 +2495,8 @@ void VoxelLodTerrain::process_deferred_collision_updates(uint32_t timeout_msec)
 			const Vector3i block_pos = deferred_collision_updates[i];
 			VoxelMeshBlockVLT *block = mesh_map.get_block(block_pos);
 
-			if (block == nullptr || block->deferred_collider_data == nullptr) {
+			if (block == nullptr ||
+				(block->deferred_collider_data == nullptr && !block->has_deferred_collision_shape)) {
 				// Block was unloaded or no longer needs a collision update
 				unordered_remove(deferred_collision_updates, i);
 				--i;
@@ -2368,7 +2507,9 @@ void VoxelLodTerrain::process_deferred_collision_updates(uint32_t timeout_msec)
 
 			if (static_cast<int>(now - block->last_collider_update_time) > _collision_update_delay) {
 				Ref<Shape3D> collision_shape;
-				if (_mesher.is_valid()) {
+				if (block->has_deferred_collision_shape) {
+					collision_shape = block->deferred_collision_shape;
+				} else if (_mesher.is_valid()) {
 					collision_shape =
 							make_collision_shape_from_mesher_output(*block->deferred_collider_data, **_mesher);
 				}
@@ -2422,6 +2563,8 @@ void VoxelLodTerrain::process_fading_blocks(float delta) {
 				const bool finished = block->update_fading(speed);
 
 				if (finished) {
+					// The block may now be merged with its neighbors
+					invalidate_mesh_block_batch(lod_index, block->position);
 					// `erase` returns the next iterator
 					it = fading_blocks.erase(it);
 
@@ -2440,20 +2583,24 @@ void VoxelLodTerrain::process_fading_blocks(float delta) {
 			item.progress -= speed;
 			if (item.progress <= 0.f) {
 				FreeMeshTask::try_add_and_destroy(item.mesh_instance);
-				_shader_material_pool.recycle(item.shader_material);
-				// TODO Optimize: mesh instances destroyed here can be really slow due to materials...
-				// Profiling has shown that `RendererSceneCull::free` of a mesh instance
-				// leads to `RendererRD::MaterialStorage::_update_queued_materials()` to be called, which internally
-				// updates hundreds of materials (supposedly from every block). Can take 1ms for a single instance,
-				// while the rest of the work is barely 1%! Why is Godot doing this? I tried resetting the material like
-				// with blocks, but that didn't improve anything...
-				// item.mesh_instance.set_material_override(Ref<Material>());
+				if (!item.shader_material_shared) {
+					_shader_material_pool.recycle(item.shader_material);
+				}
+				// Mesh instances are recycled into a pool rather than freed. Profiling has shown that
+				// `RendererSceneCull::free` of a mesh instance leads to
+				// `RendererRD::MaterialStorage::_update_queued_materials()` to be called, which internally updates
+				// hundreds of materials (supposedly from every block). It could take 1ms for a single instance.
 				_fading_out_meshes[i] = std::move(_fading_out_meshes.back());
 				_fading_out_meshes.pop_back();
 			} else {
-				item.shader_material->set_shader_parameter(
-						VoxelStringNames::get_singleton().u_lod_fade, Vector2(1.f - item.progress, 0.f)
-				);
+				const Vector2 lod_fade(1.f - item.progress, 0.f);
+				if (item.shader_material_shared) {
+					item.mesh_instance.set_shader_instance_parameter(
+							VoxelStringNames::get_singleton().u_lod_fade, lod_fade
+					);
+				} else {
+					item.shader_material->set_shader_parameter(VoxelStringNames::get_singleton().u_lod_fade, lod_fade);
+				}
 				++i;
 			}
 		}
@@ -2526,6 +2673,7 @@ void VoxelLodTerrain::set_instancer(VoxelInstancer *instancer) {
 		ERR_FAIL_COND_MSG(_instancer != nullptr, "No more than one VoxelInstancer per terrain");
 	}
 	_instancer = instancer;
+	_update_data->settings.keep_render_attributes = instancer != nullptr;
 }
 #endif
 
@@ -2644,6 +2792,7 @@ Dictionary VoxelLodTerrain::_b_get_statistics() const {
 	// Process
 	d["dropped_block_loads"] = _stats.dropped_block_loads;
 	d["dropped_block_meshs"] = _stats.dropped_block_meshs;
+	d["mesh_batch_count"] = _mesh_batches.get_batch_count();
 
 	return d;
 }
@@ -2775,6 +2924,94 @@ float VoxelLodTerrain::get_lod_fade_duration() const {
 	return _lod_fade_duration;
 }
 
+void VoxelLodTerrain::set_mesh_batching_enabled(bool enabled) {
+	if (enabled == _mesh_batching_enabled) {
+		return;
+	}
+	_mesh_batching_enabled = enabled;
+	reset_mesh_batches();
+}
+
+bool VoxelLodTerrain::is_mesh_batching_enabled() const {
+	return _mesh_batching_enabled;
+}
+
+void VoxelLodTerrain::set_mesh_batching_begin_lod_index(int lod_index) {
+	ERR_FAIL_COND(lod_index < 0);
+	ERR_FAIL_COND(lod_index >= static_cast<int>(constants::MAX_LOD));
+	if (static_cast<unsigned int>(lod_index) == _mesh_batching_begin_lod_index) {
+		return;
+	}
+	_mesh_batching_begin_lod_index = lod_index;
+	reset_mesh_batches();
+}
+
+int VoxelLodTerrain::get_mesh_batching_begin_lod_index() const {
+	return _mesh_batching_begin_lod_index;
+}
+
+bool VoxelLodTerrain::is_mesh_batching_used_at_lod(unsigned int lod_index) const {
+	return _mesh_batching_enabled && lod_index >= _mesh_batching_begin_lod_index;
+}
+
+void VoxelLodTerrain::invalidate_mesh_block_batch(unsigned int lod_index, Vector3i bpos) {
+	if (!is_mesh_batching_used_at_lod(lod_index)) {
+		return;
+	}
+	_mesh_batches.invalidate(_mesh_maps_per_lod[lod_index], _shader_material_pool, lod_index, bpos);
+}
+
+void VoxelLodTerrain::invalidate_mesh_block_batches(unsigned int lod_index, Span<const Vector3i> bpositions) {
+	for (const Vector3i bpos : bpositions) {
+		invalidate_mesh_block_batch(lod_index, bpos);
+	}
+}
+
+void VoxelLodTerrain::reset_mesh_batches() {
+	ZN_PROFILE_SCOPE();
+
+	_mesh_batches.clear(to_span(_mesh_maps_per_lod), _shader_material_pool);
+
+	const unsigned int lod_count = get_lod_count();
+	for (unsigned int lod_index = 0; lod_index < lod_count; ++lod_index) {
+		VoxelMeshMap<VoxelMeshBlockVLT> &mesh_map = _mesh_maps_per_lod[lod_index];
+
+		if (is_mesh_batching_used_at_lod(lod_index)) {
+			// Blocks meshed while batching was off don't have their surfaces, they will only be merged once they get
+			// meshed again
+			_mesh_batches.invalidate_all(mesh_map, lod_index);
+		} else {
+			mesh_map.for_each_block([](VoxelMeshBlockVLT &block) { //
+				block.batching_surfaces.clear();
+			});
+		}
+	}
+}
+
+void VoxelLodTerrain::process_mesh_batches() {
+	if (!_mesh_batching_enabled) {
+		return;
+	}
+
+	MeshBlockBatchesVLT::MergeParams params;
+	params.volume_transform = get_global_transform();
+	params.world = is_visible() ? *get_world_3d() : nullptr;
+	params.gi_mode = get_gi_mode();
+	params.shadow_casting = RenderingServer::ShadowCastingSetting(get_shadow_casting());
+	params.render_layers_mask = get_render_layers_mask();
+	params.material_override = _material;
+	params.mesher = _mesher.ptr();
+	params.mesh_block_size = get_mesh_block_size();
+
+	_mesh_batches.process(
+			to_span(_mesh_maps_per_lod, get_lod_count()),
+			_shader_material_pool,
+			params,
+			_mesh_batching_begin_lod_index,
+			VoxelEngine::get_singleton().get_main_thread_time_budget_usec()
+	);
+}
+
 #ifdef VOXEL_ENABLE_SMOOTH_MESHING
 
 void VoxelLodTerrain::set_normalmap_enabled(bool enable) {
@@ -2965,13 +3202,20 @@ void VoxelLodTerrain::get_configuration_warnings(PackedStringArray &warnings) co
 			} else {
 				Ref<Shader> shader = shader_material->get_shader();
 				if (shader.is_valid()) {
-					if (!shader_has_uniform(**shader, VoxelStringNames::get_singleton().u_transition_mask)) {
+					const StringName &u_transition_mask = VoxelStringNames::get_singleton().u_transition_mask;
+					// Instance uniforms are not listed by shaders, so we can only tell if the uniform is declared as a
+					// regular one
+					if (_instance_shader_parameters_enabled) {
+						if (shader_has_uniform(**shader, u_transition_mask)) {
+							warnings.append(ZN_TTR("Instance shader parameters are enabled, but {0} is declared as a "
+												   "regular uniform in the current shader. It must be declared as "
+												   "instance uniform.")
+													.format(varray(u_transition_mask)));
+						}
+					} else if (!shader_has_uniform(**shader, u_transition_mask)) {
 						warnings.append(ZN_TTR("The current mesher ({0}) requires to use shader with specific "
 											   "uniforms. Missing: {1}")
-												.format(
-														varray(mesher->get_class(),
-															   VoxelStringNames::get_singleton().u_transition_mask)
-												));
+												.format(varray(mesher->get_class(), u_transition_mask)));
 					}
 				}
 			}
@@ -2987,6 +3231,13 @@ void VoxelLodTerrain::get_configuration_warnings(PackedStringArray &warnings) co
 				if (shader.is_null()) {
 					warnings.append(String("Lod fading is enabled but the current material is missing a shader.")
 											.format(varray(ShaderMaterial::get_class_static())));
+				} else if (_instance_shader_parameters_enabled) {
+					if (shader_has_uniform(**shader, VoxelStringNames::get_singleton().u_lod_fade)) {
+						warnings.append(ZN_TTR("Lod fading and instance shader parameters are enabled, but {0} is "
+											   "declared as a regular uniform in the current shader. It must be "
+											   "declared as instance uniform.")
+												.format(varray(VoxelStringNames::get_singleton().u_lod_fade)));
+					}
 				} else {
 					if (!shader_has_uniform(**shader, VoxelStringNames::get_singleton().u_lod_fade)) {
 						warnings.append(ZN_TTR("Lod fading is enabled but it requires to use a specific shader "
@@ -3009,6 +3260,11 @@ void VoxelLodTerrain::get_configuration_warnings(PackedStringArray &warnings) co
 #ifdef VOXEL_ENABLE_SMOOTH_MESHING
 			// Detail textures
 			if (is_normalmap_enabled()) {
+				if (_instance_shader_parameters_enabled) {
+					warnings.append(ZN_TTR("Normalmaps are enabled, but they are not supported when instance shader "
+										   "parameters are enabled."));
+				}
+
 				if (!generator->supports_series_generation()) {
 					warnings.append(
 							ZN_TTR("Normalmaps are enabled, but it requires the generator to be able to generate "
@@ -3758,6 +4014,11 @@ void VoxelLodTerrain::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_collision_lod_count"), &Self::get_collision_lod_count);
 	ClassDB::bind_method(D_METHOD("set_collision_lod_count", "count"), &Self::set_collision_lod_count);
 
+	ClassDB::bind_method(D_METHOD("is_collision_only_mode_enabled"), &Self::is_collision_only_mode_enabled);
+	ClassDB::bind_method(
+			D_METHOD("set_collision_only_mode_enabled", "enabled"), &Self::set_collision_only_mode_enabled
+	);
+
 	ClassDB::bind_method(D_METHOD("get_collision_layer"), &Self::get_collision_layer);
 	ClassDB::bind_method(D_METHOD("set_collision_layer", "layer"), &Self::set_collision_layer);
 
@@ -3775,6 +4036,21 @@ void VoxelLodTerrain::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_lod_fade_duration"), &Self::get_lod_fade_duration);
 	ClassDB::bind_method(D_METHOD("set_lod_fade_duration", "seconds"), &Self::set_lod_fade_duration);
 
+	ClassDB::bind_method(
+			D_METHOD("set_instance_shader_parameters_enabled", "enabled"), &Self::set_instance_shader_parameters_enabled
+	);
+	ClassDB::bind_method(
+			D_METHOD("is_instance_shader_parameters_enabled"), &Self::is_instance_shader_parameters_enabled
+	);
+
+	ClassDB::bind_method(D_METHOD("set_mesh_batching_enabled", "enabled"), &Self::set_mesh_batching_enabled);
+	ClassDB::bind_method(D_METHOD("is_mesh_batching_enabled"), &Self::is_mesh_batching_enabled);
+
+	ClassDB::bind_method(
+			D_METHOD("set_mesh_batching_begin_lod_index", "lod_index"), &Self::set_mesh_batching_begin_lod_index
+	);
+	ClassDB::bind_method(D_METHOD("get_mesh_batching_begin_lod_index"), &Self::get_mesh_batching_begin_lod_index);
+
 	ClassDB::bind_method(D_METHOD("set_lod_count", "lod_count"), &Self::set_lod_count);
 	ClassDB::bind_method(D_METHOD("get_lod_count"), &Self::get_lod_count);
 
@@ -3935,6 +4211,16 @@ void VoxelLodTerrain::_bind_methods() {
 			"get_secondary_lod_distance"
 	);
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "lod_fade_duration"), "set_lod_fade_duration", "get_lod_fade_duration");
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "mesh_batching_enabled"),
+			"set_mesh_batching_enabled",
+			"is_mesh_batching_enabled"
+	);
+	ADD_PROPERTY(
+			PropertyInfo(Variant::INT, "mesh_batching_begin_lod_index"),
+			"set_mesh_batching_begin_lod_index",
+			"get_mesh_batching_begin_lod_index"
+	);
 
 	ADD_GROUP("Material", "");
 	ADD_PROPERTY(
@@ -3947,6 +4233,11 @@ void VoxelLodTerrain::_bind_methods() {
 			"set_material",
 			"get_material"
 	);
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "instance_shader_parameters_enabled"),
+			"set_instance_shader_parameters_enabled",
+			"is_instance_shader_parameters_enabled"
+	);
 
 #ifdef VOXEL_ENABLE_SMOOTH_MESHING
 	ADD_GROUP("Detail normalmaps", "normalmap_");
@@ -4000,6 +4291,11 @@ void VoxelLodTerrain::_bind_methods() {
 	ADD_PROPERTY(
 			PropertyInfo(Variant::INT, "collision_lod_count"), "set_collision_lod_count", "get_collision_lod_count"
 	);
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "collision_only_mode_enabled"),
+			"set_collision_only_mode_enabled",
+			"is_collision_only_mode_enabled"
+	);
 	ADD_PROPERTY(
 			PropertyInfo(Variant::INT, "collision_update_delay"),
 			"set_collision_update_delay",
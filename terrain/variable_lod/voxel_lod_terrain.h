@@ -10,6 +10,7 @@
 #include "../voxel_mesh_map.h"
 #include "../voxel_node.h"
 #include "lod_octree.h"
+#include "mesh_block_batches_vlt.h"
 #include "shader_material_pool_vlt.h"
 #include "voxel_lod_terrain_update_data.h"
 #include "voxel_mesh_block_vlt.h"
@@ -39,6 +40,9 @@ public:
 	~VoxelLodTerrain();
 
 	Ref<Material> get_material() const;
+
+	void set_instance_shader_parameters_enabled(bool enabled);
+	bool is_instance_shader_parameters_enabled() const;
 	void set_material(Ref<Material> p_material);
 
 	Ref<VoxelStream> get_stream() const override;
@@ -69,6 +73,10 @@ public:
 	void set_collision_lod_count(int lod_count);
 	int get_collision_lod_count() const;
 
+	// Only streams what is needed for colliders, without producing visuals. Intended for headless servers.
+	void set_collision_only_mode_enabled(bool enabled);
+	bool is_collision_only_mode_enabled() const;
+
 	void set_collision_layer(int layer);
 	int get_collision_layer() const;
 
@@ -158,6 +166,12 @@ public:
 	void set_lod_fade_duration(float seconds);
 	float get_lod_fade_duration() const;
 
+	void set_mesh_batching_enabled(bool enabled);
+	bool is_mesh_batching_enabled() const;
+
+	void set_mesh_batching_begin_lod_index(int lod_index);
+	int get_mesh_batching_begin_lod_index() const;
+
 	enum ProcessCallback { //
 		PROCESS_CALLBACK_IDLE = 0,
 		PROCESS_CALLBACK_PHYSICS,
@@ -333,13 +347,21 @@ private:
 
 	void _on_stream_params_changed();
 
+	Ref<ShaderMaterial> get_mesher_default_lod_material() const;
 	void update_shader_material_pool_template();
+	Ref<ShaderMaterial> get_or_create_shared_shader_material(unsigned int lod_index);
 
 	void save_all_modified_blocks(bool with_copy, std::shared_ptr<AsyncDependencyTracker> tracker);
 
 	void process_deferred_collision_updates(uint32_t timeout_msec);
 	void process_fading_blocks(float delta);
 
+	bool is_mesh_batching_used_at_lod(unsigned int lod_index) const;
+	void invalidate_mesh_block_batch(unsigned int lod_index, Vector3i bpos);
+	void invalidate_mesh_block_batches(unsigned int lod_index, Span<const Vector3i> bpositions);
+	void reset_mesh_batches();
+	void process_mesh_batches();
+
 	struct LocalCameraInfo {
 		Vector3 position;
 		Vector3 forward;
@@ -384,6 +406,12 @@ private:
 	// it has to add a connection to a HUGE list. Which is very slow, enough to cause stutters.
 	ShaderMaterialPoolVLT _shader_material_pool;
 
+	// When enabled, blocks of the same LOD share the same ShaderMaterial, and parameters specific to each block are
+	// set as instance uniforms. This avoids a material (and its uniform buffer) per block, at the cost of detail
+	// textures and `u_block_local_transform`, which can't be instance uniforms.
+	bool _instance_shader_parameters_enabled = false;
+	FixedArray<Ref<ShaderMaterial>, constants::MAX_LOD> _shared_shader_materials_per_lod;
+
 	FixedArray<VoxelMeshMap<VoxelMeshBlockVLT>, constants::MAX_LOD> _mesh_maps_per_lod;
 
 	// Copies of meshes just for fading out.
@@ -395,6 +423,8 @@ private:
 		// Changing properties is the reason we may want to fade the mesh, so we may hold on a copy of the material with
 		// properties before the fade starts.
 		Ref<ShaderMaterial> shader_material;
+		// If true, the material is shared with other blocks and parameters are set on the instance instead
+		bool shader_material_shared = false;
 		// Going from 1 to 0
 		float progress;
 	};
@@ -415,6 +445,10 @@ private:
 	// TODO Optimization: use FlatMap? Need to check how many blocks get in there, probably not many
 	FixedArray<StdMap<Vector3i, VoxelMeshBlockVLT *>, constants::MAX_LOD> _fading_blocks_per_lod;
 
+	bool _mesh_batching_enabled = false;
+	unsigned int _mesh_batching_begin_lod_index = 2;
+	MeshBlockBatchesVLT _mesh_batches;
+
 	struct FadingDetailTexture {
 		Vector3i block_position;
 		uint32_t lod_index;
@@ -35,11 +35,6 @@ bool find_index(Span<const std::pair<ViewerID, VoxelEngine::Viewer>> viewers, Vi
 	return false;
 }
 
-bool contains(Span<const std::pair<ViewerID, VoxelEngine::Viewer>> viewers, ViewerID id) {
-	unsigned int _unused;
-	return find_index(viewers, id, _unused);
-}
-
 bool find_index(Span<const VoxelLodTerrainUpdateData::PairedViewer> viewers, ViewerID id, unsigned int &out_index) {
 	for (unsigned int i = 0; i < viewers.size(); ++i) {
 		if (viewers[i].id == id) {
@@ -50,6 +45,15 @@ bool find_index(Span<const VoxelLodTerrainUpdateData::PairedViewer> viewers, Vie
 	return false;
 }
 
+// In collision-only mode, LODs without collision don't need meshes. The hierarchy of mesh blocks then stops at the last
+// LOD having collision, which acts as the root LOD for subdivision.
+unsigned int get_meshed_lod_count(const VoxelLodTerrainUpdateData::Settings &settings, const unsigned int lod_count) {
+	if (settings.collision_only_mode && settings.collision_lod_count != 0) {
+		return math::min(static_cast<unsigned int>(settings.collision_lod_count), lod_count);
+	}
+	return lod_count;
+}
+
 Box3i get_base_box_in_chunks(
 		Vector3i viewer_position_voxels,
 		Vector3i distance_voxels,
@@ -134,10 +138,46 @@ Vector3i get_relative_lod_distance_in_chunks(
 	return ld3;
 }
 
+VoxelLodTerrainUpdateData::PairedViewer::Distances get_view_distances_voxels(
+		const VoxelEngine::Viewer &viewer,
+		const float view_distance_scale,
+		const unsigned int max_view_distance_voxels
+) {
+	const int view_distance_voxels_h =
+			static_cast<int>(static_cast<float>(viewer.view_distances.horizontal) * view_distance_scale);
+	const int view_distance_voxels_v =
+			static_cast<int>(static_cast<float>(viewer.view_distances.vertical) * view_distance_scale);
+
+	VoxelLodTerrainUpdateData::PairedViewer::Distances distances;
+	distances.horizontal = math::min(view_distance_voxels_h, static_cast<int>(max_view_distance_voxels));
+	distances.vertical = math::min(view_distance_voxels_v, static_cast<int>(max_view_distance_voxels));
+	return distances;
+}
+
+// Viewers are only paired while the area they can see touches the bounds of the volume. That way, viewers that are
+// far away (like players in other regions of a large world) don't cost anything to the volume.
+bool is_viewer_in_range(
+		const VoxelEngine::Viewer &viewer,
+		const Transform3D &world_to_local_transform,
+		const float view_distance_scale,
+		const unsigned int max_view_distance_voxels,
+		const Box3i &volume_bounds_in_voxels,
+		const int margin_voxels
+) {
+	const VoxelLodTerrainUpdateData::PairedViewer::Distances distances =
+			get_view_distances_voxels(viewer, view_distance_scale, max_view_distance_voxels);
+	const Vector3i local_position_voxels = math::floor_to_int(world_to_local_transform.xform(viewer.world_position));
+	const Vector3i extents = Vector3i(distances.horizontal, distances.vertical, distances.horizontal) +
+			Vector3iUtil::create(margin_voxels);
+	const Box3i view_box = Box3i::from_center_extents(local_position_voxels, extents);
+	return view_box.intersects(volume_bounds_in_voxels);
+}
+
 void process_viewers(
 		VoxelLodTerrainUpdateData::ClipboxStreamingState &cs,
 		const VoxelLodTerrainUpdateData::Settings &volume_settings,
 		unsigned int lod_count,
+		unsigned int meshed_lod_count,
 		Span<const std::pair<ViewerID, VoxelEngine::Viewer>> viewers,
 		const Transform3D &volume_transform,
 		Box3i volume_bounds_in_voxels,
@@ -148,41 +188,56 @@ void process_viewers(
 ) {
 	ZN_PROFILE_SCOPE();
 
-	// Destroyed viewers
+	const Transform3D world_to_local_transform = volume_transform.affine_inverse();
+
+	// Note, this does not support non-uniform scaling
+	// TODO There is probably a better way to do this
+	const float view_distance_scale = world_to_local_transform.basis.xform(Vector3(1, 0, 0)).length();
+
+	// Boxes are snapped to chunks, so they can extend a bit further than view distance
+	const int range_margin_voxels = 1 << (volume_settings.mesh_block_size_po2 + lod_count - 1);
+
+	// Destroyed viewers, and viewers that went out of range
 	for (size_t paired_viewer_index = 0; paired_viewer_index < cs.paired_viewers.size(); ++paired_viewer_index) {
 		VoxelLodTerrainUpdateData::PairedViewer &pv = cs.paired_viewers[paired_viewer_index];
 
-		if (!contains(viewers, pv.id)) {
+		unsigned int viewer_index;
+		if (!find_index(viewers, pv.id, viewer_index)) {
 			ZN_PRINT_VERBOSE(format("Detected destroyed viewer {} in VoxelLodTerrain", pv.id));
 
-			// Interpret removal as nullified view distance so the same code handling loading of blocks
-			// will be used to unload those viewed by this viewer.
-			// We'll actually remove unpaired viewers in a second pass.
-			pv.state.view_distance_voxels = VoxelLodTerrainUpdateData::PairedViewer::Distances();
-
-			// Also update boxes, they won't be updated since the viewer has been removed.
-			// Assign prev state, otherwise in some cases resetting boxes would make them equal to prev state,
-			// therefore causing no unload
-			pv.prev_state = pv.state;
+		} else if (!is_viewer_in_range(
+						   viewers[viewer_index].second,
+						   world_to_local_transform,
+						   view_distance_scale,
+						   volume_settings.view_distance_voxels,
+						   volume_bounds_in_voxels,
+						   range_margin_voxels
+				   )) {
+			ZN_PRINT_VERBOSE(format("Viewer {} went out of range of VoxelLodTerrain", pv.id));
 
-			for (unsigned int lod_index = 0; lod_index < pv.state.data_box_per_lod.size(); ++lod_index) {
-				pv.state.data_box_per_lod[lod_index] = Box3i();
-			}
-			for (unsigned int lod_index = 0; lod_index < pv.state.mesh_box_per_lod.size(); ++lod_index) {
-				pv.state.mesh_box_per_lod[lod_index] = Box3i();
-			}
-
-			unpaired_viewers_to_remove.push_back(paired_viewer_index);
+		} else {
+			continue;
 		}
-	}
 
-	// TODO Pair/Unpair viewers as they intersect volume bounds
+		// Interpret removal as nullified view distance so the same code handling loading of blocks
+		// will be used to unload those viewed by this viewer.
+		// We'll actually remove unpaired viewers in a second pass.
+		pv.state.view_distance_voxels = VoxelLodTerrainUpdateData::PairedViewer::Distances();
 
-	const Transform3D world_to_local_transform = volume_transform.affine_inverse();
+		// Also update boxes, they won't be updated since the viewer has been removed.
+		// Assign prev state, otherwise in some cases resetting boxes would make them equal to prev state,
+		// therefore causing no unload
+		pv.prev_state = pv.state;
 
-	// Note, this does not support non-uniform scaling
-	// TODO There is probably a better way to do this
-	const float view_distance_scale = world_to_local_transform.basis.xform(Vector3(1, 0, 0)).length();
+		for (unsigned int lod_index = 0; lod_index < pv.state.data_box_per_lod.size(); ++lod_index) {
+			pv.state.data_box_per_lod[lod_index] = Box3i();
+		}
+		for (unsigned int lod_index = 0; lod_index < pv.state.mesh_box_per_lod.size(); ++lod_index) {
+			pv.state.mesh_box_per_lod[lod_index] = Box3i();
+		}
+
+		unpaired_viewers_to_remove.push_back(paired_viewer_index);
+	}
 
 	const int data_block_size = 1 << data_block_size_po2;
 
@@ -207,6 +262,18 @@ void process_viewers(
 		const ViewerID viewer_id = viewer_and_id.first;
 		const VoxelEngine::Viewer &viewer = viewer_and_id.second;
 
+		if (!is_viewer_in_range(
+					viewer,
+					world_to_local_transform,
+					view_distance_scale,
+					volume_settings.view_distance_voxels,
+					volume_bounds_in_voxels,
+					range_margin_voxels
+			)) {
+			// Not paired, or being unpaired
+			continue;
+		}
+
 		unsigned int paired_viewer_index;
 		if (!find_index(to_span_const(cs.paired_viewers), viewer_id, paired_viewer_index)) {
 			// New viewer
@@ -222,17 +289,8 @@ void process_viewers(
 		// Move current state to be the previous state
 		paired_viewer.prev_state = paired_viewer.state;
 
-		{
-			const int view_distance_voxels_h =
-					static_cast<int>(static_cast<float>(viewer.view_distances.horizontal) * view_distance_scale);
-			const int view_distance_voxels_v =
-					static_cast<int>(static_cast<float>(viewer.view_distances.vertical) * view_distance_scale);
-
-			paired_viewer.state.view_distance_voxels.horizontal =
-					math::min(view_distance_voxels_h, static_cast<int>(volume_settings.view_distance_voxels));
-			paired_viewer.state.view_distance_voxels.vertical =
-					math::min(view_distance_voxels_v, static_cast<int>(volume_settings.view_distance_voxels));
-		}
+		paired_viewer.state.view_distance_voxels =
+				get_view_distances_voxels(viewer, view_distance_scale, volume_settings.view_distance_voxels);
 
 		// The last LOD should extend at least up to view distance. It must also be at least the distance specified by
 		// "lod distance"
@@ -246,7 +304,8 @@ void process_viewers(
 
 		paired_viewer.state.local_position_voxels = math::floor_to_int(local_position);
 		paired_viewer.state.requires_collisions = viewer.require_collisions && can_mesh;
-		paired_viewer.state.requires_visuals = viewer.require_visuals && can_mesh;
+		paired_viewer.state.requires_visuals =
+				viewer.require_visuals && can_mesh && !volume_settings.collision_only_mode;
 
 		// Viewers can request any box they like, but they must follow these rules:
 		// - Boxes of parent LODs must contain child boxes (when converted into world coordinates)
@@ -260,9 +319,11 @@ void process_viewers(
 
 		// Update data and mesh boxes
 		if (paired_viewer.state.requires_collisions || paired_viewer.state.requires_visuals) {
-			// Meshes are required
+			// Meshes are required.
+			// In collision-only mode, LODs without collision don't need meshes, and only need enough data to receive
+			// edits cascading from child LODs.
 
-			for (unsigned int lod_index = 0; lod_index < lod_count; ++lod_index) {
+			for (unsigned int lod_index = 0; lod_index < meshed_lod_count; ++lod_index) {
 				const int lod_mesh_block_size_po2 = volume_settings.mesh_block_size_po2 + lod_index;
 				const int lod_mesh_block_size = 1 << lod_mesh_block_size_po2;
 
@@ -284,7 +345,7 @@ void process_viewers(
 
 				// Make min and max coordinates even in child LODs, to respect subdivision rule.
 				// Root LOD doesn't need to respect that.
-				const bool even_coordinates_required = (lod_index != lod_count - 1);
+				const bool even_coordinates_required = (lod_index != meshed_lod_count - 1);
 
 				Box3i new_mesh_box = get_base_box_in_chunks(
 						paired_viewer.state.local_position_voxels,
@@ -309,7 +370,11 @@ void process_viewers(
 				const Box3i volume_bounds_in_mesh_blocks = volume_bounds_in_voxels.downscaled(lod_mesh_block_size);
 
 				Box3i &box = paired_viewer.state.mesh_box_per_lod[lod_index];
-				box.clip(volume_bounds_in_mesh_blocks);
+				if (lod_index < meshed_lod_count) {
+					box.clip(volume_bounds_in_mesh_blocks);
+				} else {
+					box = Box3i();
+				}
 			}
 
 			// TODO We should have a flag server side to force data boxes to be based on mesh boxes, even though the
@@ -338,6 +403,14 @@ void process_viewers(
 				// 				.padded(1)
 				// 				.clipped(volume_bounds_in_data_blocks);
 
+				if (lod_index >= meshed_lod_count) {
+					// Edits are cascaded to parent LODs, so their data must cover child LOD data
+					const Box3i &child_data_box = paired_viewer.state.data_box_per_lod[lod_index - 1];
+					paired_viewer.state.data_box_per_lod[lod_index] =
+							child_data_box.downscaled(2).clipped(volume_bounds_in_data_blocks);
+					continue;
+				}
+
 				const Box3i &mesh_box = paired_viewer.state.mesh_box_per_lod[lod_index];
 
 				const Box3i data_box =
@@ -1051,6 +1124,7 @@ void process_viewer_mesh_blocks_sliding_box(
 		VoxelLodTerrainUpdateData::State &state,
 		int mesh_block_size_po2,
 		int lod_count,
+		int meshed_lod_count,
 		const Box3i &volume_bounds_in_voxels,
 		const VoxelLodTerrainUpdateData::PairedViewer &paired_viewer,
 		bool can_load,
@@ -1086,7 +1160,7 @@ void process_viewer_mesh_blocks_sliding_box(
 		const Box3i &prev_mesh_box = paired_viewer.prev_state.mesh_box_per_lod[lod_index];
 
 #ifdef DEV_ENABLED
-		if (lod_index + 1 != lod_count) {
+		if (lod_index + 1 < meshed_lod_count) {
 			const Box3i debug_parent_box_in_current_lod(debug_parent_box.position << 1, debug_parent_box.size << 1);
 			ZN_ASSERT(debug_parent_box_in_current_lod.contains(new_mesh_box));
 		}
@@ -1099,6 +1173,10 @@ void process_viewer_mesh_blocks_sliding_box(
 		// 									.clipped(bounds_in_mesh_blocks);
 
 		if (!new_mesh_box.intersects(bounds_in_mesh_blocks) && !prev_mesh_box.intersects(bounds_in_mesh_blocks)) {
+			if (lod_index >= meshed_lod_count) {
+				// LODs above the meshed ones have no mesh box in collision-only mode, but smaller LODs still do
+				continue;
+			}
 			// If this box doesn't intersect either now or before, there is no chance a smaller one will
 			break;
 		}
@@ -1135,7 +1213,7 @@ void process_viewer_mesh_blocks_sliding_box(
 							out_of_range_box,
 							lod,
 							lod_index,
-							lod_count,
+							meshed_lod_count,
 							state,
 							// Use previous state because old boxes were loaded because of them
 							paired_viewer.prev_state.requires_visuals,
@@ -1158,7 +1236,7 @@ void process_viewer_mesh_blocks_sliding_box(
 					view_mesh_box(box, lod, lod_index, is_full_load_mode, mesh_to_data_factor, data, false, true);
 				} else {
 					// Remove refcount to just collisions
-					unview_mesh_box(box, lod, lod_index, lod_count, state, false, true);
+					unview_mesh_box(box, lod, lod_index, meshed_lod_count, state, false, true);
 				}
 			}
 
@@ -1167,7 +1245,7 @@ void process_viewer_mesh_blocks_sliding_box(
 				if (paired_viewer.state.requires_visuals) {
 					view_mesh_box(box, lod, lod_index, is_full_load_mode, mesh_to_data_factor, data, true, false);
 				} else {
-					unview_mesh_box(box, lod, lod_index, lod_count, state, true, false);
+					unview_mesh_box(box, lod, lod_index, meshed_lod_count, state, true, false);
 				}
 			}
 		}
@@ -1188,6 +1266,7 @@ void process_mesh_blocks_sliding_box(
 		const VoxelLodTerrainUpdateData::Settings &settings,
 		const Box3i bounds_in_voxels,
 		int lod_count,
+		int meshed_lod_count,
 		bool is_full_load_mode,
 		bool can_load,
 		const VoxelData &data,
@@ -1210,6 +1289,7 @@ void process_mesh_blocks_sliding_box(
 					state,
 					mesh_block_size_po2,
 					lod_count,
+					meshed_lod_count,
 					bounds_in_voxels,
 					paired_viewer,
 					can_load,
@@ -1250,8 +1330,11 @@ void process_loaded_data_blocks_trigger_meshing(
 		clipbox_streaming.loaded_data_blocks.clear();
 	}
 
-	// TODO Pool memory
-	FixedArray<StdUnorderedSet<Vector3i>, constants::MAX_LOD> checked_mesh_blocks_per_lod;
+	// Pooled to avoid reallocating buckets every update
+	static thread_local FixedArray<StdUnorderedSet<Vector3i>, constants::MAX_LOD> tls_checked_mesh_blocks_per_lod;
+	for (unsigned int lod_index = 0; lod_index < data.get_lod_count(); ++lod_index) {
+		tls_checked_mesh_blocks_per_lod[lod_index].clear();
+	}
 
 	const int data_to_mesh_shift = mesh_block_size_po2 - data.get_block_size_po2();
 
@@ -1268,7 +1351,7 @@ void process_loaded_data_blocks_trigger_meshing(
 		const Box3i data_neighboring =
 				Box3i(bloc.position - Vector3i(1, 1, 1), Vector3i(3, 3, 3)).clipped(bounds_in_data_blocks);
 
-		StdUnorderedSet<Vector3i> &checked_mesh_blocks = checked_mesh_blocks_per_lod[bloc.lod];
+		StdUnorderedSet<Vector3i> &checked_mesh_blocks = tls_checked_mesh_blocks_per_lod[bloc.lod];
 		VoxelLodTerrainUpdateData::Lod &lod = state.lods[bloc.lod];
 
 		const unsigned int lod_index = bloc.lod;
@@ -1555,7 +1638,8 @@ void update_mesh_block_load(
 
 void process_loaded_mesh_blocks_trigger_visibility_changes(
 		VoxelLodTerrainUpdateData::State &state,
-		unsigned int lod_count
+		unsigned int meshed_lod_count,
+		bool transitions_enabled
 ) {
 	ZN_PROFILE_SCOPE();
 
@@ -1575,31 +1659,23 @@ void process_loaded_mesh_blocks_trigger_visibility_changes(
 	for (const VoxelLodTerrainUpdateData::LoadedMeshBlockEvent event : tls_loaded_blocks) {
 		// TODO This isn't optimal. Cost of doing this is doubled if we want both visual and collision.
 		if (event.visual) {
-			update_mesh_block_load(state, event.position, event.lod_index, lod_count, MESH_VISUAL);
+			update_mesh_block_load(state, event.position, event.lod_index, meshed_lod_count, MESH_VISUAL);
 		}
 		// TODO We should not need to run this at LODs that have no collision
 		if (event.collision) {
-			update_mesh_block_load(state, event.position, event.lod_index, lod_count, MESH_COLLIDER);
+			update_mesh_block_load(state, event.position, event.lod_index, meshed_lod_count, MESH_COLLIDER);
 		}
 	}
 
-	{
-		uint32_t lods_to_update_transitions = 0;
-		for (unsigned int lod_index = 0; lod_index < lod_count; ++lod_index) {
-			VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
-			// Only update transition masks when visuals change, this is a rendering feature
-			if (lod.mesh_blocks_to_activate_visuals.size() > 0 || lod.mesh_blocks_to_deactivate_visuals.size() > 0) {
-				lods_to_update_transitions |= (0b111 << lod_index);
-			}
-		}
-		// TODO This is quite slow (see implementation).
-		// Maybe there is a way to optimize it with the clipbox logic (updates could be grouped per new/old boxes,
-		// however it wouldn't work as-is because mesh updates take time before they actually become visible. Could
-		// also update masks incrementally somehow?). The initial reason this streaming system was added was to help
-		// with server-side performance. This feature is client-only, so it didn't need to be optimized too at the
-		// moment.
-		update_transition_masks(state, lods_to_update_transitions, lod_count, true);
+	if (!transitions_enabled) {
+		// Meshes are built without transition surfaces, there is nothing to update
+		return;
 	}
+
+	// Only blocks around those which changed visibility need their transitions updated. Checking whole maps used to
+	// take milliseconds with high LOD counts and large LOD distances, for a few slabs of blocks changing when viewers
+	// move.
+	update_transition_masks_around_changes(state, meshed_lod_count);
 }
 
 } // namespace
@@ -1618,6 +1694,7 @@ void process_clipbox_streaming(
 	ZN_PROFILE_SCOPE();
 
 	const unsigned int lod_count = data.get_lod_count();
+	const unsigned int meshed_lod_count = get_meshed_lod_count(settings, lod_count);
 	const Box3i bounds_in_voxels = data.get_bounds();
 	const unsigned int data_block_size_po2 = data.get_block_size_po2();
 	const bool streaming_enabled = data.is_streaming_enabled();
@@ -1629,6 +1706,7 @@ void process_clipbox_streaming(
 			state.clipbox_streaming,
 			settings,
 			lod_count,
+			meshed_lod_count,
 			viewers,
 			volume_transform,
 			bounds_in_voxels,
@@ -1652,7 +1730,15 @@ void process_clipbox_streaming(
 	}
 
 	process_mesh_blocks_sliding_box(
-			state, settings, bounds_in_voxels, lod_count, !streaming_enabled, can_load, data, 1 << data_block_size_po2
+			state,
+			settings,
+			bounds_in_voxels,
+			lod_count,
+			meshed_lod_count,
+			!streaming_enabled,
+			can_load,
+			data,
+			1 << data_block_size_po2
 	);
 
 	// Removing paired viewers after box diffs because we interpret viewer removal as boxes becoming zero-size, so we
@@ -1665,7 +1751,8 @@ void process_clipbox_streaming(
 		process_loaded_data_blocks_trigger_meshing(data, state, settings, bounds_in_voxels);
 	}
 
-	process_loaded_mesh_blocks_trigger_visibility_changes(state, lod_count);
+	// Transition meshes are not built in collision-only mode (see `send_mesh_requests`)
+	process_loaded_mesh_blocks_trigger_visibility_changes(state, meshed_lod_count, !settings.collision_only_mode);
 
 	// state.clipbox_streaming.viewer_pos_in_lod0_voxels_previous_update = viewer_pos_in_lod0_voxels;
 }
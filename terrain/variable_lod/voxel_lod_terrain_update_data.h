@@ -78,6 +78,14 @@ struct VoxelLodTerrainUpdateData {
 		// Not really exposed for now, will wait for it to be really needed. It might never be.
 		bool cache_generated_blocks = false;
 		bool collision_enabled = true;
+		// 0 means all LODs have collision
+		uint8_t collision_lod_count = 0;
+		// If true, only LODs having collision are streamed around viewers, and no visuals are produced. Meant for
+		// headless servers. Parent LODs only keep the data needed to cascade edits.
+		bool collision_only_mode = false;
+		// If true, meshes keep rendering attributes even when they are only built for collision, because a
+		// VoxelInstancer generates instances from them
+		bool keep_render_attributes = false;
 		bool detail_textures_use_gpu = false;
 		bool generator_use_gpu = false;
 		uint8_t detail_texture_generator_override_begin_lod_index = 0;
@@ -7,6 +7,7 @@
 #include "../../streams/load_block_data_task.h"
 #include "../../streams/save_block_data_task.h"
 #include "../../util/containers/container_funcs.h"
+#include "../../util/containers/std_unordered_set.h"
 #include "../../util/dstack.h"
 #include "../../util/godot/classes/engine.h"
 #include "../../util/math/conv.h"
@@ -334,11 +335,16 @@ void send_mesh_requests(
 			task->volume_id = volume_id;
 			task->mesh_block_position = mesh_to_update.position;
 			task->lod_index = lod_index;
-			task->lod_hint = true;
+			// Transition meshes are only needed for rendering
+			task->lod_hint = !settings.collision_only_mode ||
+					settings.streaming_system != VoxelLodTerrainUpdateData::STREAMING_SYSTEM_CLIPBOX;
 			task->meshing_dependency = meshing_dependency;
 			task->data = data_ptr;
 			task->require_visual = mesh_to_update.require_visual;
-			task->collision_hint = settings.collision_enabled;
+			task->keep_render_attributes = settings.keep_render_attributes;
+			// Collision shapes may be built by the task, so don't request them for LODs that won't use them
+			task->collision_hint = settings.collision_enabled &&
+					(settings.collision_lod_count == 0 || lod_index < settings.collision_lod_count);
 #ifdef VOXEL_ENABLE_SMOOTH_MESHING
 			task->detail_texture_settings = settings.detail_texture_settings;
 			task->detail_texture_generator_override = settings.detail_texture_generator_override;
@@ -805,6 +811,8 @@ void update_transition_masks(
 	// So instead, when any block changes state in LOD N, we update all transitions in LODs N-1, N, and N+1.
 	// It is unclear yet why the old approach didn't work, maybe because it didn't properly made N-1 and N+1 update.
 	// If you find a better approach, it has to comply with the validation check below.
+	// Clipbox streaming now uses such an approach, see `update_transition_masks_around_changes`. Octree streaming still
+	// uses this one, because it doesn't maintain mesh viewer refcounts that function relies on.
 	if (lods_to_update_transitions != 0) {
 		ZN_PROFILE_SCOPE_NAMED("Transition masks");
 		// We pass a mask that gets populated with (0b111 << index), because we want to add lod+1, lod+0 and lod-1. But
@@ -859,6 +867,115 @@ void update_transition_masks(
 #endif
 }
 
+void update_transition_masks_around_changes(VoxelLodTerrainUpdateData::State &state, const unsigned int lod_count) {
+	// The transition mask of a block only depends on the visibility of its side neighbors in the same LOD, the parent
+	// LOD and the child LOD. So instead of checking whole maps, only blocks around those whose visibility changed
+	// (or got unloaded) during this update are checked. When a viewer moves, that is only a few slabs of blocks.
+	//
+	// The old incremental approach of octree streaming caused cracks, because it missed blocks of LODs N-1 and N+1
+	// (see `update_transition_masks`). Here, the neighborhoods below are derived from exactly what
+	// `get_transition_mask` reads, in all three LODs, so they must be kept in sync with it. Tests compare the result
+	// with a full recomputation, both on a simulated layout and when running clipbox streaming.
+
+	static thread_local FixedArray<StdUnorderedSet<Vector3i>, constants::MAX_LOD> tls_candidates_per_lod;
+
+	struct L {
+		static void add_box(StdUnorderedSet<Vector3i> &candidates, const Box3i box) {
+			box.for_each_cell([&candidates](const Vector3i pos) { candidates.insert(pos); });
+		}
+
+		static void add_neighborhood(
+				FixedArray<StdUnorderedSet<Vector3i>, constants::MAX_LOD> &candidates_per_lod,
+				const Vector3i bpos,
+				const unsigned int lod_index,
+				const unsigned int lod_count
+		) {
+			// Blocks of the same LOD having this one as side neighbor
+			add_box(candidates_per_lod[lod_index], Box3i(bpos - Vector3i(1, 1, 1), Vector3i(3, 3, 3)));
+			// Blocks of the parent LOD having this one as child of a side neighbor. These read child neighbors at
+			// `2 * pos - 1` and `2 * pos + 2` along each axis, so a child block can affect parents up to 1 block away.
+			if (lod_index + 1 < lod_count) {
+				add_box(candidates_per_lod[lod_index + 1], Box3i((bpos >> 1) - Vector3i(1, 1, 1), Vector3i(3, 3, 3)));
+			}
+			// Blocks of the child LOD having this one as parent of a side neighbor. These read the parent of
+			// `pos + side_normal`, which is this block for children from `2 * pos - 1` to `2 * pos + 2`.
+			if (lod_index > 0) {
+				add_box(candidates_per_lod[lod_index - 1], Box3i((bpos << 1) - Vector3i(1, 1, 1), Vector3i(4, 4, 4)));
+			}
+		}
+
+		static void add_neighborhoods(
+				FixedArray<StdUnorderedSet<Vector3i>, constants::MAX_LOD> &candidates_per_lod,
+				Span<const Vector3i> positions,
+				const unsigned int lod_index,
+				const unsigned int lod_count
+		) {
+			for (const Vector3i bpos : positions) {
+				add_neighborhood(candidates_per_lod, bpos, lod_index, lod_count);
+			}
+		}
+	};
+
+	bool any_change = false;
+
+	for (unsigned int lod_index = 0; lod_index < lod_count; ++lod_index) {
+		tls_candidates_per_lod[lod_index].clear();
+	}
+
+	for (unsigned int lod_index = 0; lod_index < lod_count; ++lod_index) {
+		const VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
+		// Only update transition masks when visuals change, this is a rendering feature
+		if (lod.mesh_blocks_to_activate_visuals.size() > 0 || lod.mesh_blocks_to_deactivate_visuals.size() > 0 ||
+			lod.mesh_blocks_to_unload.size() > 0) {
+			L::add_neighborhoods(
+					tls_candidates_per_lod, to_span(lod.mesh_blocks_to_activate_visuals), lod_index, lod_count
+			);
+			L::add_neighborhoods(
+					tls_candidates_per_lod, to_span(lod.mesh_blocks_to_deactivate_visuals), lod_index, lod_count
+			);
+			L::add_neighborhoods(tls_candidates_per_lod, to_span(lod.mesh_blocks_to_unload), lod_index, lod_count);
+			any_change = true;
+		}
+	}
+
+	if (!any_change) {
+		return;
+	}
+
+	ZN_PROFILE_SCOPE_NAMED("Transition masks");
+
+	for (unsigned int lod_index = 0; lod_index < lod_count; ++lod_index) {
+		const StdUnorderedSet<Vector3i> &candidates = tls_candidates_per_lod[lod_index];
+		if (candidates.size() == 0) {
+			continue;
+		}
+
+		VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
+
+		RWLockRead rlock(lod.mesh_map_state.map_lock);
+
+		for (const Vector3i bpos : candidates) {
+			auto it = lod.mesh_map_state.map.find(bpos);
+			if (it == lod.mesh_map_state.map.end()) {
+				continue;
+			}
+			VoxelLodTerrainUpdateData::MeshBlockState &mesh_block = it->second;
+
+			if (mesh_block.visual_active && mesh_block.mesh_viewers.get() > 0) {
+				const uint8_t recomputed_mask =
+						VoxelLodTerrainUpdateTask::get_transition_mask(state, bpos, lod_index, lod_count);
+
+				if (recomputed_mask != mesh_block.transition_mask) {
+					mesh_block.transition_mask = recomputed_mask;
+					lod.mesh_blocks_to_update_transitions.push_back(
+							VoxelLodTerrainUpdateData::TransitionUpdate{ bpos, recomputed_mask }
+					);
+				}
+			}
+		}
+	}
+}
+
 void add_unloaded_saving_blocks(VoxelLodTerrainUpdateData::Lod &lod, Span<const VoxelData::BlockToSave> src) {
 	if (src.size() == 0) {
 		return;
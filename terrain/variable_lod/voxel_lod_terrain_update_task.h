@@ -113,6 +113,10 @@ void update_transition_masks(
 		const bool use_refcounts
 );
 
+// Same as `update_transition_masks`, but only checks blocks around those whose visuals got activated, deactivated or
+// unloaded during the current update. Only supports refcounted blocks (clipbox streaming).
+void update_transition_masks_around_changes(VoxelLodTerrainUpdateData::State &state, const unsigned int lod_count);
+
 void add_unloaded_saving_blocks(VoxelLodTerrainUpdateData::Lod &lod, Span<const VoxelData::BlockToSave> src);
 
 } // namespace zylann::voxel
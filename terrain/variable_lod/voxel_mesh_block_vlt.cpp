@@ -9,6 +9,26 @@ using namespace zylann::godot;
 
 namespace zylann::voxel {
 
+namespace {
+
+uint8_t encode_transition_mask_for_shader(uint8_t m) {
+	// TODO Needs translation here, because Cube:: tables use slightly different order...
+	// We may get rid of this once cube tables respects -x+x-y+y-z+z order
+	uint8_t bits[Cube::SIDE_COUNT];
+	for (unsigned int dir = 0; dir < Cube::SIDE_COUNT; ++dir) {
+		bits[dir] = (m >> dir) & 1;
+	}
+	uint8_t tm = bits[Cube::SIDE_NEGATIVE_X];
+	tm |= bits[Cube::SIDE_POSITIVE_X] << 1;
+	tm |= bits[Cube::SIDE_NEGATIVE_Y] << 2;
+	tm |= bits[Cube::SIDE_POSITIVE_Y] << 3;
+	tm |= bits[Cube::SIDE_NEGATIVE_Z] << 4;
+	tm |= bits[Cube::SIDE_POSITIVE_Z] << 5;
+	return tm;
+}
+
+} // namespace
+
 VoxelMeshBlockVLT::VoxelMeshBlockVLT(const Vector3i bpos, unsigned int size, unsigned int p_lod_index) :
 		VoxelMeshBlock(bpos) {
 	_position_in_voxels = bpos * (size << p_lod_index);
@@ -73,7 +93,7 @@ void VoxelMeshBlockVLT::set_mesh(
 		}
 	} else {
 		if (!_shadow_occluder.is_valid()) {
-			_shadow_occluder.create();
+			_shadow_occluder.create(VoxelEngine::get_singleton().get_rendering_instance_pool());
 			_shadow_occluder.set_interpolated(false);
 			_shadow_occluder.set_render_layers_mask(render_layers_mask);
 #ifdef TOOLS_ENABLED
@@ -91,12 +111,15 @@ void VoxelMeshBlockVLT::set_mesh(
 	if (mesh.is_valid()) {
 		if (!_mesh_instance.is_valid()) {
 			// Create instance if it doesn't exist
-			_mesh_instance.create();
+			_mesh_instance.create(VoxelEngine::get_singleton().get_rendering_instance_pool());
 			_mesh_instance.set_interpolated(false);
 			_mesh_instance.set_gi_mode(gi_mode);
 			_mesh_instance.set_cast_shadows_setting(shadow_casting);
 			_mesh_instance.set_render_layers_mask(render_layers_mask);
-			set_mesh_instance_visible(_mesh_instance, _visible && _parent_visible);
+			set_mesh_instance_visible(_mesh_instance, is_mesh_instance_visible());
+			if (_shader_material_shared) {
+				copy_shader_instance_parameters(_mesh_instance);
+			}
 		}
 
 		_mesh_instance.set_mesh(mesh);
@@ -143,6 +166,9 @@ void VoxelMeshBlockVLT::drop_visuals() {
 		}
 	}
 
+	batching_surfaces.clear();
+	_batched = false;
+
 	detail_texture_fallback_level = 0;
 	fading_state = FADING_NONE;
 	fading_progress = 0.f;
@@ -193,12 +219,15 @@ void VoxelMeshBlockVLT::set_transition_mesh(
 	if (mesh.is_valid()) {
 		if (!mesh_instance.is_valid()) {
 			// Create instance if it doesn't exist
-			mesh_instance.create();
+			mesh_instance.create(VoxelEngine::get_singleton().get_rendering_instance_pool());
 			mesh_instance.set_interpolated(false);
 			mesh_instance.set_gi_mode(gi_mode);
 			mesh_instance.set_cast_shadows_setting(shadow_casting);
 			mesh_instance.set_render_layers_mask(render_layers_mask);
 			set_mesh_instance_visible(mesh_instance, _visible && _parent_visible && _is_transition_visible(side));
+			if (_shader_material_shared) {
+				copy_shader_instance_parameters(mesh_instance);
+			}
 		}
 
 		mesh_instance.set_mesh(mesh);
@@ -240,7 +269,9 @@ void VoxelMeshBlockVLT::set_visible(bool visible) {
 }
 
 void VoxelMeshBlockVLT::_set_visible(bool visible) {
-	VoxelMeshBlock::_set_visible(visible);
+	if (_mesh_instance.is_valid()) {
+		set_mesh_instance_visible(_mesh_instance, visible && !_batched);
+	}
 
 	if (_shadow_occluder.is_valid()) {
 		set_mesh_instance_visible(_shadow_occluder, visible);
@@ -254,8 +285,19 @@ void VoxelMeshBlockVLT::_set_visible(bool visible) {
 	}
 }
 
+void VoxelMeshBlockVLT::set_batched(bool batched) {
+	if (_batched == batched) {
+		return;
+	}
+	_batched = batched;
+	if (_mesh_instance.is_valid()) {
+		set_mesh_instance_visible(_mesh_instance, is_mesh_instance_visible());
+	}
+}
+
 void VoxelMeshBlockVLT::set_shader_material(Ref<ShaderMaterial> material) {
 	_shader_material = material;
+	_shader_material_shared = false;
 
 	set_material_override_internal(material);
 
@@ -267,6 +309,53 @@ void VoxelMeshBlockVLT::set_shader_material(Ref<ShaderMaterial> material) {
 	}
 }
 
+void VoxelMeshBlockVLT::set_shared_shader_material(Ref<ShaderMaterial> material) {
+	_shader_material = material;
+	_shader_material_shared = material.is_valid();
+
+	set_material_override_internal(material);
+
+	if (_shader_material_shared) {
+		if (_mesh_instance.is_valid()) {
+			copy_shader_instance_parameters(_mesh_instance);
+		}
+		for (unsigned int i = 0; i < _transition_mesh_instances.size(); ++i) {
+			DirectMeshInstance &mi = _transition_mesh_instances[i];
+			if (mi.is_valid()) {
+				copy_shader_instance_parameters(mi);
+			}
+		}
+	}
+}
+
+void VoxelMeshBlockVLT::set_lod_fade(Vector2 lod_fade) {
+	_lod_fade = lod_fade;
+	set_block_shader_parameter(VoxelStringNames::get_singleton().u_lod_fade, lod_fade);
+}
+
+void VoxelMeshBlockVLT::copy_shader_instance_parameters(DirectMeshInstance &mi) const {
+	const VoxelStringNames &sn = VoxelStringNames::get_singleton();
+	mi.set_shader_instance_parameter(sn.u_transition_mask, encode_transition_mask_for_shader(_transition_mask));
+	mi.set_shader_instance_parameter(sn.u_lod_fade, _lod_fade);
+}
+
+void VoxelMeshBlockVLT::set_block_shader_parameter(const StringName &name, const Variant &value) {
+	if (_shader_material_shared) {
+		// The material is shared with other blocks, so parameters specific to this block go to its instances
+		if (_mesh_instance.is_valid()) {
+			_mesh_instance.set_shader_instance_parameter(name, value);
+		}
+		for (unsigned int i = 0; i < _transition_mesh_instances.size(); ++i) {
+			DirectMeshInstance &mi = _transition_mesh_instances[i];
+			if (mi.is_valid()) {
+				mi.set_shader_instance_parameter(name, value);
+			}
+		}
+	} else if (_shader_material.is_valid()) {
+		_shader_material->set_shader_parameter(name, value);
+	}
+}
+
 void VoxelMeshBlockVLT::set_material_override(Ref<Material> material) {
 #ifdef DEBUG_ENABLED
 	Ref<ShaderMaterial> sm = material;
@@ -275,6 +364,7 @@ void VoxelMeshBlockVLT::set_material_override(Ref<Material> material) {
 	}
 #endif
 	_shader_material = Ref<ShaderMaterial>();
+	_shader_material_shared = false;
 	set_material_override_internal(material);
 }
 
@@ -309,23 +399,9 @@ void VoxelMeshBlockVLT::set_transition_mask(uint8_t m) {
 		return;
 	}
 	_transition_mask = m;
-	if (_shader_material.is_valid()) {
-		// TODO Needs translation here, because Cube:: tables use slightly different order...
-		// We may get rid of this once cube tables respects -x+x-y+y-z+z order
-		uint8_t bits[Cube::SIDE_COUNT];
-		for (unsigned int dir = 0; dir < Cube::SIDE_COUNT; ++dir) {
-			bits[dir] = (m >> dir) & 1;
-		}
-		uint8_t tm = bits[Cube::SIDE_NEGATIVE_X];
-		tm |= bits[Cube::SIDE_POSITIVE_X] << 1;
-		tm |= bits[Cube::SIDE_NEGATIVE_Y] << 2;
-		tm |= bits[Cube::SIDE_POSITIVE_Y] << 3;
-		tm |= bits[Cube::SIDE_NEGATIVE_Z] << 4;
-		tm |= bits[Cube::SIDE_POSITIVE_Z] << 5;
-
-		// TODO Godot 4: we may replace this with a per-instance parameter so we can lift material access limitation
-		_shader_material->set_shader_parameter(VoxelStringNames::get_singleton().u_transition_mask, tm);
-	}
+	set_block_shader_parameter(
+			VoxelStringNames::get_singleton().u_transition_mask, encode_transition_mask_for_shader(m)
+	);
 	for (int dir = 0; dir < Cube::SIDE_COUNT; ++dir) {
 		DirectMeshInstance &mi = _transition_mesh_instances[dir];
 		if (mi.is_valid() && (diff & (1 << dir))) {
@@ -426,9 +502,7 @@ bool VoxelMeshBlockVLT::update_fading(float speed) {
 			break;
 	}
 
-	if (_shader_material.is_valid()) {
-		_shader_material->set_shader_parameter(VoxelStringNames::get_singleton().u_lod_fade, p);
-	}
+	set_lod_fade(p);
 
 	return finished;
 }
@@ -436,9 +510,7 @@ bool VoxelMeshBlockVLT::update_fading(float speed) {
 void VoxelMeshBlockVLT::clear_fading() {
 	fading_state = FADING_NONE;
 	fading_progress = 0.f;
-	if (_shader_material.is_valid()) {
-		_shader_material->set_shader_parameter(VoxelStringNames::get_singleton().u_lod_fade, Vector2(0.0, 0.0));
-	}
+	set_lod_fade(Vector2(0.0, 0.0));
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
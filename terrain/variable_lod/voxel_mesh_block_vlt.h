@@ -38,10 +38,20 @@ public:
 
 	uint64_t last_collider_update_time = 0;
 	UniquePtr<VoxelMesher::Output> deferred_collider_data;
+	// Set instead of `deferred_collider_data` when the collision shape was already built by the meshing task.
+	// The shape can be null if the mesh had no collision surface.
+	Ref<Shape3D> deferred_collision_shape;
+	bool has_deferred_collision_shape = false;
 
 	int32_t col_vertex_end = -1;
 	int32_t col_index_end = -1;
 
+	// Surfaces of the rendering mesh, only kept when mesh batching is enabled for the LOD of this block, so it can be
+	// merged with its neighbors (see `MeshBlockBatchesVLT`). This costs memory, so it is empty otherwise.
+	StdVector<VoxelMesher::Output::Surface> batching_surfaces;
+	Mesh::PrimitiveType batching_primitive_type = Mesh::PRIMITIVE_TRIANGLES;
+	uint32_t batching_mesh_flags = 0;
+
 	VoxelMeshBlockVLT(const Vector3i bpos, unsigned int size, unsigned int p_lod_index);
 	~VoxelMeshBlockVLT();
 
@@ -71,6 +81,17 @@ public:
 	);
 	void drop_visuals();
 
+	// When batched, the mesh of this block is drawn by a merged mesh instance, so its own instance is hidden.
+	void set_batched(bool batched);
+	inline bool is_batched() const {
+		return _batched;
+	}
+
+	// Tells if the block draws its own mesh. It doesn't while hidden or batched.
+	inline bool is_mesh_instance_visible() const {
+		return _mesh_instance.is_valid() && _visible && _parent_visible && !_batched;
+	}
+
 	void set_transition_mask(uint8_t m);
 	inline uint8_t get_transition_mask() const {
 		return _transition_mask;
@@ -93,6 +114,19 @@ public:
 		return _shader_material;
 	}
 
+	// Uses a material shared with other blocks. Per-block parameters are then set on mesh instances instead, so the
+	// shader must declare them as `instance uniform`.
+	void set_shared_shader_material(Ref<ShaderMaterial> material);
+	inline bool is_shader_material_shared() const {
+		return _shader_material_shared;
+	}
+
+	void set_lod_fade(Vector2 lod_fade);
+
+	// Sets per-block instance parameters on another mesh instance drawing the mesh of this block, when the material
+	// is shared.
+	void copy_shader_instance_parameters(zylann::godot::DirectMeshInstance &mi) const;
+
 	// To be used only if the material override on the terrain is not a ShaderMaterial
 	void set_material_override(Ref<Material> material);
 
@@ -122,6 +156,7 @@ public:
 
 private:
 	void set_material_override_internal(Ref<Material> material);
+	void set_block_shader_parameter(const StringName &name, const Variant &value);
 	void _set_visible(bool visible);
 
 	inline bool _is_transition_visible(unsigned int side) const {
@@ -129,11 +164,16 @@ private:
 	}
 
 	Ref<ShaderMaterial> _shader_material;
+	bool _shader_material_shared = false;
+	// Last value given to `u_lod_fade`
+	Vector2 _lod_fade;
 
 	FixedArray<zylann::godot::DirectMeshInstance, Cube::SIDE_COUNT> _transition_mesh_instances;
 
 	uint8_t _transition_mask = 0;
 
+	bool _batched = false;
+
 	// See VoxelMesherBlocky.
 	// This unfortunately has to be a whole separate mesh instance because Godot doesn't support setting
 	// `cast_shadow` mode per mesh surface. This might have an impact on performance.
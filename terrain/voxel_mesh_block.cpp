@@ -62,7 +62,7 @@ void VoxelMeshBlock::set_mesh(
 	if (mesh.is_valid()) {
 		if (!_mesh_instance.is_valid()) {
 			// Create instance if it doesn't exist
-			_mesh_instance.create();
+			_mesh_instance.create(VoxelEngine::get_singleton().get_rendering_instance_pool());
 			_mesh_instance.set_interpolated(false);
 			_mesh_instance.set_gi_mode(gi_mode);
 			_mesh_instance.set_cast_shadows_setting(shadow_setting);
@@ -154,7 +154,7 @@ void VoxelMeshBlock::set_collision_shape(Ref<Shape3D> shape, bool debug_collisio
 	}
 
 	if (!_static_body.is_valid()) {
-		_static_body.create();
+		_static_body.create(VoxelEngine::get_singleton().get_physics_body_pool());
 		_static_body.set_world(*_world);
 		// This allows collision signals to provide the terrain node in the `collider` field
 		_static_body.set_attached_object(node);
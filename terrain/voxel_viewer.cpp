@@ -107,6 +107,68 @@ bool VoxelViewer::is_enabled_in_editor() const {
 	return _enabled_in_editor;
 }
 
+void VoxelViewer::set_motion_prediction_time(float time) {
+	_motion_prediction_time = math::max(time, 0.f);
+	if (is_active()) {
+		sync_priority_parameters();
+	}
+}
+
+float VoxelViewer::get_motion_prediction_time() const {
+	return _motion_prediction_time;
+}
+
+void VoxelViewer::set_view_direction_priority_enabled(bool enabled) {
+	_view_direction_priority_enabled = enabled;
+	if (is_active()) {
+		sync_priority_parameters();
+	}
+}
+
+bool VoxelViewer::is_view_direction_priority_enabled() const {
+	return _view_direction_priority_enabled;
+}
+
+bool VoxelViewer::is_priority_motion_needed() const {
+	return _motion_prediction_time > 0.f || _view_direction_priority_enabled;
+}
+
+void VoxelViewer::sync_priority_parameters() {
+	VoxelEngine &ve = VoxelEngine::get_singleton();
+	ve.set_viewer_motion_prediction_time(_viewer_id, _motion_prediction_time);
+	if (_motion_prediction_time == 0.f) {
+		_velocity = Vector3();
+		_prev_position_valid = false;
+		ve.set_viewer_velocity(_viewer_id, Vector3());
+	}
+	if (!_view_direction_priority_enabled) {
+		ve.set_viewer_view_direction(_viewer_id, Vector3());
+	}
+	// Velocity and direction are measured every frame only if something needs them
+	set_process_internal(is_priority_motion_needed());
+}
+
+void VoxelViewer::update_priority_motion(float delta) {
+	const Transform3D transform = get_global_transform();
+	VoxelEngine &ve = VoxelEngine::get_singleton();
+
+	if (_motion_prediction_time > 0.f) {
+		if (_prev_position_valid && delta > 0.f) {
+			const Vector3 instant_velocity = (transform.origin - _prev_position) / delta;
+			// Smoothed, because the position may not change every frame (for example when moved in physics frames)
+			_velocity = _velocity.lerp(instant_velocity, 0.25f);
+			ve.set_viewer_velocity(_viewer_id, _velocity);
+		}
+		_prev_position = transform.origin;
+		_prev_position_valid = true;
+	}
+
+	if (_view_direction_priority_enabled) {
+		// Viewers are usually children of a camera, which looks towards -Z
+		ve.set_viewer_view_direction(_viewer_id, -transform.basis.get_column(Vector3::AXIS_Z));
+	}
+}
+
 void VoxelViewer::sync_view_distances() {
 	VoxelEngine::Viewer::Distances distances;
 	distances.horizontal = _view_distance;
@@ -129,6 +191,8 @@ void VoxelViewer::sync_all_parameters() {
 	ve.set_viewer_network_peer_id(_viewer_id, _network_peer_id);
 	const Vector3 pos = get_global_transform().origin;
 	ve.set_viewer_position(_viewer_id, pos);
+	_prev_position_valid = false;
+	sync_priority_parameters();
 }
 
 void VoxelViewer::_notification(int p_what) {
@@ -165,6 +229,12 @@ void VoxelViewer::_notification(int p_what) {
 			}
 			break;
 
+		case NOTIFICATION_INTERNAL_PROCESS:
+			if (is_active()) {
+				update_priority_motion(get_process_delta_time());
+			}
+			break;
+
 		case NOTIFICATION_TRANSFORM_CHANGED:
 			if (is_active()) {
 				const Vector3 pos = get_global_transform().origin;
@@ -247,7 +317,28 @@ void VoxelViewer::_bind_methods() {
 			"set_requires_data_block_notifications",
 			"is_requiring_data_block_notifications"
 	);
+	ClassDB::bind_method(D_METHOD("set_motion_prediction_time", "time"), &VoxelViewer::set_motion_prediction_time);
+	ClassDB::bind_method(D_METHOD("get_motion_prediction_time"), &VoxelViewer::get_motion_prediction_time);
+
+	ClassDB::bind_method(
+			D_METHOD("set_view_direction_priority_enabled", "enabled"),
+			&VoxelViewer::set_view_direction_priority_enabled
+	);
+	ClassDB::bind_method(
+			D_METHOD("is_view_direction_priority_enabled"), &VoxelViewer::is_view_direction_priority_enabled
+	);
+
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "enabled_in_editor"), "set_enabled_in_editor", "is_enabled_in_editor");
+	ADD_PROPERTY(
+			PropertyInfo(Variant::FLOAT, "motion_prediction_time", PROPERTY_HINT_RANGE, "0.0,10.0,0.1,or_greater"),
+			"set_motion_prediction_time",
+			"get_motion_prediction_time"
+	);
+	ADD_PROPERTY(
+			PropertyInfo(Variant::BOOL, "view_direction_priority_enabled"),
+			"set_view_direction_priority_enabled",
+			"is_view_direction_priority_enabled"
+	);
 }
 
 } // namespace zylann::voxel
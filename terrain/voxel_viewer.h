@@ -39,6 +39,13 @@ public:
 	void set_enabled_in_editor(bool enable);
 	bool is_enabled_in_editor() const;
 
+	// Time in seconds. Blocks along the way the viewer is moving will load sooner, as if the viewer was already there.
+	void set_motion_prediction_time(float time);
+	float get_motion_prediction_time() const;
+
+	void set_view_direction_priority_enabled(bool enabled);
+	bool is_view_direction_priority_enabled() const;
+
 protected:
 	void _notification(int p_what);
 
@@ -47,6 +54,9 @@ private:
 
 	void sync_all_parameters();
 	void sync_view_distances();
+	void sync_priority_parameters();
+	void update_priority_motion(float delta);
+	bool is_priority_motion_needed() const;
 
 	// static void unregister_deferred_callback(const ObjectID viewer_node_id, const Vector2i encoded_viewer_id);
 	static void unregister_deferred_callback(const int64_t viewer_node_id, const Vector2i encoded_viewer_id);
@@ -62,6 +72,12 @@ private:
 	bool _enabled_in_editor = false;
 	bool _pending_deferred_unregistration = false;
 	int _network_peer_id = -1;
+	float _motion_prediction_time = 0.f;
+	bool _view_direction_priority_enabled = false;
+	// Used to measure velocity
+	Vector3 _prev_position;
+	bool _prev_position_valid = false;
+	Vector3 _velocity;
 };
 
 } // namespace zylann::voxel
@@ -6,18 +6,22 @@
 #include "util/test_container_funcs.h"
 #include "util/test_expression_parser.h"
 #include "util/test_flat_map.h"
+#include "util/test_godot_mesh.h"
 #include "util/test_island_finder.h"
 #include "util/test_math_funcs.h"
 #include "util/test_noise.h"
+#include "util/test_server_object_pools.h"
 #include "util/test_slot_map.h"
 #include "util/test_spatial_lock.h"
 #include "util/test_string_funcs.h"
+#include "util/test_temp_arena.h"
 #include "util/test_threaded_task_runner.h"
 
 #include "voxel/test_block_serializer.h"
 #include "voxel/test_curve_range.h"
 #include "voxel/test_edition_funcs.h"
 #include "voxel/test_octree.h"
+#include "voxel/test_priority_dependency.h"
 #include "voxel/test_raycast.h"
 #include "voxel/test_region_file.h"
 #include "voxel/test_storage_funcs.h"
@@ -25,7 +29,10 @@
 #include "voxel/test_voxel_data_map.h"
 #include "voxel/test_voxel_graph.h"
 #include "voxel/test_voxel_instancer.h"
+#include "voxel/test_voxel_lod_terrain.h"
+#include "voxel/test_voxel_mesher_blocky.h"
 #include "voxel/test_voxel_mesher_cubes.h"
+#include "voxel/test_voxel_terrain.h"
 
 #ifdef VOXEL_ENABLE_SMOOTH_MESHING
 #include "voxel/test_transvoxel.h"
@@ -175,6 +182,44 @@ void run_voxel_tests(const testing::TestOptions &options) {
 	VOXEL_TEST(test_voxel_graph_multiple_function_instances);
 	VOXEL_TEST(test_voxel_graph_issue783);
 	VOXEL_TEST(test_voxel_graph_broad_block);
+	VOXEL_TEST(test_voxel_graph_steady_state_allocations);
+	VOXEL_TEST(test_voxel_graph_xz_column_cache);
+	VOXEL_TEST(test_voxel_graph_series_batch);
+	VOXEL_TEST(test_voxel_graph_shared_runtime);
+	VOXEL_TEST(test_voxel_graph_shared_runtime_resources);
+	VOXEL_TEST(test_voxel_graph_node_profiling);
+	VOXEL_TEST(test_voxel_mesher_blocky_greedy);
+	VOXEL_TEST(test_voxel_mesher_blocky_binary_culling);
+	VOXEL_TEST(test_voxel_mesher_blocky_binary_culling_inside_geometry);
+#ifdef VOXEL_ENABLE_SMOOTH_MESHING
+	VOXEL_TEST(test_transvoxel_tall_block);
+#endif
+	VOXEL_TEST(test_temp_arena);
+	VOXEL_TEST(test_voxel_mesher_blocky_vertex_compression);
+	VOXEL_TEST(test_voxel_mesher_cubes_mesh_optimization);
+	VOXEL_TEST(test_voxel_mesher_cubes_vertex_compression);
+	VOXEL_TEST(test_voxel_mesher_blocky_incremental);
+	VOXEL_TEST(test_parallel_for);
+#ifdef VOXEL_ENABLE_SMOOTH_MESHING
+	VOXEL_TEST(test_transvoxel_parallel_slabs);
+	VOXEL_TEST(test_transvoxel_mixel4_presort);
+#endif
+	VOXEL_TEST(test_priority_dependency_motion_prediction);
+	VOXEL_TEST(test_priority_dependency_view_direction);
+	VOXEL_TEST(test_voxel_lod_terrain_transition_masks_moving_viewer);
+	VOXEL_TEST(test_voxel_lod_terrain_clipbox_transition_masks);
+	VOXEL_TEST(test_voxel_lod_terrain_clipbox_viewer_pairing);
+	VOXEL_TEST(test_voxel_lod_terrain_clipbox_collision_only);
+	VOXEL_TEST(test_mesh_block_batches_vlt);
+	VOXEL_TEST(test_voxel_mesher_blocky_side_connectivity);
+	VOXEL_TEST(test_voxel_mesher_blocky_collision_only);
+	VOXEL_TEST(test_voxel_terrain_occlusion_culling_reachable_blocks);
+	VOXEL_TEST(test_voxel_terrain_threaded_collision_shape);
+#ifdef VOXEL_ENABLE_SMOOTH_MESHING
+	VOXEL_TEST(test_transvoxel_collision_only);
+#endif
+	VOXEL_TEST(test_merge_surfaces);
+	VOXEL_TEST(test_rendering_instance_pool);
 
 	print_line("------------ Voxel tests end -------------");
 }
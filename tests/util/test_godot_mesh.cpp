@@ -0,0 +1,70 @@
+#include "test_godot_mesh.h"
+#include "../../util/containers/fixed_array.h"
+#include "../../util/godot/classes/mesh.h"
+#include "../../util/testing/test_macros.h"
+
+namespace zylann::tests {
+
+namespace {
+
+Array make_triangle_surface(const float uv_x) {
+	PackedVector3Array positions;
+	positions.push_back(Vector3(0, 0, 0));
+	positions.push_back(Vector3(1, 0, 0));
+	positions.push_back(Vector3(0, 1, 0));
+
+	PackedVector2Array uvs;
+	uvs.push_back(Vector2(uv_x, 0));
+	uvs.push_back(Vector2(uv_x, 0));
+	uvs.push_back(Vector2(uv_x, 0));
+
+	PackedInt32Array indices;
+	indices.push_back(0);
+	indices.push_back(1);
+	indices.push_back(2);
+
+	Array surface;
+	surface.resize(Mesh::ARRAY_MAX);
+	surface[Mesh::ARRAY_VERTEX] = positions;
+	surface[Mesh::ARRAY_TEX_UV] = uvs;
+	surface[Mesh::ARRAY_INDEX] = indices;
+	return surface;
+}
+
+} // namespace
+
+void test_merge_surfaces() {
+	FixedArray<Array, 2> surfaces;
+	surfaces[0] = make_triangle_surface(0.f);
+	surfaces[1] = make_triangle_surface(1.f);
+
+	FixedArray<Vector3, 2> offsets;
+	offsets[0] = Vector3(0, 0, 0);
+	offsets[1] = Vector3(16, 0, 0);
+
+	const Array merged = zylann::godot::merge_surfaces(to_span_const(surfaces), to_span_const(offsets));
+	ZN_TEST_ASSERT(merged.size() == Mesh::ARRAY_MAX);
+
+	const PackedVector3Array positions = merged[Mesh::ARRAY_VERTEX];
+	ZN_TEST_ASSERT(positions.size() == 6);
+	ZN_TEST_ASSERT(positions[1] == Vector3(1, 0, 0));
+	ZN_TEST_ASSERT(positions[4] == Vector3(17, 0, 0));
+
+	const PackedVector2Array uvs = merged[Mesh::ARRAY_TEX_UV];
+	ZN_TEST_ASSERT(uvs.size() == 6);
+	ZN_TEST_ASSERT(uvs[2] == Vector2(0, 0));
+	ZN_TEST_ASSERT(uvs[3] == Vector2(1, 0));
+
+	const PackedInt32Array indices = merged[Mesh::ARRAY_INDEX];
+	ZN_TEST_ASSERT(indices.size() == 6);
+	ZN_TEST_ASSERT(indices[2] == 2);
+	ZN_TEST_ASSERT(indices[3] == 3);
+	ZN_TEST_ASSERT(indices[5] == 5);
+
+	// Surfaces with different formats can't be merged
+	surfaces[1][Mesh::ARRAY_TEX_UV] = Variant();
+	const Array invalid = zylann::godot::merge_surfaces(to_span_const(surfaces), to_span_const(offsets));
+	ZN_TEST_ASSERT(invalid.is_empty());
+}
+
+} // namespace zylann::tests
@@ -0,0 +1,10 @@
+#ifndef ZN_TEST_GODOT_MESH_H
+#define ZN_TEST_GODOT_MESH_H
+
+namespace zylann::tests {
+
+void test_merge_surfaces();
+
+} // namespace zylann::tests
+
+#endif // ZN_TEST_GODOT_MESH_H
@@ -0,0 +1,62 @@
+#include "test_server_object_pools.h"
+#include "../../util/godot/classes/rendering_server.h"
+#include "../../util/godot/direct_mesh_instance.h"
+#include "../../util/godot/server_object_pools.h"
+#include "../../util/testing/test_macros.h"
+
+namespace zylann::tests {
+
+void test_rendering_instance_pool() {
+	using namespace zylann::godot;
+
+	RenderingInstancePool pool;
+	pool.set_max_size(2);
+	ZN_TEST_ASSERT(pool.get_size() == 0);
+
+	// Acquire and recycle directly
+	const RID a = pool.allocate();
+	ZN_TEST_ASSERT(a.is_valid());
+	ZN_TEST_ASSERT(pool.get_size() == 0);
+	pool.recycle(a);
+	ZN_TEST_ASSERT(pool.get_size() == 1);
+
+	// The recycled instance is reused
+	const RID b = pool.allocate();
+	ZN_TEST_ASSERT(b == a);
+	ZN_TEST_ASSERT(pool.get_size() == 0);
+	pool.recycle(b);
+
+	// Instances created from the pool go back to it when destroyed
+	{
+		DirectMeshInstance mi;
+		mi.create(pool);
+		ZN_TEST_ASSERT(mi.is_valid());
+		ZN_TEST_ASSERT(pool.get_size() == 0);
+		mi.destroy();
+		ZN_TEST_ASSERT(!mi.is_valid());
+		ZN_TEST_ASSERT(pool.get_size() == 1);
+
+		mi.create(pool);
+		ZN_TEST_ASSERT(pool.get_size() == 0);
+		// Destructor also recycles
+	}
+	ZN_TEST_ASSERT(pool.get_size() == 1);
+
+	// Instances recycled beyond the maximum size are freed
+	const RID c = pool.allocate();
+	const RID d = pool.allocate();
+	const RID e = pool.allocate();
+	ZN_TEST_ASSERT(pool.get_size() == 0);
+	pool.recycle(c);
+	pool.recycle(d);
+	pool.recycle(e);
+	ZN_TEST_ASSERT(pool.get_size() == 2);
+
+	pool.set_max_size(1);
+	ZN_TEST_ASSERT(pool.get_size() == 1);
+
+	pool.clear();
+	ZN_TEST_ASSERT(pool.get_size() == 0);
+}
+
+} // namespace zylann::tests
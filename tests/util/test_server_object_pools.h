@@ -0,0 +1,10 @@
+#ifndef ZN_TEST_SERVER_OBJECT_POOLS_H
+#define ZN_TEST_SERVER_OBJECT_POOLS_H
+
+namespace zylann::tests {
+
+void test_rendering_instance_pool();
+
+} // namespace zylann::tests
+
+#endif // ZN_TEST_SERVER_OBJECT_POOLS_H
@@ -0,0 +1,56 @@
+#include "test_temp_arena.h"
+#include "../../util/memory/temp_arena.h"
+#include "../../util/testing/test_macros.h"
+
+namespace zylann::tests {
+
+void test_temp_arena() {
+	TempArena arena;
+	ZN_TEST_ASSERT(arena.get_used_size() == 0);
+
+	Span<uint8_t> a = arena.allocate_span<uint8_t>(3);
+	ZN_TEST_ASSERT(a.size() == 3);
+	a.fill(1);
+
+	const TempArena::Marker marker = arena.get_marker();
+	{
+		Span<uint64_t> b = arena.allocate_span<uint64_t>(10);
+		ZN_TEST_ASSERT(b.size() == 10);
+		ZN_TEST_ASSERT((reinterpret_cast<uintptr_t>(b.data()) % alignof(uint64_t)) == 0);
+		b.fill(2);
+
+		// Bigger than a page, must not invalidate previous allocations
+		Span<uint32_t> c = arena.allocate_span<uint32_t>(100'000);
+		ZN_TEST_ASSERT(c.size() == 100'000);
+		c.fill(3);
+
+		for (const uint8_t v : a) {
+			ZN_TEST_ASSERT(v == 1);
+		}
+		for (const uint64_t v : b) {
+			ZN_TEST_ASSERT(v == 2);
+		}
+	}
+	const size_t high_water_mark = arena.get_high_water_mark();
+	ZN_TEST_ASSERT(high_water_mark >= 3 + 10 * sizeof(uint64_t) + 100'000 * sizeof(uint32_t));
+
+	arena.rewind(marker);
+	ZN_TEST_ASSERT(arena.get_used_size() < high_water_mark);
+	ZN_TEST_ASSERT(arena.get_high_water_mark() == high_water_mark);
+
+	// Memory is reused after rewinding
+	const size_t capacity = arena.get_capacity();
+	{
+		TempArenaScope scope(arena);
+		Span<uint32_t> d = arena.allocate_span<uint32_t>(100'000);
+		ZN_TEST_ASSERT(d.size() == 100'000);
+		ZN_TEST_ASSERT(arena.get_capacity() == capacity);
+	}
+	ZN_TEST_ASSERT(arena.get_marker().page_index == marker.page_index);
+	ZN_TEST_ASSERT(arena.get_marker().offset == marker.offset);
+
+	arena.clear();
+	ZN_TEST_ASSERT(arena.get_used_size() == 0);
+}
+
+} // namespace zylann::tests
@@ -0,0 +1,10 @@
+#ifndef ZN_TEST_TEMP_ARENA_H
+#define ZN_TEST_TEMP_ARENA_H
+
+namespace zylann::tests {
+
+void test_temp_arena();
+
+} // namespace zylann::tests
+
+#endif // ZN_TEST_TEMP_ARENA_H
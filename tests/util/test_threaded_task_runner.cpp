@@ -10,6 +10,7 @@
 #include "../../util/profiling.h"
 #include "../../util/string/format.h"
 #include "../../util/string/std_stringstream.h"
+#include "../../util/tasks/parallel_for.h"
 #include "../../util/tasks/threaded_task_runner.h"
 #include "../../util/testing/test_macros.h"
 
@@ -461,4 +462,47 @@ void test_threaded_task_postponing() {
 #endif
 }
 
+void test_parallel_for() {
+	const unsigned int test_thread_count = 4;
+
+	ThreadedTaskRunner runner;
+	runner.set_thread_count(test_thread_count);
+	runner.set_name("Test");
+
+	// Let threads start and wait for tasks, so they can help
+	Thread::sleep_usec(50'000);
+
+	const unsigned int item_count = 64;
+	FixedArray<std::atomic_uint32_t, item_count> call_counts;
+	for (std::atomic_uint32_t &count : call_counts) {
+		count = 0;
+	}
+
+	parallel_for(runner, item_count, [&call_counts](const uint32_t i) {
+		Thread::sleep_usec(1'000);
+		++call_counts[i];
+	});
+
+	// Every item must have been processed exactly once by the time the call returns
+	for (const std::atomic_uint32_t &count : call_counts) {
+		ZN_TEST_ASSERT(count == 1);
+	}
+
+	// Helper tasks don't need to be applied, but still have to be freed
+	runner.wait_for_all_tasks();
+	runner.dequeue_completed_tasks([](IThreadedTask *task) {
+		ZN_ASSERT(task != nullptr);
+		task->apply_result();
+		ZN_DELETE(task);
+	});
+
+	// Runs on the calling thread only if there are no items to share
+	unsigned int single_call_count = 0;
+	parallel_for(runner, 1, [&single_call_count](const uint32_t i) {
+		ZN_TEST_ASSERT(i == 0);
+		++single_call_count;
+	});
+	ZN_TEST_ASSERT(single_call_count == 1);
+}
+
 } // namespace zylann::tests
@@ -0,0 +1,83 @@
+#include "test_priority_dependency.h"
+#include "../../engine/priority_dependency.h"
+#include "../../util/memory/memory.h"
+#include "../../util/testing/test_macros.h"
+
+namespace zylann::voxel::tests {
+
+namespace {
+
+std::shared_ptr<PriorityDependency::ViewersData> create_single_viewer_data(
+		const Vector3f position,
+		const Vector3f predicted_position,
+		const Vector3f view_direction
+) {
+	std::shared_ptr<PriorityDependency::ViewersData> data = make_shared_instance<PriorityDependency::ViewersData>();
+	data->viewers.resize(1);
+	data->viewers[0].position = position;
+	data->viewers[0].predicted_position = predicted_position;
+	data->viewers[0].view_direction = view_direction;
+	data->viewers_count = 1;
+	return data;
+}
+
+TaskPriority evaluate_at(
+		const std::shared_ptr<PriorityDependency::ViewersData> &data,
+		const Vector3f block_position,
+		float &out_distance_sq
+) {
+	PriorityDependency dep;
+	dep.shared = data;
+	dep.world_position = block_position;
+	dep.drop_distance_squared = 999999.f;
+	return dep.evaluate(0, 0, &out_distance_sq);
+}
+
+} // namespace
+
+void test_priority_dependency_motion_prediction() {
+	// Viewer moving towards +X, expected to move 200 units ahead
+	const std::shared_ptr<PriorityDependency::ViewersData> data =
+			create_single_viewer_data(Vector3f(), Vector3f(200, 0, 0), Vector3f());
+
+	float ahead_distance_sq;
+	const TaskPriority ahead_priority = evaluate_at(data, Vector3f(150, 0, 0), ahead_distance_sq);
+	float behind_distance_sq;
+	const TaskPriority behind_priority = evaluate_at(data, Vector3f(-150, 0, 0), behind_distance_sq);
+
+	ZN_TEST_ASSERT(behind_priority < ahead_priority);
+	// Actual distance is still reported, so decisions to drop tasks are not affected
+	ZN_TEST_ASSERT(Math::is_equal_approx(ahead_distance_sq, 150.f * 150.f));
+	ZN_TEST_ASSERT(Math::is_equal_approx(behind_distance_sq, 150.f * 150.f));
+
+	// Without prediction both are the same
+	const std::shared_ptr<PriorityDependency::ViewersData> static_data =
+			create_single_viewer_data(Vector3f(), Vector3f(), Vector3f());
+	float unused_distance_sq;
+	ZN_TEST_ASSERT(
+			evaluate_at(static_data, Vector3f(150, 0, 0), unused_distance_sq) ==
+			evaluate_at(static_data, Vector3f(-150, 0, 0), unused_distance_sq)
+	);
+}
+
+void test_priority_dependency_view_direction() {
+	// Viewer looking towards -Z
+	const std::shared_ptr<PriorityDependency::ViewersData> data =
+			create_single_viewer_data(Vector3f(), Vector3f(), Vector3f(0, 0, -1));
+
+	float unused_distance_sq;
+	const TaskPriority front_priority = evaluate_at(data, Vector3f(0, 0, -200), unused_distance_sq);
+	const TaskPriority side_priority = evaluate_at(data, Vector3f(200, 0, 0), unused_distance_sq);
+	const TaskPriority back_priority = evaluate_at(data, Vector3f(0, 0, 200), unused_distance_sq);
+
+	ZN_TEST_ASSERT(side_priority < front_priority);
+	ZN_TEST_ASSERT(back_priority < side_priority);
+
+	// Blocks close to the viewer are not affected
+	ZN_TEST_ASSERT(
+			evaluate_at(data, Vector3f(0, 0, -8), unused_distance_sq) ==
+			evaluate_at(data, Vector3f(0, 0, 8), unused_distance_sq)
+	);
+}
+
+} // namespace zylann::voxel::tests
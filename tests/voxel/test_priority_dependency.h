@@ -0,0 +1,11 @@
+#ifndef VOXEL_TEST_PRIORITY_DEPENDENCY_H
+#define VOXEL_TEST_PRIORITY_DEPENDENCY_H
+
+namespace zylann::voxel::tests {
+
+void test_priority_dependency_motion_prediction();
+void test_priority_dependency_view_direction();
+
+} // namespace zylann::voxel::tests
+
+#endif // VOXEL_TEST_PRIORITY_DEPENDENCY_H
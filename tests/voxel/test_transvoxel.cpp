@@ -1,7 +1,13 @@
 #include "test_transvoxel.h"
+#include "../../meshers/transvoxel/transvoxel_materials_mixel4.h"
 #include "../../meshers/transvoxel/voxel_mesher_transvoxel.h"
+#include "../../util/containers/std_vector.h"
+#include "../../util/godot/core/packed_arrays.h"
+#include "../../util/math/conv.h"
 #include "../../util/testing/test_macros.h"
 
+#include <algorithm>
+
 namespace zylann::voxel::tests {
 
 void test_transvoxel_issue772() {
@@ -40,4 +46,241 @@ void test_transvoxel_issue772() {
 	ZN_TEST_ASSERT(!VoxelMesher::is_mesh_empty(output.surfaces));
 }
 
+void test_transvoxel_tall_block() {
+	// Cells crossing the isolevel are found with bitmasks of 64 voxels along Y. Check a surface lying across two of
+	// them is fully polygonized.
+
+	VoxelBuffer voxels(VoxelBuffer::ALLOCATOR_DEFAULT);
+	voxels.create(Vector3i(8, 100, 8));
+	{
+		Vector3i pos;
+
+		const float h = 63.5f;
+
+		for (pos.z = 0; pos.z < voxels.get_size().z; ++pos.z) {
+			for (pos.x = 0; pos.x < voxels.get_size().x; ++pos.x) {
+				for (pos.y = 0; pos.y < voxels.get_size().y; ++pos.y) {
+					const float gy = pos.y;
+					voxels.set_voxel_f(gy - h, pos, VoxelBuffer::CHANNEL_SDF);
+				}
+			}
+		}
+	}
+
+	Ref<VoxelMesherTransvoxel> mesher;
+	mesher.instantiate();
+	VoxelMesher::Output output;
+	mesher->build(output, VoxelMesher::Input{ voxels, nullptr, Vector3i(), 0, false, false, false });
+
+	ZN_TEST_ASSERT(output.surfaces.size() == 1);
+	const PackedInt32Array indices = output.surfaces[0].arrays[Mesh::ARRAY_INDEX];
+
+	// Every cell of the horizontal layer crossed by the surface produces a quad
+	const Vector3i block_size = voxels.get_size() - Vector3iUtil::create(transvoxel::MIN_PADDING) -
+			Vector3iUtil::create(transvoxel::MAX_PADDING);
+	ZN_TEST_ASSERT(indices.size() == block_size.x * block_size.z * 2 * 3);
+}
+
+void test_transvoxel_parallel_slabs() {
+	// Large blocks can be polygonized in slabs by multiple threads. Vertices on seams are welded, so the result must
+	// have the same triangles and vertex count as when polygonized at once.
+
+	VoxelBuffer voxels(VoxelBuffer::ALLOCATOR_DEFAULT);
+	voxels.create(Vector3iUtil::create(32 + transvoxel::MIN_PADDING + transvoxel::MAX_PADDING));
+	{
+		Vector3i pos;
+		for (pos.z = 0; pos.z < voxels.get_size().z; ++pos.z) {
+			for (pos.x = 0; pos.x < voxels.get_size().x; ++pos.x) {
+				for (pos.y = 0; pos.y < voxels.get_size().y; ++pos.y) {
+					// Wavy surface crossing all slabs. The offset avoids values being exactly zero.
+					const float h = 16.3f + 12.f * Math::sin(pos.x * 0.3f) * Math::cos(pos.z * 0.2f);
+					voxels.set_voxel_f(pos.y - h, pos, VoxelBuffer::CHANNEL_SDF);
+				}
+			}
+		}
+	}
+
+	struct L {
+		static StdVector<Vector3f> get_sorted_triangle_positions(const Array &arrays) {
+			const PackedVector3Array vertices = arrays[Mesh::ARRAY_VERTEX];
+			const PackedInt32Array indices = arrays[Mesh::ARRAY_INDEX];
+			StdVector<Vector3f> triangle_positions;
+			for (int i = 0; i < indices.size(); ++i) {
+				triangle_positions.push_back(to_vec3f(vertices[indices[i]]));
+			}
+			std::sort(triangle_positions.begin(), triangle_positions.end());
+			return triangle_positions;
+		}
+	};
+
+	Ref<VoxelMesherTransvoxel> mesher;
+	mesher.instantiate();
+
+	VoxelMesher::Output expected_output;
+	mesher->build(expected_output, VoxelMesher::Input{ voxels, nullptr, Vector3i(), 0, false, false, false });
+	ZN_TEST_ASSERT(expected_output.surfaces.size() == 1);
+
+	const Array &expected_arrays = expected_output.surfaces[0].arrays;
+	const PackedVector3Array expected_vertices = expected_arrays[Mesh::ARRAY_VERTEX];
+	const StdVector<Vector3f> expected_triangle_positions = L::get_sorted_triangle_positions(expected_arrays);
+
+	mesher->set_parallel_meshing_enabled(true);
+
+	// The slab count is forced, otherwise it would depend on how many threads happen to be idle. 3 slabs don't divide
+	// the block evenly.
+	const unsigned int slab_counts[] = { 2, 3, 4 };
+	for (const unsigned int slab_count : slab_counts) {
+		mesher->set_parallel_slab_count_override(slab_count);
+
+		VoxelMesher::Output output;
+		mesher->build(output, VoxelMesher::Input{ voxels, nullptr, Vector3i(), 0, false, false, false });
+		ZN_TEST_ASSERT(output.surfaces.size() == 1);
+
+		const Array &arrays = output.surfaces[0].arrays;
+		const PackedVector3Array vertices = arrays[Mesh::ARRAY_VERTEX];
+		ZN_TEST_ASSERT(vertices.size() == expected_vertices.size());
+
+		ZN_TEST_ASSERT(L::get_sorted_triangle_positions(arrays) == expected_triangle_positions);
+	}
+}
+
+void test_transvoxel_mixel4_presort() {
+	using namespace transvoxel::materials::mixel4;
+
+	// Texture indices used by the 8 voxels of a cell, in a different order each time
+	FixedArray<uint16_t, 8> src_indices;
+	src_indices[0] = zylann::voxel::mixel4::encode_indices_to_packed_u16(3, 9, 1, 5);
+	src_indices[1] = zylann::voxel::mixel4::encode_indices_to_packed_u16(9, 3, 5, 1);
+	src_indices[2] = zylann::voxel::mixel4::encode_indices_to_packed_u16(1, 3, 5, 9);
+	src_indices[3] = zylann::voxel::mixel4::encode_indices_to_packed_u16(5, 1, 9, 3);
+	src_indices[4] = zylann::voxel::mixel4::encode_indices_to_packed_u16(3, 9, 1, 5);
+	src_indices[5] = zylann::voxel::mixel4::encode_indices_to_packed_u16(3, 9, 1, 5);
+	src_indices[6] = zylann::voxel::mixel4::encode_indices_to_packed_u16(9, 5, 3, 1);
+	src_indices[7] = zylann::voxel::mixel4::encode_indices_to_packed_u16(1, 5, 3, 9);
+
+	FixedArray<uint16_t, 8> src_weights;
+	for (unsigned int i = 0; i < src_weights.size(); ++i) {
+		// All weights non-zero so the texture selection can't pick other indices
+		src_weights[i] = zylann::voxel::mixel4::encode_weights_to_packed_u16_lossy(
+				16 * (1 + i), 16 * (2 + i), 16 * (8 - i), 16 * (3 + (i % 4))
+		);
+	}
+
+	FixedArray<uint16_t, 8> sorted_indices;
+	FixedArray<uint16_t, 8> sorted_weights;
+	presort_texture_data(to_span(src_indices), to_span(src_weights), to_span(sorted_indices), to_span(sorted_weights));
+
+	for (unsigned int i = 0; i < sorted_indices.size(); ++i) {
+		ZN_TEST_ASSERT(sorted_indices[i] == zylann::voxel::mixel4::encode_indices_to_packed_u16(1, 3, 5, 9));
+	}
+	// Voxel 1 had indices 9, 3, 5, 1
+	{
+		const FixedArray<uint8_t, 4> src_w = zylann::voxel::mixel4::decode_weights_from_packed_u16(src_weights[1]);
+		const FixedArray<uint8_t, 4> dst_w = zylann::voxel::mixel4::decode_weights_from_packed_u16(sorted_weights[1]);
+		ZN_TEST_ASSERT(dst_w[0] == src_w[3]);
+		ZN_TEST_ASSERT(dst_w[1] == src_w[1]);
+		ZN_TEST_ASSERT(dst_w[2] == src_w[2]);
+		ZN_TEST_ASSERT(dst_w[3] == src_w[0]);
+	}
+
+	// The fast path must give the same result as texture selection
+	FixedArray<unsigned int, 8> voxel_indices;
+	for (unsigned int i = 0; i < voxel_indices.size(); ++i) {
+		voxel_indices[i] = i;
+	}
+	WeightSamplerPackedU16 weights_sampler;
+	weights_sampler.u16_data = to_span(src_weights);
+
+	TextureIndicesData slow_data;
+	slow_data.buffer = to_span(src_indices);
+	CellTextureDatas<8> slow_result;
+	get_cell_texture_data(slow_result, slow_data, voxel_indices, weights_sampler, 0);
+
+	TextureIndicesData fast_data = slow_data;
+	fast_data.sorted_buffer = to_span(sorted_indices);
+	fast_data.sorted_weights = to_span(sorted_weights);
+	CellTextureDatas<8> fast_result;
+	ZN_TEST_ASSERT(try_get_presorted_cell_texture_data(fast_result, fast_data, voxel_indices, 0));
+
+	ZN_TEST_ASSERT(fast_result.packed_indices == slow_result.packed_indices);
+	ZN_TEST_ASSERT(fast_result.indices == slow_result.indices);
+	ZN_TEST_ASSERT(fast_result.weights == slow_result.weights);
+
+	// Duplicate indices are left to the generic path
+	{
+		FixedArray<uint16_t, 1> dup_indices;
+		dup_indices[0] = zylann::voxel::mixel4::encode_indices_to_packed_u16(2, 2, 0, 1);
+		FixedArray<uint16_t, 1> dup_weights;
+		dup_weights[0] = 0xffff;
+		FixedArray<uint16_t, 1> dup_sorted_indices;
+		FixedArray<uint16_t, 1> dup_sorted_weights;
+		presort_texture_data(
+				to_span(dup_indices), to_span(dup_weights), to_span(dup_sorted_indices), to_span(dup_sorted_weights)
+		);
+		ZN_TEST_ASSERT(dup_sorted_indices[0] == 0);
+	}
+}
+
+void test_transvoxel_collision_only() {
+	// When the mesh is only used for collision, render attributes and transition meshes are skipped, but the regular
+	// mesh must stay the same.
+
+	VoxelBuffer voxels(VoxelBuffer::ALLOCATOR_DEFAULT);
+	voxels.create(Vector3iUtil::create(16 + transvoxel::MIN_PADDING + transvoxel::MAX_PADDING));
+	{
+		Vector3i pos;
+		for (pos.z = 0; pos.z < voxels.get_size().z; ++pos.z) {
+			for (pos.x = 0; pos.x < voxels.get_size().x; ++pos.x) {
+				for (pos.y = 0; pos.y < voxels.get_size().y; ++pos.y) {
+					const float h = 8.3f + 4.f * Math::sin(pos.x * 0.3f) * Math::cos(pos.z * 0.2f);
+					voxels.set_voxel_f(pos.y - h, pos, VoxelBuffer::CHANNEL_SDF);
+				}
+			}
+		}
+	}
+
+	Ref<VoxelMesherTransvoxel> mesher;
+	mesher.instantiate();
+
+	// LOD hint enabled so that transition meshes would be combined in the visual mesh
+	VoxelMesher::Input input{ voxels, nullptr, Vector3i(), 1, true, true, false };
+
+	VoxelMesher::Output visual_output;
+	mesher->build(visual_output, input);
+	ZN_TEST_ASSERT(visual_output.surfaces.size() == 1);
+	ZN_TEST_ASSERT(visual_output.mesh_flags != 0);
+
+	input.visual_hint = false;
+	VoxelMesher::Output collision_output;
+	mesher->build(collision_output, input);
+	ZN_TEST_ASSERT(collision_output.surfaces.size() == 1);
+	ZN_TEST_ASSERT(collision_output.mesh_flags == 0);
+
+	const Array &visual_arrays = visual_output.surfaces[0].arrays;
+	const Array &collision_arrays = collision_output.surfaces[0].arrays;
+
+	ZN_TEST_ASSERT(collision_arrays[Mesh::ARRAY_NORMAL].get_type() == Variant::NIL);
+	ZN_TEST_ASSERT(collision_arrays[Mesh::ARRAY_CUSTOM0].get_type() == Variant::NIL);
+	ZN_TEST_ASSERT(collision_arrays[Mesh::ARRAY_CUSTOM1].get_type() == Variant::NIL);
+	ZN_TEST_ASSERT(collision_arrays[Mesh::ARRAY_CUSTOM2].get_type() == Variant::NIL);
+
+	// The regular mesh comes first in the visual mesh, followed by transition meshes
+	const PackedVector3Array visual_vertices = visual_arrays[Mesh::ARRAY_VERTEX];
+	const PackedInt32Array visual_indices = visual_arrays[Mesh::ARRAY_INDEX];
+	const PackedVector3Array collision_vertices = collision_arrays[Mesh::ARRAY_VERTEX];
+	const PackedInt32Array collision_indices = collision_arrays[Mesh::ARRAY_INDEX];
+
+	ZN_TEST_ASSERT(collision_vertices.size() > 0);
+	ZN_TEST_ASSERT(collision_vertices.size() == visual_output.collision_surface.submesh_vertex_end);
+	ZN_TEST_ASSERT(collision_indices.size() == visual_output.collision_surface.submesh_index_end);
+	ZN_TEST_ASSERT(visual_vertices.size() > collision_vertices.size());
+
+	for (int i = 0; i < collision_vertices.size(); ++i) {
+		ZN_TEST_ASSERT(collision_vertices[i] == visual_vertices[i]);
+	}
+	for (int i = 0; i < collision_indices.size(); ++i) {
+		ZN_TEST_ASSERT(collision_indices[i] == visual_indices[i]);
+	}
+}
+
 } // namespace zylann::voxel::tests
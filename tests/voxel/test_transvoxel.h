@@ -4,6 +4,10 @@
 namespace zylann::voxel::tests {
 
 void test_transvoxel_issue772();
+void test_transvoxel_tall_block();
+void test_transvoxel_parallel_slabs();
+void test_transvoxel_mixel4_presort();
+void test_transvoxel_collision_only();
 
 } // namespace zylann::voxel::tests
 
@@ -13,6 +13,7 @@
 #include "../../util/godot/core/random_pcg.h"
 #include "../../util/math/conv.h"
 #include "../../util/math/sdf.h"
+#include "../../util/memory/memory.h"
 #include "../../util/noise/fast_noise_lite/fast_noise_lite.h"
 #include "../../util/string/format.h"
 #include "../../util/string/std_string.h"
@@ -2583,4 +2584,363 @@ void test_voxel_graph_broad_block() {
 	ZN_TEST_ASSERT(sd > 0.f);
 }
 
+void test_voxel_graph_steady_state_allocations() {
+	// Once warmed up, generating blocks repeatedly on the same thread should re-use pooled states and caches without
+	// allocating memory. Only allocations made through the module's allocation macros and `StdDefaultAllocator` can be
+	// counted. Godot containers allocate on their own, so the graph runtime doesn't use them on this path.
+
+	Ref<VoxelGeneratorGraph> generator;
+	generator.instantiate();
+	load_graph_with_sphere_on_plane(**generator->get_main_function(), 6.f);
+	const CompilationResult result = generator->compile(false);
+	ZN_TEST_ASSERT(result.success);
+
+	VoxelBuffer voxels(VoxelBuffer::ALLOCATOR_DEFAULT);
+	voxels.create(Vector3i(16, 16, 16));
+
+	struct L {
+		static void generate(VoxelGeneratorGraph &g, VoxelBuffer &voxels) {
+			// Mix queries of different sizes, so states prepared for each of them have to coexist
+			g.generate_broad_block(VoxelGenerator::VoxelQueryData{ voxels, Vector3i(-8, -8, -8), 0 });
+			g.generate_block(VoxelGenerator::VoxelQueryData{ voxels, Vector3i(-8, -8, -8), 0 });
+			g.generate_single(Vector3i(1, 2, 3), VoxelBuffer::CHANNEL_SDF);
+			g.generate_block(VoxelGenerator::VoxelQueryData{ voxels, Vector3i(8, -8, -8), 1 });
+		}
+	};
+
+	// Warm up
+	L::generate(**generator, voxels);
+
+	const uint32_t state_allocations_before = VoxelGeneratorGraph::get_state_allocation_count_from_current_thread();
+#if DEBUG_ENABLED
+	const uint64_t allocations_before = MemoryCounters::tls_allocation_count;
+#endif
+
+	for (unsigned int i = 0; i < 10; ++i) {
+		L::generate(**generator, voxels);
+	}
+
+	const uint32_t state_allocations_after = VoxelGeneratorGraph::get_state_allocation_count_from_current_thread();
+	ZN_TEST_ASSERT(state_allocations_after == state_allocations_before);
+#if DEBUG_ENABLED
+	const uint64_t allocations_after = MemoryCounters::tls_allocation_count;
+	ZN_TEST_ASSERT(allocations_after == allocations_before);
+#endif
+}
+
+void test_voxel_graph_xz_column_cache() {
+	// Blocks generated with the XZ column cache must be identical to blocks generated without it, including when the
+	// cache is hit by blocks at different heights of the same column.
+
+	struct L {
+		static Ref<VoxelGeneratorGraph> create_generator(bool use_column_cache) {
+			Ref<VoxelGeneratorGraph> generator;
+			generator.instantiate();
+			load_graph_with_expression_and_noises(**generator->get_main_function(), nullptr);
+			generator->set_use_xz_column_cache(use_column_cache);
+			const CompilationResult result = generator->compile(false);
+			ZN_TEST_ASSERT(result.success);
+			return generator;
+		}
+
+		static void generate(VoxelGeneratorGraph &g, VoxelBuffer &voxels, Vector3i origin, uint8_t lod) {
+			g.generate_block(VoxelGenerator::VoxelQueryData{ voxels, origin, lod });
+		}
+	};
+
+	Ref<VoxelGeneratorGraph> generator_ref = L::create_generator(false);
+	Ref<VoxelGeneratorGraph> generator_cached = L::create_generator(true);
+
+	const Vector3i block_size(16, 16, 16);
+	const Vector3i origins[] = {
+		Vector3i(0, -16, 0), //
+		Vector3i(0, 0, 0), //
+		Vector3i(0, -16, 0), //
+		Vector3i(16, 0, -16), //
+		Vector3i(16, -16, -16) //
+	};
+
+	for (unsigned int lod = 0; lod < 2; ++lod) {
+		for (const Vector3i origin : origins) {
+			VoxelBuffer expected(VoxelBuffer::ALLOCATOR_DEFAULT);
+			expected.create(block_size);
+			L::generate(**generator_ref, expected, origin << lod, lod);
+
+			VoxelBuffer actual(VoxelBuffer::ALLOCATOR_DEFAULT);
+			actual.create(block_size);
+			L::generate(**generator_cached, actual, origin << lod, lod);
+
+			ZN_TEST_ASSERT(actual.equals(expected));
+		}
+	}
+}
+
+void test_voxel_graph_series_batch() {
+	// Querying several outputs in a single pass must give the same values as querying them one by one, and fill
+	// outputs the graph doesn't have with defaults.
+	static const float RAMP_HALF_SIZE = 4.f;
+	static const float Z_WEIGHT_SCALE = 0.01f;
+
+	// X --- Clamp --- + --- OutSDF
+	//                /
+	//               Y --- Clamp --- OutWeight(1)
+	//
+	// Z --- Multiply --- OutWeight(3)
+
+	Ref<VoxelGeneratorGraph> generator;
+	generator.instantiate();
+	{
+		VoxelGraphFunction &g = **generator->get_main_function();
+		load_graph_with_clamp(g, RAMP_HALF_SIZE);
+
+		const uint32_t n_y = g.create_node(VoxelGraphFunction::NODE_INPUT_Y);
+		const uint32_t n_z = g.create_node(VoxelGraphFunction::NODE_INPUT_Z);
+		const uint32_t n_clamp = g.create_node(VoxelGraphFunction::NODE_CLAMP);
+		const uint32_t n_mul = g.create_node(VoxelGraphFunction::NODE_MULTIPLY);
+		const uint32_t n_ow1 = g.create_node(VoxelGraphFunction::NODE_OUTPUT_WEIGHT);
+		const uint32_t n_ow3 = g.create_node(VoxelGraphFunction::NODE_OUTPUT_WEIGHT);
+
+		g.set_node_default_input(n_clamp, 1, 0.f);
+		g.set_node_default_input(n_clamp, 2, 1.f);
+		g.set_node_default_input(n_mul, 1, Z_WEIGHT_SCALE);
+		g.set_node_param(n_ow1, 0, 1);
+		g.set_node_param(n_ow3, 0, 3);
+
+		g.add_connection(n_y, 0, n_clamp, 0);
+		g.add_connection(n_clamp, 0, n_ow1, 0);
+		g.add_connection(n_z, 0, n_mul, 0);
+		g.add_connection(n_mul, 0, n_ow3, 0);
+	}
+	const CompilationResult result = generator->compile(false);
+	ZN_TEST_ASSERT(result.success);
+
+	StdVector<Vector3f> positions;
+	for (int i = 0; i < 20; ++i) {
+		positions.push_back(Vector3f(i - 10, 0.1f * i - 0.5f, 2 * i));
+	}
+	const Vector3f min_pos(-10, -0.5f, 0);
+	const Vector3f max_pos(10, 1.5f, 40);
+
+	// SDF, type, weight of layer 1, weight of layer 3, and weight of layer 2 which the graph doesn't have
+	static constexpr unsigned int OUTPUT_COUNT = 5;
+
+	FixedArray<StdVector<float>, OUTPUT_COUNT> batch_values;
+	FixedArray<StdVector<float>, OUTPUT_COUNT> single_values;
+	FixedArray<VoxelGenerator::SeriesOutput, OUTPUT_COUNT> outputs;
+
+	outputs[0].type = VoxelGenerator::SeriesOutput::TYPE_SDF;
+	outputs[1].type = VoxelGenerator::SeriesOutput::TYPE_TYPE;
+	outputs[2].type = VoxelGenerator::SeriesOutput::TYPE_WEIGHT;
+	outputs[2].layer_index = 1;
+	outputs[3].type = VoxelGenerator::SeriesOutput::TYPE_WEIGHT;
+	outputs[3].layer_index = 3;
+	outputs[4].type = VoxelGenerator::SeriesOutput::TYPE_WEIGHT;
+	outputs[4].layer_index = 2;
+
+	for (unsigned int i = 0; i < OUTPUT_COUNT; ++i) {
+		batch_values[i].resize(positions.size(), 999.f);
+		single_values[i].resize(positions.size(), 999.f);
+		outputs[i].values = to_span(batch_values[i]);
+	}
+
+	// All outputs in one pass
+	generator->generate_series_batch(to_span(positions), to_span_const(outputs), min_pos, max_pos);
+
+	// One output at a time
+	for (unsigned int i = 0; i < OUTPUT_COUNT; ++i) {
+		VoxelGenerator::SeriesOutput output = outputs[i];
+		output.values = to_span(single_values[i]);
+		generator->generate_series_batch(
+				to_span(positions), Span<const VoxelGenerator::SeriesOutput>(&output, 1), min_pos, max_pos
+		);
+	}
+
+	for (unsigned int output_index = 0; output_index < OUTPUT_COUNT; ++output_index) {
+		for (unsigned int i = 0; i < positions.size(); ++i) {
+			ZN_TEST_ASSERT(batch_values[output_index][i] == single_values[output_index][i]);
+		}
+	}
+
+	for (unsigned int i = 0; i < positions.size(); ++i) {
+		const Vector3f pos = positions[i];
+		const float expected_sd = math::clamp(pos.x, -RAMP_HALF_SIZE, RAMP_HALF_SIZE) + pos.y;
+		ZN_TEST_ASSERT(Math::is_equal_approx(batch_values[0][i], expected_sd));
+		ZN_TEST_ASSERT(batch_values[1][i] == 0.f);
+		ZN_TEST_ASSERT(Math::is_equal_approx(batch_values[2][i], math::clamp(pos.y, 0.f, 1.f)));
+		ZN_TEST_ASSERT(Math::is_equal_approx(batch_values[3][i], pos.z * Z_WEIGHT_SCALE));
+		ZN_TEST_ASSERT(batch_values[4][i] == 0.f);
+	}
+}
+
+void test_voxel_graph_shared_runtime() {
+	// Generators loading identical graphs should share the same compiled runtime instead of compiling it again.
+
+	struct L {
+		static Ref<VoxelGeneratorGraph> create_generator(float ramp_half_size) {
+			Ref<VoxelGeneratorGraph> generator;
+			generator.instantiate();
+			load_graph_with_clamp(**generator->get_main_function(), ramp_half_size);
+			const CompilationResult result = generator->compile(false);
+			ZN_TEST_ASSERT(result.success);
+			return generator;
+		}
+
+		static uint64_t get_program_id(VoxelGeneratorGraph &generator) {
+			generator.generate_single(Vector3i(1, 2, 3), VoxelBuffer::CHANNEL_SDF);
+			return VoxelGeneratorGraph::get_last_state_from_current_thread().get_prepared_program_id();
+		}
+	};
+
+	Ref<VoxelGeneratorGraph> generator1 = L::create_generator(4.f);
+	Ref<VoxelGeneratorGraph> generator2 = L::create_generator(4.f);
+	Ref<VoxelGeneratorGraph> generator3 = L::create_generator(8.f);
+
+	const uint64_t id1 = L::get_program_id(**generator1);
+	const uint64_t id2 = L::get_program_id(**generator2);
+	const uint64_t id3 = L::get_program_id(**generator3);
+
+	ZN_TEST_ASSERT(id1 == id2);
+	ZN_TEST_ASSERT(id1 != id3);
+
+	// Recompiling, which usually happens after edits, doesn't re-use the shared runtime
+	const CompilationResult result = generator2->compile(false);
+	ZN_TEST_ASSERT(result.success);
+	const uint64_t id2b = L::get_program_id(**generator2);
+	ZN_TEST_ASSERT(id2b != id1);
+
+	// Results must be the same as a non-shared runtime
+	for (int x = -10; x < 10; ++x) {
+		const Vector3i pos(x, 1, 0);
+		const float sd1 = generator1->generate_single(pos, VoxelBuffer::CHANNEL_SDF).f;
+		const float sd2 = generator2->generate_single(pos, VoxelBuffer::CHANNEL_SDF).f;
+		ZN_TEST_ASSERT(sd1 == sd2);
+	}
+}
+
+void test_voxel_graph_shared_runtime_resources() {
+	// Graphs that are equal but use different resource instances must not share their runtime, because compiled
+	// operations use those resources directly. Editing a resource of one generator must not affect the other.
+
+	struct L {
+		static Ref<VoxelGeneratorGraph> create_generator(Ref<FastNoiseLite> noise) {
+			//  X --- Noise2D --- + --- OutSDF
+			//       /           /
+			//      Z           Y
+
+			Ref<VoxelGeneratorGraph> generator;
+			generator.instantiate();
+			VoxelGraphFunction &g = **generator->get_main_function();
+
+			const uint32_t n_x = g.create_node(VoxelGraphFunction::NODE_INPUT_X);
+			const uint32_t n_y = g.create_node(VoxelGraphFunction::NODE_INPUT_Y);
+			const uint32_t n_z = g.create_node(VoxelGraphFunction::NODE_INPUT_Z);
+			const uint32_t n_noise = g.create_node(VoxelGraphFunction::NODE_NOISE_2D);
+			const uint32_t n_add = g.create_node(VoxelGraphFunction::NODE_ADD);
+			const uint32_t n_out = g.create_node(VoxelGraphFunction::NODE_OUTPUT_SDF);
+
+			g.set_node_param(n_noise, 0, noise);
+
+			g.add_connection(n_x, 0, n_noise, 0);
+			g.add_connection(n_z, 0, n_noise, 1);
+			g.add_connection(n_noise, 0, n_add, 0);
+			g.add_connection(n_y, 0, n_add, 1);
+			g.add_connection(n_add, 0, n_out, 0);
+
+			const CompilationResult result = generator->compile(false);
+			ZN_TEST_ASSERT(result.success);
+			return generator;
+		}
+
+		static uint64_t get_program_id(VoxelGeneratorGraph &generator) {
+			generator.generate_single(Vector3i(1, 2, 3), VoxelBuffer::CHANNEL_SDF);
+			return VoxelGeneratorGraph::get_last_state_from_current_thread().get_prepared_program_id();
+		}
+
+		static void get_values(VoxelGeneratorGraph &generator, StdVector<float> &values) {
+			values.clear();
+			for (int i = 0; i < 20; ++i) {
+				const Vector3i pos(7 * i - 50, 0, 13 * i - 100);
+				values.push_back(generator.generate_single(pos, VoxelBuffer::CHANNEL_SDF).f);
+			}
+		}
+	};
+
+	// Same settings, different instances
+	Ref<FastNoiseLite> noise_a;
+	noise_a.instantiate();
+	Ref<FastNoiseLite> noise_b;
+	noise_b.instantiate();
+
+	Ref<VoxelGeneratorGraph> generator_a1 = L::create_generator(noise_a);
+	Ref<VoxelGeneratorGraph> generator_b = L::create_generator(noise_b);
+	Ref<VoxelGeneratorGraph> generator_a2 = L::create_generator(noise_a);
+
+	const uint64_t id_a1 = L::get_program_id(**generator_a1);
+	const uint64_t id_b = L::get_program_id(**generator_b);
+	const uint64_t id_a2 = L::get_program_id(**generator_a2);
+
+	ZN_TEST_ASSERT(id_a1 != id_b);
+	// Using the same resources, so sharing is fine
+	ZN_TEST_ASSERT(id_a1 == id_a2);
+
+	StdVector<float> values_a_before;
+	StdVector<float> values_b_before;
+	L::get_values(**generator_a1, values_a_before);
+	L::get_values(**generator_b, values_b_before);
+	ZN_TEST_ASSERT(values_a_before == values_b_before);
+
+	noise_b->set_frequency(noise_b->get_frequency() * 3.f);
+
+	StdVector<float> values_a_after;
+	StdVector<float> values_b_after;
+	L::get_values(**generator_a1, values_a_after);
+	L::get_values(**generator_b, values_b_after);
+
+	ZN_TEST_ASSERT(values_a_after == values_a_before);
+	ZN_TEST_ASSERT(values_b_after != values_b_before);
+}
+
+void test_voxel_graph_node_profiling() {
+	// Node profiling gathers times from regular generation queries, and must only report nodes of the user's graph.
+
+	Ref<VoxelGeneratorGraph> generator;
+	generator.instantiate();
+	VoxelGraphFunction &function = **generator->get_main_function();
+	load_graph_with_expression_and_noises(function, nullptr);
+	// Run every node so they all get a chance to be measured
+	generator->set_use_optimized_execution_map(false);
+	generator->set_node_profiling_enabled(true);
+	const CompilationResult result = generator->compile(false);
+	ZN_TEST_ASSERT(result.success);
+
+	// Not every query is measured, so generate enough of them
+	for (int i = 0; i < 32; ++i) {
+		VoxelBuffer voxels(VoxelBuffer::ALLOCATOR_DEFAULT);
+		voxels.create(Vector3i(16, 16, 16));
+		generator->generate_block(VoxelGenerator::VoxelQueryData{ voxels, Vector3i(16 * i, -8, 0), 0 });
+	}
+
+	StdVector<VoxelGeneratorGraph::NodeProfilingInfo> infos;
+	generator->get_node_profiling_info(infos);
+	ZN_TEST_ASSERT(infos.size() > 0);
+	for (const VoxelGeneratorGraph::NodeProfilingInfo &info : infos) {
+		ZN_TEST_ASSERT(function.has_node(info.node_id));
+	}
+
+	generator->clear_node_profiling_info();
+	generator->get_node_profiling_info(infos);
+	ZN_TEST_ASSERT(infos.size() == 0);
+
+	// Nothing is gathered when disabled
+	generator->set_node_profiling_enabled(false);
+	for (int i = 0; i < 32; ++i) {
+		generator->generate_single(Vector3i(i, 0, 0), VoxelBuffer::CHANNEL_SDF);
+	}
+	VoxelBuffer voxels(VoxelBuffer::ALLOCATOR_DEFAULT);
+	voxels.create(Vector3i(16, 16, 16));
+	generator->generate_block(VoxelGenerator::VoxelQueryData{ voxels, Vector3i(0, -8, 0), 0 });
+	generator->get_node_profiling_info(infos);
+	ZN_TEST_ASSERT(infos.size() == 0);
+}
+
 } // namespace zylann::voxel::tests
@@ -45,6 +45,12 @@ void test_voxel_graph_constant_reduction();
 void test_voxel_graph_multiple_function_instances();
 void test_voxel_graph_issue783();
 void test_voxel_graph_broad_block();
+void test_voxel_graph_steady_state_allocations();
+void test_voxel_graph_xz_column_cache();
+void test_voxel_graph_series_batch();
+void test_voxel_graph_shared_runtime();
+void test_voxel_graph_shared_runtime_resources();
+void test_voxel_graph_node_profiling();
 
 } // namespace zylann::voxel::tests
 
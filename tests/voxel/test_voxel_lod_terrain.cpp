@@ -0,0 +1,602 @@
+#include "test_voxel_lod_terrain.h"
+#include "../../storage/voxel_data.h"
+#include "../../terrain/variable_lod/mesh_block_batches_vlt.h"
+#include "../../terrain/variable_lod/voxel_lod_terrain_update_clipbox_streaming.h"
+#include "../../terrain/variable_lod/voxel_lod_terrain_update_task.h"
+#include "../../util/godot/classes/array_mesh.h"
+#include "../../util/testing/test_macros.h"
+
+namespace zylann::voxel::tests {
+
+void test_voxel_lod_terrain_transition_masks_moving_viewer() {
+	// Simulates the visibility changes of clipbox streaming with a viewer moving one mesh block at a time, and checks
+	// that updating transition masks only around changes gives the same result as checking whole maps.
+
+	static constexpr unsigned int lod_count = 5;
+	// Half-size of clipboxes, in blocks of the parent LOD
+	static constexpr int radius = 4;
+	static constexpr int step_count = 32;
+
+	struct L {
+		static Box3i get_box(const Vector3i viewer_bpos_lod0, const unsigned int lod_index) {
+			if (lod_index + 1 == lod_count) {
+				return Box3i((viewer_bpos_lod0 >> lod_index) - Vector3iUtil::create(2 * radius),
+							 Vector3iUtil::create(4 * radius));
+			}
+			// Aligned on parent blocks, like subdivision rules require
+			return Box3i(((viewer_bpos_lod0 >> (lod_index + 1)) - Vector3iUtil::create(radius)) << 1,
+						 Vector3iUtil::create(4 * radius));
+		}
+
+		static bool is_visible(const Vector3i bpos, const Vector3i viewer_bpos_lod0, const unsigned int lod_index) {
+			if (!get_box(viewer_bpos_lod0, lod_index).contains(bpos)) {
+				return false;
+			}
+			if (lod_index == 0) {
+				return true;
+			}
+			// Hidden if subdivided
+			const Box3i child_box = get_box(viewer_bpos_lod0, lod_index - 1);
+			return !child_box.contains(bpos << 1);
+		}
+
+		// Applies the same kind of changes clipbox streaming does when its boxes move
+		static void move_viewer(VoxelLodTerrainUpdateData::State &state, const Vector3i viewer_bpos_lod0) {
+			for (unsigned int lod_index = 0; lod_index < lod_count; ++lod_index) {
+				VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
+				// Outputs are consumed by the main thread after each update
+				lod.mesh_blocks_to_activate_visuals.clear();
+				lod.mesh_blocks_to_deactivate_visuals.clear();
+				lod.mesh_blocks_to_unload.clear();
+				lod.mesh_blocks_to_update_transitions.clear();
+
+				const Box3i box = get_box(viewer_bpos_lod0, lod_index);
+
+				for (auto it = lod.mesh_map_state.map.begin(); it != lod.mesh_map_state.map.end();) {
+					if (box.contains(it->first)) {
+						++it;
+					} else {
+						lod.mesh_blocks_to_unload.push_back(it->first);
+						it = lod.mesh_map_state.map.erase(it);
+					}
+				}
+
+				box.for_each_cell([&lod, lod_index, viewer_bpos_lod0](const Vector3i bpos) {
+					VoxelLodTerrainUpdateData::MeshBlockState &block = lod.mesh_map_state.map[bpos];
+					if (block.mesh_viewers.get() == 0) {
+						block.mesh_viewers.add();
+					}
+					const bool visible = is_visible(bpos, viewer_bpos_lod0, lod_index);
+					if (visible && !block.visual_active) {
+						block.visual_active = true;
+						lod.mesh_blocks_to_activate_visuals.push_back(bpos);
+					} else if (!visible && block.visual_active) {
+						block.visual_active = false;
+						lod.mesh_blocks_to_deactivate_visuals.push_back(bpos);
+					}
+				});
+			}
+		}
+
+		static void check_transition_masks(const VoxelLodTerrainUpdateData::State &state) {
+			for (unsigned int lod_index = 0; lod_index < lod_count; ++lod_index) {
+				const VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
+				for (auto it = lod.mesh_map_state.map.begin(); it != lod.mesh_map_state.map.end(); ++it) {
+					if (!it->second.visual_active) {
+						continue;
+					}
+					const uint8_t expected_mask =
+							VoxelLodTerrainUpdateTask::get_transition_mask(state, it->first, lod_index, lod_count);
+					ZN_TEST_ASSERT(it->second.transition_mask == expected_mask);
+				}
+			}
+		}
+	};
+
+	VoxelLodTerrainUpdateData::State state;
+
+	Vector3i viewer_bpos_lod0;
+	L::move_viewer(state, viewer_bpos_lod0);
+	update_transition_masks_around_changes(state, lod_count);
+	L::check_transition_masks(state);
+
+	for (int step = 0; step < step_count; ++step) {
+		// Move diagonally so boxes of all LODs end up moving along every axis
+		viewer_bpos_lod0 += Vector3i(1, step % 2, step % 3 == 0 ? 1 : 0);
+
+		L::move_viewer(state, viewer_bpos_lod0);
+		update_transition_masks_around_changes(state, lod_count);
+		L::check_transition_masks(state);
+	}
+}
+
+void test_voxel_lod_terrain_clipbox_transition_masks() {
+	// Runs clipbox streaming like VoxelLodTerrain does while a viewer moves, with meshes loading one update after they
+	// are requested. After every update, transition masks must match a full recomputation.
+
+	static constexpr unsigned int lod_count = 4;
+	static constexpr int step_count = 24;
+
+	VoxelData data;
+	data.set_lod_count(lod_count);
+	data.set_bounds(Box3i::from_center_extents(Vector3i(), Vector3iUtil::create(4096)));
+	data.set_streaming_enabled(true);
+
+	VoxelLodTerrainUpdateData::Settings settings;
+	settings.streaming_system = VoxelLodTerrainUpdateData::STREAMING_SYSTEM_CLIPBOX;
+	settings.lod_distance = 32.f;
+	settings.secondary_lod_distance = 32.f;
+	settings.view_distance_voxels = 256;
+
+	VoxelLodTerrainUpdateData::State state;
+
+	StdVector<std::pair<ViewerID, VoxelEngine::Viewer>> viewers;
+	{
+		ViewerID viewer_id;
+		viewer_id.index = 1;
+		VoxelEngine::Viewer viewer;
+		viewer.view_distances.horizontal = 256;
+		viewer.view_distances.vertical = 256;
+		viewers.push_back({ viewer_id, viewer });
+	}
+
+	struct L {
+		// Does what the main thread does with the results of an update, and reports meshes that finished building
+		static void consume_outputs_and_load_meshes(VoxelLodTerrainUpdateData::State &state) {
+			for (unsigned int lod_index = 0; lod_index < lod_count; ++lod_index) {
+				VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
+				lod.mesh_blocks_to_unload.clear();
+				lod.mesh_blocks_to_update_transitions.clear();
+				lod.mesh_blocks_to_activate_visuals.clear();
+				lod.mesh_blocks_to_deactivate_visuals.clear();
+				lod.mesh_blocks_to_activate_collision.clear();
+				lod.mesh_blocks_to_deactivate_collision.clear();
+				lod.mesh_blocks_to_drop_visual.clear();
+				lod.mesh_blocks_to_drop_collision.clear();
+				lod.mesh_blocks_pending_update.clear();
+
+				for (auto it = lod.mesh_map_state.map.begin(); it != lod.mesh_map_state.map.end(); ++it) {
+					VoxelLodTerrainUpdateData::MeshBlockState &mesh_block = it->second;
+					mesh_block.update_list_index = -1;
+					if (!mesh_block.visual_loaded) {
+						mesh_block.visual_loaded = true;
+						state.clipbox_streaming.loaded_mesh_blocks.push_back(
+								VoxelLodTerrainUpdateData::LoadedMeshBlockEvent{
+										it->first, uint8_t(lod_index), true, false }
+						);
+					}
+				}
+			}
+		}
+
+		static unsigned int check_transition_masks(const VoxelLodTerrainUpdateData::State &state) {
+			unsigned int checked_count = 0;
+			for (unsigned int lod_index = 0; lod_index < lod_count; ++lod_index) {
+				const VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
+				for (auto it = lod.mesh_map_state.map.begin(); it != lod.mesh_map_state.map.end(); ++it) {
+					if (!it->second.visual_active || it->second.mesh_viewers.get() == 0) {
+						continue;
+					}
+					const uint8_t expected_mask =
+							VoxelLodTerrainUpdateTask::get_transition_mask(state, it->first, lod_index, lod_count);
+					ZN_TEST_ASSERT(it->second.transition_mask == expected_mask);
+					++checked_count;
+				}
+			}
+			return checked_count;
+		}
+	};
+
+	StdVector<VoxelLodTerrainUpdateData::BlockToLoad> data_blocks_to_load;
+	unsigned int checked_count = 0;
+
+	for (int step = 0; step < step_count; ++step) {
+		// Move along every axis, sometimes by less than a block, sometimes by more
+		viewers[0].second.world_position += Vector3(24, step % 2 == 0 ? 0 : 40, step % 3 == 0 ? -16 : 8);
+
+		// Let meshes finish loading before moving again, then let them load in the middle of moving
+		const unsigned int update_count = step % 4 == 0 ? 2 : 1;
+
+		for (unsigned int update_index = 0; update_index < update_count; ++update_index) {
+			L::consume_outputs_and_load_meshes(state);
+			data_blocks_to_load.clear();
+
+			process_clipbox_streaming(
+					state,
+					data,
+					to_span_const(viewers),
+					Transform3D(),
+					nullptr,
+					data_blocks_to_load,
+					settings,
+					true,
+					true
+			);
+
+			checked_count += L::check_transition_masks(state);
+		}
+	}
+
+	// Make sure the test actually checked something
+	ZN_TEST_ASSERT(checked_count > 0);
+	for (unsigned int lod_index = 0; lod_index < lod_count; ++lod_index) {
+		bool any_active = false;
+		const VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
+		for (auto it = lod.mesh_map_state.map.begin(); it != lod.mesh_map_state.map.end(); ++it) {
+			any_active |= it->second.visual_active;
+		}
+		ZN_TEST_ASSERT(any_active);
+	}
+}
+
+void test_voxel_lod_terrain_clipbox_viewer_pairing() {
+	// Viewers should only be paired with the terrain while their view distance reaches its bounds, and blocks they
+	// were loading should be released when they go out of range.
+
+	VoxelData data;
+	data.set_lod_count(4);
+	data.set_bounds(Box3i::from_center_extents(Vector3i(), Vector3iUtil::create(512)));
+	data.set_streaming_enabled(true);
+
+	VoxelLodTerrainUpdateData::Settings settings;
+	settings.streaming_system = VoxelLodTerrainUpdateData::STREAMING_SYSTEM_CLIPBOX;
+	settings.lod_distance = 32.f;
+	settings.secondary_lod_distance = 32.f;
+	settings.view_distance_voxels = 256;
+
+	VoxelLodTerrainUpdateData::State state;
+
+	StdVector<std::pair<ViewerID, VoxelEngine::Viewer>> viewers;
+	{
+		ViewerID viewer_id;
+		viewer_id.index = 1;
+		VoxelEngine::Viewer viewer;
+		viewer.world_position = Vector3(10000, 0, 0);
+		viewer.view_distances.horizontal = 128;
+		viewer.view_distances.vertical = 128;
+		viewers.push_back({ viewer_id, viewer });
+	}
+
+	struct L {
+		static unsigned int get_loading_block_count(const VoxelLodTerrainUpdateData::State &state) {
+			unsigned int count = 0;
+			for (const VoxelLodTerrainUpdateData::Lod &lod : state.lods) {
+				count += lod.loading_blocks.size();
+			}
+			return count;
+		}
+	};
+
+	StdVector<VoxelLodTerrainUpdateData::BlockToLoad> data_blocks_to_load;
+
+	// Far from the volume
+	process_clipbox_streaming(
+			state, data, to_span_const(viewers), Transform3D(), nullptr, data_blocks_to_load, settings, true, true
+	);
+	ZN_TEST_ASSERT(state.clipbox_streaming.paired_viewers.size() == 0);
+	ZN_TEST_ASSERT(data_blocks_to_load.size() == 0);
+	ZN_TEST_ASSERT(L::get_loading_block_count(state) == 0);
+
+	// Inside the volume
+	viewers[0].second.world_position = Vector3(0, 0, 0);
+	process_clipbox_streaming(
+			state, data, to_span_const(viewers), Transform3D(), nullptr, data_blocks_to_load, settings, true, true
+	);
+	ZN_TEST_ASSERT(state.clipbox_streaming.paired_viewers.size() == 1);
+	ZN_TEST_ASSERT(data_blocks_to_load.size() > 0);
+	ZN_TEST_ASSERT(L::get_loading_block_count(state) > 0);
+
+	// Moving out of range unpairs the viewer and releases what it was loading
+	viewers[0].second.world_position = Vector3(-10000, 0, 0);
+	data_blocks_to_load.clear();
+	process_clipbox_streaming(
+			state, data, to_span_const(viewers), Transform3D(), nullptr, data_blocks_to_load, settings, true, true
+	);
+	ZN_TEST_ASSERT(state.clipbox_streaming.paired_viewers.size() == 0);
+	ZN_TEST_ASSERT(data_blocks_to_load.size() == 0);
+	ZN_TEST_ASSERT(L::get_loading_block_count(state) == 0);
+
+	// Coming back pairs it again
+	viewers[0].second.world_position = Vector3(0, 0, 0);
+	process_clipbox_streaming(
+			state, data, to_span_const(viewers), Transform3D(), nullptr, data_blocks_to_load, settings, true, true
+	);
+	ZN_TEST_ASSERT(state.clipbox_streaming.paired_viewers.size() == 1);
+	ZN_TEST_ASSERT(data_blocks_to_load.size() > 0);
+}
+
+void test_voxel_lod_terrain_clipbox_collision_only() {
+	// In collision-only mode, LODs beyond the collision LOD count get no mesh blocks, so the last LOD having collision
+	// must behave as the root when activating blocks.
+
+	static constexpr unsigned int lod_count = 4;
+	static constexpr unsigned int collision_lod_count = 2;
+
+	VoxelData data;
+	data.set_lod_count(lod_count);
+	data.set_bounds(Box3i::from_center_extents(Vector3i(), Vector3iUtil::create(512)));
+	data.set_streaming_enabled(true);
+
+	VoxelLodTerrainUpdateData::Settings settings;
+	settings.streaming_system = VoxelLodTerrainUpdateData::STREAMING_SYSTEM_CLIPBOX;
+	settings.lod_distance = 32.f;
+	settings.secondary_lod_distance = 32.f;
+	settings.view_distance_voxels = 256;
+	settings.collision_lod_count = collision_lod_count;
+	settings.collision_only_mode = true;
+
+	VoxelLodTerrainUpdateData::State state;
+
+	StdVector<std::pair<ViewerID, VoxelEngine::Viewer>> viewers;
+	{
+		ViewerID viewer_id;
+		viewer_id.index = 1;
+		VoxelEngine::Viewer viewer;
+		viewer.view_distances.horizontal = 128;
+		viewer.view_distances.vertical = 128;
+		viewers.push_back({ viewer_id, viewer });
+	}
+
+	StdVector<VoxelLodTerrainUpdateData::BlockToLoad> data_blocks_to_load;
+
+	process_clipbox_streaming(
+			state, data, to_span_const(viewers), Transform3D(), nullptr, data_blocks_to_load, settings, true, true
+	);
+	ZN_TEST_ASSERT(state.clipbox_streaming.paired_viewers.size() == 1);
+
+	const VoxelLodTerrainUpdateData::PairedViewer &paired_viewer = state.clipbox_streaming.paired_viewers[0];
+	for (unsigned int lod_index = 0; lod_index < lod_count; ++lod_index) {
+		const VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
+		// Parent LODs still load the data edits cascade to
+		ZN_TEST_ASSERT(!paired_viewer.state.data_box_per_lod[lod_index].is_empty());
+
+		if (lod_index < collision_lod_count) {
+			ZN_TEST_ASSERT(lod.mesh_map_state.map.size() > 0);
+			for (auto it = lod.mesh_map_state.map.begin(); it != lod.mesh_map_state.map.end(); ++it) {
+				ZN_TEST_ASSERT(it->second.collision_viewers.get() > 0);
+				ZN_TEST_ASSERT(it->second.mesh_viewers.get() == 0);
+			}
+		} else {
+			ZN_TEST_ASSERT(paired_viewer.state.mesh_box_per_lod[lod_index].is_empty());
+			ZN_TEST_ASSERT(lod.mesh_map_state.map.size() == 0);
+		}
+	}
+
+	// Pretend every collision mesh got built, like VoxelLodTerrain does when it receives them
+	for (unsigned int lod_index = 0; lod_index < collision_lod_count; ++lod_index) {
+		VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
+		for (auto it = lod.mesh_map_state.map.begin(); it != lod.mesh_map_state.map.end(); ++it) {
+			it->second.collision_loaded = true;
+			state.clipbox_streaming.loaded_mesh_blocks.push_back(
+					VoxelLodTerrainUpdateData::LoadedMeshBlockEvent{ it->first, uint8_t(lod_index), false, true }
+			);
+		}
+	}
+
+	process_clipbox_streaming(
+			state, data, to_span_const(viewers), Transform3D(), nullptr, data_blocks_to_load, settings, true, true
+	);
+
+	// LOD0 replaces LOD1 where it is loaded, and LOD1 covers the rest
+	for (unsigned int lod_index = 0; lod_index < collision_lod_count; ++lod_index) {
+		const VoxelLodTerrainUpdateData::Lod &lod = state.lods[lod_index];
+		ZN_TEST_ASSERT(lod.mesh_blocks_to_activate_collision.size() > 0);
+		ZN_TEST_ASSERT(lod.mesh_blocks_to_activate_visuals.size() == 0);
+		ZN_TEST_ASSERT(lod.mesh_blocks_to_update_transitions.size() == 0);
+	}
+	const VoxelLodTerrainUpdateData::Lod &lod0 = state.lods[0];
+	const VoxelLodTerrainUpdateData::Lod &lod1 = state.lods[1];
+	for (auto it = lod0.mesh_map_state.map.begin(); it != lod0.mesh_map_state.map.end(); ++it) {
+		ZN_TEST_ASSERT(it->second.collision_active);
+	}
+	for (auto it = lod1.mesh_map_state.map.begin(); it != lod1.mesh_map_state.map.end(); ++it) {
+		const bool subdivided = lod0.mesh_map_state.map.find(it->first << 1) != lod0.mesh_map_state.map.end();
+		ZN_TEST_ASSERT(it->second.collision_active != subdivided);
+	}
+}
+
+void test_mesh_block_batches_vlt() {
+	// Drives batching the way VoxelLodTerrain does: groups are invalidated before their blocks change, then merged
+	// again later if they are still eligible.
+
+	static constexpr unsigned int mesh_block_size = 16;
+	static constexpr uint32_t timeout_usec = 1000000;
+
+	struct L {
+		static StdVector<VoxelMesher::Output::Surface> create_surfaces() {
+			PackedVector3Array vertices;
+			vertices.push_back(Vector3(0, 0, 0));
+			vertices.push_back(Vector3(1, 0, 0));
+			vertices.push_back(Vector3(0, 1, 0));
+			PackedVector3Array normals;
+			normals.push_back(Vector3(0, 0, 1));
+			normals.push_back(Vector3(0, 0, 1));
+			normals.push_back(Vector3(0, 0, 1));
+			PackedInt32Array indices;
+			indices.push_back(0);
+			indices.push_back(1);
+			indices.push_back(2);
+
+			Array arrays;
+			arrays.resize(Mesh::ARRAY_MAX);
+			arrays[Mesh::ARRAY_VERTEX] = vertices;
+			arrays[Mesh::ARRAY_NORMAL] = normals;
+			arrays[Mesh::ARRAY_INDEX] = indices;
+
+			StdVector<VoxelMesher::Output::Surface> surfaces;
+			surfaces.push_back(VoxelMesher::Output::Surface{ arrays, 0 });
+			return surfaces;
+		}
+
+		static void add_block(VoxelMeshMap<VoxelMeshBlockVLT> &mesh_map, const Vector3i bpos) {
+			const StdVector<VoxelMesher::Output::Surface> surfaces = create_surfaces();
+			Ref<ArrayMesh> mesh = build_mesh(to_span_const(surfaces), Mesh::PRIMITIVE_TRIANGLES, 0, Ref<Material>());
+			ZN_TEST_ASSERT(mesh.is_valid());
+
+			VoxelMeshBlockVLT *block = ZN_NEW(VoxelMeshBlockVLT(bpos, mesh_block_size, 0));
+			block->set_mesh(
+					mesh,
+					GeometryInstance3D::GI_MODE_DISABLED,
+					RenderingServer::SHADOW_CASTING_SETTING_ON,
+					1,
+					Ref<Mesh>(),
+					-1,
+					-1
+#ifdef TOOLS_ENABLED
+					,
+					RenderingServer::SHADOW_CASTING_SETTING_SHADOWS_ONLY
+#endif
+			);
+			block->set_visible(true);
+			block->visual_active = true;
+			block->batching_surfaces = surfaces;
+			mesh_map.set_block(bpos, block);
+		}
+
+		static bool is_group_batched(VoxelMeshMap<VoxelMeshBlockVLT> &mesh_map, const Vector3i group_position) {
+			bool batched = true;
+			bool any = false;
+			const Vector3i origin_bpos = group_position * 2;
+			for (int z = 0; z < 2; ++z) {
+				for (int y = 0; y < 2; ++y) {
+					for (int x = 0; x < 2; ++x) {
+						const VoxelMeshBlockVLT *block = mesh_map.get_block(origin_bpos + Vector3i(x, y, z));
+						if (block == nullptr) {
+							continue;
+						}
+						any = true;
+						// Batched blocks don't draw their own mesh
+						batched &= block->is_batched() && !block->is_mesh_instance_visible();
+					}
+				}
+			}
+			return any && batched;
+		}
+
+		static bool is_group_split(VoxelMeshMap<VoxelMeshBlockVLT> &mesh_map, const Vector3i group_position) {
+			const Vector3i origin_bpos = group_position * 2;
+			for (int z = 0; z < 2; ++z) {
+				for (int y = 0; y < 2; ++y) {
+					for (int x = 0; x < 2; ++x) {
+						const VoxelMeshBlockVLT *block = mesh_map.get_block(origin_bpos + Vector3i(x, y, z));
+						if (block != nullptr && (block->is_batched() || !block->is_mesh_instance_visible())) {
+							return false;
+						}
+					}
+				}
+			}
+			return true;
+		}
+	};
+
+	FixedArray<VoxelMeshMap<VoxelMeshBlockVLT>, 1> mesh_maps;
+	VoxelMeshMap<VoxelMeshBlockVLT> &mesh_map = mesh_maps[0];
+	ShaderMaterialPoolVLT shader_material_pool;
+	MeshBlockBatchesVLT batches;
+
+	MeshBlockBatchesVLT::MergeParams params;
+	params.gi_mode = GeometryInstance3D::GI_MODE_DISABLED;
+	params.shadow_casting = RenderingServer::SHADOW_CASTING_SETTING_ON;
+	params.render_layers_mask = 1;
+	params.mesh_block_size = mesh_block_size;
+
+	// A full group, and a group with a single block, which has nothing to gain from merging
+	const Vector3i group_position(0, 0, 0);
+	const Vector3i lone_group_position(1, 0, 0);
+	for (int z = 0; z < 2; ++z) {
+		for (int y = 0; y < 2; ++y) {
+			for (int x = 0; x < 2; ++x) {
+				L::add_block(mesh_map, Vector3i(x, y, z));
+			}
+		}
+	}
+	L::add_block(mesh_map, Vector3i(2, 0, 0));
+
+	batches.invalidate_all(mesh_map, 0);
+	batches.process(to_span(mesh_maps), shader_material_pool, params, 0, timeout_usec);
+	ZN_TEST_ASSERT(batches.get_batch_count() == 1);
+	ZN_TEST_ASSERT(L::is_group_batched(mesh_map, group_position));
+	ZN_TEST_ASSERT(L::is_group_split(mesh_map, lone_group_position));
+
+	// Remeshing
+	{
+		batches.invalidate(mesh_map, shader_material_pool, 0, Vector3i(1, 1, 1));
+		ZN_TEST_ASSERT(batches.get_batch_count() == 0);
+		ZN_TEST_ASSERT(L::is_group_split(mesh_map, group_position));
+
+		batches.process(to_span(mesh_maps), shader_material_pool, params, 0, timeout_usec);
+		ZN_TEST_ASSERT(batches.get_batch_count() == 1);
+		ZN_TEST_ASSERT(L::is_group_batched(mesh_map, group_position));
+	}
+
+	// Transitions
+	{
+		VoxelMeshBlockVLT *block = mesh_map.get_block(Vector3i(0, 1, 0));
+		ZN_TEST_ASSERT(block != nullptr);
+
+		batches.invalidate(mesh_map, shader_material_pool, 0, block->position);
+		block->set_transition_mask(1);
+		batches.process(to_span(mesh_maps), shader_material_pool, params, 0, timeout_usec);
+		ZN_TEST_ASSERT(batches.get_batch_count() == 0);
+		ZN_TEST_ASSERT(L::is_group_split(mesh_map, group_position));
+
+		batches.invalidate(mesh_map, shader_material_pool, 0, block->position);
+		block->set_transition_mask(0);
+		batches.process(to_span(mesh_maps), shader_material_pool, params, 0, timeout_usec);
+		ZN_TEST_ASSERT(batches.get_batch_count() == 1);
+		ZN_TEST_ASSERT(L::is_group_batched(mesh_map, group_position));
+	}
+
+	// Fading
+	{
+		VoxelMeshBlockVLT *block = mesh_map.get_block(Vector3i(1, 0, 1));
+		ZN_TEST_ASSERT(block != nullptr);
+
+		batches.invalidate(mesh_map, shader_material_pool, 0, block->position);
+		block->fading_state = VoxelMeshBlockVLT::FADING_IN;
+		batches.process(to_span(mesh_maps), shader_material_pool, params, 0, timeout_usec);
+		ZN_TEST_ASSERT(batches.get_batch_count() == 0);
+		ZN_TEST_ASSERT(L::is_group_split(mesh_map, group_position));
+
+		batches.invalidate(mesh_map, shader_material_pool, 0, block->position);
+		block->fading_state = VoxelMeshBlockVLT::FADING_NONE;
+		batches.process(to_span(mesh_maps), shader_material_pool, params, 0, timeout_usec);
+		ZN_TEST_ASSERT(batches.get_batch_count() == 1);
+		ZN_TEST_ASSERT(L::is_group_batched(mesh_map, group_position));
+	}
+
+	// Hiding and showing a batched block doesn't make it draw its own mesh
+	{
+		VoxelMeshBlockVLT *block = mesh_map.get_block(Vector3i(0, 0, 1));
+		ZN_TEST_ASSERT(block != nullptr);
+		block->set_visible(false);
+		block->set_visible(true);
+		ZN_TEST_ASSERT(block->is_batched());
+		ZN_TEST_ASSERT(!block->is_mesh_instance_visible());
+
+		block->set_batched(false);
+		ZN_TEST_ASSERT(block->is_mesh_instance_visible());
+		block->set_batched(true);
+		ZN_TEST_ASSERT(!block->is_mesh_instance_visible());
+	}
+
+	// Unloading
+	{
+		const Vector3i bpos(0, 0, 0);
+		batches.invalidate(mesh_map, shader_material_pool, 0, bpos);
+		mesh_map.remove_block(bpos, VoxelMeshMap<VoxelMeshBlockVLT>::NoAction());
+		ZN_TEST_ASSERT(batches.get_batch_count() == 0);
+		ZN_TEST_ASSERT(L::is_group_split(mesh_map, group_position));
+
+		// Remaining blocks can still be merged
+		batches.process(to_span(mesh_maps), shader_material_pool, params, 0, timeout_usec);
+		ZN_TEST_ASSERT(batches.get_batch_count() == 1);
+		ZN_TEST_ASSERT(L::is_group_batched(mesh_map, group_position));
+	}
+
+	batches.clear(to_span(mesh_maps), shader_material_pool);
+	ZN_TEST_ASSERT(batches.get_batch_count() == 0);
+	ZN_TEST_ASSERT(L::is_group_split(mesh_map, group_position));
+}
+
+} // namespace zylann::voxel::tests
@@ -0,0 +1,14 @@
+#ifndef VOXEL_TEST_VOXEL_LOD_TERRAIN_H
+#define VOXEL_TEST_VOXEL_LOD_TERRAIN_H
+
+namespace zylann::voxel::tests {
+
+void test_voxel_lod_terrain_transition_masks_moving_viewer();
+void test_voxel_lod_terrain_clipbox_transition_masks();
+void test_voxel_lod_terrain_clipbox_viewer_pairing();
+void test_voxel_lod_terrain_clipbox_collision_only();
+void test_mesh_block_batches_vlt();
+
+} // namespace zylann::voxel::tests
+
+#endif // VOXEL_TEST_VOXEL_LOD_TERRAIN_H
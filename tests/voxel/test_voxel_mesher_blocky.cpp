@@ -0,0 +1,577 @@
+#include "test_voxel_mesher_blocky.h"
+#include "../../meshers/blocky/voxel_blocky_library.h"
+#include "../../meshers/blocky/voxel_blocky_model_cube.h"
+#include "../../meshers/blocky/voxel_blocky_model_empty.h"
+#include "../../meshers/blocky/voxel_blocky_model_mesh.h"
+#include "../../meshers/blocky/voxel_mesher_blocky.h"
+#include "../../meshers/side_connectivity.h"
+#include "../../storage/voxel_buffer.h"
+#include "../../util/godot/classes/array_mesh.h"
+#include "../../util/godot/classes/rendering_server.h"
+#include "../../util/godot/core/packed_arrays.h"
+#include "../../util/godot/core/version.h"
+#include "../../util/testing/test_macros.h"
+
+namespace zylann::voxel::tests {
+
+void test_voxel_mesher_blocky_greedy() {
+	// A flat layer of identical cubes should be meshed as a single box when greedy meshing is enabled
+
+	Ref<VoxelBlockyLibrary> library;
+	library.instantiate();
+	{
+		Ref<VoxelBlockyModelEmpty> air;
+		air.instantiate();
+		library->add_model(air);
+	}
+	{
+		Ref<VoxelBlockyModelCube> cube;
+		cube.instantiate();
+		library->add_model(cube);
+	}
+	library->bake();
+	const int cube_id = 1;
+
+	VoxelBuffer voxels(VoxelBuffer::ALLOCATOR_DEFAULT);
+	voxels.create(Vector3i(8, 8, 8));
+	// Padding is 1 on each side, so this covers 4x1x4 voxels inside the meshed area
+	voxels.fill_area(cube_id, Vector3i(1, 3, 1), Vector3i(5, 4, 5), VoxelBuffer::CHANNEL_TYPE);
+
+	struct L {
+		static VoxelMesher::Output build(Ref<VoxelBlockyLibrary> library, const VoxelBuffer &voxels, bool greedy) {
+			Ref<VoxelMesherBlocky> mesher;
+			mesher.instantiate();
+			mesher->set_library(library);
+			mesher->set_greedy_meshing_enabled(greedy);
+
+			VoxelMesher::Input input{ voxels, nullptr, Vector3i(), 0, true };
+			VoxelMesher::Output output;
+			mesher->build(output, input);
+			return output;
+		}
+
+		static AABB get_aabb(const PackedVector3Array &positions) {
+			AABB aabb(positions[0], Vector3());
+			for (int i = 1; i < positions.size(); ++i) {
+				aabb.expand_to(positions[i]);
+			}
+			return aabb;
+		}
+	};
+
+	const VoxelMesher::Output culled_output = L::build(library, voxels, false);
+	const VoxelMesher::Output greedy_output = L::build(library, voxels, true);
+
+	ZN_TEST_ASSERT(culled_output.surfaces.size() == 1);
+	ZN_TEST_ASSERT(greedy_output.surfaces.size() == 1);
+
+	const PackedVector3Array culled_positions = culled_output.surfaces[0].arrays[Mesh::ARRAY_VERTEX];
+	const PackedVector3Array greedy_positions = greedy_output.surfaces[0].arrays[Mesh::ARRAY_VERTEX];
+	const PackedVector2Array greedy_uvs = greedy_output.surfaces[0].arrays[Mesh::ARRAY_TEX_UV];
+	const PackedFloat32Array greedy_tile_rects = greedy_output.surfaces[0].arrays[Mesh::ARRAY_CUSTOM0];
+
+	// 16 top faces, 16 bottom faces and 16 faces around
+	ZN_TEST_ASSERT(culled_positions.size() == 48 * 4);
+	// One quad per side
+	ZN_TEST_ASSERT(greedy_positions.size() == 6 * 4);
+	ZN_TEST_ASSERT(greedy_uvs.size() == greedy_positions.size());
+	ZN_TEST_ASSERT(greedy_tile_rects.size() == 4 * greedy_positions.size());
+	const uint32_t custom0_format = RenderingServer::ARRAY_CUSTOM_RGBA_FLOAT << Mesh::ARRAY_FORMAT_CUSTOM0_SHIFT;
+	ZN_TEST_ASSERT((greedy_output.mesh_flags & custom0_format) == custom0_format);
+	// Meshes without tile rects must not declare a custom format
+	ZN_TEST_ASSERT(culled_output.surfaces[0].arrays[Mesh::ARRAY_CUSTOM0].get_type() == Variant::NIL);
+	ZN_TEST_ASSERT((culled_output.mesh_flags & custom0_format) == 0);
+
+	// UVs of merged sides extend over several tiles, and can be wrapped back inside their tile using the tile rect
+	for (int i = 0; i < greedy_uvs.size(); ++i) {
+		const Vector2 uv = greedy_uvs[i];
+		const Vector2 tile_origin(greedy_tile_rects[4 * i], greedy_tile_rects[4 * i + 1]);
+		const Vector2 tile_size(greedy_tile_rects[4 * i + 2], greedy_tile_rects[4 * i + 3]);
+		ZN_TEST_ASSERT(tile_size.x > 0.f && tile_size.y > 0.f);
+		const Vector2 tiles = (uv - tile_origin) / tile_size;
+		// Faces are 4x4 or 4x1 voxels
+		ZN_TEST_ASSERT(tiles.x >= -0.001f && tiles.x <= 4.001f);
+		ZN_TEST_ASSERT(tiles.y >= -0.001f && tiles.y <= 4.001f);
+	}
+
+	// Both meshes must cover the same volume
+	const AABB culled_aabb = L::get_aabb(culled_positions);
+	const AABB greedy_aabb = L::get_aabb(greedy_positions);
+	ZN_TEST_ASSERT(culled_aabb.is_equal_approx(greedy_aabb));
+	ZN_TEST_ASSERT(greedy_aabb.is_equal_approx(AABB(Vector3(0, 2, 0), Vector3(4, 1, 4))));
+
+	// Merged faces are smaller in collision meshes too
+	ZN_TEST_ASSERT(greedy_output.collision_surface.positions.size() == 6 * 4);
+	ZN_TEST_ASSERT(greedy_output.collision_surface.indices.size() == 6 * 6);
+}
+
+void test_voxel_mesher_blocky_binary_culling() {
+	// Culling sides between opaque cubes with bitmasks must give the same result as comparing models.
+	// To get a reference without the fast path, a second library makes every model transparent. Because all models
+	// have the same transparency, culling rules between them are the same, but none of them are opaque cubes.
+
+	struct L {
+		static Ref<VoxelBlockyLibrary> create_library(int transparency_index) {
+			Ref<VoxelBlockyLibrary> library;
+			library.instantiate();
+			{
+				Ref<VoxelBlockyModelEmpty> air;
+				air.instantiate();
+				library->add_model(air);
+			}
+			{
+				Ref<VoxelBlockyModelCube> cube;
+				cube.instantiate();
+				cube->set_transparency_index(transparency_index);
+				library->add_model(cube);
+			}
+			{
+				Ref<VoxelBlockyModelCube> slab;
+				slab.instantiate();
+				slab->set_height(0.5f);
+				slab->set_transparency_index(transparency_index);
+				library->add_model(slab);
+			}
+			library->bake();
+			return library;
+		}
+
+		static VoxelMesher::Output build(Ref<VoxelBlockyLibrary> library, const VoxelBuffer &voxels) {
+			Ref<VoxelMesherBlocky> mesher;
+			mesher.instantiate();
+			mesher->set_library(library);
+
+			VoxelMesher::Input input{ voxels, nullptr, Vector3i(), 0, false };
+			VoxelMesher::Output output;
+			mesher->build(output, input);
+			return output;
+		}
+	};
+
+	const int air_id = 0;
+	const int cube_id = 1;
+	const int slab_id = 2;
+
+	VoxelBuffer voxels(VoxelBuffer::ALLOCATOR_DEFAULT);
+	voxels.create(Vector3i(18, 18, 18));
+	// Mostly solid ground with some holes and slabs, and air above
+	voxels.fill_area(cube_id, Vector3i(0, 0, 0), Vector3i(18, 10, 18), VoxelBuffer::CHANNEL_TYPE);
+	for (int z = 0; z < 18; ++z) {
+		for (int x = 0; x < 18; ++x) {
+			for (int y = 0; y < 12; ++y) {
+				const int h = (x * 7 + y * 13 + z * 5) % 11;
+				if (h == 0) {
+					voxels.set_voxel(air_id, Vector3i(x, y, z), VoxelBuffer::CHANNEL_TYPE);
+				} else if (h == 1) {
+					voxels.set_voxel(slab_id, Vector3i(x, y, z), VoxelBuffer::CHANNEL_TYPE);
+				}
+			}
+		}
+	}
+
+	const VoxelMesher::Output expected = L::build(L::create_library(1), voxels);
+	const VoxelMesher::Output actual = L::build(L::create_library(0), voxels);
+
+	ZN_TEST_ASSERT(expected.surfaces.size() == 1);
+	ZN_TEST_ASSERT(actual.surfaces.size() == 1);
+
+	const PackedVector3Array expected_positions = expected.surfaces[0].arrays[Mesh::ARRAY_VERTEX];
+	const PackedVector3Array actual_positions = actual.surfaces[0].arrays[Mesh::ARRAY_VERTEX];
+	const PackedInt32Array expected_indices = expected.surfaces[0].arrays[Mesh::ARRAY_INDEX];
+	const PackedInt32Array actual_indices = actual.surfaces[0].arrays[Mesh::ARRAY_INDEX];
+
+	ZN_TEST_ASSERT(expected_positions.size() > 0);
+	ZN_TEST_ASSERT(actual_positions == expected_positions);
+	ZN_TEST_ASSERT(actual_indices == expected_indices);
+}
+
+void test_voxel_mesher_blocky_binary_culling_inside_geometry() {
+	// Models with full sides can also have geometry inside. Fully surrounded voxels of such models must still produce
+	// that geometry, only their sides are culled.
+
+	Ref<ArrayMesh> mesh;
+	{
+		PackedVector3Array positions;
+		PackedVector3Array normals;
+		PackedVector2Array uvs;
+		PackedInt32Array indices;
+
+		struct L {
+			static void add_quad(
+					PackedVector3Array &positions,
+					PackedVector3Array &normals,
+					PackedVector2Array &uvs,
+					PackedInt32Array &indices,
+					const Vector3 origin,
+					const Vector3 u,
+					const Vector3 v,
+					const Vector3 normal
+			) {
+				const int i0 = positions.size();
+				positions.push_back(origin);
+				positions.push_back(origin + u);
+				positions.push_back(origin + u + v);
+				positions.push_back(origin + v);
+				for (int i = 0; i < 4; ++i) {
+					normals.push_back(normal);
+				}
+				uvs.push_back(Vector2(0, 0));
+				uvs.push_back(Vector2(1, 0));
+				uvs.push_back(Vector2(1, 1));
+				uvs.push_back(Vector2(0, 1));
+				indices.push_back(i0);
+				indices.push_back(i0 + 1);
+				indices.push_back(i0 + 2);
+				indices.push_back(i0);
+				indices.push_back(i0 + 2);
+				indices.push_back(i0 + 3);
+			}
+		};
+
+		// Full cube sides
+		for (int axis = 0; axis < 3; ++axis) {
+			Vector3 u;
+			u[(axis + 1) % 3] = 1;
+			Vector3 v;
+			v[(axis + 2) % 3] = 1;
+			Vector3 normal;
+			normal[axis] = 1;
+			L::add_quad(positions, normals, uvs, indices, Vector3(), u, v, -normal);
+			L::add_quad(positions, normals, uvs, indices, normal, u, v, normal);
+		}
+		// Inside quad, not touching any side
+		L::add_quad(
+				positions,
+				normals,
+				uvs,
+				indices,
+				Vector3(0.25, 0.5, 0.25),
+				Vector3(0.5, 0, 0),
+				Vector3(0, 0, 0.5),
+				Vector3(0, 1, 0)
+		);
+
+		Array arrays;
+		arrays.resize(Mesh::ARRAY_MAX);
+		arrays[Mesh::ARRAY_VERTEX] = positions;
+		arrays[Mesh::ARRAY_NORMAL] = normals;
+		arrays[Mesh::ARRAY_TEX_UV] = uvs;
+		arrays[Mesh::ARRAY_INDEX] = indices;
+
+		mesh.instantiate();
+		mesh->add_surface_from_arrays(Mesh::PRIMITIVE_TRIANGLES, arrays);
+	}
+
+	Ref<VoxelBlockyLibrary> library;
+	library.instantiate();
+	{
+		Ref<VoxelBlockyModelEmpty> air;
+		air.instantiate();
+		library->add_model(air);
+	}
+	{
+		Ref<VoxelBlockyModelMesh> model;
+		model.instantiate();
+		model->set_mesh(mesh);
+		library->add_model(model);
+	}
+	library->bake();
+	const int model_id = 1;
+
+	VoxelBuffer voxels(VoxelBuffer::ALLOCATOR_DEFAULT);
+	// With padding, this meshes 3x3x3 voxels all surrounded by other voxels
+	voxels.create(Vector3i(5, 5, 5));
+	voxels.fill(model_id, VoxelBuffer::CHANNEL_TYPE);
+
+	Ref<VoxelMesherBlocky> mesher;
+	mesher.instantiate();
+	mesher->set_library(library);
+
+	VoxelMesher::Input input{ voxels, nullptr, Vector3i(), 0, false };
+	VoxelMesher::Output output;
+	mesher->build(output, input);
+
+	ZN_TEST_ASSERT(output.surfaces.size() == 1);
+	const PackedVector3Array output_positions = output.surfaces[0].arrays[Mesh::ARRAY_VERTEX];
+	// All sides are culled, only the inside quad of every voxel remains
+	ZN_TEST_ASSERT(output_positions.size() == 3 * 3 * 3 * 4);
+	for (int i = 0; i < output_positions.size(); ++i) {
+		const Vector3 pos = output_positions[i];
+		ZN_TEST_ASSERT(Math::is_equal_approx(pos.y - Math::floor(pos.y), 0.5));
+	}
+}
+
+void test_voxel_mesher_blocky_vertex_compression() {
+#if GODOT_VERSION_MAJOR == 4 && GODOT_VERSION_MINOR <= 1
+	// Attribute compression is not available
+#else
+	Ref<VoxelBlockyLibrary> library;
+	library.instantiate();
+	{
+		Ref<VoxelBlockyModelEmpty> air;
+		air.instantiate();
+		library->add_model(air);
+	}
+	{
+		Ref<VoxelBlockyModelCube> cube;
+		cube.instantiate();
+		library->add_model(cube);
+	}
+	library->bake();
+	const int cube_id = 1;
+
+	VoxelBuffer voxels(VoxelBuffer::ALLOCATOR_DEFAULT);
+	voxels.create(Vector3i(8, 8, 8));
+	voxels.fill_area(cube_id, Vector3i(2, 2, 2), Vector3i(5, 5, 5), VoxelBuffer::CHANNEL_TYPE);
+
+	Ref<VoxelMesherBlocky> mesher;
+	mesher.instantiate();
+	mesher->set_library(library);
+
+	{
+		Ref<Mesh> mesh = mesher->build_mesh(voxels, TypedArray<Material>(), Dictionary());
+		ZN_TEST_ASSERT(mesh.is_valid());
+		ZN_TEST_ASSERT(mesh->get_surface_count() == 1);
+		ZN_TEST_ASSERT((mesh->surface_get_format(0) & Mesh::ARRAY_FLAG_COMPRESS_ATTRIBUTES) == 0);
+	}
+
+	mesher->set_vertex_compression_enabled(true);
+	{
+		Ref<Mesh> mesh = mesher->build_mesh(voxels, TypedArray<Material>(), Dictionary());
+		ZN_TEST_ASSERT(mesh.is_valid());
+		ZN_TEST_ASSERT(mesh->get_surface_count() == 1);
+		ZN_TEST_ASSERT((mesh->surface_get_format(0) & Mesh::ARRAY_FLAG_COMPRESS_ATTRIBUTES) != 0);
+		// Positions are quantized within the bounds of the block (without padding), not the bounds of the cubes, so
+		// neighbor blocks quantize vertices of their seams the same way
+		ZN_TEST_ASSERT(mesh->get_aabb().is_equal_approx(AABB(Vector3(), Vector3(6, 6, 6))));
+	}
+#endif
+}
+
+void test_voxel_mesher_blocky_incremental() {
+	Ref<VoxelBlockyLibrary> library;
+	library.instantiate();
+	{
+		Ref<VoxelBlockyModelEmpty> air;
+		air.instantiate();
+		library->add_model(air);
+	}
+	{
+		Ref<VoxelBlockyModelCube> cube;
+		cube.instantiate();
+		library->add_model(cube);
+	}
+	library->bake();
+	const int air_id = 0;
+	const int cube_id = 1;
+
+	// 16 voxels with padding, so there are two slices
+	VoxelBuffer voxels(VoxelBuffer::ALLOCATOR_DEFAULT);
+	voxels.create(Vector3i(18, 18, 18));
+	voxels.fill_area(cube_id, Vector3i(0, 0, 0), Vector3i(18, 9, 18), VoxelBuffer::CHANNEL_TYPE);
+
+	Ref<VoxelMesherBlocky> mesher;
+	mesher.instantiate();
+	mesher->set_library(library);
+
+	ZN_TEST_ASSERT(mesher->create_incremental_cache() == nullptr);
+	mesher->set_incremental_meshing_enabled(true);
+	std::shared_ptr<VoxelMesher::IncrementalCache> cache = mesher->create_incremental_cache();
+	ZN_TEST_ASSERT(cache != nullptr);
+
+	struct Stats {
+		int vertex_count = 0;
+		int index_count = 0;
+		Vector3 positions_sum;
+
+		bool operator==(const Stats &other) const {
+			return vertex_count == other.vertex_count && index_count == other.index_count &&
+					positions_sum == other.positions_sum;
+		}
+	};
+
+	struct L {
+		// Positions of vertices can be in a different order with incremental builds, so we compare summaries
+		static Stats build(VoxelMesherBlocky &mesher, const VoxelBuffer &voxels, VoxelMesher::IncrementalCache *cache) {
+			if (cache != nullptr) {
+				return build(mesher, voxels, cache, cache->take_dirty_area());
+			}
+			return build(mesher, voxels, nullptr, VoxelMesher::IncrementalCache::DirtyArea());
+		}
+
+		static Stats build(
+				VoxelMesherBlocky &mesher,
+				const VoxelBuffer &voxels,
+				VoxelMesher::IncrementalCache *cache,
+				const VoxelMesher::IncrementalCache::DirtyArea &dirty_area
+		) {
+			VoxelMesher::Input input{ voxels, nullptr, Vector3i(), 0, false };
+			input.incremental_cache = cache;
+			input.incremental_dirty_area = dirty_area;
+			VoxelMesher::Output output;
+			mesher.build(output, input);
+			ZN_TEST_ASSERT(output.surfaces.size() == 1);
+
+			const PackedVector3Array positions = output.surfaces[0].arrays[Mesh::ARRAY_VERTEX];
+			const PackedInt32Array indices = output.surfaces[0].arrays[Mesh::ARRAY_INDEX];
+			Stats stats;
+			stats.vertex_count = positions.size();
+			stats.index_count = indices.size();
+			for (int i = 0; i < positions.size(); ++i) {
+				stats.positions_sum += positions[i];
+			}
+			return stats;
+		}
+	};
+
+	// First build is complete
+	const Stats initial = L::build(**mesher, voxels, cache.get());
+	ZN_TEST_ASSERT(initial == L::build(**mesher, voxels, nullptr));
+
+	// Dig a hole at the surface, which is in the first slice
+	const Vector3i hole_pos(5, 8, 5);
+	voxels.set_voxel(air_id, hole_pos, VoxelBuffer::CHANNEL_TYPE);
+	cache->add_dirty_box(Box3i(hole_pos - Vector3i(1, 1, 1), Vector3i(1, 1, 1)).padded(1));
+
+	const Stats after_hole = L::build(**mesher, voxels, cache.get());
+	ZN_TEST_ASSERT(!(after_hole == initial));
+	ZN_TEST_ASSERT(after_hole == L::build(**mesher, voxels, nullptr));
+
+	// Change the second slice without telling the cache. The slice must be reused, so the change doesn't show up.
+	voxels.set_voxel(cube_id, Vector3i(5, 14, 5), VoxelBuffer::CHANNEL_TYPE);
+	cache->add_dirty_box(Box3i(Vector3i(0, 0, 0), Vector3i(16, 2, 16)));
+
+	const Stats stale = L::build(**mesher, voxels, cache.get());
+	ZN_TEST_ASSERT(stale == after_hole);
+
+	cache->mark_fully_dirty();
+	const Stats full = L::build(**mesher, voxels, cache.get());
+	ZN_TEST_ASSERT(!(full == after_hole));
+	ZN_TEST_ASSERT(full == L::build(**mesher, voxels, nullptr));
+
+	// Two tasks meshing the same block complete in the opposite order they gathered voxels
+	VoxelBuffer old_voxels(VoxelBuffer::ALLOCATOR_DEFAULT);
+	voxels.copy_to(old_voxels, false);
+	const VoxelMesher::IncrementalCache::DirtyArea old_area = cache->take_dirty_area();
+
+	const Vector3i hole2_pos(10, 8, 10);
+	voxels.set_voxel(air_id, hole2_pos, VoxelBuffer::CHANNEL_TYPE);
+	cache->add_dirty_box(Box3i(hole2_pos - Vector3i(1, 1, 1), Vector3i(1, 1, 1)).padded(1));
+	const VoxelMesher::IncrementalCache::DirtyArea new_area = cache->take_dirty_area();
+
+	const Stats new_stats = L::build(**mesher, voxels, cache.get(), new_area);
+	ZN_TEST_ASSERT(new_stats == L::build(**mesher, voxels, nullptr));
+
+	// The older task still gets a mesh matching its own voxels
+	const Stats old_stats = L::build(**mesher, old_voxels, cache.get(), old_area);
+	ZN_TEST_ASSERT(old_stats == full);
+
+	// And it didn't overwrite sections of the newer task
+	ZN_TEST_ASSERT(L::build(**mesher, voxels, cache.get()) == new_stats);
+}
+
+void test_voxel_mesher_blocky_side_connectivity() {
+	Ref<VoxelBlockyLibrary> library;
+	library.instantiate();
+	{
+		Ref<VoxelBlockyModelEmpty> air;
+		air.instantiate();
+		library->add_model(air);
+	}
+	{
+		Ref<VoxelBlockyModelCube> cube;
+		cube.instantiate();
+		library->add_model(cube);
+	}
+	library->bake();
+	const int air_id = 0;
+	const int cube_id = 1;
+
+	struct L {
+		static uint16_t build(Ref<VoxelBlockyLibrary> library, const VoxelBuffer &voxels) {
+			Ref<VoxelMesherBlocky> mesher;
+			mesher.instantiate();
+			mesher->set_library(library);
+
+			VoxelMesher::Input input{ voxels, nullptr, Vector3i(), 0, false };
+			input.side_connectivity_hint = true;
+			VoxelMesher::Output output;
+			mesher->build(output, input);
+			return output.side_connectivity;
+		}
+
+		static uint16_t get_pair_bit(Cube::SideAxis a, Cube::SideAxis b) {
+			return 1 << side_connectivity::get_pair_index(a, b);
+		}
+	};
+
+	// Padding is 1 on each side, so the meshed area is 6x6x6
+	VoxelBuffer voxels(VoxelBuffer::ALLOCATOR_DEFAULT);
+	voxels.create(Vector3i(8, 8, 8));
+
+	// Uniform air
+	ZN_TEST_ASSERT(L::build(library, voxels) == side_connectivity::ALL_CONNECTED);
+
+	// Uniform solid
+	voxels.fill(cube_id, VoxelBuffer::CHANNEL_TYPE);
+	ZN_TEST_ASSERT(L::build(library, voxels) == side_connectivity::NONE_CONNECTED);
+
+	// Tunnel along X
+	voxels.fill_area(air_id, Vector3i(0, 3, 3), Vector3i(8, 4, 4), VoxelBuffer::CHANNEL_TYPE);
+	ZN_TEST_ASSERT(L::build(library, voxels) == L::get_pair_bit(Cube::SIDE_NEGATIVE_X, Cube::SIDE_POSITIVE_X));
+
+	// Air split by a horizontal wall: bottom and top can't see each other, but everything else can
+	voxels.fill(air_id, VoxelBuffer::CHANNEL_TYPE);
+	voxels.fill_area(cube_id, Vector3i(0, 3, 0), Vector3i(8, 4, 8), VoxelBuffer::CHANNEL_TYPE);
+	ZN_TEST_ASSERT(
+			L::build(library, voxels) ==
+			(side_connectivity::ALL_CONNECTED & ~L::get_pair_bit(Cube::SIDE_NEGATIVE_Y, Cube::SIDE_POSITIVE_Y))
+	);
+}
+
+void test_voxel_mesher_blocky_collision_only() {
+	Ref<VoxelBlockyLibrary> library;
+	library.instantiate();
+	{
+		Ref<VoxelBlockyModelEmpty> air;
+		air.instantiate();
+		library->add_model(air);
+	}
+	{
+		Ref<VoxelBlockyModelCube> cube;
+		cube.instantiate();
+		library->add_model(cube);
+	}
+	library->bake();
+	const int cube_id = 1;
+
+	VoxelBuffer voxels(VoxelBuffer::ALLOCATOR_DEFAULT);
+	voxels.create(Vector3i(8, 8, 8));
+	voxels.fill_area(cube_id, Vector3i(1, 1, 1), Vector3i(7, 4, 7), VoxelBuffer::CHANNEL_TYPE);
+	voxels.set_voxel(cube_id, Vector3i(3, 4, 3), VoxelBuffer::CHANNEL_TYPE);
+
+	Ref<VoxelMesherBlocky> mesher;
+	mesher.instantiate();
+	mesher->set_library(library);
+
+	for (const bool greedy : { false, true }) {
+		mesher->set_greedy_meshing_enabled(greedy);
+
+		VoxelMesher::Input input{ voxels, nullptr, Vector3i(), 0, true };
+		VoxelMesher::Output visual_output;
+		mesher->build(visual_output, input);
+		ZN_TEST_ASSERT(visual_output.surfaces.size() == 1);
+		ZN_TEST_ASSERT(visual_output.collision_surface.indices.size() > 0);
+
+		input.visual_hint = false;
+		VoxelMesher::Output collision_output;
+		mesher->build(collision_output, input);
+
+		// No render arrays, but the same collision surface
+		ZN_TEST_ASSERT(collision_output.surfaces.size() == 0);
+		ZN_TEST_ASSERT(collision_output.collision_surface.positions == visual_output.collision_surface.positions);
+		ZN_TEST_ASSERT(collision_output.collision_surface.indices == visual_output.collision_surface.indices);
+	}
+}
+
+} // namespace zylann::voxel::tests
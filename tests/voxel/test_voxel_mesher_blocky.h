@@ -0,0 +1,16 @@
+#ifndef VOXEL_TESTS_VOXEL_MESHER_BLOCKY_H
+#define VOXEL_TESTS_VOXEL_MESHER_BLOCKY_H
+
+namespace zylann::voxel::tests {
+
+void test_voxel_mesher_blocky_greedy();
+void test_voxel_mesher_blocky_binary_culling();
+void test_voxel_mesher_blocky_binary_culling_inside_geometry();
+void test_voxel_mesher_blocky_vertex_compression();
+void test_voxel_mesher_blocky_incremental();
+void test_voxel_mesher_blocky_side_connectivity();
+void test_voxel_mesher_blocky_collision_only();
+
+} // namespace zylann::voxel::tests
+
+#endif // VOXEL_TESTS_VOXEL_MESHER_BLOCKY_H
@@ -1,6 +1,8 @@
 #include "test_voxel_mesher_cubes.h"
+#include "../../meshers/cubes/voxel_color_palette.h"
 #include "../../meshers/cubes/voxel_mesher_cubes.h"
 #include "../../storage/voxel_buffer.h"
+#include "../../util/godot/core/version.h"
 #include "../../util/testing/test_macros.h"
 
 namespace zylann::voxel::tests {
@@ -51,4 +53,128 @@ void test_voxel_mesher_cubes() {
 	ZN_TEST_ASSERT(surface1_vertices_count == 20);
 }
 
+void test_voxel_mesher_cubes_mesh_optimization() {
+	VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+	vb.create(8, 8, 8);
+	vb.set_channel_depth(VoxelBuffer::CHANNEL_COLOR, VoxelBuffer::DEPTH_16_BIT);
+	// Flat slab of a single color, filling the area inside padding
+	for (int z = 1; z < 7; ++z) {
+		for (int x = 1; x < 7; ++x) {
+			vb.set_voxel(Color8(0, 255, 0, 255).to_u16(), Vector3i(x, 3, z), VoxelBuffer::CHANNEL_COLOR);
+		}
+	}
+
+	Ref<VoxelMesherCubes> mesher;
+	mesher.instantiate();
+	mesher->set_color_mode(VoxelMesherCubes::COLOR_RAW);
+	// Produce one quad per voxel side, so there is something to simplify
+	mesher->set_greedy_meshing_enabled(false);
+
+	struct L {
+		static void build(VoxelMesherCubes &mesher, const VoxelBuffer &vb, uint8_t lod_index, Array &out_arrays) {
+			VoxelMesher::Input input{ vb, nullptr, Vector3i(), lod_index, false };
+			VoxelMesher::Output output;
+			mesher.build(output, input);
+			ZN_TEST_ASSERT(output.surfaces.size() == 1);
+			out_arrays = output.surfaces[0].arrays;
+		}
+	};
+
+	Array arrays_unoptimized;
+	L::build(**mesher, vb, 0, arrays_unoptimized);
+
+	mesher->set_mesh_optimization_enabled(true);
+	mesher->set_mesh_optimization_target_ratio(0.f);
+
+	Array arrays_lod0;
+	L::build(**mesher, vb, 0, arrays_lod0);
+
+	Array arrays_lod1;
+	L::build(**mesher, vb, 1, arrays_lod1);
+
+	const PackedInt32Array unoptimized_indices = arrays_unoptimized[Mesh::ARRAY_INDEX];
+	const PackedVector3Array unoptimized_vertices = arrays_unoptimized[Mesh::ARRAY_VERTEX];
+	const PackedInt32Array lod0_indices = arrays_lod0[Mesh::ARRAY_INDEX];
+	const PackedVector3Array lod0_vertices = arrays_lod0[Mesh::ARRAY_VERTEX];
+	const PackedColorArray lod0_colors = arrays_lod0[Mesh::ARRAY_COLOR];
+	const PackedInt32Array lod1_indices = arrays_lod1[Mesh::ARRAY_INDEX];
+	const PackedVector3Array lod1_vertices = arrays_lod1[Mesh::ARRAY_VERTEX];
+	const PackedVector3Array lod1_normals = arrays_lod1[Mesh::ARRAY_NORMAL];
+
+	// LOD0 is not simplified, but vertices shared by neighbor quads are welded
+	ZN_TEST_ASSERT(lod0_indices.size() == unoptimized_indices.size());
+	ZN_TEST_ASSERT(lod0_vertices.size() < unoptimized_vertices.size());
+	ZN_TEST_ASSERT(lod0_colors.size() == lod0_vertices.size());
+	for (int i = 0; i < lod0_indices.size(); ++i) {
+		ZN_TEST_ASSERT(lod0_indices[i] >= 0 && lod0_indices[i] < lod0_vertices.size());
+	}
+
+	// Inner vertices of flat sides can be removed on LODs
+	ZN_TEST_ASSERT(lod1_indices.size() < lod0_indices.size());
+	ZN_TEST_ASSERT(lod1_indices.size() % 3 == 0);
+
+	// Vertices on the borders of the block must not move, otherwise cracks would appear with neighbors
+	const float lod1_border = 6 * 2;
+	for (int i = 0; i < lod0_vertices.size(); ++i) {
+		const Vector3 v = lod0_vertices[i] * 2;
+		if (v.x != 0 && v.x != lod1_border && v.z != 0 && v.z != lod1_border) {
+			continue;
+		}
+		ZN_TEST_ASSERT(lod1_vertices.has(v));
+	}
+
+	// Corners of simplified triangles keep the normals of the faces they belong to
+	for (int i = 0; i < lod1_indices.size(); i += 3) {
+		const Vector3 p0 = lod1_vertices[lod1_indices[i]];
+		const Vector3 p1 = lod1_vertices[lod1_indices[i + 1]];
+		const Vector3 p2 = lod1_vertices[lod1_indices[i + 2]];
+		const Vector3 face_normal = (p1 - p0).cross(p2 - p0).normalized();
+		for (int c = 0; c < 3; ++c) {
+			const Vector3 normal = lod1_normals[lod1_indices[i + c]];
+			ZN_TEST_ASSERT(Math::abs(normal.dot(face_normal)) > 0.99f);
+		}
+	}
+}
+
+void test_voxel_mesher_cubes_vertex_compression() {
+#if GODOT_VERSION_MAJOR == 4 && GODOT_VERSION_MINOR <= 1
+	// Attribute compression is not available
+#else
+	// The color atlas is only used with palettes
+	Ref<VoxelColorPalette> palette;
+	palette.instantiate();
+	palette->set_color(1, Color(0, 1, 0));
+	palette->set_color(2, Color(1, 0, 0));
+
+	VoxelBuffer vb(VoxelBuffer::ALLOCATOR_DEFAULT);
+	vb.create(8, 8, 8);
+	vb.set_channel_depth(VoxelBuffer::CHANNEL_COLOR, VoxelBuffer::DEPTH_8_BIT);
+	vb.set_voxel(1, Vector3i(3, 4, 4), VoxelBuffer::CHANNEL_COLOR);
+	vb.set_voxel(2, Vector3i(4, 4, 4), VoxelBuffer::CHANNEL_COLOR);
+
+	Ref<VoxelMesherCubes> mesher;
+	mesher.instantiate();
+	mesher->set_color_mode(VoxelMesherCubes::COLOR_MESHER_PALETTE);
+	mesher->set_palette(palette);
+	mesher->set_vertex_compression_enabled(true);
+
+	{
+		VoxelMesher::Input input{ vb, nullptr, Vector3i(), 0, false };
+		VoxelMesher::Output output;
+		mesher->build(output, input);
+		ZN_TEST_ASSERT((output.mesh_flags & Mesh::ARRAY_FLAG_COMPRESS_ATTRIBUTES) != 0);
+	}
+
+	// UVs pointing into the color atlas must not be quantized
+	mesher->set_store_colors_in_texture(true);
+	{
+		VoxelMesher::Input input{ vb, nullptr, Vector3i(), 0, false };
+		VoxelMesher::Output output;
+		mesher->build(output, input);
+		ZN_TEST_ASSERT(output.atlas_image.is_valid());
+		ZN_TEST_ASSERT((output.mesh_flags & Mesh::ARRAY_FLAG_COMPRESS_ATTRIBUTES) == 0);
+	}
+#endif
+}
+
 } // namespace zylann::voxel::tests
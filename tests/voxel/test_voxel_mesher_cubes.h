@@ -4,6 +4,8 @@
 namespace zylann::voxel::tests {
 
 void test_voxel_mesher_cubes();
+void test_voxel_mesher_cubes_mesh_optimization();
+void test_voxel_mesher_cubes_vertex_compression();
 
 } // namespace zylann::voxel::tests
 
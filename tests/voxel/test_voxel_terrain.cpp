@@ -0,0 +1,166 @@
+#include "test_voxel_terrain.h"
+#include "../../constants/cube_tables.h"
+#include "../../engine/voxel_engine.h"
+#include "../../meshers/cubes/voxel_mesher_cubes.h"
+#include "../../meshers/mesh_block_task.h"
+#include "../../meshers/side_connectivity.h"
+#include "../../storage/voxel_data.h"
+#include "../../terrain/fixed_lod/voxel_terrain_occlusion_culling.h"
+#include "../../util/godot/classes/concave_polygon_shape_3d.h"
+#include "../../util/godot/classes/rendering_server.h"
+#include "../../util/testing/test_macros.h"
+
+namespace zylann::voxel::tests {
+
+void test_voxel_terrain_occlusion_culling_reachable_blocks() {
+	struct L {
+		static bool is_reached(const StdUnorderedMap<Vector3i, uint8_t> &reached_blocks, const Vector3i bpos) {
+			return reached_blocks.find(bpos) != reached_blocks.end();
+		}
+	};
+
+	const Vector3i camera_bpos(0, 0, 0);
+	const int max_distance = 3;
+
+	const Cube::Side side_px = Cube::dir_to_side(Vector3i(1, 0, 0));
+	const Cube::Side side_nx = Cube::dir_to_side(Vector3i(-1, 0, 0));
+
+	StdUnorderedMap<Vector3i, uint16_t> side_connectivity_map;
+
+	// Opaque walls on both sides of the camera along X, covering the whole search distance
+	for (int z = -max_distance; z <= max_distance; ++z) {
+		for (int y = -max_distance; y <= max_distance; ++y) {
+			side_connectivity_map[Vector3i(2, y, z)] = side_connectivity::NONE_CONNECTED;
+			side_connectivity_map[Vector3i(-2, y, z)] = side_connectivity::NONE_CONNECTED;
+		}
+	}
+	// Blocks behind walls, known to be fully open. These are the blocks that must get culled.
+	side_connectivity_map[Vector3i(3, 0, 0)] = side_connectivity::ALL_CONNECTED;
+	side_connectivity_map[Vector3i(3, 1, 2)] = side_connectivity::ALL_CONNECTED;
+	// A tunnel through the -X wall
+	side_connectivity_map[Vector3i(-2, 0, 0)] = 1 << side_connectivity::get_pair_index(side_px, side_nx);
+	side_connectivity_map[Vector3i(-3, 0, 0)] = side_connectivity::ALL_CONNECTED;
+	side_connectivity_map[Vector3i(-3, 1, 0)] = side_connectivity::ALL_CONNECTED;
+
+	StdUnorderedMap<Vector3i, uint8_t> reached_blocks;
+	find_reachable_blocks(side_connectivity_map, camera_bpos, max_distance, reached_blocks);
+
+	ZN_TEST_ASSERT(L::is_reached(reached_blocks, camera_bpos));
+	ZN_TEST_ASSERT(L::is_reached(reached_blocks, Vector3i(1, 0, 0)));
+	ZN_TEST_ASSERT(L::is_reached(reached_blocks, Vector3i(0, 3, 0)));
+	ZN_TEST_ASSERT(L::is_reached(reached_blocks, Vector3i(1, -3, 3)));
+
+	// Walls can be seen, but not through
+	ZN_TEST_ASSERT(L::is_reached(reached_blocks, Vector3i(2, 0, 0)));
+	ZN_TEST_ASSERT(reached_blocks[Vector3i(2, 0, 0)] == (1 << side_nx));
+	ZN_TEST_ASSERT(!L::is_reached(reached_blocks, Vector3i(3, 0, 0)));
+	ZN_TEST_ASSERT(!L::is_reached(reached_blocks, Vector3i(3, 1, 2)));
+
+	// Through the tunnel, then turning
+	ZN_TEST_ASSERT(L::is_reached(reached_blocks, Vector3i(-3, 0, 0)));
+	ZN_TEST_ASSERT(reached_blocks[Vector3i(-3, 0, 0)] == (1 << side_px));
+	ZN_TEST_ASSERT(L::is_reached(reached_blocks, Vector3i(-3, 1, 0)));
+	// Going back against a direction already taken is not allowed, so the wall next to the tunnel is only entered
+	// from the camera side
+	ZN_TEST_ASSERT(reached_blocks[Vector3i(-2, 1, 0)] == (1 << side_px));
+
+	// Out of range
+	ZN_TEST_ASSERT(!L::is_reached(reached_blocks, Vector3i(0, 4, 0)));
+	ZN_TEST_ASSERT(!L::is_reached(reached_blocks, Vector3i(-4, 0, 0)));
+
+	// Without walls, everything in range is reached
+	side_connectivity_map.clear();
+	find_reachable_blocks(side_connectivity_map, camera_bpos, max_distance, reached_blocks);
+	ZN_TEST_ASSERT(L::is_reached(reached_blocks, Vector3i(3, 0, 0)));
+	ZN_TEST_ASSERT(L::is_reached(reached_blocks, Vector3i(3, 1, 2)));
+	ZN_TEST_ASSERT(L::is_reached(reached_blocks, Vector3i(-3, -3, -3)));
+	ZN_TEST_ASSERT(reached_blocks.size() == 7 * 7 * 7);
+}
+
+void test_voxel_terrain_threaded_collision_shape() {
+	// Collision shapes should be built in threads even when graphics resources can't be, which is the case on servers
+	// running with the headless driver.
+
+	VoxelEngine &engine = VoxelEngine::get_singleton();
+	engine.try_initialize_physics_features();
+	ZN_TEST_ASSERT(engine.is_threaded_physics_shape_building_enabled());
+
+	const bool headless = zylann::godot::get_current_rendering_driver_name() == "dummy";
+	if (headless) {
+		ZN_TEST_ASSERT(!engine.is_threaded_graphics_resource_building_enabled());
+	}
+
+	struct Results {
+		unsigned int mesh_output_count = 0;
+		bool has_mesh_resource = false;
+		bool has_collision_shape = false;
+		Ref<Shape3D> collision_shape;
+
+		static void on_mesh_output(void *cb_data, VoxelEngine::BlockMeshOutput &ob) {
+			Results &results = *static_cast<Results *>(cb_data);
+			++results.mesh_output_count;
+			results.has_mesh_resource = ob.has_mesh_resource;
+			results.has_collision_shape = ob.has_collision_shape;
+			results.collision_shape = ob.collision_shape;
+		}
+
+		static void on_data_output(void *cb_data, VoxelEngine::BlockDataOutput &ob) {}
+	};
+
+	Results results;
+	VoxelEngine::VolumeCallbacks callbacks;
+	callbacks.mesh_output_callback = Results::on_mesh_output;
+	callbacks.data_output_callback = Results::on_data_output;
+	callbacks.data = &results;
+	const VolumeID volume_id = engine.add_volume(callbacks);
+
+	Ref<VoxelMesherCubes> mesher;
+	mesher.instantiate();
+	mesher->set_color_mode(VoxelMesherCubes::COLOR_RAW);
+
+	VoxelFormat format;
+	format.depths[VoxelBuffer::CHANNEL_COLOR] = VoxelBuffer::DEPTH_16_BIT;
+	std::shared_ptr<VoxelData> data = make_shared_instance<VoxelData>();
+	data->set_format(format);
+	const Vector3i block_size = Vector3iUtil::create(data->get_block_size());
+
+	std::shared_ptr<VoxelBuffer> empty_block = make_shared_instance<VoxelBuffer>(VoxelBuffer::ALLOCATOR_DEFAULT);
+	format.configure_buffer(*empty_block);
+	empty_block->create(block_size);
+
+	// A single cube in the middle of the central block
+	std::shared_ptr<VoxelBuffer> central_block = make_shared_instance<VoxelBuffer>(VoxelBuffer::ALLOCATOR_DEFAULT);
+	format.configure_buffer(*central_block);
+	central_block->create(block_size);
+	central_block->set_voxel(Color8(0, 255, 0, 255).to_u16(), block_size / 2, VoxelBuffer::CHANNEL_COLOR);
+
+	{
+		MeshBlockTask task;
+		task.volume_id = volume_id;
+		task.blocks_count = 3 * 3 * 3;
+		for (unsigned int i = 0; i < task.blocks_count; ++i) {
+			task.blocks[i] = empty_block;
+		}
+		task.blocks[3 * 3 + 3 + 1] = central_block;
+		task.require_visual = true;
+		task.collision_hint = true;
+		task.data = data;
+		MeshingDependency::reset(task.meshing_dependency, mesher, Ref<VoxelGenerator>());
+
+		ThreadedTaskContext ctx(0, TaskPriority());
+		task.run(ctx);
+		task.apply_result();
+	}
+
+	engine.remove_volume(volume_id);
+
+	ZN_TEST_ASSERT(results.mesh_output_count == 1);
+	ZN_TEST_ASSERT(results.has_mesh_resource == engine.is_threaded_graphics_resource_building_enabled());
+	ZN_TEST_ASSERT(results.has_collision_shape);
+	Ref<ConcavePolygonShape3D> shape = results.collision_shape;
+	ZN_TEST_ASSERT(shape.is_valid());
+	// 6 sides, 2 triangles each
+	ZN_TEST_ASSERT(shape->get_faces().size() == 6 * 2 * 3);
+}
+
+} // namespace zylann::voxel::tests
@@ -0,0 +1,11 @@
+#ifndef VOXEL_TESTS_VOXEL_TERRAIN_H
+#define VOXEL_TESTS_VOXEL_TERRAIN_H
+
+namespace zylann::voxel::tests {
+
+void test_voxel_terrain_occlusion_culling_reachable_blocks();
+void test_voxel_terrain_threaded_collision_shape();
+
+} // namespace zylann::voxel::tests
+
+#endif // VOXEL_TESTS_VOXEL_TERRAIN_H
@@ -1,4 +1,5 @@
 #include "mesh.h"
+#include "../../errors.h"
 
 namespace zylann::godot {
 
@@ -54,4 +55,134 @@ void offset_surface(Array &surface, Vector3 offset) {
 	surface[Mesh::ARRAY_VERTEX] = positions;
 }
 
+namespace {
+
+template <typename TPackedArray>
+TPackedArray concatenate_surface_arrays(Span<const Array> surfaces, const unsigned int array_index) {
+	TPackedArray dst;
+	for (const Array &surface : surfaces) {
+		const TPackedArray src = surface[array_index];
+		dst.append_array(src);
+	}
+	return dst;
+}
+
+PackedVector3Array merge_surface_positions(Span<const Array> surfaces, Span<const Vector3> offsets) {
+	int total_count = 0;
+	for (const Array &surface : surfaces) {
+		const PackedVector3Array positions = surface[Mesh::ARRAY_VERTEX];
+		total_count += positions.size();
+	}
+
+	PackedVector3Array dst;
+	dst.resize(total_count);
+	Vector3 *dst_data = dst.ptrw();
+
+	for (unsigned int surface_index = 0; surface_index < surfaces.size(); ++surface_index) {
+		const PackedVector3Array positions = surfaces[surface_index][Mesh::ARRAY_VERTEX];
+		const Vector3 *src_data = positions.ptr();
+		const Vector3 offset = offsets[surface_index];
+		const int count = positions.size();
+		for (int i = 0; i < count; ++i) {
+			dst_data[i] = src_data[i] + offset;
+		}
+		dst_data += count;
+	}
+
+	return dst;
+}
+
+PackedInt32Array merge_surface_indices(Span<const Array> surfaces) {
+	int total_count = 0;
+	for (const Array &surface : surfaces) {
+		const PackedInt32Array indices = surface[Mesh::ARRAY_INDEX];
+		total_count += indices.size();
+	}
+
+	PackedInt32Array dst;
+	dst.resize(total_count);
+	int32_t *dst_data = dst.ptrw();
+	int32_t vertex_base = 0;
+
+	for (const Array &surface : surfaces) {
+		const PackedInt32Array indices = surface[Mesh::ARRAY_INDEX];
+		const PackedVector3Array positions = surface[Mesh::ARRAY_VERTEX];
+		const int32_t *src_data = indices.ptr();
+		const int count = indices.size();
+		for (int i = 0; i < count; ++i) {
+			dst_data[i] = src_data[i] + vertex_base;
+		}
+		dst_data += count;
+		vertex_base += positions.size();
+	}
+
+	return dst;
+}
+
+} // namespace
+
+Array merge_surfaces(Span<const Array> surfaces, Span<const Vector3> offsets) {
+	ZN_ASSERT_RETURN_V(surfaces.size() == offsets.size(), Array());
+	ZN_ASSERT_RETURN_V(surfaces.size() > 0, Array());
+
+	Array merged;
+	merged.resize(Mesh::ARRAY_MAX);
+
+	for (unsigned int array_index = 0; array_index < Mesh::ARRAY_MAX; ++array_index) {
+		const Variant::Type type = surfaces[0][array_index].get_type();
+
+		for (const Array &surface : surfaces) {
+			if (surface.size() != Mesh::ARRAY_MAX || surface[array_index].get_type() != type) {
+				return Array();
+			}
+		}
+
+		switch (array_index) {
+			case Mesh::ARRAY_VERTEX:
+				if (type != Variant::PACKED_VECTOR3_ARRAY) {
+					return Array();
+				}
+				merged[array_index] = merge_surface_positions(surfaces, offsets);
+				break;
+
+			case Mesh::ARRAY_INDEX:
+				if (type != Variant::PACKED_INT32_ARRAY) {
+					return Array();
+				}
+				merged[array_index] = merge_surface_indices(surfaces);
+				break;
+
+			default:
+				switch (type) {
+					case Variant::NIL:
+						break;
+					case Variant::PACKED_BYTE_ARRAY:
+						merged[array_index] = concatenate_surface_arrays<PackedByteArray>(surfaces, array_index);
+						break;
+					case Variant::PACKED_INT32_ARRAY:
+						merged[array_index] = concatenate_surface_arrays<PackedInt32Array>(surfaces, array_index);
+						break;
+					case Variant::PACKED_FLOAT32_ARRAY:
+						merged[array_index] = concatenate_surface_arrays<PackedFloat32Array>(surfaces, array_index);
+						break;
+					case Variant::PACKED_VECTOR2_ARRAY:
+						merged[array_index] = concatenate_surface_arrays<PackedVector2Array>(surfaces, array_index);
+						break;
+					case Variant::PACKED_VECTOR3_ARRAY:
+						merged[array_index] = concatenate_surface_arrays<PackedVector3Array>(surfaces, array_index);
+						break;
+					case Variant::PACKED_COLOR_ARRAY:
+						merged[array_index] = concatenate_surface_arrays<PackedColorArray>(surfaces, array_index);
+						break;
+					default:
+						ZN_PRINT_ERROR("Unsupported array type in surface");
+						return Array();
+				}
+				break;
+		}
+	}
+
+	return merged;
+}
+
 } // namespace zylann::godot
@@ -22,6 +22,11 @@ void offset_vec3_array(PackedVector3Array &array, Vector3 offset);
 void scale_surface(Array &surface, float scale);
 void offset_surface(Array &surface, Vector3 offset);
 
+// Concatenates indexed surfaces sharing the same format into a single surface. Vertices of each source surface are
+// translated by the corresponding offset, and indices are shifted accordingly.
+// Returns an empty array if surfaces are not indexed, or have different formats.
+Array merge_surfaces(Span<const Array> surfaces, Span<const Vector3> offsets);
+
 } // namespace zylann::godot
 
 #endif // ZN_GODOT_MESH_H
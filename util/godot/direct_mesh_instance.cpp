@@ -2,6 +2,7 @@
 #include "../profiling.h"
 #include "classes/material.h"
 #include "classes/world_3d.h"
+#include "server_object_pools.h"
 
 namespace zylann::godot {
 
@@ -13,9 +14,11 @@ DirectMeshInstance::DirectMeshInstance() {
 DirectMeshInstance::DirectMeshInstance(DirectMeshInstance &&src) {
 	_mesh_instance = src._mesh_instance;
 	_mesh = src._mesh;
+	_pool = src._pool;
 
 	src._mesh_instance = RID();
 	src._mesh = Ref<Mesh>();
+	src._pool = nullptr;
 }
 
 DirectMeshInstance::~DirectMeshInstance() {
@@ -33,11 +36,22 @@ void DirectMeshInstance::create() {
 	vs.instance_set_visible(_mesh_instance, true); // TODO Is it needed?
 }
 
+void DirectMeshInstance::create(RenderingInstancePool &pool) {
+	ERR_FAIL_COND(_mesh_instance.is_valid());
+	_mesh_instance = pool.allocate();
+	_pool = &pool;
+}
+
 void DirectMeshInstance::destroy() {
 	if (_mesh_instance.is_valid()) {
 		ZN_PROFILE_SCOPE();
-		RenderingServer &vs = *RenderingServer::get_singleton();
-		free_rendering_server_rid(vs, _mesh_instance);
+		if (_pool != nullptr) {
+			_pool->recycle(_mesh_instance);
+			_pool = nullptr;
+		} else {
+			RenderingServer &vs = *RenderingServer::get_singleton();
+			free_rendering_server_rid(vs, _mesh_instance);
+		}
 		_mesh_instance = RID();
 	}
 	_mesh.unref();
@@ -137,9 +151,11 @@ void DirectMeshInstance::operator=(DirectMeshInstance &&src) {
 
 	_mesh_instance = src._mesh_instance;
 	_mesh = src._mesh;
+	_pool = src._pool;
 
 	src._mesh_instance = RID();
 	src._mesh.unref();
+	src._pool = nullptr;
 }
 
 } // namespace zylann::godot
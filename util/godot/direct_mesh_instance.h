@@ -11,6 +11,8 @@ ZN_GODOT_FORWARD_DECLARE(class World3D);
 
 namespace zylann::godot {
 
+class RenderingInstancePool;
+
 // Thin wrapper around VisualServer mesh instance API
 class DirectMeshInstance : public NonCopyable {
 public:
@@ -20,6 +22,9 @@ public:
 
 	bool is_valid() const;
 	void create();
+	// Same as `create`, but takes the instance from a pool. It goes back to that pool when destroyed, so the pool must
+	// outlive it.
+	void create(RenderingInstancePool &pool);
 	void destroy();
 	void set_world(World3D *world);
 	void set_transform(Transform3D world_transform);
@@ -42,6 +47,7 @@ public:
 private:
 	RID _mesh_instance;
 	Ref<Mesh> _mesh;
+	RenderingInstancePool *_pool = nullptr;
 };
 
 } // namespace zylann::godot
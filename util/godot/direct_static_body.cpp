@@ -3,6 +3,7 @@
 #include "classes/array_mesh.h"
 #include "classes/physics_server_3d.h"
 #include "classes/world_3d.h"
+#include "server_object_pools.h"
 
 namespace zylann::godot {
 
@@ -23,10 +24,23 @@ void DirectStaticBody::create() {
 	ps.body_set_mode(_body, PhysicsServer3D::BODY_MODE_STATIC);
 }
 
+void DirectStaticBody::create(PhysicsBodyPool &pool) {
+	ERR_FAIL_COND(_body.is_valid());
+	_body = pool.allocate();
+	_pool = &pool;
+	PhysicsServer3D::get_singleton()->body_set_ray_pickable(_body, false);
+}
+
 void DirectStaticBody::destroy() {
 	if (_body.is_valid()) {
-		PhysicsServer3D &ps = *PhysicsServer3D::get_singleton();
-		free_physics_server_rid(ps, _body);
+		if (_pool != nullptr) {
+			// Shapes get removed from the body when recycled
+			_pool->recycle(_body);
+			_pool = nullptr;
+		} else {
+			PhysicsServer3D &ps = *PhysicsServer3D::get_singleton();
+			free_physics_server_rid(ps, _body);
+		}
 		_body = RID();
 		// The shape need to be destroyed after the body
 		_shape.unref();
@@ -10,6 +10,8 @@ ZN_GODOT_FORWARD_DECLARE(class World3D);
 
 namespace zylann::godot {
 
+class PhysicsBodyPool;
+
 // Thin wrapper around static body API
 class DirectStaticBody : public zylann::NonCopyable {
 public:
@@ -17,6 +19,9 @@ public:
 	~DirectStaticBody();
 
 	void create();
+	// Same as `create`, but takes the body from a pool. It goes back to that pool when destroyed, so the pool must
+	// outlive it.
+	void create(PhysicsBodyPool &pool);
 	void destroy();
 	bool is_valid() const;
 	void set_transform(Transform3D transform);
@@ -34,6 +39,7 @@ public:
 private:
 	RID _body;
 	Ref<Shape3D> _shape;
+	PhysicsBodyPool *_pool = nullptr;
 	DirectMeshInstance _debug_mesh_instance;
 };
 
@@ -0,0 +1,145 @@
+#include "server_object_pools.h"
+#include "../errors.h"
+#include "../profiling.h"
+#include "classes/geometry_instance_3d.h"
+#include "classes/physics_server_3d.h"
+#include "classes/rendering_server.h"
+
+namespace zylann::godot {
+
+RenderingInstancePool::~RenderingInstancePool() {
+	clear();
+}
+
+RID RenderingInstancePool::allocate() {
+	if (!_instances.empty()) {
+		const RID rid = _instances.back();
+		_instances.pop_back();
+		return rid;
+	}
+	ZN_PROFILE_SCOPE();
+	return RenderingServer::get_singleton()->instance_create();
+}
+
+void RenderingInstancePool::recycle(RID rid) {
+	ZN_ASSERT_RETURN(rid.is_valid());
+	ZN_PROFILE_SCOPE();
+
+	RenderingServer &rs = *RenderingServer::get_singleton();
+
+	if (_instances.size() >= _max_size) {
+		free_rendering_server_rid(rs, rid);
+		return;
+	}
+
+	// Reset to the same state as a new instance, so users don't have to care where it came from
+	rs.instance_set_scenario(rid, RID());
+	rs.instance_set_base(rid, RID());
+	rs.instance_geometry_set_material_override(rid, RID());
+	rs.instance_set_transform(rid, Transform3D());
+	rs.instance_set_visible(rid, true);
+	rs.instance_set_layer_mask(rid, 1);
+	rs.instance_geometry_set_cast_shadows_setting(rid, RenderingServer::SHADOW_CASTING_SETTING_ON);
+	set_geometry_instance_gi_mode(rid, GeometryInstance3D::GI_MODE_DISABLED);
+
+	_instances.push_back(rid);
+}
+
+void RenderingInstancePool::set_max_size(unsigned int max_size) {
+	_max_size = max_size;
+	if (_instances.size() > _max_size) {
+		RenderingServer &rs = *RenderingServer::get_singleton();
+		for (unsigned int i = _max_size; i < _instances.size(); ++i) {
+			free_rendering_server_rid(rs, _instances[i]);
+		}
+		_instances.resize(_max_size);
+	}
+}
+
+unsigned int RenderingInstancePool::get_max_size() const {
+	return _max_size;
+}
+
+unsigned int RenderingInstancePool::get_size() const {
+	return _instances.size();
+}
+
+void RenderingInstancePool::clear() {
+	RenderingServer *rs = RenderingServer::get_singleton();
+	// The server might already be gone when shutting down, in which case it has freed everything already
+	if (rs != nullptr) {
+		for (const RID rid : _instances) {
+			free_rendering_server_rid(*rs, rid);
+		}
+	}
+	_instances.clear();
+}
+
+PhysicsBodyPool::~PhysicsBodyPool() {
+	clear();
+}
+
+RID PhysicsBodyPool::allocate() {
+	if (!_bodies.empty()) {
+		const RID rid = _bodies.back();
+		_bodies.pop_back();
+		return rid;
+	}
+	ZN_PROFILE_SCOPE();
+	PhysicsServer3D &ps = *PhysicsServer3D::get_singleton();
+	const RID rid = ps.body_create();
+	ps.body_set_mode(rid, PhysicsServer3D::BODY_MODE_STATIC);
+	return rid;
+}
+
+void PhysicsBodyPool::recycle(RID rid) {
+	ZN_ASSERT_RETURN(rid.is_valid());
+	ZN_PROFILE_SCOPE();
+
+	PhysicsServer3D &ps = *PhysicsServer3D::get_singleton();
+
+	if (_bodies.size() >= _max_size) {
+		free_physics_server_rid(ps, rid);
+		return;
+	}
+
+	ps.body_set_space(rid, RID());
+	ps.body_clear_shapes(rid);
+	ps.body_attach_object_instance_id(rid, ObjectID());
+	ps.body_set_collision_layer(rid, 1);
+	ps.body_set_collision_mask(rid, 1);
+	ps.body_set_state(rid, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D());
+
+	_bodies.push_back(rid);
+}
+
+void PhysicsBodyPool::set_max_size(unsigned int max_size) {
+	_max_size = max_size;
+	if (_bodies.size() > _max_size) {
+		PhysicsServer3D &ps = *PhysicsServer3D::get_singleton();
+		for (unsigned int i = _max_size; i < _bodies.size(); ++i) {
+			free_physics_server_rid(ps, _bodies[i]);
+		}
+		_bodies.resize(_max_size);
+	}
+}
+
+unsigned int PhysicsBodyPool::get_max_size() const {
+	return _max_size;
+}
+
+unsigned int PhysicsBodyPool::get_size() const {
+	return _bodies.size();
+}
+
+void PhysicsBodyPool::clear() {
+	PhysicsServer3D *ps = PhysicsServer3D::get_singleton();
+	if (ps != nullptr) {
+		for (const RID rid : _bodies) {
+			free_physics_server_rid(*ps, rid);
+		}
+	}
+	_bodies.clear();
+}
+
+} // namespace zylann::godot
@@ -0,0 +1,58 @@
+#ifndef ZN_GODOT_SERVER_OBJECT_POOLS_H
+#define ZN_GODOT_SERVER_OBJECT_POOLS_H
+
+#include "../containers/std_vector.h"
+#include "../non_copyable.h"
+#include "core/rid.h"
+
+namespace zylann::godot {
+
+// Keeps RenderingServer instances around after they are no longer used, so they can be reused instead of being freed
+// and created again. Terrains stream many chunks in and out, and freeing instances can be expensive (for example
+// RenderingServer updates queued materials when an instance is freed).
+// Recycled instances are reset to default state, except shader instance parameters.
+// Must only be used on the main thread.
+class RenderingInstancePool : public NonCopyable {
+public:
+	~RenderingInstancePool();
+
+	// Returns an instance that is not in any scenario. It is either recycled or newly created.
+	RID allocate();
+	// Takes ownership of the instance. It gets freed if the pool is full.
+	void recycle(RID rid);
+
+	// Maximum number of instances kept for reuse. 0 disables pooling.
+	void set_max_size(unsigned int max_size);
+	unsigned int get_max_size() const;
+
+	unsigned int get_size() const;
+	void clear();
+
+private:
+	StdVector<RID> _instances;
+	unsigned int _max_size = 0;
+};
+
+// Same as `RenderingInstancePool`, for static bodies of PhysicsServer3D.
+// Recycled bodies are static, not in any space, and have no shapes.
+class PhysicsBodyPool : public NonCopyable {
+public:
+	~PhysicsBodyPool();
+
+	RID allocate();
+	void recycle(RID rid);
+
+	void set_max_size(unsigned int max_size);
+	unsigned int get_max_size() const;
+
+	unsigned int get_size() const;
+	void clear();
+
+private:
+	StdVector<RID> _bodies;
+	unsigned int _max_size = 0;
+};
+
+} // namespace zylann::godot
+
+#endif // ZN_GODOT_SERVER_OBJECT_POOLS_H
@@ -53,9 +53,23 @@ void ShaderMaterialPool::recycle(Ref<ShaderMaterial> material) {
 	ZN_ASSERT_RETURN(material.is_valid());
 	ZN_ASSERT_RETURN(_template_material.is_valid());
 	ZN_ASSERT_RETURN(material->get_shader() == _template_material->get_shader());
+	if (_materials.size() >= _max_size) {
+		return;
+	}
 	_materials.push_back(material);
 }
 
+void ShaderMaterialPool::set_max_size(unsigned int max_size) {
+	_max_size = max_size;
+	if (_materials.size() > _max_size) {
+		_materials.resize(_max_size);
+	}
+}
+
+unsigned int ShaderMaterialPool::get_max_size() const {
+	return _max_size;
+}
+
 Span<const StringName> ShaderMaterialPool::get_cached_shader_uniforms() const {
 	return to_span(_shader_params_cache);
 }
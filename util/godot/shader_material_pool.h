@@ -23,6 +23,10 @@ public:
 	Ref<ShaderMaterial> allocate();
 	void recycle(Ref<ShaderMaterial> material);
 
+	// Maximum number of materials kept for reuse. Materials recycled beyond that are released.
+	void set_max_size(unsigned int max_size);
+	unsigned int get_max_size() const;
+
 	// Materials have a cache too, but this one is even more direct
 	Span<const StringName> get_cached_shader_uniforms() const;
 
@@ -30,6 +34,7 @@ private:
 	Ref<ShaderMaterial> _template_material;
 	StdVector<StringName> _shader_params_cache;
 	StdVector<Ref<ShaderMaterial>> _materials;
+	unsigned int _max_size = 1024;
 };
 
 void copy_shader_params(const ShaderMaterial &src, ShaderMaterial &dst, Span<const StringName> params);
@@ -12,8 +12,13 @@ using namespace godot;
 
 #include "constants.h"
 #include <cmath>
+#include <cstdint>
 #include <type_traits>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace zylann::math {
 
 // Generic math functions, only using scalar types.
@@ -293,6 +298,27 @@ inline unsigned int get_next_power_of_two_32_shift(unsigned int num) {
 	return 0;
 }
 
+// Returns the index of the lowest bit set in `x`. `x` must not be zero.
+inline unsigned int count_trailing_zeros_64(uint64_t x) {
+#ifdef DEBUG_ENABLED
+	ZN_ASSERT(x != 0);
+#endif
+#if defined(__GNUC__)
+	return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanForward64(&index, x);
+	return index;
+#else
+	unsigned int i = 0;
+	while ((x & 1) == 0) {
+		x >>= 1;
+		++i;
+	}
+	return i;
+#endif
+}
+
 // If the provided address `a` is not aligned to the number of bytes specified in `align`,
 // returns the next aligned address. `align` must be a power of two.
 inline size_t alignup(size_t a, size_t align) {
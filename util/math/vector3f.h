@@ -23,6 +23,10 @@ inline Vector3f ceil(const Vector3f a) {
 	return Vector3f(Math::ceil(a.x), Math::ceil(a.y), Math::ceil(a.z));
 }
 
+inline Vector3f fract(const Vector3f a) {
+	return a - floor(a);
+}
+
 inline Vector3f lerp(const Vector3f a, const Vector3f b, const float t) {
 	return Vector3f(Math::lerp(a.x, b.x, t), Math::lerp(a.y, b.y, t), Math::lerp(a.z, b.z, t));
 }
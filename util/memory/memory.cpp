@@ -0,0 +1,11 @@
+#include "memory.h"
+
+namespace zylann {
+
+#if DEBUG_ENABLED
+namespace MemoryCounters {
+thread_local uint64_t tls_allocation_count = 0;
+} // namespace MemoryCounters
+#endif
+
+} // namespace zylann
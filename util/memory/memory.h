@@ -3,6 +3,21 @@
 
 #include <memory>
 
+#if DEBUG_ENABLED
+#include <cstdint>
+
+namespace zylann::MemoryCounters {
+// Number of allocations made by the current thread through the macros below (which includes `StdDefaultAllocator`).
+// Used to check that hot paths don't allocate once warmed up. Allocations made directly by Godot containers are not
+// counted.
+extern thread_local uint64_t tls_allocation_count;
+} // namespace zylann::MemoryCounters
+
+#define ZN_COUNT_ALLOCATION() (++zylann::MemoryCounters::tls_allocation_count)
+#else
+#define ZN_COUNT_ALLOCATION() 0
+#endif
+
 // Default new and delete operators.
 #if defined(ZN_GODOT)
 
@@ -10,20 +25,20 @@
 
 // Use Godot's allocator.
 // In modules, memnew and memdelete work for anything. However in GDExtension it might not be the case...
-#define ZN_NEW(t) memnew(t)
+#define ZN_NEW(t) ((void)ZN_COUNT_ALLOCATION(), memnew(t))
 #define ZN_DELETE(t) memdelete(t)
-#define ZN_ALLOC(size) memalloc(size)
-#define ZN_REALLOC(p, size) memrealloc(p, size)
+#define ZN_ALLOC(size) ((void)ZN_COUNT_ALLOCATION(), memalloc(size))
+#define ZN_REALLOC(p, size) ((void)ZN_COUNT_ALLOCATION(), memrealloc(p, size))
 #define ZN_FREE(p) memfree(p)
 
 #elif defined(ZN_GODOT_EXTENSION)
 
 #include <godot_cpp/core/memory.hpp>
 
-#define ZN_NEW(t) memnew(t)
+#define ZN_NEW(t) ((void)ZN_COUNT_ALLOCATION(), memnew(t))
 #define ZN_DELETE(t) ::godot::memdelete(t)
-#define ZN_ALLOC(size) memalloc(size)
-#define ZN_REALLOC(p, size) memrealloc(p, size)
+#define ZN_ALLOC(size) ((void)ZN_COUNT_ALLOCATION(), memalloc(size))
+#define ZN_REALLOC(p, size) ((void)ZN_COUNT_ALLOCATION(), memrealloc(p, size))
 #define ZN_FREE(p) memfree(p)
 
 #endif
@@ -0,0 +1,110 @@
+#include "temp_arena.h"
+#include "../errors.h"
+#include "../math/funcs.h"
+#include "memory.h"
+#include <atomic>
+
+namespace zylann {
+
+namespace {
+
+// Pages are allocated with this size, unless a bigger allocation is requested
+static const size_t DEFAULT_PAGE_SIZE = 64 * 1024;
+// Alignment guaranteed by the general allocator
+static const size_t MAX_ALIGNMENT = 16;
+
+std::atomic_size_t g_high_water_mark = { 0 };
+std::atomic_size_t g_capacity = { 0 };
+
+} // namespace
+
+TempArena::~TempArena() {
+	for (Page &page : _pages) {
+		ZN_FREE(page.data);
+		g_capacity -= page.capacity;
+	}
+}
+
+void *TempArena::allocate(const size_t size, const size_t alignment) {
+	ZN_ASSERT(alignment <= MAX_ALIGNMENT);
+
+	if (_page_index < _pages.size()) {
+		const Page &page = _pages[_page_index];
+		const size_t begin = math::alignup(_offset, alignment);
+		if (begin + size <= page.capacity) {
+			_offset = begin + size;
+			update_high_water_mark();
+			return page.data + begin;
+		}
+		// Not enough space left, the rest of the page is skipped
+		++_page_index;
+		_offset = 0;
+	}
+
+	if (_page_index >= _pages.size() || _pages[_page_index].capacity < size) {
+		// Next pages are kept, they may fit later allocations
+		Page page;
+		page.capacity = math::max(DEFAULT_PAGE_SIZE, size);
+		page.data = static_cast<uint8_t *>(ZN_ALLOC(page.capacity));
+		ZN_ASSERT(page.data != nullptr);
+		_pages.insert(_pages.begin() + _page_index, page);
+		g_capacity += page.capacity;
+	}
+
+	_offset = size;
+	update_high_water_mark();
+	return _pages[_page_index].data;
+}
+
+void TempArena::rewind(const Marker marker) {
+#ifdef DEBUG_ENABLED
+	ZN_ASSERT(marker.page_index < _page_index || (marker.page_index == _page_index && marker.offset <= _offset));
+#endif
+	_page_index = marker.page_index;
+	_offset = marker.offset;
+}
+
+size_t TempArena::get_used_size() const {
+	// Includes space skipped at the end of previous pages
+	size_t size = _offset;
+	for (unsigned int i = 0; i < _page_index && i < _pages.size(); ++i) {
+		size += _pages[i].capacity;
+	}
+	return size;
+}
+
+size_t TempArena::get_capacity() const {
+	size_t capacity = 0;
+	for (const Page &page : _pages) {
+		capacity += page.capacity;
+	}
+	return capacity;
+}
+
+void TempArena::update_high_water_mark() {
+	const size_t used_size = get_used_size();
+	if (used_size <= _high_water_mark) {
+		return;
+	}
+	_high_water_mark = used_size;
+
+	size_t global_mark = g_high_water_mark.load(std::memory_order_relaxed);
+	while (global_mark < used_size &&
+		   !g_high_water_mark.compare_exchange_weak(global_mark, used_size, std::memory_order_relaxed)) {
+	}
+}
+
+TempArena &TempArena::get_for_current_thread() {
+	static thread_local TempArena tls_arena;
+	return tls_arena;
+}
+
+size_t TempArena::get_global_high_water_mark() {
+	return g_high_water_mark;
+}
+
+size_t TempArena::get_global_capacity() {
+	return g_capacity;
+}
+
+} // namespace zylann
@@ -0,0 +1,105 @@
+#ifndef ZN_TEMP_ARENA_H
+#define ZN_TEMP_ARENA_H
+
+#include "../containers/span.h"
+#include "../containers/std_vector.h"
+#include <cstdint>
+#include <type_traits>
+
+namespace zylann {
+
+// Linear allocator for short-lived scratch memory. Allocating only bumps an offset, and memory is released all at once
+// by rewinding to a previous marker (see `TempArenaScope`). Meant to be used with one instance per thread, so there is
+// no contention between threads.
+// Memory is allocated in pages that are kept after being released, so once warmed up, no more calls to the general
+// allocator are made. Spans obtained from it remain valid until the arena is rewound before them.
+class TempArena {
+public:
+	struct Marker {
+		unsigned int page_index;
+		size_t offset;
+	};
+
+	TempArena() = default;
+	~TempArena();
+
+	TempArena(const TempArena &) = delete;
+	TempArena &operator=(const TempArena &) = delete;
+
+	void *allocate(const size_t size, const size_t alignment);
+
+	// Memory is NOT initialized. Only trivial types are supported, because destructors won't run.
+	template <typename T>
+	Span<T> allocate_span(const size_t count) {
+		static_assert(std::is_trivially_destructible_v<T>);
+		if (count == 0) {
+			return Span<T>();
+		}
+		T *p = static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+		return Span<T>(p, count);
+	}
+
+	Marker get_marker() const {
+		return { _page_index, _offset };
+	}
+
+	// Releases everything allocated after the given marker.
+	void rewind(const Marker marker);
+
+	// Releases everything. Pages remain allocated for reuse.
+	void clear() {
+		rewind({ 0, 0 });
+	}
+
+	// Bytes currently allocated from the arena.
+	size_t get_used_size() const;
+	// Total bytes reserved by pages.
+	size_t get_capacity() const;
+	// Highest amount of bytes that were in use at the same time.
+	size_t get_high_water_mark() const {
+		return _high_water_mark;
+	}
+
+	static TempArena &get_for_current_thread();
+
+	// Highest amount of bytes that were in use at the same time in any thread arena.
+	static size_t get_global_high_water_mark();
+	// Total bytes reserved by pages of thread arenas.
+	static size_t get_global_capacity();
+
+private:
+	struct Page {
+		uint8_t *data;
+		size_t capacity;
+	};
+
+	void update_high_water_mark();
+
+	StdVector<Page> _pages;
+	unsigned int _page_index = 0;
+	// Offset within the current page
+	size_t _offset = 0;
+	size_t _high_water_mark = 0;
+};
+
+// Rewinds an arena when going out of scope, releasing everything allocated in between.
+class TempArenaScope {
+public:
+	TempArenaScope(TempArena &arena) : _arena(arena), _marker(arena.get_marker()) {}
+
+	~TempArenaScope() {
+		_arena.rewind(_marker);
+	}
+
+	TempArena &get_arena() {
+		return _arena;
+	}
+
+private:
+	TempArena &_arena;
+	const TempArena::Marker _marker;
+};
+
+} // namespace zylann
+
+#endif // ZN_TEMP_ARENA_H
@@ -2,6 +2,7 @@
 #define PROFILING_CLOCK_H
 
 #include "godot/classes/time.h"
+#include <chrono>
 
 namespace zylann {
 
@@ -24,6 +25,27 @@ struct ProfilingClock {
 	}
 };
 
+// Higher resolution clock, for measuring operations taking less than a microsecond
+struct ProfilingClockNs {
+	std::chrono::steady_clock::time_point time_before;
+
+	ProfilingClockNs() {
+		restart();
+	}
+
+	inline uint64_t get_elapsed_nanoseconds() const {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - time_before)
+				.count();
+	}
+
+	inline uint64_t restart() {
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		const uint64_t time_spent = std::chrono::duration_cast<std::chrono::nanoseconds>(now - time_before).count();
+		time_before = now;
+		return time_spent;
+	}
+};
+
 } // namespace zylann
 
 #endif // PROFILING_CLOCK_H
@@ -0,0 +1,110 @@
+#include "parallel_for.h"
+#include "../containers/fixed_array.h"
+#include "../errors.h"
+#include "../math/funcs.h"
+#include "../memory/memory.h"
+#include "../profiling.h"
+#include "../thread/semaphore.h"
+#include "threaded_task_runner.h"
+
+#include <atomic>
+
+namespace zylann {
+
+namespace {
+
+// Waiting threads are limited, and splitting work too much gives diminishing returns
+constexpr uint32_t MAX_HELPERS = 8;
+
+// Shared between the calling thread and helper tasks. Helper tasks may run long after the call returned, in which case
+// they find no item left and must not touch the callback anymore.
+struct ParallelForState {
+	std::atomic_uint32_t next_index = { 0 };
+	uint32_t count = 0;
+	ParallelForCallback callback = nullptr;
+	void *callback_data = nullptr;
+	// Posted every time a helper finishes an item
+	Semaphore helper_done_semaphore;
+
+	bool run_next() {
+		const uint32_t index = next_index.fetch_add(1);
+		if (index >= count) {
+			return false;
+		}
+		callback(callback_data, index);
+		return true;
+	}
+
+	bool is_picked_up() const {
+		return next_index >= count;
+	}
+};
+
+class ParallelForHelperTask : public IThreadedTask {
+public:
+	ParallelForHelperTask(std::shared_ptr<ParallelForState> p_state) : _state(p_state) {}
+
+	const char *get_debug_name() const override {
+		return "ParallelForHelper";
+	}
+
+	void run(ThreadedTaskContext &ctx) override {
+		ZN_PROFILE_SCOPE();
+		while (_state->run_next()) {
+			_state->helper_done_semaphore.post();
+		}
+	}
+
+	bool is_cancelled() override {
+		// The calling thread may have done all the work already
+		return _state->is_picked_up();
+	}
+
+private:
+	std::shared_ptr<ParallelForState> _state;
+};
+
+} // namespace
+
+void parallel_for(ThreadedTaskRunner &runner, uint32_t count, ParallelForCallback callback, void *data) {
+	ZN_PROFILE_SCOPE();
+	ZN_ASSERT_RETURN(callback != nullptr);
+
+	if (count == 0) {
+		return;
+	}
+
+	const uint32_t helper_count = math::min(count - 1, runner.get_waiting_thread_count(), MAX_HELPERS);
+
+	if (helper_count == 0) {
+		for (uint32_t i = 0; i < count; ++i) {
+			callback(data, i);
+		}
+		return;
+	}
+
+	std::shared_ptr<ParallelForState> state = make_shared_instance<ParallelForState>();
+	state->count = count;
+	state->callback = callback;
+	state->callback_data = data;
+
+	{
+		FixedArray<IThreadedTask *, MAX_HELPERS> helpers;
+		for (uint32_t i = 0; i < helper_count; ++i) {
+			helpers[i] = ZN_NEW(ParallelForHelperTask(state));
+		}
+		runner.enqueue(to_span(helpers, helper_count), false);
+	}
+
+	uint32_t done_by_caller = 0;
+	while (state->run_next()) {
+		++done_by_caller;
+	}
+
+	// Remaining items have been picked up by helpers that are running them, wait for them to finish
+	for (uint32_t i = done_by_caller; i < count; ++i) {
+		state->helper_done_semaphore.wait();
+	}
+}
+
+} // namespace zylann
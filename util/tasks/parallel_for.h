@@ -0,0 +1,33 @@
+#ifndef ZN_PARALLEL_FOR_H
+#define ZN_PARALLEL_FOR_H
+
+#include <cstdint>
+
+namespace zylann {
+
+class ThreadedTaskRunner;
+
+using ParallelForCallback = void (*)(void *data, uint32_t index);
+
+// Calls `callback(data, i)` for every `i` in `[0, count)`, and returns when all calls are done.
+// The calling thread takes part in the work. Other threads of `runner` only help if some are waiting for tasks at the
+// time of the call, otherwise everything runs on the calling thread. Items are picked on the fly, so the calling thread
+// never waits for items that haven't started yet. That makes it safe to call from a task running in `runner`.
+void parallel_for(ThreadedTaskRunner &runner, uint32_t count, ParallelForCallback callback, void *data);
+
+template <typename F>
+inline void parallel_for(ThreadedTaskRunner &runner, uint32_t count, F f) {
+	parallel_for(
+			runner,
+			count,
+			[](void *data, uint32_t index) { //
+				F &f = *static_cast<F *>(data);
+				f(index);
+			},
+			&f
+	);
+}
+
+} // namespace zylann
+
+#endif // ZN_PARALLEL_FOR_H
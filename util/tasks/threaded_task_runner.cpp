@@ -312,7 +312,9 @@ void ThreadedTaskRunner::thread_func(ThreadData &data) {
 
 				// Wait for more tasks
 				data.waiting = true;
+				++_waiting_thread_count;
 				_tasks_semaphore.wait();
+				--_waiting_thread_count;
 				data.waiting = false;
 
 			} else {
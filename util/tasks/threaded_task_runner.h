@@ -96,6 +96,12 @@ public:
 	const char *get_thread_debug_task_name(unsigned int thread_index) const;
 	unsigned int get_debug_remaining_tasks() const;
 
+	// Number of threads currently waiting for tasks. It can change as soon as it is read, so it should only be used as
+	// a hint, for example to decide if it is worth splitting work.
+	uint32_t get_waiting_thread_count() const {
+		return _waiting_thread_count;
+	}
+
 private:
 	static StdVector<IThreadedTask *> &get_completed_tasks_temp_tls();
 
@@ -173,6 +179,8 @@ private:
 	unsigned int _debug_completed_tasks = 0;
 	unsigned int _debug_taken_out_tasks = 0;
 
+	std::atomic_uint32_t _waiting_thread_count = { 0 };
+
 #ifdef ZN_THREADED_TASK_RUNNER_CHECK_DUPLICATE_TASKS
 	StdUnorderedMap<IThreadedTask *, StdString> _debug_owned_tasks;
 	Mutex _debug_owned_tasks_mutex;